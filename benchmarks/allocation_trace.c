@@ -0,0 +1,281 @@
+#include "allocation_trace.h"
+
+#include <assert.h>
+#include <iso646.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Notes:
+- The hash table of the recorder uses linear probing and backward shift deletion, like allocation_tracker.
+- The load factor is kept at or below 1/2.
+*/
+
+enum {
+	allocation_trace_initial_capacity = 1024,
+	allocation_trace_recorder_initial_capacity = 64
+};
+
+void allocation_trace_init(allocation_trace_type *trace)
+{
+	assert(trace != NULL);
+	memset(trace, 0, sizeof(*trace));
+}
+
+void allocation_trace_deinit(allocation_trace_type *trace)
+{
+	assert(trace != NULL);
+	free(trace->requests);
+	memset(trace, 0, sizeof(*trace));
+}
+
+bool allocation_trace_append(allocation_trace_type *trace, allocation_trace_request_enum type, uint32_t slot, size_t number_of_bytes)
+{
+	assert(trace != NULL);
+	if (trace->number_of_requests == trace->capacity) {
+		const size_t new_capacity = (trace->capacity > 0U) ? (2U * trace->capacity) : (size_t) allocation_trace_initial_capacity;
+		allocation_trace_request_type *requests = NULL;
+		if (new_capacity > SIZE_MAX / sizeof(allocation_trace_request_type)) {
+			return false;
+		}
+		requests = (allocation_trace_request_type*) realloc(trace->requests, new_capacity * sizeof(allocation_trace_request_type));
+		if (requests == NULL) {
+			return false;
+		}
+		trace->requests = requests;
+		trace->capacity = new_capacity;
+	}
+
+	trace->requests[trace->number_of_requests].type = type;
+	trace->requests[trace->number_of_requests].slot = slot;
+	trace->requests[trace->number_of_requests].number_of_bytes = number_of_bytes;
+	++trace->number_of_requests;
+	if ((size_t) slot >= trace->number_of_slots) {
+		trace->number_of_slots = (size_t) slot + 1U;
+	}
+	return true;
+}
+
+bool allocation_trace_read(allocation_trace_type *trace, FILE *input, size_t *line_number)
+{
+	char line[256];
+	size_t current_line_number = 0U;
+
+	assert(trace != NULL);
+	assert(input != NULL);
+	while (fgets(line, (int) sizeof(line), input) != NULL) {
+		unsigned long slot = 0UL;
+		unsigned long number_of_bytes = 0UL;
+		char type = '\0';
+		int number_of_fields = 0;
+		bool is_valid = false;
+
+		++current_line_number;
+		if (line[0] == '#' or line[0] == '\n' or line[0] == '\0') {
+			continue;
+		}
+
+		number_of_fields = sscanf(line, " %c %lu %lu", &type, &slot, &number_of_bytes);
+		if (slot <= UINT32_MAX) {
+			switch (type) {
+			case 'a':
+				is_valid = number_of_fields == 3 and
+					allocation_trace_append(trace, allocation_trace_request_allocate, (uint32_t) slot, (size_t) number_of_bytes);
+				break;
+			case 'r':
+				is_valid = number_of_fields == 3 and
+					allocation_trace_append(trace, allocation_trace_request_reallocate, (uint32_t) slot, (size_t) number_of_bytes);
+				break;
+			case 'f':
+				is_valid = number_of_fields >= 2 and
+					allocation_trace_append(trace, allocation_trace_request_deallocate, (uint32_t) slot, 0U);
+				break;
+			default:
+				break;
+			}
+		}
+
+		if (not is_valid) {
+			if (line_number != NULL) {
+				*line_number = current_line_number;
+			}
+			return false;
+		}
+	}
+
+	return not ferror(input);
+}
+
+bool allocation_trace_write(const allocation_trace_type *trace, FILE *output)
+{
+	assert(trace != NULL);
+	assert(output != NULL);
+	for (size_t i = 0U; i < trace->number_of_requests; ++i) {
+		const allocation_trace_request_type *request = &trace->requests[i];
+		switch (request->type) {
+		case allocation_trace_request_allocate:
+			fprintf(output, "a %lu %lu\n", (unsigned long) request->slot, (unsigned long) request->number_of_bytes);
+			break;
+		case allocation_trace_request_reallocate:
+			fprintf(output, "r %lu %lu\n", (unsigned long) request->slot, (unsigned long) request->number_of_bytes);
+			break;
+		default:
+			fprintf(output, "f %lu\n", (unsigned long) request->slot);
+			break;
+		}
+	}
+	return not ferror(output);
+}
+
+static size_t allocation_trace_recorder_hash(const void *memory_block)
+{
+	size_t hash = (size_t) memory_block;
+	hash >>= 4U; /* the lowest bits are usually zero due to alignment */
+	hash ^= hash >> 15U;
+	hash *= 0x9E3779B1U;
+	hash ^= hash >> 13U;
+	return hash;
+}
+
+static size_t allocation_trace_recorder_find(const allocation_trace_recorder_type *recorder, const void *memory_block)
+{
+	const size_t mask = recorder->capacity - 1U;
+	size_t index = allocation_trace_recorder_hash(memory_block) & mask;
+	while (recorder->entries[index].memory_block != NULL and recorder->entries[index].memory_block != memory_block) {
+		index = (index + 1U) & mask;
+	}
+	return index;
+}
+
+static bool allocation_trace_recorder_grow(allocation_trace_recorder_type *recorder)
+{
+	const size_t old_capacity = recorder->capacity;
+	const size_t new_capacity = (old_capacity > 0U) ? (2U * old_capacity) : (size_t) allocation_trace_recorder_initial_capacity;
+	allocation_trace_recorder_entry_type *old_entries = recorder->entries;
+	allocation_trace_recorder_entry_type *new_entries =
+		(allocation_trace_recorder_entry_type*) calloc(new_capacity, sizeof(allocation_trace_recorder_entry_type));
+	if (new_entries == NULL) {
+		return false;
+	}
+
+	recorder->entries = new_entries;
+	recorder->capacity = new_capacity;
+	for (size_t i = 0U; i < old_capacity; ++i) {
+		if (old_entries[i].memory_block != NULL) {
+			recorder->entries[allocation_trace_recorder_find(recorder, old_entries[i].memory_block)] = old_entries[i];
+		}
+	}
+	free(old_entries);
+	return true;
+}
+
+static void allocation_trace_recorder_remove(allocation_trace_recorder_type *recorder, size_t index)
+{
+	const size_t mask = recorder->capacity - 1U;
+	size_t next_index = (index + 1U) & mask;
+
+	while (recorder->entries[next_index].memory_block != NULL) {
+		const size_t home_index = allocation_trace_recorder_hash(recorder->entries[next_index].memory_block) & mask;
+		/* move the entry back if its home slot is not in the cyclic range (index, next_index] */
+		if (((next_index - home_index) & mask) >= ((next_index - index) & mask)) {
+			recorder->entries[index] = recorder->entries[next_index];
+			index = next_index;
+		}
+		next_index = (next_index + 1U) & mask;
+	}
+
+	memset(&recorder->entries[index], 0, sizeof(recorder->entries[index]));
+	--recorder->number_of_live_blocks;
+}
+
+static void allocation_trace_recorder_insert(allocation_trace_recorder_type *recorder, void *memory_block, size_t number_of_bytes, uint32_t slot)
+{
+	const size_t index = allocation_trace_recorder_find(recorder, memory_block);
+	recorder->entries[index].memory_block = memory_block;
+	recorder->entries[index].number_of_bytes = number_of_bytes;
+	recorder->entries[index].slot = slot;
+	++recorder->number_of_live_blocks;
+}
+
+void allocation_trace_recorder_init(allocation_trace_recorder_type *recorder, allocator_type allocator, FILE *output)
+{
+	assert(recorder != NULL);
+	assert(output != NULL);
+	memset(recorder, 0, sizeof(*recorder));
+	recorder->allocator = allocator;
+	recorder->output = output;
+}
+
+void allocation_trace_recorder_deinit(allocation_trace_recorder_type *recorder)
+{
+	assert(recorder != NULL);
+	free(recorder->entries);
+	recorder->entries = NULL;
+	recorder->capacity = 0U;
+	recorder->number_of_live_blocks = 0U;
+}
+
+void *allocation_trace_recorder_allocate(allocation_trace_recorder_type *recorder, size_t number_of_bytes)
+{
+	void *memory_block = NULL;
+
+	assert(recorder != NULL);
+	if ((recorder->number_of_live_blocks + 1U) * 2U > recorder->capacity and not allocation_trace_recorder_grow(recorder)) {
+		return NULL;
+	}
+
+	memory_block = recorder->allocator.allocate(number_of_bytes);
+	if (memory_block != NULL) {
+		allocation_trace_recorder_insert(recorder, memory_block, number_of_bytes, recorder->next_slot);
+		fprintf(recorder->output, "a %lu %lu\n", (unsigned long) recorder->next_slot, (unsigned long) number_of_bytes);
+		++recorder->next_slot;
+	}
+	return memory_block;
+}
+
+void *allocation_trace_recorder_reallocate(allocation_trace_recorder_type *recorder, void *memory_block, size_t new_number_of_bytes)
+{
+	allocation_trace_recorder_entry_type entry;
+	size_t index = 0U;
+	void *new_memory_block = NULL;
+
+	assert(recorder != NULL);
+	if (memory_block == NULL) {
+		return allocation_trace_recorder_allocate(recorder, new_number_of_bytes);
+	}
+
+	if (new_number_of_bytes == 0U) {
+		allocation_trace_recorder_deallocate(recorder, memory_block);
+		return NULL;
+	}
+
+	index = allocation_trace_recorder_find(recorder, memory_block);
+	if (recorder->entries[index].memory_block != memory_block) {
+		return NULL;
+	}
+
+	entry = recorder->entries[index];
+	new_memory_block = allocator_reallocate(recorder->allocator, memory_block, entry.number_of_bytes, new_number_of_bytes);
+	if (new_memory_block != NULL) {
+		allocation_trace_recorder_remove(recorder, index);
+		allocation_trace_recorder_insert(recorder, new_memory_block, new_number_of_bytes, entry.slot);
+		fprintf(recorder->output, "r %lu %lu\n", (unsigned long) entry.slot, (unsigned long) new_number_of_bytes);
+	}
+	return new_memory_block;
+}
+
+void allocation_trace_recorder_deallocate(allocation_trace_recorder_type *recorder, void *memory_block)
+{
+	size_t index = 0U;
+
+	assert(recorder != NULL);
+	if (memory_block == NULL or recorder->entries == NULL) {
+		return;
+	}
+
+	index = allocation_trace_recorder_find(recorder, memory_block);
+	if (recorder->entries[index].memory_block == memory_block) {
+		fprintf(recorder->output, "f %lu\n", (unsigned long) recorder->entries[index].slot);
+		allocation_trace_recorder_remove(recorder, index);
+		recorder->allocator.deallocate(memory_block);
+	}
+}
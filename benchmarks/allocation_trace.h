@@ -0,0 +1,121 @@
+#ifndef ALLOCATION_TRACE_H
+#define ALLOCATION_TRACE_H
+
+#include "allocator_type.h"
+#include "macro_concatenate.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+An allocation trace is a sequence of allocation, reallocation and deallocation requests.
+Each request refers to a slot, which identifies a memory block from its allocation to its deallocation.
+
+Text format of a trace file, one request per line:
+a <slot> <number of bytes>   allocation
+r <slot> <number of bytes>   reallocation
+f <slot>                     deallocation
+Lines starting with # are comments.
+*/
+
+typedef enum allocation_trace_request_enum
+{
+	allocation_trace_request_allocate = 0,
+	allocation_trace_request_reallocate,
+	allocation_trace_request_deallocate
+} allocation_trace_request_enum;
+
+typedef struct allocation_trace_request_type
+{
+	allocation_trace_request_enum type;
+	uint32_t slot;
+	size_t number_of_bytes;
+} allocation_trace_request_type;
+
+typedef struct allocation_trace_type
+{
+	allocation_trace_request_type *requests;
+	size_t number_of_requests;
+	size_t capacity;
+	size_t number_of_slots;
+} allocation_trace_type;
+
+/* Initializes an empty trace. */
+void allocation_trace_init(allocation_trace_type *trace);
+
+/* Frees the memory of a trace. */
+void allocation_trace_deinit(allocation_trace_type *trace);
+
+/* Appends a request. Returns false if there is not enough memory. */
+bool allocation_trace_append(allocation_trace_type *trace, allocation_trace_request_enum type, uint32_t slot, size_t number_of_bytes);
+
+/*
+Reads the requests from a trace file and appends them to the trace.
+
+Return value: true if the file is read successfully, otherwise false. On failure, line_number is set to the line with an error.
+*/
+bool allocation_trace_read(allocation_trace_type *trace, FILE *input, size_t *line_number);
+
+/* Writes the requests of a trace in the text format. Returns false if an output error occurs. */
+bool allocation_trace_write(const allocation_trace_type *trace, FILE *output);
+
+/*
+An allocation trace recorder forwards requests to an allocator and writes them to a file in the text format,
+so that the allocation pattern of a real program can be replayed by allocator_benchmark.
+The recorder uses malloc for its own bookkeeping and is not thread-safe.
+*/
+typedef struct allocation_trace_recorder_entry_type
+{
+	void *memory_block;
+	size_t number_of_bytes;
+	uint32_t slot;
+} allocation_trace_recorder_entry_type;
+
+typedef struct allocation_trace_recorder_type
+{
+	allocator_type allocator;
+	FILE *output;
+	allocation_trace_recorder_entry_type *entries; /* hash table of the live memory blocks */
+	size_t capacity;
+	size_t number_of_live_blocks;
+	uint32_t next_slot;
+} allocation_trace_recorder_type;
+
+/* Initializes a recorder which forwards to the allocator and writes to the output. */
+void allocation_trace_recorder_init(allocation_trace_recorder_type *recorder, allocator_type allocator, FILE *output);
+
+/* Frees the bookkeeping memory of a recorder. It does not close the output. */
+void allocation_trace_recorder_deinit(allocation_trace_recorder_type *recorder);
+
+void *allocation_trace_recorder_allocate(allocation_trace_recorder_type *recorder, size_t number_of_bytes);
+void *allocation_trace_recorder_reallocate(allocation_trace_recorder_type *recorder, void *memory_block, size_t new_number_of_bytes);
+void allocation_trace_recorder_deallocate(allocation_trace_recorder_type *recorder, void *memory_block);
+
+/*
+Defines the functions for an allocator_type which forwards to a recorder with static storage duration.
+Generated functions: prefix_allocate, prefix_reallocate and prefix_deallocate.
+*/
+#define ALLOCATION_TRACE_RECORDER_DEFINE_ALLOCATOR(prefix, recorder) \
+	static void *CONCATENATE(prefix, _allocate)(size_t number_of_bytes) \
+	{ \
+		return allocation_trace_recorder_allocate(&(recorder), number_of_bytes); \
+	} \
+	static void *CONCATENATE(prefix, _reallocate)(void *memory_block, size_t number_of_bytes) \
+	{ \
+		return allocation_trace_recorder_reallocate(&(recorder), memory_block, number_of_bytes); \
+	} \
+	static void CONCATENATE(prefix, _deallocate)(void *memory_block) \
+	{ \
+		allocation_trace_recorder_deallocate(&(recorder), memory_block); \
+	}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
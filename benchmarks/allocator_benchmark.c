@@ -0,0 +1,676 @@
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* for fork, pipe and sysconf */
+#endif
+
+#include "allocation_trace.h"
+#include "allocation_tracker.h"
+#include "benchmark_timer.h"
+#include "block_pool.h"
+#include "dynamic_array.h"
+#include "numa_allocator.h"
+#include "scratch_allocator.h"
+#include "static_pool.h"
+
+#include <iso646.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ALLOCATOR_BENCHMARK_FORK 1
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#else
+#define ALLOCATOR_BENCHMARK_FORK 0
+#endif
+
+/*
+Replays allocation traces against allocators which implement allocator_type and reports
+- the throughput in millions of requests per second,
+- the tail latency of single requests, and
+- the resident set size (RSS) overhead at the peak of the requested memory, which includes fragmentation.
+
+Each pair of allocator and trace is replayed in a separate process where fork is available, so that the RSS of one
+replay does not affect the next one. Every allocated page is touched once, so that it counts towards the RSS.
+
+Usage:
+allocator_benchmark [--requests N] [trace files]
+	Replays the synthetic traces (N requests each, default 200000), or the trace files if any is given.
+allocator_benchmark --record FILE
+	Records the allocation trace of a dynamic_array workload to FILE. Any program can record a trace by using
+	allocation_trace_recorder_type as its allocator.
+
+To benchmark a custom allocator, add it to the list of allocators in get_benchmark_allocators.
+Allocators with a fixed capacity report the requests they cannot serve as failures. static_pool holds only one
+memory block at a time, so its results are only meaningful for traces with a single live block.
+The RSS is measured by the operating system in pages, so the overhead of traces with little memory is approximate.
+*/
+
+enum {
+	default_number_of_requests = 200000,
+	page_size_for_touching = 4096,
+	block_pool_benchmark_block_size = 256,
+	block_pool_benchmark_number_of_blocks = 65536
+};
+
+/* Allocators */
+
+typedef struct benchmark_allocator_type
+{
+	const char *name;
+	allocator_type allocator;
+	void (*setup)(void); /* can be null */
+} benchmark_allocator_type;
+
+static static_pool_type s_static_pool;
+static void *static_pool_benchmark_allocate(size_t number_of_bytes) { return static_pool_allocate(&s_static_pool, number_of_bytes); }
+static void *static_pool_benchmark_reallocate(void *memory_block, size_t number_of_bytes) { return static_pool_reallocate(&s_static_pool, memory_block, number_of_bytes); }
+static void static_pool_benchmark_deallocate(void *memory_block) { static_pool_deallocate(&s_static_pool, memory_block); }
+static void static_pool_benchmark_setup(void) { memset(&s_static_pool, 0, sizeof(s_static_pool)); }
+
+BLOCK_POOL_DEFINE_STORAGE(s_block_pool_storage, block_pool_benchmark_block_size, block_pool_benchmark_number_of_blocks);
+static block_pool_type s_block_pool;
+BLOCK_POOL_DEFINE_ALLOCATOR(block_pool_benchmark, s_block_pool)
+static void block_pool_benchmark_setup(void)
+{
+	(void) block_pool_init(&s_block_pool, s_block_pool_storage, sizeof(s_block_pool_storage), block_pool_benchmark_block_size);
+}
+
+static numa_allocator_type s_numa_allocator;
+NUMA_ALLOCATOR_DEFINE_ALLOCATOR(numa_benchmark, s_numa_allocator)
+static void numa_benchmark_setup(void) { numa_allocator_init(&s_numa_allocator, numa_allocator_policy_local, 0); }
+
+static allocation_tracker_type s_tracker;
+ALLOCATION_TRACKER_DEFINE_ALLOCATOR(tracked_benchmark, s_tracker)
+static void tracked_benchmark_setup(void)
+{
+	allocator_type system_allocator = {&malloc, &realloc, &free};
+	allocation_tracker_deinit(&s_tracker);
+	allocation_tracker_init(&s_tracker, system_allocator);
+}
+
+static size_t get_benchmark_allocators(const benchmark_allocator_type **allocators)
+{
+	static const benchmark_allocator_type list[] = {
+		/* the default allocator of dynamic_array */
+		{"malloc", {&malloc, &realloc, &free}, NULL},
+		{"static_pool", {&static_pool_benchmark_allocate, &static_pool_benchmark_reallocate, &static_pool_benchmark_deallocate}, &static_pool_benchmark_setup},
+		{"block_pool", {&block_pool_benchmark_allocate, &block_pool_benchmark_reallocate, &block_pool_benchmark_deallocate}, &block_pool_benchmark_setup},
+		{"scratch", {&scratch_allocator_allocate, &scratch_allocator_reallocate, &scratch_allocator_deallocate}, NULL},
+		{"numa (local)", {&numa_benchmark_allocate, &numa_benchmark_reallocate, &numa_benchmark_deallocate}, &numa_benchmark_setup},
+		{"tracked malloc", {&tracked_benchmark_allocate, &tracked_benchmark_reallocate, &tracked_benchmark_deallocate}, &tracked_benchmark_setup}
+	};
+	*allocators = list;
+	return sizeof(list) / sizeof(list[0]);
+}
+
+/* Synthetic traces */
+
+typedef struct random_generator_type
+{
+	uint64_t state;
+} random_generator_type;
+
+static uint64_t random_next(random_generator_type *generator)
+{
+	/* xorshift64* */
+	generator->state ^= generator->state >> 12U;
+	generator->state ^= generator->state << 25U;
+	generator->state ^= generator->state >> 27U;
+	return generator->state * UINT64_C(2685821657736338717);
+}
+
+static size_t random_below(random_generator_type *generator, size_t limit)
+{
+	return (limit > 0U) ? (size_t) (random_next(generator) % limit) : 0U;
+}
+
+/* a size between minimum and maximum, uniformly distributed on a logarithmic scale */
+static size_t random_log_uniform_size(random_generator_type *generator, size_t minimum, size_t maximum)
+{
+	size_t number_of_levels = 0U;
+	for (size_t size = minimum; size <= maximum / 2U; size *= 2U) {
+		++number_of_levels;
+	}
+	const size_t size = minimum << random_below(generator, number_of_levels + 1U);
+	const size_t result = size + random_below(generator, size);
+	return (result < maximum) ? result : maximum;
+}
+
+typedef struct slot_set_type
+{
+	uint32_t *live_slots;
+	size_t number_of_live_slots;
+	uint32_t *free_slots;
+	size_t number_of_free_slots;
+	uint32_t next_slot;
+} slot_set_type;
+
+static bool slot_set_init(slot_set_type *set, size_t maximum_number_of_live_slots)
+{
+	memset(set, 0, sizeof(*set));
+	set->live_slots = (uint32_t*) malloc(maximum_number_of_live_slots * sizeof(uint32_t));
+	set->free_slots = (uint32_t*) malloc(maximum_number_of_live_slots * sizeof(uint32_t));
+	return set->live_slots != NULL and set->free_slots != NULL;
+}
+
+static void slot_set_deinit(slot_set_type *set)
+{
+	free(set->live_slots);
+	free(set->free_slots);
+}
+
+static uint32_t slot_set_acquire(slot_set_type *set)
+{
+	const uint32_t slot = (set->number_of_free_slots > 0U) ? set->free_slots[--set->number_of_free_slots] : set->next_slot++;
+	set->live_slots[set->number_of_live_slots++] = slot;
+	return slot;
+}
+
+static uint32_t slot_set_release(slot_set_type *set, size_t index)
+{
+	const uint32_t slot = set->live_slots[index];
+	set->live_slots[index] = set->live_slots[--set->number_of_live_slots];
+	set->free_slots[set->number_of_free_slots++] = slot;
+	return slot;
+}
+
+static void free_all_slots(allocation_trace_type *trace, slot_set_type *set)
+{
+	while (set->number_of_live_slots > 0U) {
+		(void) allocation_trace_append(trace, allocation_trace_request_deallocate, slot_set_release(set, set->number_of_live_slots - 1U), 0U);
+	}
+}
+
+/* random small objects with random lifetimes, e.g. nodes of containers */
+static void generate_small_objects(allocation_trace_type *trace, size_t number_of_requests, random_generator_type *generator)
+{
+	enum { maximum_number_of_live_slots = 8192 };
+	slot_set_type set;
+	if (not slot_set_init(&set, maximum_number_of_live_slots)) {
+		return;
+	}
+	while (trace->number_of_requests < number_of_requests) {
+		if (set.number_of_live_slots == 0U or
+			(set.number_of_live_slots < maximum_number_of_live_slots and random_below(generator, 100U) < 55U)) {
+			(void) allocation_trace_append(trace, allocation_trace_request_allocate, slot_set_acquire(&set),
+				random_log_uniform_size(generator, 8U, 256U));
+		} else {
+			(void) allocation_trace_append(trace, allocation_trace_request_deallocate,
+				slot_set_release(&set, random_below(generator, set.number_of_live_slots)), 0U);
+		}
+	}
+	free_all_slots(trace, &set);
+	slot_set_deinit(&set);
+}
+
+/* sizes from 16 bytes to 1 MiB with random lifetimes */
+static void generate_mixed_sizes(allocation_trace_type *trace, size_t number_of_requests, random_generator_type *generator)
+{
+	enum { maximum_number_of_live_slots = 512 };
+	slot_set_type set;
+	if (not slot_set_init(&set, maximum_number_of_live_slots)) {
+		return;
+	}
+	while (trace->number_of_requests < number_of_requests) {
+		if (set.number_of_live_slots == 0U or
+			(set.number_of_live_slots < maximum_number_of_live_slots and random_below(generator, 100U) < 52U)) {
+			(void) allocation_trace_append(trace, allocation_trace_request_allocate, slot_set_acquire(&set),
+				random_log_uniform_size(generator, 16U, 1024U * 1024U));
+		} else {
+			(void) allocation_trace_append(trace, allocation_trace_request_deallocate,
+				slot_set_release(&set, random_below(generator, set.number_of_live_slots)), 0U);
+		}
+	}
+	free_all_slots(trace, &set);
+	slot_set_deinit(&set);
+}
+
+/* nested scopes which free their temporary buffers in reverse order */
+static void generate_lifo_scopes(allocation_trace_type *trace, size_t number_of_requests, random_generator_type *generator)
+{
+	enum { maximum_number_of_live_slots = 256 };
+	slot_set_type set;
+	if (not slot_set_init(&set, maximum_number_of_live_slots)) {
+		return;
+	}
+	while (trace->number_of_requests < number_of_requests) {
+		const size_t number_of_blocks = 1U + random_below(generator, 16U);
+		for (size_t i = 0U; i < number_of_blocks and set.number_of_live_slots < maximum_number_of_live_slots; ++i) {
+			(void) allocation_trace_append(trace, allocation_trace_request_allocate, slot_set_acquire(&set),
+				random_log_uniform_size(generator, 16U, 4096U));
+		}
+		const size_t number_of_blocks_to_free = random_below(generator, set.number_of_live_slots + 1U);
+		for (size_t i = 0U; i < number_of_blocks_to_free; ++i) {
+			(void) allocation_trace_append(trace, allocation_trace_request_deallocate,
+				slot_set_release(&set, set.number_of_live_slots - 1U), 0U);
+		}
+	}
+	free_all_slots(trace, &set);
+	slot_set_deinit(&set);
+}
+
+/* dynamic arrays which grow by doubling their capacity, interleaved with each other */
+static void generate_dynamic_array_growth(allocation_trace_type *trace, size_t number_of_requests, random_generator_type *generator)
+{
+	enum { number_of_arrays = 64 };
+	size_t capacities[number_of_arrays];
+	size_t final_capacities[number_of_arrays];
+	for (size_t i = 0U; i < number_of_arrays; ++i) {
+		capacities[i] = 0U;
+	}
+	while (trace->number_of_requests < number_of_requests) {
+		const size_t i = random_below(generator, number_of_arrays);
+		if (capacities[i] == 0U) {
+			capacities[i] = 16U;
+			final_capacities[i] = random_log_uniform_size(generator, 64U, 256U * 1024U);
+			(void) allocation_trace_append(trace, allocation_trace_request_allocate, (uint32_t) i, capacities[i]);
+		} else if (capacities[i] < final_capacities[i]) {
+			capacities[i] *= 2U;
+			(void) allocation_trace_append(trace, allocation_trace_request_reallocate, (uint32_t) i, capacities[i]);
+		} else {
+			capacities[i] = 0U;
+			(void) allocation_trace_append(trace, allocation_trace_request_deallocate, (uint32_t) i, 0U);
+		}
+	}
+	for (size_t i = 0U; i < number_of_arrays; ++i) {
+		if (capacities[i] > 0U) {
+			(void) allocation_trace_append(trace, allocation_trace_request_deallocate, (uint32_t) i, 0U);
+		}
+	}
+}
+
+/* long-lived blocks allocated first, followed by short-lived blocks which fill the holes between them */
+static void generate_long_lived_and_short_lived(allocation_trace_type *trace, size_t number_of_requests, random_generator_type *generator)
+{
+	enum { number_of_long_lived_blocks = 2048, maximum_number_of_short_lived_slots = 1024 };
+	slot_set_type set;
+	if (not slot_set_init(&set, maximum_number_of_short_lived_slots)) {
+		return;
+	}
+	set.next_slot = number_of_long_lived_blocks;
+	for (uint32_t slot = 0U; slot < number_of_long_lived_blocks; ++slot) {
+		(void) allocation_trace_append(trace, allocation_trace_request_allocate, slot, random_log_uniform_size(generator, 32U, 4096U));
+	}
+	while (trace->number_of_requests + number_of_long_lived_blocks < number_of_requests) {
+		if (set.number_of_live_slots == 0U or
+			(set.number_of_live_slots < maximum_number_of_short_lived_slots and random_below(generator, 2U) == 0U)) {
+			(void) allocation_trace_append(trace, allocation_trace_request_allocate, slot_set_acquire(&set),
+				random_log_uniform_size(generator, 16U, 16384U));
+		} else {
+			(void) allocation_trace_append(trace, allocation_trace_request_deallocate,
+				slot_set_release(&set, random_below(generator, set.number_of_live_slots)), 0U);
+		}
+	}
+	free_all_slots(trace, &set);
+	for (uint32_t slot = 0U; slot < number_of_long_lived_blocks; ++slot) {
+		(void) allocation_trace_append(trace, allocation_trace_request_deallocate, slot, 0U);
+	}
+	slot_set_deinit(&set);
+}
+
+/* Replay */
+
+typedef struct replay_slot_type
+{
+	void *memory_block;
+	size_t number_of_bytes;
+} replay_slot_type;
+
+typedef struct replay_result_type
+{
+	double seconds;
+	size_t number_of_failures;
+	double latency_nanoseconds[4]; /* 50th, 99th and 99.9th percentiles and maximum */
+	long long rss_increase; /* in bytes, or -1 if unknown */
+	bool has_crashed;
+} replay_result_type;
+
+static void touch_pages(void *memory_block, size_t first_byte, size_t number_of_bytes)
+{
+	volatile unsigned char *bytes = (volatile unsigned char*) memory_block;
+	for (size_t i = first_byte; i < number_of_bytes; i += page_size_for_touching) {
+		bytes[i] = 1U;
+	}
+	if (number_of_bytes > first_byte) {
+		bytes[number_of_bytes - 1U] = 1U;
+	}
+}
+
+static bool replay_request(allocator_type allocator, replay_slot_type *slots, const allocation_trace_request_type *request)
+{
+	replay_slot_type *slot = &slots[request->slot];
+	void *memory_block = NULL;
+
+	switch (request->type) {
+	case allocation_trace_request_allocate:
+		if (slot->memory_block != NULL) {
+			allocator.deallocate(slot->memory_block);
+			slot->memory_block = NULL;
+		}
+		memory_block = allocator.allocate(request->number_of_bytes);
+		if (memory_block == NULL) {
+			return false;
+		}
+		touch_pages(memory_block, 0U, request->number_of_bytes);
+		break;
+	case allocation_trace_request_reallocate:
+		if (slot->memory_block == NULL) {
+			memory_block = allocator.allocate(request->number_of_bytes);
+		} else {
+			memory_block = allocator_reallocate(allocator, slot->memory_block, slot->number_of_bytes, request->number_of_bytes);
+		}
+		if (memory_block == NULL) {
+			return false;
+		}
+		touch_pages(memory_block, (slot->memory_block != NULL) ? slot->number_of_bytes : 0U, request->number_of_bytes);
+		break;
+	default:
+		if (slot->memory_block != NULL) {
+			allocator.deallocate(slot->memory_block);
+		}
+		break;
+	}
+
+	slot->memory_block = memory_block;
+	slot->number_of_bytes = request->number_of_bytes;
+	return true;
+}
+
+static void free_remaining_blocks(allocator_type allocator, replay_slot_type *slots, size_t number_of_slots)
+{
+	for (size_t i = 0U; i < number_of_slots; ++i) {
+		if (slots[i].memory_block != NULL) {
+			allocator.deallocate(slots[i].memory_block);
+			slots[i].memory_block = NULL;
+		}
+	}
+}
+
+static long long get_resident_set_size(void)
+{
+#if defined(__linux__)
+	long long size = -1, resident = -1;
+	FILE *file = fopen("/proc/self/statm", "r");
+	if (file != NULL) {
+		if (fscanf(file, "%lld %lld", &size, &resident) != 2) {
+			resident = -1;
+		}
+		fclose(file);
+	}
+	return (resident >= 0) ? resident * (long long) sysconf(_SC_PAGESIZE) : -1;
+#else
+	return -1;
+#endif
+}
+
+/* finds the request after which the requested memory is at its peak */
+static size_t find_peak(const allocation_trace_type *trace, size_t *peak_number_of_bytes)
+{
+	size_t *sizes = (size_t*) calloc(trace->number_of_slots + 1U, sizeof(size_t));
+	size_t current_number_of_bytes = 0U, peak_index = 0U;
+
+	*peak_number_of_bytes = 0U;
+	if (sizes == NULL) {
+		return 0U;
+	}
+	for (size_t i = 0U; i < trace->number_of_requests; ++i) {
+		const allocation_trace_request_type *request = &trace->requests[i];
+		current_number_of_bytes -= sizes[request->slot];
+		sizes[request->slot] = (request->type == allocation_trace_request_deallocate) ? 0U : request->number_of_bytes;
+		current_number_of_bytes += sizes[request->slot];
+		if (current_number_of_bytes > *peak_number_of_bytes) {
+			*peak_number_of_bytes = current_number_of_bytes;
+			peak_index = i;
+		}
+	}
+	free(sizes);
+	return peak_index;
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+	const double x = *(const double*) a, y = *(const double*) b;
+	return (x > y) - (x < y);
+}
+
+static replay_result_type replay(const benchmark_allocator_type *benchmark_allocator, const allocation_trace_type *trace, size_t peak_index)
+{
+	replay_result_type result = {0.0, 0U, {0.0, 0.0, 0.0, 0.0}, -1, false};
+	const allocator_type allocator = benchmark_allocator->allocator;
+	replay_slot_type *slots = (replay_slot_type*) calloc(trace->number_of_slots + 1U, sizeof(replay_slot_type));
+	double *latencies = (double*) malloc((trace->number_of_requests + 1U) * sizeof(double));
+
+	if (slots == NULL or latencies == NULL) {
+		free(slots);
+		free(latencies);
+		result.number_of_failures = trace->number_of_requests;
+		return result;
+	}
+
+	/* throughput and RSS */
+	if (benchmark_allocator->setup != NULL) {
+		benchmark_allocator->setup();
+	}
+	const long long baseline_rss = get_resident_set_size();
+	const double start = benchmark_seconds();
+	for (size_t i = 0U; i < trace->number_of_requests; ++i) {
+		if (not replay_request(allocator, slots, &trace->requests[i])) {
+			++result.number_of_failures;
+		}
+		if (i == peak_index and baseline_rss >= 0) {
+			const long long peak_rss = get_resident_set_size();
+			result.rss_increase = (peak_rss >= 0) ? (peak_rss - baseline_rss) : -1;
+		}
+	}
+	result.seconds = benchmark_seconds() - start;
+	free_remaining_blocks(allocator, slots, trace->number_of_slots);
+
+	/* latency of single requests */
+	if (benchmark_allocator->setup != NULL) {
+		benchmark_allocator->setup();
+	}
+	for (size_t i = 0U; i < trace->number_of_requests; ++i) {
+		const double request_start = benchmark_seconds();
+		(void) replay_request(allocator, slots, &trace->requests[i]);
+		latencies[i] = (benchmark_seconds() - request_start) * 1e9;
+	}
+	free_remaining_blocks(allocator, slots, trace->number_of_slots);
+
+	if (trace->number_of_requests > 0U) {
+		const size_t n = trace->number_of_requests;
+		qsort(latencies, n, sizeof(double), &compare_doubles);
+		result.latency_nanoseconds[0] = latencies[n / 2U];
+		result.latency_nanoseconds[1] = latencies[(size_t) ((double) n * 0.99)];
+		result.latency_nanoseconds[2] = latencies[(size_t) ((double) n * 0.999)];
+		result.latency_nanoseconds[3] = latencies[n - 1U];
+	}
+
+	free(slots);
+	free(latencies);
+	return result;
+}
+
+static replay_result_type replay_in_separate_process(const benchmark_allocator_type *benchmark_allocator,
+	const allocation_trace_type *trace, size_t peak_index)
+{
+#if ALLOCATOR_BENCHMARK_FORK
+	replay_result_type result = {0.0, trace->number_of_requests, {0.0, 0.0, 0.0, 0.0}, -1, true};
+	int pipe_descriptors[2];
+	if (pipe(pipe_descriptors) != 0) {
+		return replay(benchmark_allocator, trace, peak_index);
+	}
+
+	fflush(stdout);
+	const pid_t pid = fork();
+	if (pid < 0) {
+		close(pipe_descriptors[0]);
+		close(pipe_descriptors[1]);
+		return replay(benchmark_allocator, trace, peak_index);
+	}
+
+	if (pid == 0) {
+		close(pipe_descriptors[0]);
+		result = replay(benchmark_allocator, trace, peak_index);
+		const ssize_t number_of_bytes_written = write(pipe_descriptors[1], &result, sizeof(result));
+		close(pipe_descriptors[1]);
+		_exit(number_of_bytes_written == (ssize_t) sizeof(result) ? 0 : 1);
+	}
+
+	close(pipe_descriptors[1]);
+	if (read(pipe_descriptors[0], &result, sizeof(result)) != (ssize_t) sizeof(result)) {
+		result.has_crashed = true; /* e.g. an assertion has failed */
+	}
+	close(pipe_descriptors[0]);
+	(void) waitpid(pid, NULL, 0);
+	return result;
+#else
+	return replay(benchmark_allocator, trace, peak_index);
+#endif
+}
+
+static void run_benchmarks(const char *trace_name, const allocation_trace_type *trace)
+{
+	const benchmark_allocator_type *allocators = NULL;
+	const size_t number_of_allocators = get_benchmark_allocators(&allocators);
+	size_t peak_number_of_bytes = 0U;
+	const size_t peak_index = find_peak(trace, &peak_number_of_bytes);
+
+	printf("\nTrace: %s (%lu requests, %lu slots, peak %.2f MiB requested)\n", trace_name,
+		(unsigned long) trace->number_of_requests, (unsigned long) trace->number_of_slots,
+		(double) peak_number_of_bytes / (1024.0 * 1024.0));
+	printf("%-15s %9s %9s %9s %9s %11s %9s %13s\n",
+		"Allocator", "Mreq/s", "p50 ns", "p99 ns", "p99.9 ns", "max ns", "Failures", "RSS overhead");
+	for (size_t i = 0U; i < number_of_allocators; ++i) {
+		const replay_result_type result = replay_in_separate_process(&allocators[i], trace, peak_index);
+		if (result.has_crashed) {
+			printf("%-15s crashed\n", allocators[i].name);
+			continue;
+		}
+		const double throughput = (result.seconds > 0.0) ? ((double) trace->number_of_requests / result.seconds / 1e6) : 0.0;
+		printf("%-15s %9.2f %9.0f %9.0f %9.0f %11.0f %9lu", allocators[i].name, throughput,
+			result.latency_nanoseconds[0], result.latency_nanoseconds[1], result.latency_nanoseconds[2],
+			result.latency_nanoseconds[3], (unsigned long) result.number_of_failures);
+		if (result.rss_increase >= 0 and peak_number_of_bytes > 0U) {
+			printf(" %12.1f%%\n", 100.0 * ((double) result.rss_increase - (double) peak_number_of_bytes) / (double) peak_number_of_bytes);
+		} else {
+			printf(" %13s\n", "n/a");
+		}
+	}
+}
+
+/* Recording */
+
+static allocation_trace_recorder_type s_recorder;
+ALLOCATION_TRACE_RECORDER_DEFINE_ALLOCATOR(recorded, s_recorder)
+
+static int record_dynamic_array_workload(const char *file_name)
+{
+	enum { number_of_arrays = 32, number_of_rounds = 200 };
+	allocator_type system_allocator = {&malloc, &realloc, &free};
+	allocator_type recorded_allocator = {&recorded_allocate, &recorded_reallocate, &recorded_deallocate};
+	dynamic_array_type(double) arrays[number_of_arrays];
+	random_generator_type generator = {UINT64_C(0x853C49E6748FEA9B)};
+	FILE *output = fopen(file_name, "w");
+
+	if (output == NULL) {
+		fprintf(stderr, "Cannot open %s\n", file_name);
+		return 1;
+	}
+
+	fprintf(output, "# dynamic_array workload recorded by allocator_benchmark\n");
+	allocation_trace_recorder_init(&s_recorder, system_allocator, output);
+	for (size_t i = 0U; i < number_of_arrays; ++i) {
+		arrays[i] = dynamic_array_create_with_allocator(double, 0U, recorded_allocator);
+	}
+	for (size_t round = 0U; round < number_of_rounds; ++round) {
+		const size_t i = random_below(&generator, number_of_arrays);
+		const size_t number_of_elements = random_log_uniform_size(&generator, 1U, 4096U);
+		for (size_t j = 0U; j < number_of_elements; ++j) {
+			dynamic_array_push_back(double, arrays[i], (double) j);
+		}
+		if (random_below(&generator, 4U) == 0U) {
+			dynamic_array_delete(arrays[i]);
+			arrays[i] = dynamic_array_create_with_allocator(double, 0U, recorded_allocator);
+		}
+	}
+	for (size_t i = 0U; i < number_of_arrays; ++i) {
+		dynamic_array_delete(arrays[i]);
+	}
+	allocation_trace_recorder_deinit(&s_recorder);
+
+	const bool is_written = not ferror(output);
+	fclose(output);
+	printf("Recorded %u memory blocks to %s\n", (unsigned) s_recorder.next_slot, file_name);
+	return is_written ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+	size_t number_of_requests = default_number_of_requests;
+	int first_file_index = argc;
+
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--record") == 0 and i + 1 < argc) {
+			return record_dynamic_array_workload(argv[i + 1]);
+		} else if (strcmp(argv[i], "--requests") == 0 and i + 1 < argc) {
+			number_of_requests = (size_t) strtoul(argv[++i], NULL, 10);
+		} else if (argv[i][0] == '-') {
+			printf("Usage: %s [--requests N] [trace files]\n", argv[0]);
+			printf("       %s --record FILE\n", argv[0]);
+			return 0;
+		} else {
+			first_file_index = i;
+			break;
+		}
+	}
+
+	printf("Latencies include the time to touch every page of the memory block once.\n");
+	printf("RSS overhead is the increase of the resident set size at the peak of the requested memory relative to the peak.\n");
+
+	if (first_file_index < argc) {
+		for (int i = first_file_index; i < argc; ++i) {
+			allocation_trace_type trace;
+			size_t line_number = 0U;
+			FILE *input = fopen(argv[i], "r");
+			if (input == NULL) {
+				fprintf(stderr, "Cannot open %s\n", argv[i]);
+				continue;
+			}
+			allocation_trace_init(&trace);
+			if (allocation_trace_read(&trace, input, &line_number)) {
+				run_benchmarks(argv[i], &trace);
+			} else {
+				fprintf(stderr, "%s: invalid request at line %lu\n", argv[i], (unsigned long) line_number);
+			}
+			allocation_trace_deinit(&trace);
+			fclose(input);
+		}
+		return 0;
+	}
+
+	const struct {
+		const char *name;
+		void (*generate)(allocation_trace_type*, size_t, random_generator_type*);
+	} synthetic_traces[] = {
+		{"small objects, random lifetimes", &generate_small_objects},
+		{"16 B to 1 MiB, random lifetimes", &generate_mixed_sizes},
+		{"LIFO scopes", &generate_lifo_scopes},
+		{"dynamic_array growth (realloc)", &generate_dynamic_array_growth},
+		{"long-lived and short-lived", &generate_long_lived_and_short_lived}
+	};
+	for (size_t i = 0U; i < sizeof(synthetic_traces) / sizeof(synthetic_traces[0]); ++i) {
+		allocation_trace_type trace;
+		random_generator_type generator = {UINT64_C(0x9E3779B97F4A7C15) + i};
+		allocation_trace_init(&trace);
+		synthetic_traces[i].generate(&trace, number_of_requests, &generator);
+		run_benchmarks(synthetic_traces[i].name, &trace);
+		allocation_trace_deinit(&trace);
+	}
+
+	return 0;
+}
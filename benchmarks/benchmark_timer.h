@@ -0,0 +1,43 @@
+#ifndef BENCHMARK_TIMER_H
+#define BENCHMARK_TIMER_H
+
+/*
+benchmark_seconds returns a monotonic time in seconds with the best resolution available on the platform.
+Only differences between two values are meaningful.
+*/
+
+#if defined(_WIN32)
+
+#include <windows.h>
+
+static double benchmark_seconds(void)
+{
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double) counter.QuadPart / (double) frequency.QuadPart;
+}
+
+#elif defined(__unix__) || defined(__APPLE__)
+
+#include <time.h>
+
+static double benchmark_seconds(void)
+{
+	struct timespec time_value;
+	clock_gettime(CLOCK_MONOTONIC, &time_value);
+	return (double) time_value.tv_sec + (double) time_value.tv_nsec * 1e-9;
+}
+
+#else
+
+#include <time.h>
+
+static double benchmark_seconds(void)
+{
+	return (double) clock() / (double) CLOCKS_PER_SEC;
+}
+
+#endif
+
+#endif
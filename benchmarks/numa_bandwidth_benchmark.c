@@ -0,0 +1,181 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* for sched_setaffinity */
+#endif
+
+#include "benchmark_timer.h"
+#include "numa_allocator.h"
+
+#include <iso646.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+/*
+Measures the memory bandwidth between the CPUs of each NUMA node and the memory of each NUMA node.
+The calling thread is pinned to the CPUs of one node at a time, and a buffer is placed on each node by a NUMA allocator.
+Then the bandwidth of the default, local and interleave policies is compared when the buffer is written by one node.
+
+Usage: numa_bandwidth_benchmark [number of megabytes per buffer]
+*/
+
+enum {
+	default_number_of_megabytes = 256,
+	number_of_repetitions = 5
+};
+
+typedef struct bandwidth_type
+{
+	double write_gigabytes_per_second;
+	double read_gigabytes_per_second;
+} bandwidth_type;
+
+static volatile uint64_t s_sink;
+
+static bool pin_thread_to_node(int node)
+{
+#if defined(__linux__)
+	char path[64];
+	char cpu_list[4096];
+	cpu_set_t cpu_set;
+	FILE *file = NULL;
+	const char *p = cpu_list;
+	bool has_cpu = false;
+
+	snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+	file = fopen(path, "r");
+	if (file == NULL) {
+		return node == 0;
+	}
+	if (fgets(cpu_list, (int) sizeof(cpu_list), file) == NULL) {
+		cpu_list[0] = '\0';
+	}
+	fclose(file);
+
+	/* the format of the list is e.g. "0-3,8-11" */
+	CPU_ZERO(&cpu_set);
+	while (*p != '\0' and *p != '\n') {
+		char *end = NULL;
+		long first = strtol(p, &end, 10);
+		long last = first;
+		if (end == p) {
+			break;
+		}
+		if (*end == '-') {
+			p = end + 1;
+			last = strtol(p, &end, 10);
+		}
+		for (; first <= last and first < CPU_SETSIZE; ++first) {
+			CPU_SET((size_t) first, &cpu_set);
+			has_cpu = true;
+		}
+		p = (*end == ',') ? end + 1 : end;
+	}
+
+	return has_cpu and sched_setaffinity(0, sizeof(cpu_set), &cpu_set) == 0;
+#else
+	return node == 0;
+#endif
+}
+
+static bandwidth_type measure_bandwidth(uint64_t *buffer, size_t number_of_words)
+{
+	const double gigabytes = (double) (number_of_words * sizeof(uint64_t)) / 1e9;
+	bandwidth_type bandwidth = {0.0, 0.0};
+	double best_write_seconds = 1e30;
+	double best_read_seconds = 1e30;
+
+	for (int repetition = 0; repetition < number_of_repetitions; ++repetition) {
+		double start = benchmark_seconds();
+		memset(buffer, repetition, number_of_words * sizeof(uint64_t));
+		double seconds = benchmark_seconds() - start;
+		if (seconds < best_write_seconds) {
+			best_write_seconds = seconds;
+		}
+
+		uint64_t sum = 0U;
+		start = benchmark_seconds();
+		for (size_t i = 0U; i < number_of_words; ++i) {
+			sum += buffer[i];
+		}
+		seconds = benchmark_seconds() - start;
+		s_sink += sum;
+		if (seconds < best_read_seconds) {
+			best_read_seconds = seconds;
+		}
+	}
+
+	bandwidth.write_gigabytes_per_second = (best_write_seconds > 0.0) ? gigabytes / best_write_seconds : 0.0;
+	bandwidth.read_gigabytes_per_second = (best_read_seconds > 0.0) ? gigabytes / best_read_seconds : 0.0;
+	return bandwidth;
+}
+
+static bool measure_policy(numa_allocator_policy_type policy, int node, size_t number_of_bytes, bandwidth_type *bandwidth)
+{
+	numa_allocator_type numa_allocator;
+	numa_allocator_init(&numa_allocator, policy, node);
+	uint64_t *buffer = (uint64_t*) numa_allocator_allocate(&numa_allocator, number_of_bytes);
+	if (buffer == NULL) {
+		return false;
+	}
+	*bandwidth = measure_bandwidth(buffer, number_of_bytes / sizeof(uint64_t));
+	numa_allocator_deallocate(&numa_allocator, buffer);
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	const long number_of_megabytes = (argc > 1) ? strtol(argv[1], NULL, 10) : default_number_of_megabytes;
+	if (number_of_megabytes <= 0) {
+		printf("Usage: %s [number of megabytes per buffer]\n", argv[0]);
+		return 0;
+	}
+
+	const size_t number_of_bytes = (size_t) number_of_megabytes * 1024U * 1024U;
+	const int highest_node = numa_allocator_highest_node();
+	printf("Number of NUMA nodes: %d\n", numa_allocator_number_of_nodes());
+	printf("Buffer size: %ld MiB, best of %d repetitions\n", number_of_megabytes, number_of_repetitions);
+	if (not numa_allocator_is_available()) {
+		printf("NUMA placement is not available. Only the bandwidth of the local node is measured.\n");
+	}
+
+	printf("\nCPU node  Memory node  Write (GB/s)  Read (GB/s)\n");
+	for (int cpu_node = 0; cpu_node <= highest_node; ++cpu_node) {
+		if (not pin_thread_to_node(cpu_node)) {
+			continue;
+		}
+		for (int memory_node = 0; memory_node <= highest_node; ++memory_node) {
+			bandwidth_type bandwidth;
+			if (measure_policy(numa_allocator_policy_node, memory_node, number_of_bytes, &bandwidth)) {
+				printf("%8d  %11d  %12.2f  %11.2f\n", cpu_node, memory_node,
+					bandwidth.write_gigabytes_per_second, bandwidth.read_gigabytes_per_second);
+			}
+		}
+	}
+
+	const struct {
+		numa_allocator_policy_type policy;
+		const char *name;
+	} policies[] = {
+		{numa_allocator_policy_default, "default (first touch)"},
+		{numa_allocator_policy_local, "local"},
+		{numa_allocator_policy_interleave, "interleave"}
+	};
+	(void) pin_thread_to_node(0);
+	printf("\nPolicy                 Write (GB/s)  Read (GB/s)\n");
+	for (size_t i = 0U; i < sizeof(policies) / sizeof(policies[0]); ++i) {
+		bandwidth_type bandwidth;
+		if (measure_policy(policies[i].policy, 0, number_of_bytes, &bandwidth)) {
+			printf("%-21s  %12.2f  %11.2f\n", policies[i].name,
+				bandwidth.write_gigabytes_per_second, bandwidth.read_gigabytes_per_second);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,330 @@
+#include "benchmark_timer.h"
+#include "simple_tokenizer.h"
+
+#include <ctype.h>
+#include <iso646.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+Compares simple_tokenizer_tokenize, which classifies bytes with a 256-entry table and consumes runs in an inner loop,
+with the previous implementation, which classified each byte with a chain of comparisons and ispunct and extended
+runs one byte at a time through a state switch. The inputs are generated corpora of different kinds, since each
+kind takes other paths through the tokenizer: ASCII source code, log lines which are mostly aligned with spaces,
+text which is mostly UTF-8 characters, and random bytes, which are mostly invalid UTF-8 and single-byte tokens.
+The throughput is in megabytes and millions of tokens per second for each corpus. The two implementations must
+find the same number of tokens, so the benchmark also catches a change of the tokens.
+
+Usage: simple_tokenizer_benchmark [number of megabytes per corpus]
+*/
+
+enum {
+	default_number_of_megabytes = 32,
+	number_of_repetitions = 5
+};
+
+typedef enum reference_byte_class_enum {
+	reference_letter,
+	reference_digit,
+	reference_punctuation,
+	reference_space,
+	reference_newline,
+	reference_zero,
+	reference_control,
+	reference_extended_ascii,
+	reference_utf8
+} reference_byte_class_enum;
+
+static reference_byte_class_enum reference_classify(unsigned char byte, size_t *number_of_utf8_bytes)
+{
+	*number_of_utf8_bytes = 1U;
+	if ((byte >= 'A' and byte <= 'Z') or (byte >= 'a' and byte <= 'z')) {
+		return reference_letter;
+	} else if (byte >= '0' and byte <= '9') {
+		return reference_digit;
+	} else if (byte == ' ' or byte == '\t') {
+		return reference_space;
+	} else if (byte == '\r' or byte == '\n') {
+		return reference_newline;
+	} else if (byte == '\0') {
+		return reference_zero;
+	} else if (ispunct(byte) and byte < 128U) {
+		return reference_punctuation;
+	} else if (byte < 128U) {
+		return reference_control;
+	} else if ((byte & 0xE0U) == 0xC0U) {
+		*number_of_utf8_bytes = 2U;
+	} else if ((byte & 0xF0U) == 0xE0U) {
+		*number_of_utf8_bytes = 3U;
+	} else if ((byte & 0xF8U) == 0xF0U) {
+		*number_of_utf8_bytes = 4U;
+	} else {
+		return reference_extended_ascii;
+	}
+	return reference_utf8;
+}
+
+/* The previous implementation: every byte goes through the classification and the state switch. */
+static size_t reference_tokenize(const char *string, size_t length)
+{
+	size_t number_of_tokens = 0U;
+	bool has_token = false;
+	reference_byte_class_enum token_class = reference_letter;
+	size_t token_length = 0U;
+	const char *first_char = NULL;
+
+	for (size_t index = 0U; index < length; ++index) {
+		size_t number_of_utf8_bytes = 1U;
+		reference_byte_class_enum byte_class = reference_classify((unsigned char) string[index], &number_of_utf8_bytes);
+		if (byte_class == reference_utf8) {
+			bool is_valid = false;
+			if (index + number_of_utf8_bytes <= length) {
+				const simple_tokenizer_utf8_char_type utf8_char = simple_tokenizer_stringref_to_utf8_char(
+					string_to_const_stringref(&string[index], number_of_utf8_bytes));
+				is_valid = (utf8_char.error == simple_tokenizer_utf8_char_error_none);
+			}
+			if (not is_valid) {
+				byte_class = reference_extended_ascii;
+				number_of_utf8_bytes = 1U;
+			}
+		}
+
+		bool add_token = false;
+		if (not has_token) {
+			has_token = true;
+		} else {
+			switch (token_class) {
+			case reference_letter:
+			case reference_digit:
+			case reference_space:
+			case reference_zero:
+				if (byte_class == token_class) {
+					++token_length;
+					continue;
+				}
+				add_token = true;
+				break;
+			case reference_newline:
+				if (byte_class == token_class and token_length == 1U and *first_char == '\r' and string[index] == '\n') {
+					++token_length;
+					continue;
+				}
+				add_token = true;
+				break;
+			default:
+				add_token = true;
+				break;
+			}
+		}
+		if (add_token) {
+			++number_of_tokens;
+		}
+		token_class = byte_class;
+		token_length = number_of_utf8_bytes;
+		first_char = &string[index];
+		index += number_of_utf8_bytes - 1U;
+	}
+	return number_of_tokens + (has_token ? 1U : 0U);
+}
+
+static size_t table_tokenize(const char *string, size_t length)
+{
+	return simple_tokenizer_tokenize(string, length, NULL, 0U);
+}
+
+typedef size_t (*tokenize_function_type)(const char*, size_t);
+
+/* called through volatile pointers, so that no function can be inlined into the measurement loop */
+static tokenize_function_type volatile s_tokenize_functions[2] = {&reference_tokenize, &table_tokenize};
+
+static double measure(size_t function_index, const char *text, size_t length, size_t *number_of_tokens)
+{
+	const tokenize_function_type tokenize_function = s_tokenize_functions[function_index];
+	double best_seconds = 1e30;
+	for (int repetition = 0; repetition < number_of_repetitions; ++repetition) {
+		const double start = benchmark_seconds();
+		*number_of_tokens = tokenize_function(text, length);
+		const double seconds = benchmark_seconds() - start;
+		if (seconds < best_seconds) {
+			best_seconds = seconds;
+		}
+	}
+	return best_seconds;
+}
+
+static uint64_t next_random_number(uint64_t *state)
+{
+	*state ^= *state << 13U;
+	*state ^= *state >> 7U;
+	*state ^= *state << 17U;
+	return *state;
+}
+
+/* Copies a piece into a text, up to its length. Returns the new position. */
+static size_t append_piece(char *text, size_t length, size_t position, const char *piece)
+{
+	for (; *piece != '\0' and position < length; ++piece) {
+		text[position++] = *piece;
+	}
+	return position;
+}
+
+/* Generates lines of C-like source code with identifiers, numbers, operators and indentation. */
+static void generate_source_code(char *text, size_t length)
+{
+	static const char *const words[] = {
+		"index", "length", "number_of_tokens", "string", "if", "for", "return", "const", "size_t", "char",
+		"result", "value", "x", "y", "buffer", "while", "static", "unsigned", "count", "token_type"
+	};
+	static const char *const operators[] = {" = ", " + ", " < ", "(", ")", ", ", "; ", "[", "]", " == ", "->", "."};
+	uint64_t state = 0x9E3779B97F4A7C15ULL;
+	size_t position = 0U;
+	size_t line_length = 0U;
+
+	while (position < length) {
+		const uint64_t random_number = next_random_number(&state);
+		const char *piece = NULL;
+		char number[24];
+		switch (random_number % 8U) {
+		case 0U:
+			snprintf(number, sizeof(number), "%lu", (unsigned long) (random_number >> 40U) % 100000UL);
+			piece = number;
+			break;
+		case 1U:
+		case 2U:
+			piece = operators[(random_number >> 8U) % (sizeof(operators) / sizeof(operators[0]))];
+			break;
+		default:
+			piece = words[(random_number >> 8U) % (sizeof(words) / sizeof(words[0]))];
+			break;
+		}
+		if (line_length > 60U) {
+			piece = ((random_number >> 20U) % 2U == 0U) ? "\n\t" : "\n\t\t";
+			line_length = 0U;
+		}
+		const size_t new_position = append_piece(text, length, position, piece);
+		line_length += new_position - position;
+		position = new_position;
+	}
+}
+
+/*
+Generates log lines whose fields are aligned in columns with runs of spaces, with blank lines and CRLF line ends,
+so most of the bytes are spaces.
+*/
+static void generate_log_lines(char *text, size_t length)
+{
+	static const char *const levels[] = {"INFO", "WARN", "DEBUG", "ERROR"};
+	static const char *const messages[] = {"request done", "cache miss", "retrying", "connection closed", "ok"};
+	uint64_t state = 0x2545F4914F6CDD1DULL;
+	size_t position = 0U;
+
+	while (position < length) {
+		const uint64_t random_number = next_random_number(&state);
+		char line[256];
+		const int column = 24 + (int) ((random_number >> 8U) % 40U);
+		snprintf(line, sizeof(line), "2026-10-19 %02u:%02u:%02u.%03u      %-8s%*s%-*s%8lu ms%s",
+			(unsigned int) (random_number % 24U), (unsigned int) ((random_number >> 5U) % 60U),
+			(unsigned int) ((random_number >> 11U) % 60U), (unsigned int) ((random_number >> 17U) % 1000U),
+			levels[(random_number >> 27U) % (sizeof(levels) / sizeof(levels[0]))], column, "",
+			column, messages[(random_number >> 29U) % (sizeof(messages) / sizeof(messages[0]))],
+			(unsigned long) ((random_number >> 33U) % 10000U),
+			((random_number >> 45U) % 4U == 0U) ? "\r\n\r\n" : "\n");
+		position = append_piece(text, length, position, line);
+	}
+}
+
+/* Generates text of words which are mostly accented Latin, Cyrillic, CJK and emoji characters. */
+static void generate_utf8_text(char *text, size_t length)
+{
+	static const char *const words[] = {
+		"Stra\xC3\x9F" "e", "caf\xC3\xA9", "\xC3\xA0", "\xD0\xB4\xD0\xB0", "\xD1\x81\xD0\xBB\xD0\xBE\xD0\xB2\xD0\xBE",
+		"\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E", "\xE4\xB8\xAD\xE6\x96\x87", "\xED\x95\x9C\xEA\xB5\xAD\xEC\x96\xB4",
+		"\xF0\x9F\x98\x80", "\xF0\x9F\x9A\x80\xF0\x9F\x8C\x8D", "\xE3\x80\x82", "\xEF\xBC\x8C"
+	};
+	uint64_t state = 0x3C6EF372FE94F82BULL;
+	size_t position = 0U;
+
+	while (position < length) {
+		const uint64_t random_number = next_random_number(&state);
+		position = append_piece(text, length, position, words[random_number % (sizeof(words) / sizeof(words[0]))]);
+		if ((random_number >> 8U) % 3U == 0U) {
+			position = append_piece(text, length, position, ((random_number >> 12U) % 16U == 0U) ? ".\n" : " ");
+		}
+	}
+}
+
+/* Generates random bytes, which include zeros, control characters and mostly invalid UTF-8. */
+static void generate_binary_garbage(char *text, size_t length)
+{
+	uint64_t state = 0xA54FF53A5F1D36F1ULL;
+	size_t position = 0U;
+
+	while (position < length) {
+		uint64_t random_number = next_random_number(&state);
+		for (int i = 0; i < 8 and position < length; ++i) {
+			text[position++] = (char) (random_number & 0xFFU);
+			random_number >>= 8U;
+		}
+	}
+}
+
+typedef struct corpus_type
+{
+	const char *name;
+	void (*generate)(char*, size_t);
+} corpus_type;
+
+static const corpus_type corpora[] = {
+	{"source code", &generate_source_code},
+	{"log lines", &generate_log_lines},
+	{"UTF-8 text", &generate_utf8_text},
+	{"binary garbage", &generate_binary_garbage}
+};
+
+int main(int argc, char **argv)
+{
+	const long number_of_megabytes = (argc > 1) ? strtol(argv[1], NULL, 10) : default_number_of_megabytes;
+	if (number_of_megabytes <= 0) {
+		printf("Usage: %s [number of megabytes per corpus]\n", argv[0]);
+		return 0;
+	}
+
+	const size_t length = (size_t) number_of_megabytes * 1024U * 1024U;
+	char *text = (char*) malloc(length);
+	if (text == NULL) {
+		printf("Not enough memory for %ld MiB.\n", number_of_megabytes);
+		return 1;
+	}
+
+	printf("%ld MiB per corpus, best of %d repetitions\n\n", number_of_megabytes, number_of_repetitions);
+	printf("%-15s %12s %26s %26s\n", "", "", "branches (previous)", "256-entry table");
+	printf("%-15s %12s %12s %13s %12s %13s\n", "Corpus", "Tokens", "MB/s", "Mtokens/s", "MB/s", "Mtokens/s");
+
+	int exit_code = 0;
+	for (size_t corpus_index = 0U; corpus_index < sizeof(corpora) / sizeof(corpora[0]); ++corpus_index) {
+		corpora[corpus_index].generate(text, length);
+
+		size_t reference_number_of_tokens = 0U;
+		size_t number_of_tokens = 0U;
+		const double reference_seconds = measure(0U, text, length, &reference_number_of_tokens);
+		const double seconds = measure(1U, text, length, &number_of_tokens);
+		if (reference_number_of_tokens != number_of_tokens) {
+			printf("The implementations disagree on the %s: %lu and %lu tokens.\n", corpora[corpus_index].name,
+				(unsigned long) reference_number_of_tokens, (unsigned long) number_of_tokens);
+			exit_code = 1;
+			continue;
+		}
+		printf("%-15s %12lu %12.1f %13.1f %12.1f %13.1f\n", corpora[corpus_index].name,
+			(unsigned long) number_of_tokens,
+			(double) length / reference_seconds / 1e6, (double) number_of_tokens / reference_seconds / 1e6,
+			(double) length / seconds / 1e6, (double) number_of_tokens / seconds / 1e6);
+	}
+
+	free(text);
+	return exit_code;
+}
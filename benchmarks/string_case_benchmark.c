@@ -0,0 +1,148 @@
+#include "benchmark_timer.h"
+#include "string_case.h"
+
+#include <ctype.h>
+#include <iso646.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+Compares the ASCII case-insensitive functions of string_case.h with loops which call tolower of ctype.h per byte.
+Strings of each length are folded in place, and compared with a copy in another case, back to back.
+
+Usage: string_case_benchmark [number of megabytes per length]
+*/
+
+enum {
+	default_number_of_megabytes = 64,
+	number_of_repetitions = 5
+};
+
+static volatile size_t s_sink;
+
+static void fold_with_tolower(char *string, size_t length)
+{
+	for (size_t i = 0U; i < length; ++i) {
+		string[i] = (char) tolower((unsigned char) string[i]);
+	}
+}
+
+static bool equal_with_tolower(const char *string1, const char *string2, size_t length)
+{
+	for (size_t i = 0U; i < length; ++i) {
+		if (tolower((unsigned char) string1[i]) != tolower((unsigned char) string2[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void fold_with_string_case(char *string, size_t length)
+{
+	string_case_fold_ascii(string_to_stringref(string, length));
+}
+
+static bool equal_with_string_case(const char *string1, const char *string2, size_t length)
+{
+	return string_case_equal_ascii(string_to_const_stringref(string1, length), string_to_const_stringref(string2, length));
+}
+
+typedef void (*fold_function_type)(char*, size_t);
+typedef bool (*equal_function_type)(const char*, const char*, size_t);
+
+/* called through volatile pointers, so that no function can be inlined into the measurement loop */
+static fold_function_type volatile s_fold_functions[2] = {&fold_with_tolower, &fold_with_string_case};
+static equal_function_type volatile s_equal_functions[2] = {&equal_with_tolower, &equal_with_string_case};
+
+static double to_gigabytes_per_second(size_t number_of_bytes, size_t input_length, double seconds)
+{
+	return (seconds > 0.0) ? (double) (number_of_bytes / input_length * input_length) / seconds / 1e9 : 0.0;
+}
+
+static double measure_fold(size_t function_index, char *buffer, size_t number_of_bytes, size_t input_length)
+{
+	const fold_function_type fold_function = s_fold_functions[function_index];
+	double best_seconds = 1e30;
+	for (int repetition = 0; repetition < number_of_repetitions; ++repetition) {
+		const double start = benchmark_seconds();
+		for (size_t offset = 0U; offset + input_length <= number_of_bytes; offset += input_length) {
+			fold_function(buffer + offset, input_length);
+		}
+		const double seconds = benchmark_seconds() - start;
+		if (seconds < best_seconds) {
+			best_seconds = seconds;
+		}
+	}
+	return to_gigabytes_per_second(number_of_bytes, input_length, best_seconds);
+}
+
+static double measure_equal(size_t function_index, const char *buffer1, const char *buffer2,
+	size_t number_of_bytes, size_t input_length)
+{
+	const equal_function_type equal_function = s_equal_functions[function_index];
+	double best_seconds = 1e30;
+	for (int repetition = 0; repetition < number_of_repetitions; ++repetition) {
+		size_t number_of_equal_strings = 0U;
+		const double start = benchmark_seconds();
+		for (size_t offset = 0U; offset + input_length <= number_of_bytes; offset += input_length) {
+			number_of_equal_strings += equal_function(buffer1 + offset, buffer2 + offset, input_length);
+		}
+		const double seconds = benchmark_seconds() - start;
+		s_sink += number_of_equal_strings;
+		if (seconds < best_seconds) {
+			best_seconds = seconds;
+		}
+	}
+	return to_gigabytes_per_second(number_of_bytes, input_length, best_seconds);
+}
+
+int main(int argc, char **argv)
+{
+	static const char characters[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_";
+	static const size_t input_lengths[] = {8U, 16U, 32U, 64U, 256U, 4096U, 1048576U};
+	const long number_of_megabytes = (argc > 1) ? strtol(argv[1], NULL, 10) : default_number_of_megabytes;
+	if (number_of_megabytes <= 0) {
+		printf("Usage: %s [number of megabytes per length]\n", argv[0]);
+		return 0;
+	}
+
+	const size_t number_of_bytes = (size_t) number_of_megabytes * 1024U * 1024U;
+	char *mixed_case = (char*) malloc(number_of_bytes);
+	char *upper_case = (char*) malloc(number_of_bytes);
+	if (mixed_case == NULL or upper_case == NULL) {
+		printf("Not enough memory for %ld MiB.\n", number_of_megabytes);
+		free(mixed_case);
+		free(upper_case);
+		return 1;
+	}
+	uint64_t state = 0x9E3779B97F4A7C15ULL;
+	for (size_t i = 0U; i < number_of_bytes; ++i) {
+		state ^= state << 13U;
+		state ^= state >> 7U;
+		state ^= state << 17U;
+		mixed_case[i] = characters[state % (sizeof(characters) - 1U)];
+		upper_case[i] = (char) toupper((unsigned char) mixed_case[i]);
+	}
+
+	printf("%ld MiB per length, best of %d repetitions, throughput in GB/s\n\n", number_of_megabytes, number_of_repetitions);
+	printf("Input length  fold (tolower)  fold (string_case)  equal (tolower)  equal (string_case)\n");
+	for (size_t i = 0U; i < sizeof(input_lengths) / sizeof(input_lengths[0]); ++i) {
+		const size_t input_length = input_lengths[i];
+		if (input_length > number_of_bytes) {
+			break;
+		}
+		printf("%12lu  %14.2f  %18.2f  %15.2f  %19.2f\n", (unsigned long) input_length,
+			measure_fold(0U, mixed_case, number_of_bytes, input_length),
+			measure_fold(1U, mixed_case, number_of_bytes, input_length),
+			measure_equal(0U, mixed_case, upper_case, number_of_bytes, input_length),
+			measure_equal(1U, mixed_case, upper_case, number_of_bytes, input_length));
+	}
+
+	free(mixed_case);
+	free(upper_case);
+	return 0;
+}
@@ -0,0 +1,116 @@
+#include "benchmark_timer.h"
+#include "string_hash.h"
+
+#include <iso646.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+Compares the throughput of string_hash with 64-bit FNV-1a for inputs of different lengths.
+For each length, the same total number of bytes is hashed as a sequence of back-to-back inputs.
+
+Usage: string_hash_benchmark [number of megabytes per length]
+*/
+
+enum {
+	default_number_of_megabytes = 64,
+	number_of_repetitions = 5
+};
+
+static volatile uint64_t s_sink;
+
+static uint64_t fnv1a_64(const void *data, size_t number_of_bytes)
+{
+	const unsigned char *bytes = (const unsigned char*) data;
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	for (size_t i = 0U; i < number_of_bytes; ++i) {
+		hash ^= bytes[i];
+		hash *= 0x100000001B3ULL;
+	}
+	return hash;
+}
+
+static uint64_t string_hash_streaming(const void *data, size_t number_of_bytes)
+{
+	/* the input is appended in pieces of 1000 bytes */
+	const unsigned char *bytes = (const unsigned char*) data;
+	string_hash_state_type state;
+	string_hash_init(&state, 0U);
+	for (size_t offset = 0U; offset < number_of_bytes; offset += 1000U) {
+		string_hash_update(&state, bytes + offset, (number_of_bytes - offset < 1000U) ? number_of_bytes - offset : 1000U);
+	}
+	return string_hash_final(&state);
+}
+
+static uint64_t string_hash_one_shot(const void *data, size_t number_of_bytes)
+{
+	return string_hash_bytes(data, number_of_bytes, 0U);
+}
+
+typedef uint64_t (*hash_function_type)(const void*, size_t);
+
+/* called through volatile pointers, so that no hash function can be inlined into the measurement loop */
+static hash_function_type volatile s_hash_functions[3] = {&fnv1a_64, &string_hash_one_shot, &string_hash_streaming};
+
+static double measure(size_t function_index, const unsigned char *buffer,
+	size_t number_of_bytes, size_t input_length)
+{
+	const hash_function_type hash_function = s_hash_functions[function_index];
+	double best_seconds = 1e30;
+	for (int repetition = 0; repetition < number_of_repetitions; ++repetition) {
+		uint64_t sum = 0U;
+		const double start = benchmark_seconds();
+		for (size_t offset = 0U; offset + input_length <= number_of_bytes; offset += input_length) {
+			sum += hash_function(buffer + offset, input_length);
+		}
+		const double seconds = benchmark_seconds() - start;
+		s_sink += sum;
+		if (seconds < best_seconds) {
+			best_seconds = seconds;
+		}
+	}
+	return (best_seconds > 0.0) ? (double) (number_of_bytes / input_length * input_length) / best_seconds / 1e9 : 0.0;
+}
+
+int main(int argc, char **argv)
+{
+	static const size_t input_lengths[] = {4U, 8U, 16U, 32U, 64U, 128U, 256U, 1024U, 65536U, 1048576U};
+	const long number_of_megabytes = (argc > 1) ? strtol(argv[1], NULL, 10) : default_number_of_megabytes;
+	if (number_of_megabytes <= 0) {
+		printf("Usage: %s [number of megabytes per length]\n", argv[0]);
+		return 0;
+	}
+
+	const size_t number_of_bytes = (size_t) number_of_megabytes * 1024U * 1024U;
+	unsigned char *buffer = (unsigned char*) malloc(number_of_bytes);
+	if (buffer == NULL) {
+		printf("Not enough memory for %ld MiB.\n", number_of_megabytes);
+		return 1;
+	}
+	uint64_t state = 0x9E3779B97F4A7C15ULL;
+	for (size_t i = 0U; i < number_of_bytes; ++i) {
+		state ^= state << 13U;
+		state ^= state >> 7U;
+		state ^= state << 17U;
+		buffer[i] = (unsigned char) state;
+	}
+
+	printf("%ld MiB per length, best of %d repetitions, throughput in GB/s\n\n", number_of_megabytes, number_of_repetitions);
+	printf("Input length  FNV-1a  string_hash  string_hash (streaming)\n");
+	for (size_t i = 0U; i < sizeof(input_lengths) / sizeof(input_lengths[0]); ++i) {
+		const size_t input_length = input_lengths[i];
+		if (input_length > number_of_bytes) {
+			break;
+		}
+		printf("%12lu  %6.2f  %11.2f  %23.2f\n", (unsigned long) input_length,
+			measure(0U, buffer, number_of_bytes, input_length),
+			measure(1U, buffer, number_of_bytes, input_length),
+			measure(2U, buffer, number_of_bytes, input_length));
+	}
+
+	free(buffer);
+	return 0;
+}
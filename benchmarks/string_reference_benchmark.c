@@ -0,0 +1,261 @@
+#include "benchmark_timer.h"
+#include "string_reference.h"
+#include "string_search.h"
+
+#include <iso646.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+Measures the throughput of the string reference functions over a large buffer and over a stream of short tokens,
+and the throughput of substring search over a large buffer.
+Each function is compared with a byte-at-a-time reference implementation.
+
+Usage: string_reference_benchmark [number of megabytes]
+*/
+
+enum {
+	default_number_of_megabytes = 64,
+	number_of_repetitions = 5,
+	maximum_token_length = 32
+};
+
+typedef struct token_stream_type
+{
+	const_stringref_type *tokens;
+	size_t number_of_tokens;
+	size_t number_of_bytes;
+} token_stream_type;
+
+static volatile size_t s_sink;
+
+static uint64_t next_random_number(uint64_t *state)
+{
+	uint64_t x = *state;
+	x ^= x >> 12U;
+	x ^= x << 25U;
+	x ^= x >> 27U;
+	*state = x;
+	return x * 0x2545F4914F6CDD1DULL;
+}
+
+static size_t byte_loop_string_length(const_stringref_type stringref)
+{
+	size_t index = 0U;
+	if (stringref.string != NULL) {
+		for (; index < stringref.length; ++index) {
+			if (stringref.string[index] == '\0') {
+				break;
+			}
+		}
+	}
+	return index;
+}
+
+/* the previous implementation of const_stringref_strings_are_equal, which scans both strings before comparing them */
+static bool byte_loop_strings_are_equal(const_stringref_type strref1, const_stringref_type strref2)
+{
+	const size_t length1 = byte_loop_string_length(strref1);
+	const size_t length2 = byte_loop_string_length(strref2);
+	return length1 == length2 and memcmp(strref1.string, strref2.string, length1) == 0;
+}
+
+static size_t naive_find(const_stringref_type haystack, const_stringref_type needle)
+{
+	for (size_t position = 0U; position + needle.length <= haystack.length; ++position) {
+		size_t i = 0U;
+		while (i < needle.length and haystack.string[position + i] == needle.string[i]) {
+			++i;
+		}
+		if (i == needle.length) {
+			return position;
+		}
+	}
+	return STRING_SEARCH_NOT_FOUND;
+}
+
+static void print_result(const char *name, size_t number_of_bytes, double seconds)
+{
+	printf("%-44s %10.2f GB/s\n", name, (seconds > 0.0) ? (double) number_of_bytes / seconds / 1e9 : 0.0);
+}
+
+static void benchmark_string_length(const char *buffer, size_t number_of_bytes)
+{
+	const_stringref_type stringref = string_to_const_stringref(buffer, number_of_bytes);
+	double best_byte_loop_seconds = 1e30;
+	double best_seconds = 1e30;
+
+	for (int repetition = 0; repetition < number_of_repetitions; ++repetition) {
+		double start = benchmark_seconds();
+		s_sink += byte_loop_string_length(stringref);
+		double seconds = benchmark_seconds() - start;
+		if (seconds < best_byte_loop_seconds) {
+			best_byte_loop_seconds = seconds;
+		}
+
+		start = benchmark_seconds();
+		s_sink += const_stringref_string_length(stringref);
+		seconds = benchmark_seconds() - start;
+		if (seconds < best_seconds) {
+			best_seconds = seconds;
+		}
+	}
+
+	print_result("string length, byte loop", number_of_bytes, best_byte_loop_seconds);
+	print_result("const_stringref_string_length", number_of_bytes, best_seconds);
+}
+
+static bool make_token_stream(token_stream_type *stream, char *buffer, size_t number_of_bytes)
+{
+	uint64_t state = 0x9E3779B97F4A7C15ULL;
+	size_t offset = 0U;
+
+	stream->tokens = (const_stringref_type*) malloc((number_of_bytes / 2U + 1U) * sizeof(const_stringref_type));
+	stream->number_of_tokens = 0U;
+	stream->number_of_bytes = 0U;
+	if (stream->tokens == NULL) {
+		return false;
+	}
+
+	/* tokens of 1 to maximum_token_length bytes drawn from a small alphabet, so that many comparisons succeed */
+	while (offset + maximum_token_length < number_of_bytes) {
+		const size_t length = 1U + (size_t) (next_random_number(&state) % maximum_token_length);
+		for (size_t i = 0U; i < length; ++i) {
+			buffer[offset + i] = (char) ('a' + (next_random_number(&state) % 2U));
+		}
+		stream->tokens[stream->number_of_tokens] = string_to_const_stringref(buffer + offset, length);
+		++stream->number_of_tokens;
+		stream->number_of_bytes += length;
+		offset += length;
+	}
+	return true;
+}
+
+static void benchmark_token_equality(const token_stream_type *stream)
+{
+	const_stringref_type *truncated_tokens = (const_stringref_type*) malloc(stream->number_of_tokens * sizeof(const_stringref_type));
+	double best_seconds[3] = {1e30, 1e30, 1e30};
+
+	if (truncated_tokens == NULL) {
+		return;
+	}
+	for (size_t i = 0U; i < stream->number_of_tokens; ++i) {
+		truncated_tokens[i] = const_stringref_truncate_at_null_terminator(stream->tokens[i]);
+	}
+
+	/* each token is compared with the next one, so that every byte is read twice */
+	for (int repetition = 0; repetition < number_of_repetitions; ++repetition) {
+		size_t number_of_equal_tokens = 0U;
+		double start = benchmark_seconds();
+		for (size_t i = 1U; i < stream->number_of_tokens; ++i) {
+			number_of_equal_tokens += byte_loop_strings_are_equal(stream->tokens[i - 1U], stream->tokens[i]);
+		}
+		double seconds = benchmark_seconds() - start;
+		if (seconds < best_seconds[0]) {
+			best_seconds[0] = seconds;
+		}
+
+		start = benchmark_seconds();
+		for (size_t i = 1U; i < stream->number_of_tokens; ++i) {
+			number_of_equal_tokens += const_stringref_strings_are_equal(stream->tokens[i - 1U], stream->tokens[i]);
+		}
+		seconds = benchmark_seconds() - start;
+		if (seconds < best_seconds[1]) {
+			best_seconds[1] = seconds;
+		}
+
+		start = benchmark_seconds();
+		for (size_t i = 1U; i < stream->number_of_tokens; ++i) {
+			number_of_equal_tokens += const_stringref_contents_are_equal(truncated_tokens[i - 1U], truncated_tokens[i]);
+		}
+		seconds = benchmark_seconds() - start;
+		if (seconds < best_seconds[2]) {
+			best_seconds[2] = seconds;
+		}
+		s_sink += number_of_equal_tokens;
+	}
+
+	printf("\n%lu tokens of 1 to %d bytes, each compared with the next one\n",
+		(unsigned long) stream->number_of_tokens, (int) maximum_token_length);
+	print_result("token equality, byte loop", 2U * stream->number_of_bytes, best_seconds[0]);
+	print_result("const_stringref_strings_are_equal", 2U * stream->number_of_bytes, best_seconds[1]);
+	print_result("cached length, contents_are_equal", 2U * stream->number_of_bytes, best_seconds[2]);
+	free(truncated_tokens);
+}
+
+static void benchmark_substring_search(char *buffer, size_t number_of_bytes)
+{
+	/* a repetitive text, where the first byte of the needle is frequent and partial matches are long */
+	static const char needle_string[] = "aaaaaaaaaaaaaaaab";
+	const_stringref_type needle = string_to_const_stringref(needle_string, sizeof(needle_string) - 1U);
+	const_stringref_type haystack = string_to_const_stringref(buffer, number_of_bytes);
+	string_searcher_type searcher;
+	double best_seconds[3] = {1e30, 1e30, 1e30};
+
+	memset(buffer, 'a', number_of_bytes);
+	memcpy(buffer + number_of_bytes - needle.length, needle.string, needle.length);
+	string_searcher_init(&searcher, needle);
+	for (int repetition = 0; repetition < number_of_repetitions; ++repetition) {
+		double start = benchmark_seconds();
+		s_sink += naive_find(haystack, needle);
+		double seconds = benchmark_seconds() - start;
+		if (seconds < best_seconds[0]) {
+			best_seconds[0] = seconds;
+		}
+
+		start = benchmark_seconds();
+		s_sink += string_search_find(haystack, needle);
+		seconds = benchmark_seconds() - start;
+		if (seconds < best_seconds[1]) {
+			best_seconds[1] = seconds;
+		}
+
+		start = benchmark_seconds();
+		s_sink += string_searcher_find(&searcher, haystack);
+		seconds = benchmark_seconds() - start;
+		if (seconds < best_seconds[2]) {
+			best_seconds[2] = seconds;
+		}
+	}
+
+	printf("\nSearch for \"%s\" in a buffer of 'a'\n", needle_string);
+	print_result("substring search, naive loop", number_of_bytes, best_seconds[0]);
+	print_result("string_search_find", number_of_bytes, best_seconds[1]);
+	print_result("string_searcher_find", number_of_bytes, best_seconds[2]);
+}
+
+int main(int argc, char **argv)
+{
+	const long number_of_megabytes = (argc > 1) ? strtol(argv[1], NULL, 10) : default_number_of_megabytes;
+	if (number_of_megabytes <= 0) {
+		printf("Usage: %s [number of megabytes]\n", argv[0]);
+		return 0;
+	}
+
+	const size_t number_of_bytes = (size_t) number_of_megabytes * 1024U * 1024U;
+	char *buffer = (char*) malloc(number_of_bytes);
+	if (buffer == NULL) {
+		printf("Not enough memory for %ld MiB.\n", number_of_megabytes);
+		return 1;
+	}
+
+	printf("Buffer size: %ld MiB, best of %d repetitions\n\n", number_of_megabytes, number_of_repetitions);
+	memset(buffer, 'a', number_of_bytes);
+	buffer[number_of_bytes - 1U] = '\0';
+	benchmark_string_length(buffer, number_of_bytes);
+
+	token_stream_type stream;
+	if (make_token_stream(&stream, buffer, number_of_bytes)) {
+		benchmark_token_equality(&stream);
+		free(stream.tokens);
+	}
+
+	benchmark_substring_search(buffer, number_of_bytes);
+
+	free(buffer);
+	return 0;
+}
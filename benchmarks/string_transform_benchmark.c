@@ -0,0 +1,124 @@
+#include "benchmark_timer.h"
+#include "string_transform.h"
+
+#include <iso646.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+Compares the in-place transforms of string_transform.h with loops which process one byte per iteration,
+on a buffer of several megabytes: reversing, swapping the byte order of 2-, 4- and 8-byte words and translating
+with a table of 256 bytes.
+
+Usage: string_transform_benchmark [number of megabytes]
+*/
+
+enum {
+	default_number_of_megabytes = 16,
+	number_of_repetitions = 5
+};
+
+static unsigned char s_table[256];
+
+static void reverse_byte_by_byte(stringref_type string, size_t parameter)
+{
+	(void) parameter;
+	stringref_reverse_string(string);
+}
+
+static void reverse_with_string_transform(stringref_type string, size_t parameter)
+{
+	(void) parameter;
+	string_transform_reverse(string);
+}
+
+static void swap_byte_by_byte(stringref_type string, size_t word_size)
+{
+	for (size_t offset = 0U; offset + word_size <= string.length; offset += word_size) {
+		char *word = string.string + offset;
+		for (size_t left = 0U, right = word_size - 1U; left < right; ++left, --right) {
+			const char byte = word[left];
+			word[left] = word[right];
+			word[right] = byte;
+		}
+	}
+}
+
+static void swap_with_string_transform(stringref_type string, size_t word_size)
+{
+	string_transform_swap_byte_order(string, word_size);
+}
+
+static void translate_byte_by_byte(stringref_type string, size_t parameter)
+{
+	(void) parameter;
+	for (size_t i = 0U; i < string.length; ++i) {
+		string.string[i] = (char) s_table[(unsigned char) string.string[i]];
+	}
+}
+
+static void translate_with_string_transform(stringref_type string, size_t parameter)
+{
+	(void) parameter;
+	string_transform_translate(string, s_table);
+}
+
+typedef void (*transform_function_type)(stringref_type, size_t);
+
+/* called through volatile pointers, so that no function can be inlined into the measurement loop */
+static transform_function_type volatile s_functions[6] = {
+	&reverse_byte_by_byte, &reverse_with_string_transform,
+	&swap_byte_by_byte, &swap_with_string_transform,
+	&translate_byte_by_byte, &translate_with_string_transform
+};
+
+static double measure(size_t function_index, char *buffer, size_t number_of_bytes, size_t parameter)
+{
+	const transform_function_type function = s_functions[function_index];
+	double best_seconds = 1e30;
+	for (int repetition = 0; repetition < number_of_repetitions; ++repetition) {
+		const double start = benchmark_seconds();
+		function(string_to_stringref(buffer, number_of_bytes), parameter);
+		const double seconds = benchmark_seconds() - start;
+		if (seconds < best_seconds) {
+			best_seconds = seconds;
+		}
+	}
+	return (best_seconds > 0.0) ? (double) number_of_bytes / best_seconds / 1e9 : 0.0;
+}
+
+int main(int argc, char **argv)
+{
+	const long number_of_megabytes = (argc > 1) ? strtol(argv[1], NULL, 10) : default_number_of_megabytes;
+	if (number_of_megabytes <= 0) {
+		printf("Usage: %s [number of megabytes]\n", argv[0]);
+		return 0;
+	}
+
+	const size_t number_of_bytes = (size_t) number_of_megabytes * 1024U * 1024U;
+	char *buffer = (char*) malloc(number_of_bytes);
+	if (buffer == NULL) {
+		printf("Not enough memory for %ld MiB.\n", number_of_megabytes);
+		return 1;
+	}
+	for (size_t i = 0U; i < number_of_bytes; ++i) {
+		buffer[i] = (char) (unsigned char) (i * 131U);
+	}
+	for (size_t i = 0U; i < 256U; ++i) {
+		s_table[i] = (unsigned char) ((i * 167U + 13U) & 0xFFU);
+	}
+
+	printf("%ld MiB, best of %d repetitions, throughput in GB/s\n\n", number_of_megabytes, number_of_repetitions);
+	printf("Transform                byte by byte  string_transform\n");
+	printf("reverse                  %12.2f  %16.2f\n", measure(0U, buffer, number_of_bytes, 0U), measure(1U, buffer, number_of_bytes, 0U));
+	printf("swap 2-byte byte order   %12.2f  %16.2f\n", measure(2U, buffer, number_of_bytes, 2U), measure(3U, buffer, number_of_bytes, 2U));
+	printf("swap 4-byte byte order   %12.2f  %16.2f\n", measure(2U, buffer, number_of_bytes, 4U), measure(3U, buffer, number_of_bytes, 4U));
+	printf("swap 8-byte byte order   %12.2f  %16.2f\n", measure(2U, buffer, number_of_bytes, 8U), measure(3U, buffer, number_of_bytes, 8U));
+	printf("translate                %12.2f  %16.2f\n", measure(4U, buffer, number_of_bytes, 0U), measure(5U, buffer, number_of_bytes, 0U));
+
+	free(buffer);
+	return 0;
+}
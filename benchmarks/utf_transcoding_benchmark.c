@@ -0,0 +1,224 @@
+#include "benchmark_timer.h"
+#include "simple_tokenizer.h"
+
+#include <iso646.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+Compares the bulk transcoding functions of simple_tokenizer, simple_tokenizer_utf8_to_utf32,
+simple_tokenizer_utf8_to_utf16 and simple_tokenizer_utf16_to_utf8, with a loop which decodes one character per call
+of simple_tokenizer_stringref_to_utf8_char. The inputs are generated texts of ASCII, of mostly ASCII with accented
+letters, of Cyrillic, of CJK characters and of emoji, so the characters take from 1 to 4 bytes.
+The throughput is in megabytes of UTF-8 per second.
+
+Usage: utf_transcoding_benchmark [number of megabytes]
+*/
+
+enum {
+	default_number_of_megabytes = 16,
+	number_of_repetitions = 5
+};
+
+typedef struct corpus_type
+{
+	const char *name;
+	const char *const *words;
+	size_t number_of_words;
+} corpus_type;
+
+static const char *const ascii_words[] = {"the", "index", "of", "a", "token", "is", "counted", "from", "zero", "string"};
+static const char *const latin_words[] = {"der", "Stra\xC3\x9F" "e", "caf\xC3\xA9", "na\xC3\xAFve", "und", "\xC3\xA0", "le", "r\xC3\xB6" "d"};
+static const char *const cyrillic_words[] = {
+	"\xD0\xB4\xD0\xB0", "\xD0\xBD\xD0\xB5\xD1\x82", "\xD1\x81\xD0\xBB\xD0\xBE\xD0\xB2\xD0\xBE",
+	"\xD0\xBC\xD0\xB8\xD1\x80"
+};
+static const char *const cjk_words[] = {
+	"\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E", "\xE4\xB8\xAD\xE6\x96\x87", "\xE6\x96\x87\xE5\xAD\x97\xE5\x88\x97",
+	"\xED\x95\x9C\xEA\xB5\xAD\xEC\x96\xB4"
+};
+static const char *const emoji_words[] = {
+	"\xF0\x9F\x98\x80", "\xF0\x9F\x8E\x89\xF0\x9F\x8E\x89", "\xF0\x9F\x91\x8D", "\xF0\x9F\x9A\x80\xF0\x9F\x8C\x8D"
+};
+
+#define CORPUS(name, words) {name, words, sizeof(words) / sizeof(words[0])}
+
+static const corpus_type corpora[] = {
+	CORPUS("ASCII", ascii_words),
+	CORPUS("Latin", latin_words),
+	CORPUS("Cyrillic", cyrillic_words),
+	CORPUS("CJK", cjk_words),
+	CORPUS("emoji", emoji_words)
+};
+
+/* Fills a buffer with words separated by spaces, ending at a character boundary. Returns the number of bytes. */
+static size_t generate_text(char *text, size_t length, const corpus_type *corpus)
+{
+	uint64_t state = 0x9E3779B97F4A7C15ULL;
+	size_t position = 0U;
+
+	for (;;) {
+		state ^= state << 13U;
+		state ^= state >> 7U;
+		state ^= state << 17U;
+		const char *word = corpus->words[state % corpus->number_of_words];
+		const size_t word_length = strlen(word);
+		if (position + word_length + 1U > length) {
+			return position;
+		}
+		memcpy(text + position, word, word_length);
+		position += word_length;
+		text[position++] = ' ';
+	}
+}
+
+typedef struct buffers_type
+{
+	const char *utf8;
+	size_t utf8_length;
+	uint32_t *utf32;
+	uint16_t *utf16;
+	size_t utf16_length;
+	char *utf8_output;
+} buffers_type;
+
+/* Decodes one character per call, as a program would without a bulk conversion. */
+static size_t per_character_utf8_to_utf32(buffers_type *buffers)
+{
+	const unsigned char *string = (const unsigned char*) buffers->utf8;
+	size_t number_of_units = 0U;
+
+	for (size_t index = 0U; index < buffers->utf8_length;) {
+		const size_t number_of_bytes = (string[index] < 0xC0U) ? 1U : (string[index] < 0xE0U) ? 2U :
+			(string[index] < 0xF0U) ? 3U : 4U;
+		if (number_of_bytes > buffers->utf8_length - index) {
+			break;
+		}
+		const simple_tokenizer_utf8_char_type utf8_char = simple_tokenizer_stringref_to_utf8_char(
+			string_to_const_stringref(buffers->utf8 + index, number_of_bytes));
+		if (utf8_char.error != simple_tokenizer_utf8_char_error_none) {
+			break;
+		}
+		buffers->utf32[number_of_units++] = utf8_char.unicode_value;
+		index += number_of_bytes;
+	}
+	return number_of_units;
+}
+
+static size_t bulk_utf8_to_utf32(buffers_type *buffers)
+{
+	return simple_tokenizer_utf8_to_utf32(buffers->utf8, buffers->utf8_length, buffers->utf32,
+		buffers->utf8_length).number_of_output_units;
+}
+
+static size_t bulk_utf8_to_utf16(buffers_type *buffers)
+{
+	return simple_tokenizer_utf8_to_utf16(buffers->utf8, buffers->utf8_length, buffers->utf16,
+		buffers->utf8_length).number_of_output_units;
+}
+
+static size_t bulk_utf16_to_utf8(buffers_type *buffers)
+{
+	return simple_tokenizer_utf16_to_utf8(buffers->utf16, buffers->utf16_length, buffers->utf8_output,
+		buffers->utf8_length).number_of_output_units;
+}
+
+typedef size_t (*transcode_function_type)(buffers_type*);
+
+/* called through volatile pointers, so that no function can be inlined into the measurement loop */
+static transcode_function_type volatile s_transcode_functions[4] = {
+	&per_character_utf8_to_utf32, &bulk_utf8_to_utf32, &bulk_utf8_to_utf16, &bulk_utf16_to_utf8
+};
+
+static const char *const s_transcode_function_names[4] = {
+	"per character UTF-8 to UTF-32", "UTF-8 to UTF-32", "UTF-8 to UTF-16", "UTF-16 to UTF-8"
+};
+
+static double measure(size_t function_index, buffers_type *buffers, size_t *number_of_units)
+{
+	const transcode_function_type transcode_function = s_transcode_functions[function_index];
+	double best_seconds = 1e30;
+	for (int repetition = 0; repetition < number_of_repetitions; ++repetition) {
+		const double start = benchmark_seconds();
+		*number_of_units = transcode_function(buffers);
+		const double seconds = benchmark_seconds() - start;
+		if (seconds < best_seconds) {
+			best_seconds = seconds;
+		}
+	}
+	return best_seconds;
+}
+
+int main(int argc, char **argv)
+{
+	const long number_of_megabytes = (argc > 1) ? strtol(argv[1], NULL, 10) : default_number_of_megabytes;
+	if (number_of_megabytes <= 0) {
+		printf("Usage: %s [number of megabytes]\n", argv[0]);
+		return 0;
+	}
+
+	const size_t capacity = (size_t) number_of_megabytes * 1024U * 1024U;
+	char *text = (char*) malloc(capacity);
+	uint32_t *utf32 = (uint32_t*) malloc(capacity * sizeof(uint32_t));
+	uint16_t *utf16 = (uint16_t*) malloc(capacity * sizeof(uint16_t));
+	char *utf8_output = (char*) malloc(capacity);
+	if (text == NULL or utf32 == NULL or utf16 == NULL or utf8_output == NULL) {
+		printf("Not enough memory for %ld MiB.\n", number_of_megabytes);
+		free(text);
+		free(utf32);
+		free(utf16);
+		free(utf8_output);
+		return 1;
+	}
+
+	printf("%ld MiB of text per corpus, best of %d repetitions, MB of UTF-8 per second\n\n",
+		number_of_megabytes, number_of_repetitions);
+	printf("%-10s", "Corpus");
+	for (size_t function_index = 0U; function_index < 4U; ++function_index) {
+		printf(" %30s", s_transcode_function_names[function_index]);
+	}
+	printf("\n");
+
+	int exit_code = 0;
+	for (size_t corpus_index = 0U; corpus_index < sizeof(corpora) / sizeof(corpora[0]); ++corpus_index) {
+		buffers_type buffers = {text, 0U, utf32, utf16, 0U, utf8_output};
+		buffers.utf8_length = generate_text(text, capacity, &corpora[corpus_index]);
+		buffers.utf16_length = simple_tokenizer_utf8_to_utf16(text, buffers.utf8_length, utf16,
+			capacity).number_of_output_units;
+
+		size_t expected_numbers_of_units[4];
+		expected_numbers_of_units[0] = simple_tokenizer_utf8_to_utf32(text, buffers.utf8_length, NULL,
+			0U).number_of_output_units;
+		expected_numbers_of_units[1] = expected_numbers_of_units[0];
+		expected_numbers_of_units[2] = buffers.utf16_length;
+		expected_numbers_of_units[3] = buffers.utf8_length;
+
+		printf("%-10s", corpora[corpus_index].name);
+		for (size_t function_index = 0U; function_index < 4U; ++function_index) {
+			size_t number_of_units = 0U;
+			const double seconds = measure(function_index, &buffers, &number_of_units);
+			if (number_of_units != expected_numbers_of_units[function_index]) {
+				printf("\n%s converted %lu instead of %lu code units.\n", s_transcode_function_names[function_index],
+					(unsigned long) number_of_units, (unsigned long) expected_numbers_of_units[function_index]);
+				exit_code = 1;
+				break;
+			}
+			printf(" %30.1f", (double) buffers.utf8_length / seconds / 1e6);
+		}
+		printf("\n");
+		if (exit_code == 0 and memcmp(utf8_output, text, buffers.utf8_length) != 0) {
+			printf("The UTF-8 converted from UTF-16 differs from the input.\n");
+			exit_code = 1;
+		}
+	}
+
+	free(text);
+	free(utf32);
+	free(utf16);
+	free(utf8_output);
+	return exit_code;
+}
@@ -0,0 +1,444 @@
+#if defined(__unix__) || defined(__APPLE__)
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L /* for pthread.h and clock_gettime */
+#endif
+#endif
+
+#include "allocation_tracker.h"
+#include "Boolean_type.h"
+#include "static_assert.h"
+#include "thread_local.h"
+#include <assert.h>
+#include <iso646.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(ALLOCATION_TRACKER_WINDOWS)
+#include <windows.h>
+#endif
+
+/* Notes:
+- The hash table uses linear probing and backward shift deletion, so there is no tombstone.
+- The load factor is kept at or below 1/2.
+- The wrapped allocator is called with the lock held. Otherwise, a block deallocated by one thread and allocated again
+  by another thread could be inserted before the record of the old block is removed.
+- A record holds a sequence number instead of a timestamp, so the clock is not read on every allocation.
+*/
+
+STATIC_ASSERT(sizeof(size_t) == sizeof(void*), "size_t and pointer type must have the same size.");
+
+enum {
+	allocation_tracker_initial_capacity = 64
+};
+
+/* The call site of the next allocation or reallocation of the calling thread, for the tracker it was set for. */
+static THREAD_LOCAL const allocation_tracker_type *s_pending_tracker = NULL;
+static THREAD_LOCAL const char *s_pending_file_name = NULL;
+static THREAD_LOCAL int s_pending_line_number = 0;
+
+static double allocation_tracker_wall_clock(void)
+{
+#if defined(ALLOCATION_TRACKER_POSIX)
+	struct timespec time_point;
+	if (clock_gettime(CLOCK_MONOTONIC, &time_point) == 0) {
+		return (double) time_point.tv_sec + (double) time_point.tv_nsec * 1e-9;
+	}
+	return (double) time(NULL);
+#elif defined(ALLOCATION_TRACKER_WINDOWS)
+	LARGE_INTEGER counter;
+	LARGE_INTEGER frequency;
+	if (QueryPerformanceCounter(&counter) and QueryPerformanceFrequency(&frequency)) {
+		return (double) counter.QuadPart / (double) frequency.QuadPart;
+	}
+	return (double) time(NULL);
+#else
+	return (double) time(NULL);
+#endif
+}
+
+/* The statistics and the leak report only read the tracker, but they hold its lock as well. */
+static void allocation_tracker_lock(const allocation_tracker_type *tracker)
+{
+#if defined(ALLOCATION_TRACKER_POSIX)
+	(void) pthread_mutex_lock(&((allocation_tracker_type*) tracker)->lock);
+#elif defined(ALLOCATION_TRACKER_WINDOWS)
+	AcquireSRWLockExclusive((PSRWLOCK) &((allocation_tracker_type*) tracker)->lock);
+#else
+	(void) tracker;
+#endif
+}
+
+static void allocation_tracker_unlock(const allocation_tracker_type *tracker)
+{
+#if defined(ALLOCATION_TRACKER_POSIX)
+	(void) pthread_mutex_unlock(&((allocation_tracker_type*) tracker)->lock);
+#elif defined(ALLOCATION_TRACKER_WINDOWS)
+	ReleaseSRWLockExclusive((PSRWLOCK) &((allocation_tracker_type*) tracker)->lock);
+#else
+	(void) tracker;
+#endif
+}
+
+/* Returns the call site set for the tracker by the calling thread and clears it, whether or not it is used. */
+static void allocation_tracker_take_call_site(const allocation_tracker_type *tracker, const char **file_name, int *line_number)
+{
+	*file_name = NULL;
+	*line_number = 0;
+	if (s_pending_tracker == tracker) {
+		*file_name = s_pending_file_name;
+		*line_number = s_pending_line_number;
+	}
+	s_pending_tracker = NULL;
+	s_pending_file_name = NULL;
+	s_pending_line_number = 0;
+}
+
+static size_t allocation_tracker_hash(const void *memory_block)
+{
+	size_t hash = (size_t) memory_block;
+	hash >>= 4U; /* the lowest bits are usually zero due to alignment */
+	hash ^= hash >> 15U;
+	hash *= 0x9E3779B1U;
+	hash ^= hash >> 13U;
+	return hash;
+}
+
+static size_t allocation_tracker_find_slot(const allocation_tracker_type *tracker, const void *memory_block)
+{
+	const size_t mask = tracker->capacity - 1U;
+	size_t index = allocation_tracker_hash(memory_block) & mask;
+	while (tracker->records[index].memory_block != NULL and tracker->records[index].memory_block != memory_block) {
+		index = (index + 1U) & mask;
+	}
+	return index;
+}
+
+static Boolean_type allocation_tracker_grow(allocation_tracker_type *tracker)
+{
+	const size_t old_capacity = tracker->capacity;
+	const size_t new_capacity = (old_capacity > 0U) ? (old_capacity * 2U) : (size_t) allocation_tracker_initial_capacity;
+	allocation_tracker_record_type *old_records = tracker->records;
+	allocation_tracker_record_type *new_records = NULL;
+	size_t index = 0U;
+
+	if (new_capacity < old_capacity or new_capacity > ((size_t) -1) / sizeof(allocation_tracker_record_type)) {
+		return Boolean_false;
+	}
+
+	new_records = (allocation_tracker_record_type*) allocator_allocate(tracker->allocator, new_capacity * sizeof(allocation_tracker_record_type));
+	if (new_records == NULL) {
+		return Boolean_false;
+	}
+
+	tracker->records = new_records;
+	tracker->capacity = new_capacity;
+	for (index = 0U; index < old_capacity; ++index) {
+		if (old_records[index].memory_block != NULL) {
+			const size_t new_index = allocation_tracker_find_slot(tracker, old_records[index].memory_block);
+			tracker->records[new_index] = old_records[index];
+		}
+	}
+
+	allocator_deallocate(tracker->allocator, old_records);
+	return Boolean_true;
+}
+
+static void allocation_tracker_remove_slot(allocation_tracker_type *tracker, size_t index)
+{
+	const size_t mask = tracker->capacity - 1U;
+	size_t next_index = (index + 1U) & mask;
+
+	while (tracker->records[next_index].memory_block != NULL) {
+		const size_t home_index = allocation_tracker_hash(tracker->records[next_index].memory_block) & mask;
+		/* move the record back if its home slot is not in the cyclic range (index, next_index] */
+		if (((next_index - home_index) & mask) >= ((next_index - index) & mask)) {
+			tracker->records[index] = tracker->records[next_index];
+			index = next_index;
+		}
+		next_index = (next_index + 1U) & mask;
+	}
+
+	memset(&tracker->records[index], 0, sizeof(tracker->records[index]));
+}
+
+static void allocation_tracker_record(allocation_tracker_type *tracker, size_t index, void *memory_block, size_t number_of_bytes,
+	const char *file_name, int line_number)
+{
+	allocation_tracker_record_type *record = &tracker->records[index];
+	record->memory_block = memory_block;
+	record->number_of_bytes = number_of_bytes;
+	record->sequence_number = tracker->number_of_requests;
+	record->file_name = file_name;
+	record->line_number = line_number;
+
+	tracker->statistics.current_number_of_bytes += number_of_bytes;
+	tracker->statistics.total_number_of_bytes_allocated += number_of_bytes;
+	if (tracker->statistics.current_number_of_bytes > tracker->statistics.peak_number_of_bytes) {
+		tracker->statistics.peak_number_of_bytes = tracker->statistics.current_number_of_bytes;
+	}
+}
+
+void allocation_tracker_init(allocation_tracker_type *tracker, allocator_type allocator)
+{
+	assert(tracker != NULL);
+	assert(allocator.allocate != NULL);
+	assert(allocator.deallocate != NULL);
+	if (tracker != NULL) {
+		memset(tracker, 0, sizeof(*tracker));
+		tracker->allocator = allocator;
+		tracker->start_time = allocation_tracker_wall_clock();
+#if defined(ALLOCATION_TRACKER_POSIX)
+		(void) pthread_mutex_init(&tracker->lock, NULL);
+#elif defined(ALLOCATION_TRACKER_WINDOWS)
+		InitializeSRWLock((PSRWLOCK) &tracker->lock);
+#endif
+	}
+}
+
+void allocation_tracker_deinit(allocation_tracker_type *tracker)
+{
+	assert(tracker != NULL);
+	if (tracker != NULL) {
+		if (tracker->records != NULL) {
+			allocator_deallocate(tracker->allocator, tracker->records);
+		}
+		tracker->records = NULL;
+		tracker->capacity = 0U;
+#if defined(ALLOCATION_TRACKER_POSIX)
+		(void) pthread_mutex_destroy(&tracker->lock);
+#endif
+	}
+}
+
+void allocation_tracker_set_call_site(allocation_tracker_type *tracker, const char *file_name, int line_number)
+{
+	assert(tracker != NULL);
+	if (tracker != NULL) {
+		s_pending_tracker = tracker;
+		s_pending_file_name = file_name;
+		s_pending_line_number = line_number;
+	}
+}
+
+static void *allocation_tracker_allocate_locked(allocation_tracker_type *tracker, size_t number_of_bytes,
+	const char *file_name, int line_number)
+{
+	void *memory_block = NULL;
+	size_t index = 0U;
+
+	++tracker->number_of_requests;
+	if ((tracker->statistics.number_of_live_blocks + 1U) * 2U > tracker->capacity) {
+		if (not allocation_tracker_grow(tracker)) {
+			++tracker->statistics.number_of_failed_allocations;
+			return NULL;
+		}
+	}
+
+	memory_block = tracker->allocator.allocate(number_of_bytes);
+	if (memory_block == NULL) {
+		++tracker->statistics.number_of_failed_allocations;
+		return NULL;
+	}
+
+	index = allocation_tracker_find_slot(tracker, memory_block);
+	assert(tracker->records[index].memory_block == NULL);
+	allocation_tracker_record(tracker, index, memory_block, number_of_bytes, file_name, line_number);
+	++tracker->statistics.number_of_allocations;
+	++tracker->statistics.number_of_live_blocks;
+	return memory_block;
+}
+
+static void allocation_tracker_deallocate_locked(allocation_tracker_type *tracker, void *memory_block)
+{
+	size_t index = 0U;
+
+	if (tracker->records != NULL) {
+		index = allocation_tracker_find_slot(tracker, memory_block);
+	}
+
+	if (tracker->records == NULL or tracker->records[index].memory_block != memory_block) {
+		++tracker->statistics.number_of_invalid_deallocations;
+		return;
+	}
+
+	tracker->statistics.current_number_of_bytes -= tracker->records[index].number_of_bytes;
+	--tracker->statistics.number_of_live_blocks;
+	++tracker->statistics.number_of_deallocations;
+	allocation_tracker_remove_slot(tracker, index);
+	allocator_deallocate(tracker->allocator, memory_block);
+}
+
+static void *allocation_tracker_reallocate_locked(allocation_tracker_type *tracker, void *memory_block,
+	size_t new_number_of_bytes, const char *file_name, int line_number)
+{
+	void *new_memory_block = NULL;
+	size_t index = 0U;
+	size_t old_number_of_bytes = 0U;
+
+	if (memory_block == NULL) {
+		return allocation_tracker_allocate_locked(tracker, new_number_of_bytes, file_name, line_number);
+	}
+
+	if (new_number_of_bytes == 0U) {
+		allocation_tracker_deallocate_locked(tracker, memory_block);
+		return NULL;
+	}
+
+	++tracker->number_of_requests;
+	if (tracker->records == NULL) {
+		++tracker->statistics.number_of_failed_allocations;
+		return NULL;
+	}
+
+	index = allocation_tracker_find_slot(tracker, memory_block);
+	assert(tracker->records[index].memory_block == memory_block);
+	if (tracker->records[index].memory_block != memory_block) {
+		++tracker->statistics.number_of_failed_allocations;
+		return NULL;
+	}
+
+	old_number_of_bytes = tracker->records[index].number_of_bytes;
+	new_memory_block = allocator_reallocate(tracker->allocator, memory_block,
+		(old_number_of_bytes > 0U) ? old_number_of_bytes : 1U, new_number_of_bytes);
+	if (new_memory_block == NULL) {
+		++tracker->statistics.number_of_failed_allocations;
+		return NULL;
+	}
+
+	tracker->statistics.current_number_of_bytes -= old_number_of_bytes;
+	if (new_memory_block != memory_block) {
+		allocation_tracker_remove_slot(tracker, index);
+		index = allocation_tracker_find_slot(tracker, new_memory_block);
+		assert(tracker->records[index].memory_block == NULL);
+	}
+	allocation_tracker_record(tracker, index, new_memory_block, new_number_of_bytes, file_name, line_number);
+	++tracker->statistics.number_of_reallocations;
+	return new_memory_block;
+}
+
+void *allocation_tracker_allocate(allocation_tracker_type *tracker, size_t number_of_bytes)
+{
+	void *memory_block = NULL;
+	const char *file_name = NULL;
+	int line_number = 0;
+
+	assert(tracker != NULL);
+	if (tracker == NULL or tracker->allocator.allocate == NULL) {
+		return NULL;
+	}
+
+	allocation_tracker_take_call_site(tracker, &file_name, &line_number);
+	allocation_tracker_lock(tracker);
+	memory_block = allocation_tracker_allocate_locked(tracker, number_of_bytes, file_name, line_number);
+	allocation_tracker_unlock(tracker);
+	return memory_block;
+}
+
+void *allocation_tracker_reallocate(allocation_tracker_type *tracker, void *memory_block, size_t new_number_of_bytes)
+{
+	void *new_memory_block = NULL;
+	const char *file_name = NULL;
+	int line_number = 0;
+
+	assert(tracker != NULL);
+	if (tracker == NULL or tracker->allocator.allocate == NULL) {
+		return NULL;
+	}
+
+	allocation_tracker_take_call_site(tracker, &file_name, &line_number);
+	allocation_tracker_lock(tracker);
+	new_memory_block = allocation_tracker_reallocate_locked(tracker, memory_block, new_number_of_bytes, file_name, line_number);
+	allocation_tracker_unlock(tracker);
+	return new_memory_block;
+}
+
+void allocation_tracker_deallocate(allocation_tracker_type *tracker, void *memory_block)
+{
+	const char *file_name = NULL;
+	int line_number = 0;
+
+	assert(tracker != NULL);
+	if (tracker == NULL) {
+		return;
+	}
+
+	allocation_tracker_take_call_site(tracker, &file_name, &line_number);
+	if (memory_block != NULL) {
+		allocation_tracker_lock(tracker);
+		allocation_tracker_deallocate_locked(tracker, memory_block);
+		allocation_tracker_unlock(tracker);
+	}
+}
+
+allocation_tracker_statistics_type allocation_tracker_get_statistics(const allocation_tracker_type *tracker)
+{
+	allocation_tracker_statistics_type statistics = {0U};
+	assert(tracker != NULL);
+	if (tracker != NULL) {
+		allocation_tracker_lock(tracker);
+		statistics = tracker->statistics;
+		allocation_tracker_unlock(tracker);
+		statistics.elapsed_seconds = allocation_tracker_wall_clock() - tracker->start_time;
+	}
+	return statistics;
+}
+
+double allocation_tracker_allocation_rate(const allocation_tracker_type *tracker)
+{
+	const allocation_tracker_statistics_type statistics = allocation_tracker_get_statistics(tracker);
+	const double number_of_requests = (double) statistics.number_of_allocations + (double) statistics.number_of_reallocations;
+	return (statistics.elapsed_seconds > 0.0) ? (number_of_requests / statistics.elapsed_seconds) : 0.0;
+}
+
+size_t allocation_tracker_report_leaks(const allocation_tracker_type *tracker, FILE *output)
+{
+	size_t number_of_leaks = 0U;
+	size_t index = 0U;
+
+	assert(tracker != NULL);
+	assert(output != NULL);
+	if (tracker == NULL or output == NULL) {
+		return 0U;
+	}
+
+	allocation_tracker_lock(tracker);
+	for (index = 0U; index < tracker->capacity; ++index) {
+		const allocation_tracker_record_type *record = &tracker->records[index];
+		if (record->memory_block != NULL) {
+			fprintf(output, "Leak: %lu bytes at %p allocated by request %lu",
+				(unsigned long) record->number_of_bytes, record->memory_block, (unsigned long) record->sequence_number);
+			if (record->file_name != NULL) {
+				fprintf(output, " by %s (line %d)", record->file_name, record->line_number);
+			}
+			fprintf(output, "\n");
+			++number_of_leaks;
+		}
+	}
+	allocation_tracker_unlock(tracker);
+
+	return number_of_leaks;
+}
+
+void allocation_tracker_report(const allocation_tracker_type *tracker, FILE *output)
+{
+	allocation_tracker_statistics_type statistics = {0U};
+
+	assert(tracker != NULL);
+	assert(output != NULL);
+	if (tracker == NULL or output == NULL) {
+		return;
+	}
+
+	statistics = allocation_tracker_get_statistics(tracker);
+	fprintf(output, "Number of allocations: %lu\n", (unsigned long) statistics.number_of_allocations);
+	fprintf(output, "Number of reallocations: %lu\n", (unsigned long) statistics.number_of_reallocations);
+	fprintf(output, "Number of deallocations: %lu\n", (unsigned long) statistics.number_of_deallocations);
+	fprintf(output, "Number of failed allocations: %lu\n", (unsigned long) statistics.number_of_failed_allocations);
+	fprintf(output, "Number of invalid deallocations: %lu\n", (unsigned long) statistics.number_of_invalid_deallocations);
+	fprintf(output, "Total number of bytes allocated: %lu\n", (unsigned long) statistics.total_number_of_bytes_allocated);
+	fprintf(output, "Peak number of bytes: %lu\n", (unsigned long) statistics.peak_number_of_bytes);
+	fprintf(output, "Allocation rate: %.1f per second\n", allocation_tracker_allocation_rate(tracker));
+	fprintf(output, "Number of leaks: %lu (%lu bytes)\n",
+		(unsigned long) statistics.number_of_live_blocks, (unsigned long) statistics.current_number_of_bytes);
+	(void) allocation_tracker_report_leaks(tracker, output);
+}
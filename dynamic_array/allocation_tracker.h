@@ -0,0 +1,227 @@
+/* Minimum C Standard: C89 */
+
+#ifndef ALLOCATION_TRACKER_H
+#define ALLOCATION_TRACKER_H
+
+#include "allocator_type.h"
+#include "macro_concatenate.h"
+#include <stddef.h>
+#include <stdio.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#define ALLOCATION_TRACKER_POSIX 1
+#elif defined(_WIN32)
+#define ALLOCATION_TRACKER_WINDOWS 1
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+An allocation tracker wraps an allocator and records every live memory block in an open addressing hash table
+keyed by the address of the block. Each record holds the size of the block, the sequence number of the request
+which allocated it and an optional call site. The tracker keeps statistics (peak number of bytes, allocation rate,
+etc.) and reports the memory blocks which are still alive (leaks).
+
+The cost of tracking a memory block is a lock and an O(1) insertion or removal in the hash table. The clock is read
+only when the tracker is initialized and when the statistics are requested, so the tracker can be left enabled in
+builds which run under realistic load.
+
+Notes:
+- The hash table is allocated through the wrapped allocator.
+- The tracker is thread-safe on POSIX systems and on Windows: every operation holds the lock of the tracker, including
+  the call of the wrapped allocator. Elsewhere, the tracker must be used by one thread at a time.
+- The call site set by allocation_tracker_set_call_site is kept per thread if the compiler supports thread-local
+  storage.
+- Use ALLOCATION_TRACKER_DEFINE_ALLOCATOR to generate the functions required by allocator_type.
+*/
+
+typedef struct allocation_tracker_record_type
+{
+	void *memory_block; /* null if the slot is empty */
+	size_t number_of_bytes;
+	size_t sequence_number; /* of the allocation or reallocation request which produced the block, starting at 1 */
+	const char *file_name; /* call site, can be null */
+	int line_number; /* call site */
+} allocation_tracker_record_type;
+
+typedef struct allocation_tracker_statistics_type
+{
+	size_t number_of_allocations;
+	size_t number_of_reallocations;
+	size_t number_of_deallocations;
+	size_t number_of_failed_allocations; /* allocations and reallocations */
+	size_t number_of_invalid_deallocations; /* blocks which are not tracked, e.g. double free */
+	size_t number_of_live_blocks;
+	size_t current_number_of_bytes;
+	size_t peak_number_of_bytes;
+	size_t total_number_of_bytes_allocated;
+	double elapsed_seconds; /* wall-clock time since the tracker was initialized */
+} allocation_tracker_statistics_type;
+
+typedef struct allocation_tracker_type
+{
+	allocator_type allocator; /* the wrapped allocator */
+	allocation_tracker_record_type *records; /* hash table, the capacity is always a power of two */
+	size_t capacity;
+	allocation_tracker_statistics_type statistics;
+	size_t number_of_requests; /* allocations and reallocations, including the failed ones */
+	double start_time; /* wall-clock time in seconds */
+#if defined(ALLOCATION_TRACKER_POSIX)
+	pthread_mutex_t lock;
+#elif defined(ALLOCATION_TRACKER_WINDOWS)
+	void *lock; /* an SRWLOCK, which has the size of a pointer */
+#endif
+} allocation_tracker_type;
+
+/*
+Initializes an allocation tracker.
+
+Parameters:
+tracker  : A pointer to an allocation tracker. Must not be null.
+allocator: The allocator to be wrapped. Its 'allocate' and 'deallocate' function pointers must not be null.
+
+Return value: None.
+*/
+void allocation_tracker_init(allocation_tracker_type *tracker, allocator_type allocator);
+
+/*
+Releases the hash table and the lock of an allocation tracker. Memory blocks which are still alive are not deallocated.
+
+Parameter:
+tracker: A pointer to an initialized allocation tracker. Must not be null.
+
+Return value: None.
+*/
+void allocation_tracker_deinit(allocation_tracker_type *tracker);
+
+/*
+Sets the call site of the next allocation or reallocation of the calling thread.
+The call site is cleared by the next call of allocation_tracker_allocate, allocation_tracker_reallocate or
+allocation_tracker_deallocate of the thread, whether or not it allocates, so a call site is never attributed to a
+later, unrelated memory block.
+
+Parameters:
+tracker    : A pointer to an initialized allocation tracker. Must not be null.
+file_name  : The name or path of the source file which requests the memory block. Can be null.
+line_number: The line number of the source file at which the memory block is requested.
+
+Return value: None.
+*/
+void allocation_tracker_set_call_site(allocation_tracker_type *tracker, const char *file_name, int line_number);
+
+/*
+Allocates a memory block by using the wrapped allocator and records it.
+
+Return value: A pointer to the memory block, or null if the allocation fails.
+*/
+void *allocation_tracker_allocate(allocation_tracker_type *tracker, size_t number_of_bytes);
+
+/*
+Reallocates a memory block by using the wrapped allocator and updates its record.
+If memory_block is null, the function behaves like allocation_tracker_allocate.
+If new_number_of_bytes is zero, the function behaves like allocation_tracker_deallocate and returns null.
+If the wrapped allocator has no 'reallocate' function, 'allocate' and 'deallocate' are used instead.
+
+Return value: A pointer to the new memory block, or null if the reallocation fails.
+*/
+void *allocation_tracker_reallocate(allocation_tracker_type *tracker, void *memory_block, size_t new_number_of_bytes);
+
+/*
+Removes the record of a memory block and deallocates it by using the wrapped allocator.
+A memory block which is not tracked is not passed to the wrapped allocator and is counted as an invalid deallocation.
+
+Return value: None.
+*/
+void allocation_tracker_deallocate(allocation_tracker_type *tracker, void *memory_block);
+
+/*
+Returns the statistics of an allocation tracker. The elapsed time is measured when the function is called.
+*/
+allocation_tracker_statistics_type allocation_tracker_get_statistics(const allocation_tracker_type *tracker);
+
+/*
+Returns the allocation rate (number of allocations and reallocations per second of wall-clock time).
+*/
+double allocation_tracker_allocation_rate(const allocation_tracker_type *tracker);
+
+/*
+Prints every memory block which is still alive.
+
+Parameters:
+tracker: A pointer to an initialized allocation tracker. Must not be null.
+output : The output file. Must not be null.
+
+Return value: The number of memory blocks which are still alive.
+*/
+size_t allocation_tracker_report_leaks(const allocation_tracker_type *tracker, FILE *output);
+
+/*
+Prints the statistics and the memory blocks which are still alive.
+
+Parameters:
+tracker: A pointer to an initialized allocation tracker. Must not be null.
+output : The output file. Must not be null.
+
+Return value: None.
+*/
+void allocation_tracker_report(const allocation_tracker_type *tracker, FILE *output);
+
+/*
+Defines the functions for an allocator_type which forwards to an allocation tracker.
+
+Parameters:
+prefix : The prefix of the names of the generated functions.
+tracker: The name of an allocation tracker variable with static storage duration.
+
+Generated functions:
+prefix_allocate, prefix_reallocate and prefix_deallocate: For initializing an allocator_type.
+prefix_set_call_site: A call site handler which can be passed to dynamic_array_set_call_site_handler.
+prefix_report_at_exit: Prints the report to stderr. It can be passed to atexit.
+
+Usage example:
+
+static allocation_tracker_type tracker;
+ALLOCATION_TRACKER_DEFINE_ALLOCATOR(tracked, tracker)
+static allocator_type tracked_allocator = {&tracked_allocate, &tracked_reallocate, &tracked_deallocate};
+
+int main(void)
+{
+	allocator_type system_allocator = {&malloc, &realloc, &free};
+	allocation_tracker_init(&tracker, system_allocator);
+	dynamic_array_set_call_site_handler(&tracked_set_call_site);
+	(void) atexit(&tracked_report_at_exit);
+	...
+}
+*/
+#define ALLOCATION_TRACKER_DEFINE_ALLOCATOR(prefix, tracker) \
+	static void *CONCATENATE(prefix, _allocate)(size_t number_of_bytes) \
+	{ \
+		return allocation_tracker_allocate(&(tracker), number_of_bytes); \
+	} \
+	static void *CONCATENATE(prefix, _reallocate)(void *memory_block, size_t number_of_bytes) \
+	{ \
+		return allocation_tracker_reallocate(&(tracker), memory_block, number_of_bytes); \
+	} \
+	static void CONCATENATE(prefix, _deallocate)(void *memory_block) \
+	{ \
+		allocation_tracker_deallocate(&(tracker), memory_block); \
+	} \
+	static void CONCATENATE(prefix, _set_call_site)(const allocator_type *allocator, const char *file_name, int line_number) \
+	{ \
+		if (allocator != NULL && allocator->allocate == &CONCATENATE(prefix, _allocate)) { \
+			allocation_tracker_set_call_site(&(tracker), file_name, line_number); \
+		} \
+	} \
+	static void CONCATENATE(prefix, _report_at_exit)(void) \
+	{ \
+		allocation_tracker_report(&(tracker), stderr); \
+	}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
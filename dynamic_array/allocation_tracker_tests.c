@@ -0,0 +1,338 @@
+#if defined(__unix__) || defined(__APPLE__)
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L /* for pthread.h */
+#endif
+#endif
+
+#include "allocation_tracker.h"
+#include "dynamic_array.h"
+#include "unit_testing.h"
+#include <stdlib.h>
+#include <string.h>
+
+static allocation_tracker_type s_tracker;
+
+ALLOCATION_TRACKER_DEFINE_ALLOCATOR(tracked, s_tracker)
+
+static void tracker_init(void)
+{
+	allocator_type system_allocator = {&malloc, &realloc, &free};
+	allocation_tracker_init(&s_tracker, system_allocator);
+}
+
+static void tracker_init_without_reallocation(void)
+{
+	allocator_type system_allocator = {&malloc, NULL, &free};
+	allocation_tracker_init(&s_tracker, system_allocator);
+}
+
+TEST(allocation_and_deallocation, "Allocations and deallocations are counted")
+{
+	allocation_tracker_statistics_type statistics;
+	void *block1 = NULL;
+	void *block2 = NULL;
+
+	tracker_init();
+	block1 = allocation_tracker_allocate(&s_tracker, 100U);
+	block2 = allocation_tracker_allocate(&s_tracker, 50U);
+	ASSERT(block1 != NULL);
+	ASSERT(block2 != NULL);
+
+	statistics = allocation_tracker_get_statistics(&s_tracker);
+	ASSERT_UINT_EQUAL(statistics.number_of_allocations, 2U);
+	ASSERT_UINT_EQUAL(statistics.number_of_live_blocks, 2U);
+	ASSERT_UINT_EQUAL(statistics.current_number_of_bytes, 150U);
+	ASSERT_UINT_EQUAL(statistics.peak_number_of_bytes, 150U);
+
+	allocation_tracker_deallocate(&s_tracker, block1);
+	statistics = allocation_tracker_get_statistics(&s_tracker);
+	ASSERT_UINT_EQUAL(statistics.number_of_deallocations, 1U);
+	ASSERT_UINT_EQUAL(statistics.number_of_live_blocks, 1U);
+	ASSERT_UINT_EQUAL(statistics.current_number_of_bytes, 50U);
+	ASSERT_UINT_EQUAL(statistics.peak_number_of_bytes, 150U);
+
+	allocation_tracker_deallocate(&s_tracker, block2);
+	statistics = allocation_tracker_get_statistics(&s_tracker);
+	ASSERT_UINT_EQUAL(statistics.number_of_live_blocks, 0U);
+	ASSERT_UINT_EQUAL(statistics.current_number_of_bytes, 0U);
+	ASSERT_UINT_EQUAL(statistics.total_number_of_bytes_allocated, 150U);
+	ASSERT_UINT_EQUAL(allocation_tracker_report_leaks(&s_tracker, stdout), 0U);
+	allocation_tracker_deinit(&s_tracker);
+}
+
+TEST(reallocation, "Reallocation updates the record of a memory block")
+{
+	allocation_tracker_statistics_type statistics;
+	char *block = NULL;
+
+	tracker_init();
+	block = (char*) allocation_tracker_allocate(&s_tracker, 4U);
+	memcpy(block, "abc", 4U);
+	block = (char*) allocation_tracker_reallocate(&s_tracker, block, 4096U);
+	ASSERT(block != NULL);
+	ASSERT_EQUAL(memcmp(block, "abc", 4U), 0);
+
+	statistics = allocation_tracker_get_statistics(&s_tracker);
+	ASSERT_UINT_EQUAL(statistics.number_of_reallocations, 1U);
+	ASSERT_UINT_EQUAL(statistics.number_of_live_blocks, 1U);
+	ASSERT_UINT_EQUAL(statistics.current_number_of_bytes, 4096U);
+	ASSERT_UINT_EQUAL(statistics.peak_number_of_bytes, 4096U);
+
+	block = (char*) allocation_tracker_reallocate(&s_tracker, block, 0U);
+	ASSERT(block == NULL);
+	statistics = allocation_tracker_get_statistics(&s_tracker);
+	ASSERT_UINT_EQUAL(statistics.number_of_live_blocks, 0U);
+	ASSERT_UINT_EQUAL(statistics.current_number_of_bytes, 0U);
+	allocation_tracker_deinit(&s_tracker);
+}
+
+TEST(reallocation_without_reallocation_function, "Reallocation uses the recorded size if the allocator cannot reallocate")
+{
+	allocation_tracker_statistics_type statistics;
+	char *block = NULL;
+
+	tracker_init_without_reallocation();
+	block = (char*) allocation_tracker_allocate(&s_tracker, 8U);
+	memcpy(block, "1234567", 8U);
+	block = (char*) allocation_tracker_reallocate(&s_tracker, block, 16U);
+	ASSERT(block != NULL);
+	ASSERT_EQUAL(memcmp(block, "1234567", 8U), 0);
+
+	statistics = allocation_tracker_get_statistics(&s_tracker);
+	ASSERT_UINT_EQUAL(statistics.number_of_live_blocks, 1U);
+	ASSERT_UINT_EQUAL(statistics.current_number_of_bytes, 16U);
+
+	allocation_tracker_deallocate(&s_tracker, block);
+	allocation_tracker_deinit(&s_tracker);
+}
+
+TEST(leaks_and_invalid_deallocations, "Leaks and invalid deallocations are reported")
+{
+	allocation_tracker_statistics_type statistics;
+	void *block1 = NULL;
+	void *block2 = NULL;
+
+	tracker_init();
+	block1 = allocation_tracker_allocate(&s_tracker, 10U);
+	block2 = allocation_tracker_allocate(&s_tracker, 20U);
+	allocation_tracker_deallocate(&s_tracker, block1);
+	allocation_tracker_deallocate(&s_tracker, block1); /* double free is not forwarded */
+
+	statistics = allocation_tracker_get_statistics(&s_tracker);
+	ASSERT_UINT_EQUAL(statistics.number_of_invalid_deallocations, 1U);
+	ASSERT_UINT_EQUAL(allocation_tracker_report_leaks(&s_tracker, stdout), 1U);
+
+	allocation_tracker_deallocate(&s_tracker, block2);
+	allocation_tracker_deinit(&s_tracker);
+}
+
+TEST(many_live_blocks, "The hash table grows with the number of live blocks")
+{
+	enum { number_of_blocks = 1000 };
+	static void *blocks[number_of_blocks];
+	allocation_tracker_statistics_type statistics;
+	size_t i = 0U;
+
+	tracker_init();
+	for (i = 0U; i < number_of_blocks; ++i) {
+		blocks[i] = allocation_tracker_allocate(&s_tracker, i + 1U);
+	}
+
+	statistics = allocation_tracker_get_statistics(&s_tracker);
+	ASSERT_UINT_EQUAL(statistics.number_of_live_blocks, number_of_blocks);
+	ASSERT_UINT_EQUAL(statistics.current_number_of_bytes, (number_of_blocks * (number_of_blocks + 1U)) / 2U);
+
+	for (i = 0U; i < number_of_blocks; i += 2U) {
+		allocation_tracker_deallocate(&s_tracker, blocks[i]);
+	}
+	for (i = 1U; i < number_of_blocks; i += 2U) {
+		allocation_tracker_deallocate(&s_tracker, blocks[i]);
+	}
+
+	statistics = allocation_tracker_get_statistics(&s_tracker);
+	ASSERT_UINT_EQUAL(statistics.number_of_live_blocks, 0U);
+	ASSERT_UINT_EQUAL(statistics.current_number_of_bytes, 0U);
+	ASSERT_UINT_EQUAL(statistics.number_of_invalid_deallocations, 0U);
+	allocation_tracker_deinit(&s_tracker);
+}
+
+TEST(call_site_from_dynamic_array, "The call site of a dynamic array is recorded")
+{
+	allocator_type tracked_allocator = {&tracked_allocate, &tracked_reallocate, &tracked_deallocate};
+	dynamic_array_type(int) array;
+	const int expected_line_number = __LINE__ + 5;
+	size_t index = 0U;
+
+	tracker_init();
+	dynamic_array_set_call_site_handler(&tracked_set_call_site);
+	array = dynamic_array_create_with_allocator(int, 4U, tracked_allocator);
+
+	for (index = 0U; index < s_tracker.capacity; ++index) {
+		if (s_tracker.records[index].memory_block != NULL) {
+			break;
+		}
+	}
+	ASSERT(index < s_tracker.capacity);
+	if (index < s_tracker.capacity) {
+		ASSERT(s_tracker.records[index].file_name != NULL);
+		ASSERT_EQUAL(s_tracker.records[index].line_number, expected_line_number);
+	}
+
+	ASSERT_UINT_EQUAL(allocation_tracker_report_leaks(&s_tracker, stdout), 1U);
+	dynamic_array_delete(array);
+	ASSERT_UINT_EQUAL(allocation_tracker_report_leaks(&s_tracker, stdout), 0U);
+	dynamic_array_set_call_site_handler(NULL);
+	allocation_tracker_deinit(&s_tracker);
+}
+
+static const allocation_tracker_record_type *find_record(const void *memory_block)
+{
+	size_t index = 0U;
+	for (index = 0U; index < s_tracker.capacity; ++index) {
+		if (s_tracker.records[index].memory_block == memory_block) {
+			return &s_tracker.records[index];
+		}
+	}
+	return NULL;
+}
+
+TEST(sequence_numbers, "Each record holds the sequence number of the request which allocated it")
+{
+	void *block1 = NULL;
+	void *block2 = NULL;
+	const allocation_tracker_record_type *record = NULL;
+
+	tracker_init();
+	block1 = allocation_tracker_allocate(&s_tracker, 10U);
+	block2 = allocation_tracker_allocate(&s_tracker, 20U);
+	block1 = allocation_tracker_reallocate(&s_tracker, block1, 1000U);
+	ASSERT(block1 != NULL);
+	ASSERT(block2 != NULL);
+
+	record = find_record(block1);
+	ASSERT(record != NULL);
+	if (record != NULL) {
+		ASSERT_UINT_EQUAL(record->sequence_number, 3U);
+	}
+	record = find_record(block2);
+	ASSERT(record != NULL);
+	if (record != NULL) {
+		ASSERT_UINT_EQUAL(record->sequence_number, 2U);
+	}
+
+	allocation_tracker_deallocate(&s_tracker, block1);
+	allocation_tracker_deallocate(&s_tracker, block2);
+	allocation_tracker_deinit(&s_tracker);
+}
+
+TEST(call_site_is_cleared, "A call site is not attributed to a later allocation")
+{
+	void *block1 = NULL;
+	void *block2 = NULL;
+	const allocation_tracker_record_type *record = NULL;
+
+	tracker_init();
+	block1 = allocation_tracker_allocate(&s_tracker, 10U);
+
+	/* the operation which the call site was set for deallocates instead */
+	allocation_tracker_set_call_site(&s_tracker, __FILE__, __LINE__);
+	block1 = allocation_tracker_reallocate(&s_tracker, block1, 0U);
+	ASSERT(block1 == NULL);
+	block2 = allocation_tracker_allocate(&s_tracker, 20U);
+	record = find_record(block2);
+	ASSERT(record != NULL);
+	if (record != NULL) {
+		ASSERT(record->file_name == NULL);
+	}
+	allocation_tracker_deallocate(&s_tracker, block2);
+
+	/* the operation which the call site was set for does not reach the tracker's hash table */
+	allocation_tracker_set_call_site(&s_tracker, __FILE__, __LINE__);
+	allocation_tracker_deallocate(&s_tracker, NULL);
+	block2 = allocation_tracker_allocate(&s_tracker, 20U);
+	record = find_record(block2);
+	ASSERT(record != NULL);
+	if (record != NULL) {
+		ASSERT(record->file_name == NULL);
+	}
+	allocation_tracker_deallocate(&s_tracker, block2);
+
+	ASSERT_UINT_EQUAL(allocation_tracker_report_leaks(&s_tracker, stdout), 0U);
+	allocation_tracker_deinit(&s_tracker);
+}
+
+#if defined(ALLOCATION_TRACKER_POSIX)
+
+enum {
+	number_of_threads = 4,
+	number_of_blocks_per_thread = 1000
+};
+
+static void *allocate_and_deallocate(void *argument)
+{
+	static void *blocks[number_of_threads][number_of_blocks_per_thread];
+	const size_t thread_index = *(const size_t*) argument;
+	size_t i = 0U;
+
+	for (i = 0U; i < number_of_blocks_per_thread; ++i) {
+		blocks[thread_index][i] = allocation_tracker_allocate(&s_tracker, i + 1U);
+	}
+	for (i = 0U; i < number_of_blocks_per_thread; ++i) {
+		blocks[thread_index][i] = allocation_tracker_reallocate(&s_tracker, blocks[thread_index][i], 2U * (i + 1U));
+	}
+	for (i = 0U; i < number_of_blocks_per_thread; ++i) {
+		allocation_tracker_deallocate(&s_tracker, blocks[thread_index][i]);
+	}
+	return NULL;
+}
+
+TEST(several_threads, "Several threads can share a tracker")
+{
+	pthread_t threads[number_of_threads];
+	size_t thread_indices[number_of_threads];
+	allocation_tracker_statistics_type statistics;
+	size_t i = 0U;
+
+	tracker_init();
+	for (i = 0U; i < number_of_threads; ++i) {
+		thread_indices[i] = i;
+		ASSERT_EQUAL(pthread_create(&threads[i], NULL, &allocate_and_deallocate, &thread_indices[i]), 0);
+	}
+	for (i = 0U; i < number_of_threads; ++i) {
+		(void) pthread_join(threads[i], NULL);
+	}
+
+	statistics = allocation_tracker_get_statistics(&s_tracker);
+	ASSERT_UINT_EQUAL(statistics.number_of_allocations, number_of_threads * number_of_blocks_per_thread);
+	ASSERT_UINT_EQUAL(statistics.number_of_reallocations, number_of_threads * number_of_blocks_per_thread);
+	ASSERT_UINT_EQUAL(statistics.number_of_deallocations, number_of_threads * number_of_blocks_per_thread);
+	ASSERT_UINT_EQUAL(statistics.number_of_live_blocks, 0U);
+	ASSERT_UINT_EQUAL(statistics.current_number_of_bytes, 0U);
+	ASSERT_UINT_EQUAL(statistics.number_of_invalid_deallocations, 0U);
+	allocation_tracker_deinit(&s_tracker);
+}
+
+#endif
+
+int main(void)
+{
+	DEFINE_LIST_OF_TESTS(tests) {
+		allocation_and_deallocation,
+		reallocation,
+		reallocation_without_reallocation_function,
+		leaks_and_invalid_deallocations,
+		many_live_blocks,
+		call_site_from_dynamic_array,
+		sequence_numbers,
+		call_site_is_cleared
+#if defined(ALLOCATION_TRACKER_POSIX)
+		, several_threads
+#endif
+	};
+
+	PRINT_FILE_NAME();
+	RUN_TESTS(tests);
+	PRINT_TEST_STATISTICS(tests);
+
+	return 0;
+}
@@ -0,0 +1,128 @@
+#include "block_pool.h"
+#include "static_assert.h"
+#include <assert.h>
+#include <iso646.h>
+#include <string.h>
+
+STATIC_ASSERT(sizeof(block_pool_storage_unit_type) >= sizeof(void*), "A block must be able to hold a pointer.");
+STATIC_ASSERT(sizeof(size_t) == sizeof(void*), "size_t and pointer type must have the same size.");
+
+size_t block_pool_init(block_pool_type *pool, void *buffer, size_t buffer_size, size_t block_size)
+{
+	const size_t unit_size = sizeof(block_pool_storage_unit_type);
+
+	assert(pool != NULL);
+	assert(buffer != NULL);
+	assert(((size_t) buffer % unit_size) == 0U);
+	if (pool == NULL) {
+		return 0U;
+	}
+
+	memset(pool, 0, sizeof(*pool));
+	if (buffer == NULL or ((size_t) buffer % unit_size) != 0U or block_size > ((size_t) -1) - unit_size) {
+		return 0U;
+	}
+
+	pool->buffer = (unsigned char*) buffer;
+	pool->block_size = BLOCK_POOL_ROUNDED_BLOCK_SIZE(block_size);
+	pool->number_of_blocks = buffer_size / pool->block_size;
+	pool->number_of_free_blocks = pool->number_of_blocks;
+	pool->number_of_untouched_blocks = pool->number_of_blocks;
+	pool->free_list = NULL;
+	return pool->number_of_blocks;
+}
+
+void *block_pool_allocate(block_pool_type *pool, size_t number_of_bytes)
+{
+	void *memory_block = NULL;
+
+	assert(pool != NULL);
+	if (pool == NULL or number_of_bytes > pool->block_size) {
+		return NULL;
+	}
+
+	if (pool->free_list != NULL) {
+		memory_block = pool->free_list;
+		memcpy(&pool->free_list, memory_block, sizeof(pool->free_list));
+		--pool->number_of_free_blocks;
+	} else if (pool->number_of_untouched_blocks > 0U) {
+		const size_t index = pool->number_of_blocks - pool->number_of_untouched_blocks;
+		memory_block = &pool->buffer[index * pool->block_size];
+		--pool->number_of_untouched_blocks;
+		--pool->number_of_free_blocks;
+	}
+
+	return memory_block;
+}
+
+void *block_pool_reallocate(block_pool_type *pool, void *memory_block, size_t new_number_of_bytes)
+{
+	assert(pool != NULL);
+	if (pool == NULL) {
+		return NULL;
+	}
+
+	if (memory_block == NULL) {
+		return block_pool_allocate(pool, new_number_of_bytes);
+	}
+
+	if (new_number_of_bytes == 0U) {
+		block_pool_deallocate(pool, memory_block);
+		return NULL;
+	}
+
+	assert(block_pool_owns(pool, memory_block));
+	return (new_number_of_bytes <= pool->block_size) ? memory_block : NULL;
+}
+
+void block_pool_deallocate(block_pool_type *pool, void *memory_block)
+{
+	assert(pool != NULL);
+	if (pool == NULL or memory_block == NULL) {
+		return;
+	}
+
+	assert(block_pool_owns(pool, memory_block));
+	assert(pool->number_of_free_blocks < pool->number_of_blocks);
+	memcpy(memory_block, &pool->free_list, sizeof(pool->free_list));
+	pool->free_list = memory_block;
+	++pool->number_of_free_blocks;
+}
+
+size_t block_pool_block_size(const block_pool_type *pool)
+{
+	assert(pool != NULL);
+	return (pool != NULL) ? pool->block_size : 0U;
+}
+
+size_t block_pool_capacity(const block_pool_type *pool)
+{
+	assert(pool != NULL);
+	return (pool != NULL) ? pool->number_of_blocks : 0U;
+}
+
+size_t block_pool_number_of_free_blocks(const block_pool_type *pool)
+{
+	assert(pool != NULL);
+	return (pool != NULL) ? pool->number_of_free_blocks : 0U;
+}
+
+Boolean_type block_pool_owns(const block_pool_type *pool, const void *memory_block)
+{
+	size_t address = (size_t) memory_block;
+	size_t first_address = 0U;
+	size_t offset = 0U;
+
+	assert(pool != NULL);
+	if (pool == NULL or pool->buffer == NULL or memory_block == NULL) {
+		return Boolean_false;
+	}
+
+	first_address = (size_t) pool->buffer;
+	if (address < first_address) {
+		return Boolean_false;
+	}
+
+	offset = address - first_address;
+	return (offset < (pool->number_of_blocks * pool->block_size)) and ((offset % pool->block_size) == 0U);
+}
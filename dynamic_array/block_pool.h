@@ -0,0 +1,147 @@
+/* Minimum C Standard: C89 */
+
+#ifndef BLOCK_POOL_H
+#define BLOCK_POOL_H
+
+#include "allocator_type.h"
+#include "Boolean_type.h"
+#include "macro_concatenate.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+A block pool manages a fixed number of memory blocks of the same size in a buffer provided by the user.
+Free blocks are linked through an intrusive free list, so allocation and deallocation are O(1) and any number of
+blocks (up to the capacity) can be alive at the same time. Blocks which have never been allocated are handed out
+in address order, so initialization is also O(1).
+
+Every block is aligned to sizeof(block_pool_storage_unit_type), which is suitable for any fundamental type.
+
+The pool is not thread-safe.
+*/
+
+typedef union block_pool_storage_unit_type
+{
+	void *pointer;
+	void (*function_pointer)(void);
+	long integer;
+	double floating_point;
+	long double extended_floating_point;
+} block_pool_storage_unit_type;
+
+typedef struct block_pool_type
+{
+	unsigned char *buffer;
+	size_t block_size; /* number of bytes of each block after rounding */
+	size_t number_of_blocks;
+	size_t number_of_free_blocks;
+	size_t number_of_untouched_blocks; /* blocks at the end of the buffer which have never been allocated */
+	void *free_list; /* first free block which has been allocated and deallocated before */
+} block_pool_type;
+
+/* The number of bytes of each block after rounding up to a multiple of the storage unit size */
+#define BLOCK_POOL_ROUNDED_BLOCK_SIZE(block_size) \
+	((((block_size) > 0U ? (block_size) : 1U) + sizeof(block_pool_storage_unit_type) - 1U) / \
+	sizeof(block_pool_storage_unit_type) * sizeof(block_pool_storage_unit_type))
+
+/* The number of bytes of a buffer which can hold number_of_blocks blocks of block_size bytes */
+#define BLOCK_POOL_BUFFER_SIZE(block_size, number_of_blocks) \
+	(BLOCK_POOL_ROUNDED_BLOCK_SIZE(block_size) * (number_of_blocks))
+
+/*
+Defines a suitably aligned static buffer for a block pool which is configured at compile time.
+
+Usage example:
+
+BLOCK_POOL_DEFINE_STORAGE(node_storage, sizeof(node_type), 1024);
+static block_pool_type node_pool;
+...
+block_pool_init(&node_pool, node_storage, sizeof(node_storage), sizeof(node_type));
+*/
+#define BLOCK_POOL_DEFINE_STORAGE(name, block_size, number_of_blocks) \
+	static block_pool_storage_unit_type name[BLOCK_POOL_BUFFER_SIZE(block_size, number_of_blocks) / sizeof(block_pool_storage_unit_type)]
+
+/*
+Initializes a block pool.
+
+Parameters:
+pool       : A pointer to a block pool. Must not be null.
+buffer     : The memory used by the pool. Must be aligned to sizeof(block_pool_storage_unit_type) and must outlive the pool.
+buffer_size: The number of bytes of the buffer.
+block_size : The number of bytes of each block. It is rounded up to a multiple of sizeof(block_pool_storage_unit_type).
+
+Return value: The number of blocks that the pool can hold.
+*/
+size_t block_pool_init(block_pool_type *pool, void *buffer, size_t buffer_size, size_t block_size);
+
+/*
+Allocates a block. O(1).
+
+Return value: A pointer to a block, or null if number_of_bytes is greater than the block size or if there is no free block.
+*/
+void *block_pool_allocate(block_pool_type *pool, size_t number_of_bytes);
+
+/*
+Reallocates a block. A block cannot grow beyond the block size, so the same block is returned if it is large enough.
+If memory_block is null, the function behaves like block_pool_allocate.
+If new_number_of_bytes is zero, the block is deallocated and the returned pointer is null.
+
+Return value: memory_block or a new block, or null if the reallocation fails. On failure, memory_block remains valid.
+*/
+void *block_pool_reallocate(block_pool_type *pool, void *memory_block, size_t new_number_of_bytes);
+
+/*
+Returns a block to the pool. O(1). No action is taken if memory_block is null.
+memory_block MUST point to a block allocated from the same pool.
+*/
+void block_pool_deallocate(block_pool_type *pool, void *memory_block);
+
+/* Returns the number of bytes of each block after rounding. */
+size_t block_pool_block_size(const block_pool_type *pool);
+
+/* Returns the number of blocks that the pool can hold. */
+size_t block_pool_capacity(const block_pool_type *pool);
+
+/* Returns the number of blocks which are not allocated. */
+size_t block_pool_number_of_free_blocks(const block_pool_type *pool);
+
+/* Returns true if the memory block points to a block of the pool. */
+Boolean_type block_pool_owns(const block_pool_type *pool, const void *memory_block);
+
+/*
+Defines the functions for an allocator_type which forwards to a block pool.
+
+Parameters:
+prefix: The prefix of the names of the generated functions.
+pool  : The name of a block pool variable with static storage duration.
+
+Generated functions: prefix_allocate, prefix_reallocate and prefix_deallocate.
+
+Usage example:
+
+static block_pool_type pool;
+BLOCK_POOL_DEFINE_ALLOCATOR(pooled, pool)
+static allocator_type pool_allocator = {&pooled_allocate, &pooled_reallocate, &pooled_deallocate};
+*/
+#define BLOCK_POOL_DEFINE_ALLOCATOR(prefix, pool) \
+	static void *CONCATENATE(prefix, _allocate)(size_t number_of_bytes) \
+	{ \
+		return block_pool_allocate(&(pool), number_of_bytes); \
+	} \
+	static void *CONCATENATE(prefix, _reallocate)(void *memory_block, size_t number_of_bytes) \
+	{ \
+		return block_pool_reallocate(&(pool), memory_block, number_of_bytes); \
+	} \
+	static void CONCATENATE(prefix, _deallocate)(void *memory_block) \
+	{ \
+		block_pool_deallocate(&(pool), memory_block); \
+	}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
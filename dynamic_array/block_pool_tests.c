@@ -0,0 +1,163 @@
+#include "block_pool.h"
+#include "dynamic_array.h"
+#include "unit_testing.h"
+#include <iso646.h>
+#include <stddef.h>
+#include <string.h>
+
+enum {
+	test_block_size = 24,
+	test_number_of_blocks = 16
+};
+
+BLOCK_POOL_DEFINE_STORAGE(s_storage, test_block_size, test_number_of_blocks);
+static block_pool_type s_pool;
+
+BLOCK_POOL_DEFINE_ALLOCATOR(pooled, s_pool)
+
+static size_t test_pool_init(void)
+{
+	return block_pool_init(&s_pool, s_storage, sizeof(s_storage), test_block_size);
+}
+
+TEST(initialization, "A pool configured at compile time holds the requested number of blocks")
+{
+	const size_t capacity = test_pool_init();
+	ASSERT_UINT_EQUAL(capacity, test_number_of_blocks);
+	ASSERT_UINT_EQUAL(block_pool_capacity(&s_pool), test_number_of_blocks);
+	ASSERT_UINT_EQUAL(block_pool_number_of_free_blocks(&s_pool), test_number_of_blocks);
+	ASSERT_UINT_GREATER_OR_EQUAL(block_pool_block_size(&s_pool), test_block_size);
+	ASSERT_UINT_EQUAL(block_pool_block_size(&s_pool) % sizeof(block_pool_storage_unit_type), 0U);
+}
+
+TEST(many_live_blocks, "All blocks can be alive at the same time")
+{
+	void *blocks[test_number_of_blocks];
+	size_t i = 0U, j = 0U;
+
+	(void) test_pool_init();
+	for (i = 0U; i < test_number_of_blocks; ++i) {
+		blocks[i] = block_pool_allocate(&s_pool, test_block_size);
+		ASSERT(blocks[i] != NULL);
+		ASSERT(block_pool_owns(&s_pool, blocks[i]));
+		memset(blocks[i], (int) i, test_block_size);
+	}
+	ASSERT_UINT_EQUAL(block_pool_number_of_free_blocks(&s_pool), 0U);
+	ASSERT(block_pool_allocate(&s_pool, 1U) == NULL);
+
+	for (i = 0U; i < test_number_of_blocks; ++i) {
+		const unsigned char *bytes = (const unsigned char*) blocks[i];
+		for (j = 0U; j < test_block_size; ++j) {
+			if (bytes[j] != (unsigned char) i) {
+				break;
+			}
+		}
+		ASSERT_UINT_EQUAL(j, test_block_size);
+	}
+
+	for (i = 0U; i < test_number_of_blocks; ++i) {
+		block_pool_deallocate(&s_pool, blocks[i]);
+	}
+	ASSERT_UINT_EQUAL(block_pool_number_of_free_blocks(&s_pool), test_number_of_blocks);
+}
+
+TEST(block_reuse, "The most recently deallocated block is reused first")
+{
+	void *block1 = NULL;
+	void *block2 = NULL;
+	void *block3 = NULL;
+
+	(void) test_pool_init();
+	block1 = block_pool_allocate(&s_pool, 1U);
+	block2 = block_pool_allocate(&s_pool, 1U);
+	ASSERT(block1 != block2);
+	block_pool_deallocate(&s_pool, block1);
+	block3 = block_pool_allocate(&s_pool, 1U);
+	ASSERT(block3 == block1);
+	block_pool_deallocate(&s_pool, block2);
+	block_pool_deallocate(&s_pool, block3);
+	ASSERT_UINT_EQUAL(block_pool_number_of_free_blocks(&s_pool), test_number_of_blocks);
+}
+
+TEST(oversized_requests, "Requests larger than the block size fail")
+{
+	void *block = NULL;
+	size_t block_size = 0U;
+
+	(void) test_pool_init();
+	block_size = block_pool_block_size(&s_pool);
+	ASSERT(block_pool_allocate(&s_pool, block_size + 1U) == NULL);
+
+	block = block_pool_allocate(&s_pool, 1U);
+	ASSERT(block_pool_reallocate(&s_pool, block, block_size) == block);
+	ASSERT(block_pool_reallocate(&s_pool, block, block_size + 1U) == NULL);
+	ASSERT(block_pool_reallocate(&s_pool, block, 0U) == NULL);
+	ASSERT_UINT_EQUAL(block_pool_number_of_free_blocks(&s_pool), test_number_of_blocks);
+}
+
+TEST(ownership, "Only blocks of the pool are owned by the pool")
+{
+	int variable = 0;
+	void *block = NULL;
+
+	(void) test_pool_init();
+	block = block_pool_allocate(&s_pool, 1U);
+	ASSERT(block_pool_owns(&s_pool, block));
+	ASSERT(not block_pool_owns(&s_pool, (unsigned char*) block + 1));
+	ASSERT(not block_pool_owns(&s_pool, &variable));
+	ASSERT(not block_pool_owns(&s_pool, NULL));
+	block_pool_deallocate(&s_pool, block);
+}
+
+TEST(pool_initialized_at_runtime, "A pool configured at initialization time")
+{
+	block_pool_storage_unit_type buffer[32];
+	block_pool_type pool;
+	size_t capacity = 0U;
+	void *block = NULL;
+
+	capacity = block_pool_init(&pool, buffer, sizeof(buffer), 2U * sizeof(block_pool_storage_unit_type));
+	ASSERT_UINT_EQUAL(capacity, 16U);
+	block = block_pool_allocate(&pool, 1U);
+	ASSERT(block == (void*) &buffer[0]);
+	block = block_pool_allocate(&pool, 1U);
+	ASSERT(block == (void*) &buffer[2]);
+}
+
+TEST(dynamic_array_with_block_pool, "A dynamic array can use a block pool through allocator_type")
+{
+	allocator_type pool_allocator = {&pooled_allocate, &pooled_reallocate, &pooled_deallocate};
+	dynamic_array_type(char) array1;
+	dynamic_array_type(char) array2;
+
+	(void) test_pool_init();
+	array1 = dynamic_array_create_with_allocator(char, 4U, pool_allocator);
+	array2 = dynamic_array_create_with_allocator(char, 8U, pool_allocator);
+	ASSERT_UINT_EQUAL(block_pool_number_of_free_blocks(&s_pool), test_number_of_blocks - 2U);
+	dynamic_array_element(char, array1, 0U) = 'a';
+	dynamic_array_element(char, array2, 0U) = 'b';
+	ASSERT_EQUAL(dynamic_array_element(char, array1, 0U), 'a');
+	ASSERT_EQUAL(dynamic_array_element(char, array2, 0U), 'b');
+	dynamic_array_delete(array1);
+	dynamic_array_delete(array2);
+	ASSERT_UINT_EQUAL(block_pool_number_of_free_blocks(&s_pool), test_number_of_blocks);
+}
+
+int main(void)
+{
+	DEFINE_LIST_OF_TESTS(tests) {
+		initialization,
+		many_live_blocks,
+		block_reuse,
+		oversized_requests,
+		ownership,
+		pool_initialized_at_runtime,
+		dynamic_array_with_block_pool
+	};
+
+	PRINT_FILE_NAME();
+	RUN_TESTS(tests);
+	PRINT_TEST_STATISTICS(tests);
+
+	return 0;
+}
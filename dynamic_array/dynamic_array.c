@@ -109,6 +109,15 @@ static void dynamic_array_handle_exception(dynamic_array_error_type error)
 	}
 }
 
+static void (*s_call_site_handler_funcptr)(const dynamic_array_allocator_type*, const char*, int) = NULL;
+
+static void dynamic_array_notify_call_site(const dynamic_array_allocator_type *allocator, const char *file_name, int line_number)
+{
+	if (s_call_site_handler_funcptr != NULL) {
+		s_call_site_handler_funcptr(allocator, file_name, line_number);
+	}
+}
+
 static void dynamic_array_terminate(void)
 {
 	exit(EXIT_FAILURE);
@@ -191,6 +200,13 @@ void dynamic_array_set_error_reporting_handler(
 	s_report_error_funcptr = report_error_funcptr;
 }
 
+void dynamic_array_set_call_site_handler(
+	void (*call_site_handler_funcptr)(const dynamic_array_allocator_type*, const char*, int)
+)
+{
+	s_call_site_handler_funcptr = call_site_handler_funcptr;
+}
+
 dynamic_array_error_type
 dynamic_array_check_(
 	const dynamic_array_type_ *dynamic_array,
@@ -298,6 +314,7 @@ dynamic_array_create_(
 
 	assert(allocator != NULL);
 	number_of_bytes = initial_capacity * element_size;
+	dynamic_array_notify_call_site(allocator, file_name, line_number);
 	ptr = allocator_allocate(*allocator, number_of_bytes);
 	if (ptr != NULL) {
 		if (source != NULL) {
@@ -605,6 +622,7 @@ void dynamic_array_add_elements_at_index_(
 #endif
 		old_byte_count = array->capacity * array->element_size;
 		new_byte_count = new_capacity * array->element_size;
+		dynamic_array_notify_call_site(array->allocator, file_name, line_number);
 		ptr = allocator_reallocate(*(array->allocator), array->ptr, old_byte_count, new_byte_count);
 		if (ptr != NULL) {
 			array->ptr = ptr;
@@ -793,6 +811,7 @@ void dynamic_array_resize_(
 #endif
 			old_byte_count = array->capacity * array->element_size;
 			new_byte_count = new_capacity * array->element_size;
+			dynamic_array_notify_call_site(array->allocator, file_name, line_number);
 			ptr = allocator_reallocate(*(array->allocator), array->ptr, old_byte_count, new_byte_count);
 			if (ptr != NULL) {
 				array->ptr = ptr;
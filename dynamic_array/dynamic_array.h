@@ -103,6 +103,31 @@ void dynamic_array_set_error_reporting_handler(
 	void (*report_error_funcptr)(dynamic_array_debug_info_type)
 );
 
+/*
+Provides a call site handler callback function.
+The handler is called right before a dynamic array allocates or reallocates its internal buffer.
+It receives the allocator which is about to be used and the source location passed through the dynamic array macros,
+so that an allocator which tracks memory blocks can record where each block is requested.
+
+Parameter:
+call_site_handler_funcptr: A pointer to a call site handler function. Can be NULL to remove the current handler.
+
+Return value: None.
+
+Function signature of call site handler:
+void call_site_handler(const dynamic_array_allocator_type *allocator, const char *file_name, int line_number);
+
+Parameters:
+allocator  : The allocator which will perform the allocation or reallocation.
+file_name  : The name or path of the source file which calls the dynamic array function.
+line_number: The line number of the source file at which the dynamic array function is called.
+
+Return value: None.
+*/
+void dynamic_array_set_call_site_handler(
+	void (*call_site_handler_funcptr)(const dynamic_array_allocator_type*, const char*, int)
+);
+
 /*
 Function declarations and macros
 Most functions will invoke the exception handler on error.
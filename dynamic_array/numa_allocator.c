@@ -0,0 +1,344 @@
+#if defined(__linux__)
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* for mremap and syscall */
+#endif
+#define NUMA_ALLOCATOR_LINUX 1
+#else
+#define NUMA_ALLOCATOR_LINUX 0
+#endif
+
+#include "numa_allocator.h"
+#include <assert.h>
+#include <iso646.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if NUMA_ALLOCATOR_LINUX
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/* Notes:
+- On Linux, every memory block is a separate anonymous mapping. The first numa_allocator_header_size bytes of the
+  mapping store the size of the mapping, so the returned pointer is aligned to a cache line.
+- The system calls are invoked directly, so the library does not depend on libnuma.
+- The nodes are detected once, by the first allocation of any thread, under pthread_once. The other threads wait for
+  the detection and only read the nodes afterwards.
+*/
+
+#if NUMA_ALLOCATOR_LINUX
+
+enum {
+	numa_allocator_header_size = 64,
+	numa_allocator_max_number_of_nodes = 1024,
+	/* memory policy modes and flags of the Linux kernel */
+	numa_allocator_mode_default = 0,
+	numa_allocator_mode_preferred = 1,
+	numa_allocator_mode_interleave = 3,
+	numa_allocator_flag_node = 1,
+	numa_allocator_flag_address = 2,
+	numa_allocator_flag_memories_allowed = 4
+};
+
+#define NUMA_ALLOCATOR_BITS_PER_WORD (CHAR_BIT * sizeof(unsigned long))
+#define NUMA_ALLOCATOR_MASK_SIZE (numa_allocator_max_number_of_nodes / NUMA_ALLOCATOR_BITS_PER_WORD)
+/* The kernel ignores the last bit of the mask size passed to the memory policy system calls. */
+#define NUMA_ALLOCATOR_MAX_NODE_ARGUMENT ((unsigned long) numa_allocator_max_number_of_nodes + 1UL)
+
+typedef struct numa_allocator_header_type
+{
+	size_t mapping_size;
+} numa_allocator_header_type;
+
+typedef struct numa_allocator_nodes_type
+{
+	int number_of_nodes;
+	int highest_node;
+	unsigned long allowed_nodes[NUMA_ALLOCATOR_MASK_SIZE];
+} numa_allocator_nodes_type;
+
+static numa_allocator_nodes_type s_nodes;
+static pthread_once_t s_nodes_once = PTHREAD_ONCE_INIT;
+
+static void numa_allocator_detect_nodes(void)
+{
+	int mode = 0;
+	int node = 0;
+
+	memset(&s_nodes, 0, sizeof(s_nodes));
+	if (syscall(SYS_get_mempolicy, &mode, s_nodes.allowed_nodes, NUMA_ALLOCATOR_MAX_NODE_ARGUMENT,
+		NULL, (unsigned long) numa_allocator_flag_memories_allowed) == 0) {
+		for (node = 0; node < numa_allocator_max_number_of_nodes; ++node) {
+			if ((s_nodes.allowed_nodes[(size_t) node / NUMA_ALLOCATOR_BITS_PER_WORD] >>
+				((size_t) node % NUMA_ALLOCATOR_BITS_PER_WORD)) & 1UL) {
+				++s_nodes.number_of_nodes;
+				s_nodes.highest_node = node;
+			}
+		}
+	}
+
+	if (s_nodes.number_of_nodes == 0) {
+		s_nodes.number_of_nodes = 1;
+		s_nodes.highest_node = 0;
+	}
+}
+
+static const numa_allocator_nodes_type *numa_allocator_nodes(void)
+{
+	/* pthread_once only fails on invalid arguments */
+	(void) pthread_once(&s_nodes_once, &numa_allocator_detect_nodes);
+	return &s_nodes;
+}
+
+static size_t numa_allocator_page_size(void)
+{
+	const long page_size = sysconf(_SC_PAGESIZE);
+	return (page_size > 0) ? (size_t) page_size : 4096U;
+}
+
+static size_t numa_allocator_mapping_size(size_t number_of_bytes)
+{
+	const size_t page_size = numa_allocator_page_size();
+	if (number_of_bytes > ((size_t) -1) - numa_allocator_header_size - page_size) {
+		return 0U;
+	}
+	return (number_of_bytes + numa_allocator_header_size + page_size - 1U) / page_size * page_size;
+}
+
+static numa_allocator_header_type *numa_allocator_header(void *memory_block)
+{
+	return (numa_allocator_header_type*) ((unsigned char*) memory_block - numa_allocator_header_size);
+}
+
+static Boolean_type numa_allocator_apply_policy(const numa_allocator_type *numa_allocator, void *mapping, size_t mapping_size)
+{
+	const numa_allocator_nodes_type *nodes = numa_allocator_nodes();
+	unsigned long mask[NUMA_ALLOCATOR_MASK_SIZE] = {0UL};
+	unsigned long mode = numa_allocator_mode_preferred;
+	int node = 0;
+
+	if (nodes->number_of_nodes <= 1) {
+		return Boolean_false;
+	}
+
+	switch (numa_allocator->policy) {
+	case numa_allocator_policy_local:
+		node = numa_allocator_current_node();
+		break;
+	case numa_allocator_policy_node:
+		node = numa_allocator->node;
+		break;
+	case numa_allocator_policy_interleave:
+		mode = numa_allocator_mode_interleave;
+		break;
+	default:
+		return Boolean_false;
+	}
+
+	if (mode == numa_allocator_mode_interleave) {
+		memcpy(mask, nodes->allowed_nodes, sizeof(mask));
+	} else if (node >= 0 and node <= nodes->highest_node) {
+		mask[(size_t) node / NUMA_ALLOCATOR_BITS_PER_WORD] |= 1UL << ((size_t) node % NUMA_ALLOCATOR_BITS_PER_WORD);
+	} else {
+		return Boolean_false;
+	}
+
+	/* The placement is a hint. If mbind fails, the mapping is still usable. */
+	return syscall(SYS_mbind, mapping, mapping_size, mode, mask, NUMA_ALLOCATOR_MAX_NODE_ARGUMENT, 0UL) == 0;
+}
+
+#endif
+
+void numa_allocator_init(numa_allocator_type *numa_allocator, numa_allocator_policy_type policy, int node)
+{
+	assert(numa_allocator != NULL);
+	if (numa_allocator != NULL) {
+		numa_allocator->policy = policy;
+		numa_allocator->node = node;
+	}
+}
+
+void *numa_allocator_allocate(const numa_allocator_type *numa_allocator, size_t number_of_bytes)
+{
+#if NUMA_ALLOCATOR_LINUX
+	size_t mapping_size = 0U;
+	void *mapping = NULL;
+
+	assert(numa_allocator != NULL);
+	if (numa_allocator == NULL or number_of_bytes == 0U) {
+		return NULL;
+	}
+
+	mapping_size = numa_allocator_mapping_size(number_of_bytes);
+	if (mapping_size == 0U) {
+		return NULL;
+	}
+
+	mapping = mmap(NULL, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (mapping == MAP_FAILED) {
+		return NULL;
+	}
+
+	/* the policy must be set before the header is written, because writing the header touches the first page */
+	(void) numa_allocator_apply_policy(numa_allocator, mapping, mapping_size);
+	((numa_allocator_header_type*) mapping)->mapping_size = mapping_size;
+	return (unsigned char*) mapping + numa_allocator_header_size;
+#else
+	assert(numa_allocator != NULL);
+	(void) numa_allocator;
+	return (number_of_bytes > 0U) ? malloc(number_of_bytes) : NULL;
+#endif
+}
+
+void *numa_allocator_reallocate(const numa_allocator_type *numa_allocator, void *memory_block, size_t new_number_of_bytes)
+{
+#if NUMA_ALLOCATOR_LINUX
+	numa_allocator_header_type *header = NULL;
+	size_t new_mapping_size = 0U;
+	void *new_mapping = NULL;
+
+	assert(numa_allocator != NULL);
+	if (memory_block == NULL) {
+		return numa_allocator_allocate(numa_allocator, new_number_of_bytes);
+	}
+
+	if (new_number_of_bytes == 0U) {
+		numa_allocator_deallocate(numa_allocator, memory_block);
+		return NULL;
+	}
+
+	header = numa_allocator_header(memory_block);
+	new_mapping_size = numa_allocator_mapping_size(new_number_of_bytes);
+	if (new_mapping_size == 0U) {
+		return NULL;
+	}
+
+	if (new_mapping_size == header->mapping_size) {
+		return memory_block;
+	}
+
+	/* the memory policy of the mapping applies to the pages added by mremap */
+	new_mapping = mremap(header, header->mapping_size, new_mapping_size, MREMAP_MAYMOVE);
+	if (new_mapping == MAP_FAILED) {
+		return NULL;
+	}
+
+	((numa_allocator_header_type*) new_mapping)->mapping_size = new_mapping_size;
+	return (unsigned char*) new_mapping + numa_allocator_header_size;
+#else
+	assert(numa_allocator != NULL);
+	(void) numa_allocator;
+	if (new_number_of_bytes == 0U) {
+		free(memory_block);
+		return NULL;
+	}
+	return realloc(memory_block, new_number_of_bytes);
+#endif
+}
+
+void numa_allocator_deallocate(const numa_allocator_type *numa_allocator, void *memory_block)
+{
+	assert(numa_allocator != NULL);
+	(void) numa_allocator;
+	if (memory_block == NULL) {
+		return;
+	}
+
+#if NUMA_ALLOCATOR_LINUX
+	{
+		numa_allocator_header_type *header = numa_allocator_header(memory_block);
+		(void) munmap(header, header->mapping_size);
+	}
+#else
+	free(memory_block);
+#endif
+}
+
+Boolean_type numa_allocator_is_available(void)
+{
+#if NUMA_ALLOCATOR_LINUX
+	return numa_allocator_nodes()->number_of_nodes > 1;
+#else
+	return Boolean_false;
+#endif
+}
+
+int numa_allocator_number_of_nodes(void)
+{
+#if NUMA_ALLOCATOR_LINUX
+	return numa_allocator_nodes()->number_of_nodes;
+#else
+	return 1;
+#endif
+}
+
+int numa_allocator_highest_node(void)
+{
+#if NUMA_ALLOCATOR_LINUX
+	return numa_allocator_nodes()->highest_node;
+#else
+	return 0;
+#endif
+}
+
+int numa_allocator_current_node(void)
+{
+#if NUMA_ALLOCATOR_LINUX
+	unsigned int cpu = 0U;
+	unsigned int node = 0U;
+	if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0) {
+		return (int) node;
+	}
+#endif
+	return 0;
+}
+
+int numa_allocator_node_of_address(const void *address)
+{
+#if NUMA_ALLOCATOR_LINUX
+	int node = -1;
+	if (address != NULL and syscall(SYS_get_mempolicy, &node, NULL, 0UL, address,
+		(unsigned long) (numa_allocator_flag_node | numa_allocator_flag_address)) == 0) {
+		return node;
+	}
+#else
+	(void) address;
+#endif
+	return -1;
+}
+
+Boolean_type numa_allocator_set_thread_policy(numa_allocator_policy_type policy, int node)
+{
+#if NUMA_ALLOCATOR_LINUX
+	const numa_allocator_nodes_type *nodes = numa_allocator_nodes();
+	unsigned long mask[NUMA_ALLOCATOR_MASK_SIZE] = {0UL};
+
+	switch (policy) {
+	case numa_allocator_policy_default:
+		return syscall(SYS_set_mempolicy, (unsigned long) numa_allocator_mode_default, NULL, 0UL) == 0;
+	case numa_allocator_policy_local:
+		node = numa_allocator_current_node();
+		break;
+	case numa_allocator_policy_node:
+		break;
+	case numa_allocator_policy_interleave:
+		memcpy(mask, nodes->allowed_nodes, sizeof(mask));
+		return syscall(SYS_set_mempolicy, (unsigned long) numa_allocator_mode_interleave,
+			mask, NUMA_ALLOCATOR_MAX_NODE_ARGUMENT) == 0;
+	default:
+		return Boolean_false;
+	}
+
+	if (node < 0 or node > nodes->highest_node) {
+		return Boolean_false;
+	}
+	mask[(size_t) node / NUMA_ALLOCATOR_BITS_PER_WORD] |= 1UL << ((size_t) node % NUMA_ALLOCATOR_BITS_PER_WORD);
+	return syscall(SYS_set_mempolicy, (unsigned long) numa_allocator_mode_preferred, mask, NUMA_ALLOCATOR_MAX_NODE_ARGUMENT) == 0;
+#else
+	(void) node;
+	return policy == numa_allocator_policy_default;
+#endif
+}
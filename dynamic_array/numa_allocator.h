@@ -0,0 +1,138 @@
+/* Minimum C Standard: C89 */
+
+#ifndef NUMA_ALLOCATOR_H
+#define NUMA_ALLOCATOR_H
+
+#include "allocator_type.h"
+#include "Boolean_type.h"
+#include "macro_concatenate.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+The NUMA allocator places the pages of large buffers on a chosen NUMA node or interleaves them across all nodes.
+
+Each memory block is a separate page-aligned mapping obtained from the operating system. Its memory policy is set
+using mbind before the pages are touched, so the placement does not depend on which thread touches the pages first.
+Reallocation remaps the pages without copying, and the memory policy remains in effect for the new pages.
+The allocator is intended for large buffers, e.g. the buffers of large dynamic arrays. Every block occupies at
+least one page.
+
+NUMA placement is only supported on Linux. If the system has only one NUMA node or if the memory policy system calls
+are not available, the memory policy is not applied and the pages are placed by the operating system as usual.
+On other operating systems, the allocator falls back to malloc, realloc and free.
+
+The allocator is thread-safe.
+*/
+
+typedef enum numa_allocator_policy_type
+{
+	/* pages are placed by the default policy of the operating system, usually on the node of the thread touching them first */
+	numa_allocator_policy_default = 0,
+	/* pages are placed on the node of the thread which allocates the memory block */
+	numa_allocator_policy_local,
+	/* pages are placed on a specified node */
+	numa_allocator_policy_node,
+	/* pages are interleaved across all nodes */
+	numa_allocator_policy_interleave
+} numa_allocator_policy_type;
+
+typedef struct numa_allocator_type
+{
+	numa_allocator_policy_type policy;
+	int node; /* used by numa_allocator_policy_node */
+} numa_allocator_type;
+
+/*
+Initializes a NUMA allocator.
+
+Parameters:
+numa_allocator: A pointer to a NUMA allocator. Must not be null.
+policy        : The placement of the pages of each memory block.
+node          : The node used by numa_allocator_policy_node. It is ignored by the other policies.
+*/
+void numa_allocator_init(numa_allocator_type *numa_allocator, numa_allocator_policy_type policy, int node);
+
+/*
+Allocates a memory block and applies the memory policy of the allocator to its pages.
+
+Return value: A pointer to the memory block, or null if number_of_bytes is zero or if the allocation fails.
+*/
+void *numa_allocator_allocate(const numa_allocator_type *numa_allocator, size_t number_of_bytes);
+
+/*
+Reallocates a memory block. If memory_block is null, the function behaves like numa_allocator_allocate.
+If new_number_of_bytes is zero, the block is deallocated and the returned pointer is null.
+
+Return value: A pointer to the reallocated memory block, or null if the reallocation fails. On failure, memory_block remains valid.
+*/
+void *numa_allocator_reallocate(const numa_allocator_type *numa_allocator, void *memory_block, size_t new_number_of_bytes);
+
+/* Deallocates a memory block. No action is taken if memory_block is null. */
+void numa_allocator_deallocate(const numa_allocator_type *numa_allocator, void *memory_block);
+
+/* Returns true if NUMA placement is supported, i.e. the system has more than one NUMA node and the system calls are available. */
+Boolean_type numa_allocator_is_available(void);
+
+/* Returns the number of NUMA nodes with memory, or 1 if NUMA is not supported. */
+int numa_allocator_number_of_nodes(void);
+
+/* Returns the highest node number which can be used, or 0 if NUMA is not supported. */
+int numa_allocator_highest_node(void);
+
+/* Returns the node of the CPU which runs the calling thread, or 0 if it cannot be determined. */
+int numa_allocator_current_node(void);
+
+/*
+Returns the node on which the page containing the address is placed, or -1 if it cannot be determined.
+If the page has not been touched yet, it is placed by this function.
+*/
+int numa_allocator_node_of_address(const void *address);
+
+/*
+Sets the memory policy of the calling thread, which applies to all memory allocated by the thread afterwards,
+e.g. by malloc. numa_allocator_policy_default restores the default policy.
+
+Return value: true if the memory policy is set, otherwise false.
+*/
+Boolean_type numa_allocator_set_thread_policy(numa_allocator_policy_type policy, int node);
+
+/*
+Defines the functions for an allocator_type which forwards to a NUMA allocator.
+
+Parameters:
+prefix        : The prefix of the names of the generated functions.
+numa_allocator: The name of a NUMA allocator variable with static storage duration.
+
+Generated functions: prefix_allocate, prefix_reallocate and prefix_deallocate.
+
+Usage example:
+
+static numa_allocator_type interleaved;
+NUMA_ALLOCATOR_DEFINE_ALLOCATOR(interleaved, interleaved)
+static allocator_type interleaved_allocator = {&interleaved_allocate, &interleaved_reallocate, &interleaved_deallocate};
+...
+numa_allocator_init(&interleaved, numa_allocator_policy_interleave, 0);
+*/
+#define NUMA_ALLOCATOR_DEFINE_ALLOCATOR(prefix, numa_allocator) \
+	static void *CONCATENATE(prefix, _allocate)(size_t number_of_bytes) \
+	{ \
+		return numa_allocator_allocate(&(numa_allocator), number_of_bytes); \
+	} \
+	static void *CONCATENATE(prefix, _reallocate)(void *memory_block, size_t number_of_bytes) \
+	{ \
+		return numa_allocator_reallocate(&(numa_allocator), memory_block, number_of_bytes); \
+	} \
+	static void CONCATENATE(prefix, _deallocate)(void *memory_block) \
+	{ \
+		numa_allocator_deallocate(&(numa_allocator), memory_block); \
+	}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,118 @@
+#include "numa_allocator.h"
+#include "dynamic_array.h"
+#include "unit_testing.h"
+#include <iso646.h>
+#include <stddef.h>
+#include <string.h>
+
+static numa_allocator_type s_numa_allocator;
+
+NUMA_ALLOCATOR_DEFINE_ALLOCATOR(numa, s_numa_allocator)
+
+TEST(node_information, "The node information is consistent")
+{
+	const int number_of_nodes = numa_allocator_number_of_nodes();
+	const int highest_node = numa_allocator_highest_node();
+	const int current_node = numa_allocator_current_node();
+
+	ASSERT(number_of_nodes >= 1);
+	ASSERT(highest_node >= number_of_nodes - 1);
+	ASSERT(current_node >= 0 and current_node <= highest_node);
+	ASSERT(numa_allocator_is_available() == (number_of_nodes > 1));
+}
+
+TEST(allocation_with_each_policy, "Memory blocks can be allocated with each policy")
+{
+	const numa_allocator_policy_type policies[] = {
+		numa_allocator_policy_default,
+		numa_allocator_policy_local,
+		numa_allocator_policy_node,
+		numa_allocator_policy_interleave
+	};
+	const size_t number_of_bytes = 1024U * 1024U;
+	size_t i = 0U;
+
+	for (i = 0U; i < sizeof(policies) / sizeof(policies[0]); ++i) {
+		unsigned char *block = NULL;
+		numa_allocator_init(&s_numa_allocator, policies[i], numa_allocator_highest_node());
+		block = (unsigned char*) numa_allocator_allocate(&s_numa_allocator, number_of_bytes);
+		ASSERT(block != NULL);
+		if (block != NULL) {
+			const int node = numa_allocator_node_of_address(block);
+			ASSERT_UINT_EQUAL((size_t) block % 64U, 0U);
+			memset(block, 0xAB, number_of_bytes);
+			ASSERT_UINT_EQUAL(block[number_of_bytes - 1U], 0xABU);
+			ASSERT(node == -1 or (node >= 0 and node <= numa_allocator_highest_node()));
+			if (policies[i] == numa_allocator_policy_node and numa_allocator_is_available()) {
+				ASSERT_EQUAL(node, numa_allocator_highest_node());
+			}
+			numa_allocator_deallocate(&s_numa_allocator, block);
+		}
+	}
+
+	ASSERT(numa_allocator_allocate(&s_numa_allocator, 0U) == NULL);
+}
+
+TEST(reallocation, "Reallocation keeps the content of a memory block")
+{
+	char *block = NULL;
+	size_t i = 0U;
+
+	numa_allocator_init(&s_numa_allocator, numa_allocator_policy_interleave, 0);
+	block = (char*) numa_allocator_allocate(&s_numa_allocator, 100U);
+	ASSERT(block != NULL);
+	memcpy(block, "numa", 5U);
+
+	for (i = 1U; i <= 8U; ++i) {
+		block = (char*) numa_allocator_reallocate(&s_numa_allocator, block, i * 100000U);
+		ASSERT(block != NULL);
+		ASSERT_EQUAL(memcmp(block, "numa", 5U), 0);
+		block[i * 100000U - 1U] = 'x';
+	}
+
+	block = (char*) numa_allocator_reallocate(&s_numa_allocator, block, 10U);
+	ASSERT(block != NULL);
+	ASSERT_EQUAL(memcmp(block, "numa", 5U), 0);
+	ASSERT(numa_allocator_reallocate(&s_numa_allocator, block, 0U) == NULL);
+}
+
+TEST(thread_policy, "The default memory policy of a thread can always be restored")
+{
+	if (numa_allocator_is_available()) {
+		ASSERT(numa_allocator_set_thread_policy(numa_allocator_policy_interleave, 0));
+	}
+	ASSERT(numa_allocator_set_thread_policy(numa_allocator_policy_default, 0));
+}
+
+TEST(dynamic_array_with_numa_allocator, "A dynamic array can use a NUMA allocator through allocator_type")
+{
+	allocator_type allocator = {&numa_allocate, &numa_reallocate, &numa_deallocate};
+	dynamic_array_type(double) values;
+	size_t i = 0U;
+
+	numa_allocator_init(&s_numa_allocator, numa_allocator_policy_local, 0);
+	values = dynamic_array_create_with_allocator(double, 0U, allocator);
+	for (i = 0U; i < 100000U; ++i) {
+		dynamic_array_push_back(double, values, (double) i);
+	}
+	ASSERT_UINT_EQUAL(dynamic_array_length(values), 100000U);
+	ASSERT(dynamic_array_element(double, values, 99999U) == 99999.0);
+	dynamic_array_delete(values);
+}
+
+int main(void)
+{
+	DEFINE_LIST_OF_TESTS(tests) {
+		node_information,
+		allocation_with_each_policy,
+		reallocation,
+		thread_policy,
+		dynamic_array_with_numa_allocator
+	};
+
+	PRINT_FILE_NAME();
+	RUN_TESTS(tests);
+	PRINT_TEST_STATISTICS(tests);
+
+	return 0;
+}
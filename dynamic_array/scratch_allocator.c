@@ -0,0 +1,199 @@
+#include "scratch_allocator.h"
+#include "static_assert.h"
+#include "thread_local.h"
+#include <assert.h>
+#include <iso646.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Notes:
+- Every block is preceded by a header, which records the capacity of the block and the offset of the previous block.
+- The offsets and the capacities are multiples of the storage unit size, so every block is suitably aligned.
+*/
+
+STATIC_ASSERT(sizeof(size_t) == sizeof(void*), "size_t and pointer type must have the same size.");
+
+typedef union scratch_allocator_storage_unit_type
+{
+	void *pointer;
+	void (*function_pointer)(void);
+	long integer;
+	double floating_point;
+	long double extended_floating_point;
+} scratch_allocator_storage_unit_type;
+
+typedef struct scratch_allocator_header_type
+{
+	size_t previous_block_offset;
+	size_t capacity; /* number of bytes after rounding */
+	size_t is_free;
+} scratch_allocator_header_type;
+
+typedef struct scratch_allocator_stack_type
+{
+	size_t number_of_bytes_used;
+	size_t top_block_offset; /* offset of the header of the topmost block, valid if number_of_bytes_used is not zero */
+	scratch_allocator_storage_unit_type region[SCRATCH_ALLOCATOR_REGION_SIZE / sizeof(scratch_allocator_storage_unit_type)];
+} scratch_allocator_stack_type;
+
+#define SCRATCH_ALLOCATOR_ROUNDED_SIZE(number_of_bytes) \
+	(((number_of_bytes) + sizeof(scratch_allocator_storage_unit_type) - 1U) / \
+	sizeof(scratch_allocator_storage_unit_type) * sizeof(scratch_allocator_storage_unit_type))
+
+#define SCRATCH_ALLOCATOR_HEADER_SIZE SCRATCH_ALLOCATOR_ROUNDED_SIZE(sizeof(scratch_allocator_header_type))
+
+#define SCRATCH_ALLOCATOR_REGION_CAPACITY sizeof(((scratch_allocator_stack_type*) NULL)->region)
+
+static THREAD_LOCAL scratch_allocator_stack_type s_stack;
+
+static unsigned char *scratch_allocator_region(void)
+{
+	return (unsigned char*) s_stack.region;
+}
+
+static scratch_allocator_header_type *scratch_allocator_header(size_t block_offset)
+{
+	return (scratch_allocator_header_type*) (scratch_allocator_region() + block_offset);
+}
+
+static size_t scratch_allocator_block_offset(const void *memory_block)
+{
+	return (size_t) ((const unsigned char*) memory_block - scratch_allocator_region()) - SCRATCH_ALLOCATOR_HEADER_SIZE;
+}
+
+static void scratch_allocator_pop_free_blocks(void)
+{
+	while (s_stack.number_of_bytes_used > 0U) {
+		const scratch_allocator_header_type *header = scratch_allocator_header(s_stack.top_block_offset);
+		if (not header->is_free) {
+			break;
+		}
+		s_stack.number_of_bytes_used = s_stack.top_block_offset;
+		s_stack.top_block_offset = header->previous_block_offset;
+	}
+}
+
+void *scratch_allocator_allocate(size_t number_of_bytes)
+{
+	const size_t available_number_of_bytes = SCRATCH_ALLOCATOR_REGION_CAPACITY - s_stack.number_of_bytes_used;
+	scratch_allocator_header_type *header = NULL;
+	size_t capacity = 0U;
+
+	if (number_of_bytes == 0U) {
+		return NULL;
+	}
+
+	if (available_number_of_bytes < SCRATCH_ALLOCATOR_HEADER_SIZE or
+		number_of_bytes > available_number_of_bytes - SCRATCH_ALLOCATOR_HEADER_SIZE) {
+		return malloc(number_of_bytes);
+	}
+
+	capacity = SCRATCH_ALLOCATOR_ROUNDED_SIZE(number_of_bytes);
+
+	header = scratch_allocator_header(s_stack.number_of_bytes_used);
+	header->previous_block_offset = s_stack.top_block_offset;
+	header->capacity = capacity;
+	header->is_free = 0U;
+	s_stack.top_block_offset = s_stack.number_of_bytes_used;
+	s_stack.number_of_bytes_used += SCRATCH_ALLOCATOR_HEADER_SIZE + capacity;
+	return (unsigned char*) header + SCRATCH_ALLOCATOR_HEADER_SIZE;
+}
+
+void *scratch_allocator_reallocate(void *memory_block, size_t new_number_of_bytes)
+{
+	scratch_allocator_header_type *header = NULL;
+	size_t block_offset = 0U;
+	void *new_memory_block = NULL;
+
+	if (memory_block == NULL) {
+		return scratch_allocator_allocate(new_number_of_bytes);
+	}
+
+	if (new_number_of_bytes == 0U) {
+		scratch_allocator_deallocate(memory_block);
+		return NULL;
+	}
+
+	if (not scratch_allocator_owns(memory_block)) {
+		return realloc(memory_block, new_number_of_bytes);
+	}
+
+	block_offset = scratch_allocator_block_offset(memory_block);
+	header = scratch_allocator_header(block_offset);
+	assert(not header->is_free);
+	if (new_number_of_bytes <= header->capacity) {
+		if (block_offset == s_stack.top_block_offset) {
+			header->capacity = SCRATCH_ALLOCATOR_ROUNDED_SIZE(new_number_of_bytes);
+			s_stack.number_of_bytes_used = block_offset + SCRATCH_ALLOCATOR_HEADER_SIZE + header->capacity;
+		}
+		return memory_block;
+	}
+
+	/* the region capacity is a multiple of the storage unit size, so the rounded size fits as well */
+	if (block_offset == s_stack.top_block_offset and
+		new_number_of_bytes <= SCRATCH_ALLOCATOR_REGION_CAPACITY - block_offset - SCRATCH_ALLOCATOR_HEADER_SIZE) {
+		header->capacity = SCRATCH_ALLOCATOR_ROUNDED_SIZE(new_number_of_bytes);
+		s_stack.number_of_bytes_used = block_offset + SCRATCH_ALLOCATOR_HEADER_SIZE + header->capacity;
+		return memory_block;
+	}
+
+	new_memory_block = scratch_allocator_allocate(new_number_of_bytes);
+	if (new_memory_block != NULL) {
+		(void) memcpy(new_memory_block, memory_block, header->capacity);
+		scratch_allocator_deallocate(memory_block);
+	}
+	return new_memory_block;
+}
+
+void scratch_allocator_deallocate(void *memory_block)
+{
+	size_t block_offset = 0U;
+
+	if (memory_block == NULL) {
+		return;
+	}
+
+	if (not scratch_allocator_owns(memory_block)) {
+		free(memory_block);
+		return;
+	}
+
+	block_offset = scratch_allocator_block_offset(memory_block);
+	assert(not scratch_allocator_header(block_offset)->is_free);
+	scratch_allocator_header(block_offset)->is_free = 1U;
+	if (block_offset == s_stack.top_block_offset) {
+		scratch_allocator_pop_free_blocks();
+	}
+}
+
+scratch_allocator_marker_type scratch_allocator_mark(void)
+{
+	scratch_allocator_marker_type marker;
+	marker.number_of_bytes_used = s_stack.number_of_bytes_used;
+	marker.top_block_offset = s_stack.top_block_offset;
+	return marker;
+}
+
+void scratch_allocator_release(scratch_allocator_marker_type marker)
+{
+	assert(marker.number_of_bytes_used <= s_stack.number_of_bytes_used);
+	if (marker.number_of_bytes_used <= s_stack.number_of_bytes_used) {
+		s_stack.number_of_bytes_used = marker.number_of_bytes_used;
+		s_stack.top_block_offset = marker.top_block_offset;
+		/* blocks below the marker may have been deallocated while they were not the topmost block */
+		scratch_allocator_pop_free_blocks();
+	}
+}
+
+size_t scratch_allocator_number_of_bytes_used(void)
+{
+	return s_stack.number_of_bytes_used;
+}
+
+Boolean_type scratch_allocator_owns(const void *memory_block)
+{
+	const size_t address = (size_t) memory_block;
+	const size_t first_address = (size_t) scratch_allocator_region();
+	return (address >= first_address + SCRATCH_ALLOCATOR_HEADER_SIZE) and
+		(address - first_address < SCRATCH_ALLOCATOR_REGION_CAPACITY);
+}
@@ -0,0 +1,94 @@
+/* Minimum C Standard: C89 */
+
+#ifndef SCRATCH_ALLOCATOR_H
+#define SCRATCH_ALLOCATOR_H
+
+#include "allocator_type.h"
+#include "Boolean_type.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+The scratch allocator is a LIFO (stack) allocator for temporary buffers which never outlive the function creating them.
+Each thread has its own stack region (see thread_local.h), so no locking is required.
+
+- Allocation bumps the top of the stack.
+- Deallocation of the topmost block moves the top back. A block which is not the topmost block is marked as free
+  and its memory is reclaimed as soon as every block above it has been deallocated.
+- Reallocation of the topmost block grows or shrinks it in place.
+- scratch_allocator_mark and scratch_allocator_release reclaim every block allocated in between at once.
+- If the region is exhausted, memory blocks are allocated using malloc instead. Such blocks are not reclaimed by
+  scratch_allocator_release, so they must be deallocated by scratch_allocator_deallocate.
+
+A memory block MUST be deallocated by the thread which has allocated it.
+
+The size of the region of each thread is SCRATCH_ALLOCATOR_REGION_SIZE bytes.
+To change it, define the macro when building the scratch_allocator library.
+
+Usage example:
+
+static allocator_type scratch = {&scratch_allocator_allocate, &scratch_allocator_reallocate, &scratch_allocator_deallocate};
+...
+dynamic_array_type(int) numbers = dynamic_array_create_with_allocator(int, 0U, scratch);
+...
+dynamic_array_delete(numbers);
+*/
+
+#ifndef SCRATCH_ALLOCATOR_REGION_SIZE
+#define SCRATCH_ALLOCATOR_REGION_SIZE 65536
+#endif
+
+typedef struct scratch_allocator_marker_type
+{
+	size_t number_of_bytes_used;
+	size_t top_block_offset;
+} scratch_allocator_marker_type;
+
+/*
+Allocates a memory block from the stack region of the calling thread.
+
+Return value: A pointer to the memory block, or null if number_of_bytes is zero or if the allocation fails.
+*/
+void *scratch_allocator_allocate(size_t number_of_bytes);
+
+/*
+Reallocates a memory block. The topmost block is resized in place if the region has enough space.
+Other blocks are moved to a new block. If memory_block is null, the function behaves like scratch_allocator_allocate.
+If new_number_of_bytes is zero, the block is deallocated and the returned pointer is null.
+
+Return value: A pointer to the reallocated memory block, or null if the reallocation fails. On failure, memory_block remains valid.
+*/
+void *scratch_allocator_reallocate(void *memory_block, size_t new_number_of_bytes);
+
+/*
+Deallocates a memory block. No action is taken if memory_block is null.
+Blocks are reclaimed in LIFO order.
+*/
+void scratch_allocator_deallocate(void *memory_block);
+
+/*
+Returns a marker of the current top of the stack of the calling thread.
+*/
+scratch_allocator_marker_type scratch_allocator_mark(void);
+
+/*
+Reclaims every block of the stack region allocated after the marker was obtained. O(1).
+Pointers to those blocks MUST NOT be used afterwards.
+Blocks allocated using malloc because the region was exhausted are not affected.
+*/
+void scratch_allocator_release(scratch_allocator_marker_type marker);
+
+/* Returns the number of bytes of the stack region of the calling thread which are in use, including block headers. */
+size_t scratch_allocator_number_of_bytes_used(void);
+
+/* Returns true if the memory block is in the stack region of the calling thread. */
+Boolean_type scratch_allocator_owns(const void *memory_block);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,140 @@
+#include "scratch_allocator.h"
+#include "dynamic_array.h"
+#include "unit_testing.h"
+#include <iso646.h>
+#include <stddef.h>
+#include <string.h>
+
+static allocator_type s_scratch = {&scratch_allocator_allocate, &scratch_allocator_reallocate, &scratch_allocator_deallocate};
+
+TEST(pointer_bump, "Consecutive blocks are allocated next to each other")
+{
+	const size_t number_of_bytes_used = scratch_allocator_number_of_bytes_used();
+	unsigned char *block1 = (unsigned char*) scratch_allocator_allocate(16U);
+	unsigned char *block2 = (unsigned char*) scratch_allocator_allocate(16U);
+	ASSERT(block1 != NULL);
+	ASSERT(block2 != NULL);
+	ASSERT(block1 < block2);
+	ASSERT(scratch_allocator_owns(block1));
+	ASSERT(scratch_allocator_owns(block2));
+	ASSERT_UINT_GREATER_OR_EQUAL(scratch_allocator_number_of_bytes_used(), number_of_bytes_used + 32U);
+	scratch_allocator_deallocate(block2);
+	scratch_allocator_deallocate(block1);
+	ASSERT_UINT_EQUAL(scratch_allocator_number_of_bytes_used(), number_of_bytes_used);
+}
+
+TEST(lifo_deallocation, "A block below the top is reclaimed when the blocks above it are deallocated")
+{
+	const size_t number_of_bytes_used = scratch_allocator_number_of_bytes_used();
+	void *block1 = scratch_allocator_allocate(8U);
+	void *block2 = scratch_allocator_allocate(8U);
+	size_t number_of_bytes_used_after_allocation = scratch_allocator_number_of_bytes_used();
+	void *block3 = NULL;
+
+	scratch_allocator_deallocate(block1);
+	ASSERT_UINT_EQUAL(scratch_allocator_number_of_bytes_used(), number_of_bytes_used_after_allocation);
+	scratch_allocator_deallocate(block2);
+	ASSERT_UINT_EQUAL(scratch_allocator_number_of_bytes_used(), number_of_bytes_used);
+
+	block3 = scratch_allocator_allocate(8U);
+	ASSERT(block3 == block1);
+	scratch_allocator_deallocate(block3);
+}
+
+TEST(reallocation_in_place, "The topmost block grows and shrinks in place")
+{
+	const size_t number_of_bytes_used = scratch_allocator_number_of_bytes_used();
+	char *block1 = (char*) scratch_allocator_allocate(4U);
+	char *block2 = NULL;
+	char *block3 = NULL;
+
+	memcpy(block1, "abc", 4U);
+	block2 = (char*) scratch_allocator_reallocate(block1, 1000U);
+	ASSERT(block2 == block1);
+	block2 = (char*) scratch_allocator_reallocate(block2, 10U);
+	ASSERT(block2 == block1);
+	ASSERT_EQUAL(memcmp(block2, "abc", 4U), 0);
+
+	block3 = (char*) scratch_allocator_allocate(4U);
+	block1 = (char*) scratch_allocator_reallocate(block2, 100U); /* no longer the topmost block */
+	ASSERT(block1 != block2);
+	ASSERT(block1 > block3);
+	ASSERT_EQUAL(memcmp(block1, "abc", 4U), 0);
+
+	scratch_allocator_deallocate(block1);
+	scratch_allocator_deallocate(block3);
+	ASSERT_UINT_EQUAL(scratch_allocator_number_of_bytes_used(), number_of_bytes_used);
+}
+
+TEST(mark_and_release, "Every block allocated after a mark is reclaimed at once")
+{
+	const scratch_allocator_marker_type marker = scratch_allocator_mark();
+	const size_t number_of_bytes_used = scratch_allocator_number_of_bytes_used();
+	size_t i = 0U;
+
+	for (i = 0U; i < 10U; ++i) {
+		ASSERT(scratch_allocator_allocate(i + 1U) != NULL);
+	}
+	ASSERT(scratch_allocator_number_of_bytes_used() > number_of_bytes_used);
+	scratch_allocator_release(marker);
+	ASSERT_UINT_EQUAL(scratch_allocator_number_of_bytes_used(), number_of_bytes_used);
+}
+
+TEST(region_exhausted, "Memory is allocated using malloc when the region is exhausted")
+{
+	const size_t number_of_bytes_used = scratch_allocator_number_of_bytes_used();
+	char *block1 = (char*) scratch_allocator_allocate(SCRATCH_ALLOCATOR_REGION_SIZE + 1U);
+	char *block2 = (char*) scratch_allocator_allocate(16U);
+	ASSERT(block1 != NULL);
+	ASSERT(not scratch_allocator_owns(block1));
+	ASSERT(scratch_allocator_owns(block2));
+	block1[SCRATCH_ALLOCATOR_REGION_SIZE] = 'a';
+
+	block2 = (char*) scratch_allocator_reallocate(block2, 2U * SCRATCH_ALLOCATOR_REGION_SIZE);
+	ASSERT(block2 != NULL);
+	ASSERT(not scratch_allocator_owns(block2));
+	ASSERT_UINT_EQUAL(scratch_allocator_number_of_bytes_used(), number_of_bytes_used);
+
+	scratch_allocator_deallocate(block2);
+	scratch_allocator_deallocate(block1);
+}
+
+TEST(dynamic_arrays_with_scratch_allocator, "Temporary dynamic arrays use the scratch allocator through allocator_type")
+{
+	const size_t number_of_bytes_used = scratch_allocator_number_of_bytes_used();
+	dynamic_array_type(int) numbers = dynamic_array_create_with_allocator(int, 0U, s_scratch);
+	dynamic_array_type(char) text = dynamic_array_create_with_allocator(char, 0U, s_scratch);
+	int i = 0;
+
+	for (i = 0; i < 100; ++i) {
+		dynamic_array_push_back(int, numbers, i);
+		dynamic_array_push_back(char, text, (char) ('a' + i % 26));
+	}
+	ASSERT_UINT_EQUAL(dynamic_array_length(numbers), 100U);
+	ASSERT_UINT_EQUAL(dynamic_array_length(text), 100U);
+	ASSERT_EQUAL(dynamic_array_element(int, numbers, 99U), 99);
+	ASSERT_EQUAL(dynamic_array_element(char, text, 27U), 'b');
+	ASSERT(scratch_allocator_owns(&dynamic_array_element(int, numbers, 0U)));
+
+	dynamic_array_delete(text);
+	dynamic_array_delete(numbers);
+	ASSERT_UINT_EQUAL(scratch_allocator_number_of_bytes_used(), number_of_bytes_used);
+}
+
+int main(void)
+{
+	DEFINE_LIST_OF_TESTS(tests) {
+		pointer_bump,
+		lifo_deallocation,
+		reallocation_in_place,
+		mark_and_release,
+		region_exhausted,
+		dynamic_arrays_with_scratch_allocator
+	};
+
+	PRINT_FILE_NAME();
+	RUN_TESTS(tests);
+	PRINT_TEST_STATISTICS(tests);
+
+	return 0;
+}
@@ -30,6 +30,24 @@ typedef struct const_stringref_type
 	size_t length;
 } const_stringref_type;
 
+/*
+Initializer of a string reference to a string literal, excluding its null terminator. It is a constant expression,
+so it can initialize static tables, e.g.
+static const const_stringref_type keywords[] = {CONST_STRINGREF_LITERAL("if"), CONST_STRINGREF_LITERAL("else")};
+*/
+#define CONST_STRINGREF_LITERAL(string_literal) {("" string_literal), sizeof(string_literal) - 1U}
+
+/*
+Defines a constant string reference to a string literal: constexpr in C++11 and later, static const otherwise.
+*/
+#if defined(__cplusplus) && (__cplusplus >= 201103L)
+#define CONSTEXPR_CONST_STRINGREF(name, string_literal) \
+	constexpr const_stringref_type name = CONST_STRINGREF_LITERAL(string_literal)
+#else
+#define CONSTEXPR_CONST_STRINGREF(name, string_literal) \
+	static const const_stringref_type name = CONST_STRINGREF_LITERAL(string_literal)
+#endif
+
 INLINE_OR_STATIC
 const_stringref_type
 stringref_to_const_stringref(stringref_type stringref)
@@ -101,14 +119,10 @@ size_t
 const_stringref_string_length(const_stringref_type stringref)
 {
 	size_t length = 0U;
-	if (stringref.string != NULL) {
-		size_t index = 0U;
-		for (; index < stringref.length; ++index) {
-			if (stringref.string[index] == '\0') {
-				break;
-			}
-		}
-		length = index;
+	if (stringref.string != NULL && stringref.length > 0U) {
+		/* memchr of the C library is vectorized on the common platforms (e.g. SSE2/AVX2 in glibc) */
+		const char *null_terminator = (const char*) memchr(stringref.string, '\0', stringref.length);
+		length = (null_terminator != NULL) ? (size_t) (null_terminator - stringref.string) : stringref.length;
 	}
 	return length;
 }
@@ -159,6 +173,11 @@ stringref_to_string(stringref_type stringref, char *buffer, size_t buffer_size)
 	const_stringref_to_string(const_stringref, buffer, buffer_size);
 }
 
+/*
+Compares the strings before the first '\0' of both string references.
+The first string is scanned for '\0' once. The second string is not scanned separately, because it can only be equal
+if its first length1 bytes match and it ends right after them.
+*/
 INLINE_OR_STATIC
 Boolean_type
 const_stringref_strings_are_equal(const_stringref_type strref1, const_stringref_type strref2)
@@ -167,8 +186,9 @@ const_stringref_strings_are_equal(const_stringref_type strref1, const_stringref_
 	if (const_stringref_is_valid(strref1)) {
 		const size_t length1 = const_stringref_string_length(strref1);
 		if (const_stringref_is_valid(strref2)) {
-			const size_t length2 = const_stringref_string_length(strref2);
-			result = (length1 == length2) ? (memcmp(strref1.string, strref2.string, length1) == 0) : Boolean_false;
+			if (length1 <= strref2.length && (strref1.string == strref2.string || memcmp(strref1.string, strref2.string, length1) == 0)) {
+				result = (length1 == strref2.length || strref2.string[length1] == '\0');
+			}
 		} else {
 			result = (length1 == 0U);
 		}
@@ -183,6 +203,19 @@ const_stringref_strings_are_equal(const_stringref_type strref1, const_stringref_
 	return result;
 }
 
+/*
+Returns a string reference whose length is the string length, i.e. the part before the first '\0'.
+The string length of a token can be computed once and kept in the reference, so that later comparisons can use
+const_stringref_contents_are_equal, which compares the lengths before the contents and does not scan for '\0'.
+*/
+INLINE_OR_STATIC
+const_stringref_type
+const_stringref_truncate_at_null_terminator(const_stringref_type stringref)
+{
+	stringref.length = const_stringref_string_length(stringref);
+	return stringref;
+}
+
 INLINE_OR_STATIC
 Boolean_type
 const_stringref_contents_are_equal(const_stringref_type strref1, const_stringref_type strref2)
@@ -190,7 +223,8 @@ const_stringref_contents_are_equal(const_stringref_type strref1, const_stringref
 	Boolean_type result = Boolean_false;
 	if (const_stringref_is_valid(strref1)) {
 		if (const_stringref_is_valid(strref2)) {
-			result = (strref1.length == strref2.length) ? (memcmp(strref1.string, strref2.string, strref1.length) == 0) : Boolean_false;
+			result = (strref1.length == strref2.length) ?
+				(strref1.string == strref2.string || memcmp(strref1.string, strref2.string, strref1.length) == 0) : Boolean_false;
 		} else {
 			result = (strref1.length == 0U);
 		}
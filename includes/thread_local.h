@@ -0,0 +1,38 @@
+#ifndef THREAD_LOCAL_H
+#define THREAD_LOCAL_H
+
+/*
+THREAD_LOCAL is a storage class specifier which gives each thread its own instance of a variable.
+It must be combined with static or extern, e.g. static THREAD_LOCAL int counter;
+THREAD_LOCAL_SUPPORTED is 1 if the compiler supports thread-local storage, otherwise 0.
+If thread-local storage is not supported, THREAD_LOCAL expands to nothing and the variable is shared by all threads.
+*/
+
+#if defined(__cplusplus) && (__cplusplus >= 201103L)
+
+#define THREAD_LOCAL thread_local
+#define THREAD_LOCAL_SUPPORTED 1
+
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+
+#define THREAD_LOCAL _Thread_local
+#define THREAD_LOCAL_SUPPORTED 1
+
+#elif defined(_MSC_VER)
+
+#define THREAD_LOCAL __declspec(thread)
+#define THREAD_LOCAL_SUPPORTED 1
+
+#elif defined(__GNUC__) || defined(__clang__)
+
+#define THREAD_LOCAL __thread
+#define THREAD_LOCAL_SUPPORTED 1
+
+#else
+
+#define THREAD_LOCAL
+#define THREAD_LOCAL_SUPPORTED 0
+
+#endif
+
+#endif
@@ -1,11 +1,15 @@
 #include "dynamic_array.h"
+#include "owned_string.h"
 #include <errno.h>
 #include <iso646.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+static const allocator_type heap_allocator = {&malloc, &realloc, &free};
+
 static uint8_t hexadecimal_pair_to_byte(char upper_half_byte, char lower_half_byte)
 {
 	const char u = upper_half_byte;
@@ -61,17 +65,21 @@ static void insert_into_char_dynamic_array_if_not_found(dynamic_array_type(char)
 	}
 }
 
-static dynamic_array_type(char)
-get_string_from_input(void)
+/* File names are usually short enough to be stored in the string itself, without memory allocation. */
+static owned_string_type get_string_from_input(void)
 {
-	dynamic_array_type(char) array = dynamic_array_create(char, 0U);
+	owned_string_type string;
+	owned_string_init(&string, heap_allocator);
 	int c = fgetc(stdin);
 	while (c != '\n' and c != EOF) {
-		dynamic_array_append_element(char, array, c);
+		if (not owned_string_push_back(&string, (char) c)) {
+			fprintf(stderr, "Not enough memory for the input string.\n");
+			owned_string_deinit(&string);
+			exit(EXIT_FAILURE);
+		}
 		c = fgetc(stdin);
 	}
-	dynamic_array_append_element(char, array, '\0');
-	return array;
+	return string;
 }
 
 int main(int argc, char **argv)
@@ -135,9 +143,9 @@ int main(int argc, char **argv)
 			}
 
 			printf("Enter a file name or path: ");
-			dynamic_array_type(char) input_string = get_string_from_input();
+			owned_string_type input_string = get_string_from_input();
 
-			FILE *file = fopen(&dynamic_array_element(char, input_string, 0U), "wb");
+			FILE *file = fopen(owned_string_c_string(&input_string), "wb");
 			if (file != NULL) {
 				const uint8_t *data = &dynamic_array_element(uint8_t, bytes, 0U);
 				const size_t number_of_bytes_to_write = dynamic_array_length(bytes);
@@ -157,7 +165,7 @@ int main(int argc, char **argv)
 				printf("Error: %s\n", strerror(errno));
 			}
 
-			dynamic_array_delete(input_string);
+			owned_string_deinit(&input_string);
 			dynamic_array_delete(bytes);
 		}
 	} else {
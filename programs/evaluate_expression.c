@@ -1,5 +1,8 @@
 #include "dynamic_array.h"
+#include "scratch_allocator.h"
 #include "simple_tokenizer.h"
+#include "simple_tokenizer_rules.h"
+#include "string_builder.h"
 #include "safer_fixed_width_integers.h"
 
 #include <assert.h>
@@ -34,6 +37,13 @@ typedef struct expression_token_type
 	expression_token_type_enum type;
 } expression_token_type;
 
+/* Temporary arrays which never outlive the function creating them are allocated from the thread-local scratch stack. */
+static allocator_type scratch_allocator = {
+	&scratch_allocator_allocate,
+	&scratch_allocator_reallocate,
+	&scratch_allocator_deallocate
+};
+
 static const char *get_expression_token_type_name(expression_token_type_enum type)
 {
 	switch (type) {
@@ -89,173 +99,153 @@ static void print_list_of_tokens(FILE *fp, const expression_token_type *ptokens,
 	}
 }
 
-static expression_token_type_enum
-simple_tokenizer_token_type_to_expression_token_type(simple_tokenizer_token_type simple_tokenizer_token)
+/*
+The tokens of an expression are the longest matches of these rules, which are compiled into the automaton of a
+simple_tokenizer_rules_type, so each token is found in a single pass over its bytes:
+- An identifier starts with a letter, an underscore or a byte from 0x80 to 0xFF and continues with these or digits.
+  Its bytes from 0x80 to 0xFF are then checked to be valid UTF-8 characters by append_identifier_tokens.
+- A number may have a sign, so "-2" is an integer, "+.5" is a decimal number and "1+2" is "1" and "+2". A decimal
+  number has digits before or after its dot, or both.
+- Spaces, tabs and newlines can be ignored. Every other byte, e.g. "<", is an unsupported token of its own.
+*/
+static bool add_expression_rules(simple_tokenizer_rules_type *rules)
 {
-	expression_token_type_enum new_token_type = expression_token_unknown;
-	switch (simple_tokenizer_token.type) {
-	case simple_tokenizer_token_letters:
-	case simple_tokenizer_token_utf8_character:
-		new_token_type = expression_token_identifier;
-		break;
-	case simple_tokenizer_token_digits:
-		new_token_type = expression_token_integer;
-		break;
-	case simple_tokenizer_token_punctuation:
-		if (1U == simple_tokenizer_token.value.length) {
-			const char operator = simple_tokenizer_token.value.string[0];
-			if      (operator == '+')
-				new_token_type = expression_token_operator_addition;
-			else if (operator == '-')
-				new_token_type = expression_token_operator_subtraction;
-			else if (operator == '*')
-				new_token_type = expression_token_operator_multiplication;
-			else if (operator == '/')
-				new_token_type = expression_token_operator_division;
-			else if (operator == '=')
-				new_token_type = expression_token_operator_assignment;
-			else if (operator == '.')
-				new_token_type = expression_token_operator_dot;
-			else if (operator == '(')
-				new_token_type = expression_token_left_parenthesis;
-			else if (operator == ')')
-				new_token_type = expression_token_right_parenthesis;
-			else if (operator == '_')
-				new_token_type = expression_token_identifier;
-			else
-				new_token_type = expression_token_unsupported;
-		} else {
-			new_token_type = expression_token_unsupported;
+	static const struct {
+		const char *pattern;
+		expression_token_type_enum type;
+	} patterns[] = {
+		{"[ \\t\\r\\n]+", expression_token_can_be_ignored},
+		{"[A-Za-z_\\x80-\\xFF][A-Za-z0-9_\\x80-\\xFF]*", expression_token_identifier},
+		{"[+\\-]?[0-9]+", expression_token_integer},
+		{"[+\\-]?[0-9]+\\.[0-9]*", expression_token_decimal_number},
+		{"[+\\-]?\\.[0-9]+", expression_token_decimal_number}
+	};
+	static const struct {
+		const_stringref_type literal;
+		expression_token_type_enum type;
+	} operators[] = {
+		{CONST_STRINGREF_LITERAL("+"), expression_token_operator_addition},
+		{CONST_STRINGREF_LITERAL("-"), expression_token_operator_subtraction},
+		{CONST_STRINGREF_LITERAL("*"), expression_token_operator_multiplication},
+		{CONST_STRINGREF_LITERAL("/"), expression_token_operator_division},
+		{CONST_STRINGREF_LITERAL("="), expression_token_operator_assignment},
+		{CONST_STRINGREF_LITERAL("."), expression_token_operator_dot},
+		{CONST_STRINGREF_LITERAL("("), expression_token_left_parenthesis},
+		{CONST_STRINGREF_LITERAL(")"), expression_token_right_parenthesis}
+	};
+
+	for (size_t i = 0U; i < sizeof(patterns) / sizeof(patterns[0]); ++i) {
+		if (not simple_tokenizer_rules_add_pattern(rules, patterns[i].pattern, (int) patterns[i].type)) {
+			return false;
 		}
-		break;
-	case simple_tokenizer_token_spaces:
-	case simple_tokenizer_token_newline:
-		new_token_type = expression_token_can_be_ignored;
-		break;
-	default:
-		new_token_type = expression_token_unsupported;
-		break;
 	}
-	return new_token_type;
+	for (size_t i = 0U; i < sizeof(operators) / sizeof(operators[0]); ++i) {
+		if (not simple_tokenizer_rules_add_literal(rules, operators[i].literal, (int) operators[i].type)) {
+			return false;
+		}
+	}
+	return simple_tokenizer_rules_compile(rules);
 }
 
-static dynamic_array_type(expression_token_type)
-simple_tokenizer_tokens_to_expression_tokens(const simple_tokenizer_token_type *p_input_tokens, size_t input_token_count)
+/*
+The identifier rule accepts any byte from 0x80 to 0xFF, so the bytes of an identifier are checked to be UTF-8.
+Each byte which does not start a valid character is an unsupported token of its own, and the valid bytes between
+them are identifiers, or integers followed by identifiers if they start with digits.
+*/
+static void append_identifier_tokens(dynamic_array_type(expression_token_type) *p_tokens, const_stringref_type value)
 {
-	dynamic_array_type(expression_token_type) tokens = dynamic_array_create(expression_token_type, 0U);
-	expression_token_type token = {.value = {.string = NULL, .length = 0U}, .type = expression_token_unknown};
-
-	for (size_t index = 0U; index < input_token_count; ++index) {
-		bool add_token = false;
-		const simple_tokenizer_token_type simple_token = p_input_tokens[index];
-		expression_token_type_enum new_token_type = simple_tokenizer_token_type_to_expression_token_type(simple_token);
-
-		switch (token.type) {
-		case expression_token_unknown:
-			token.type = new_token_type;
-			token.value = simple_token.value;
-			break;
-		case expression_token_identifier:
-			if (new_token_type == token.type or new_token_type == expression_token_integer) {
-				assert((token.value.string + token.value.length) == simple_token.value.string);
-				token.value.length += simple_token.value.length;
-			} else {
-				add_token = true;
-			}
-			break;
-		case expression_token_integer:
-			if (new_token_type == expression_token_operator_dot) {
-				assert((token.value.string + token.value.length) == simple_token.value.string);
-				token.value.length += simple_token.value.length;
-				token.type = expression_token_decimal_number;
-			} else {
-				add_token = true;
-			}
-			break;
-		case expression_token_decimal_number:
-			if (new_token_type == expression_token_integer) {
-				assert(token.value.length > 0U);
-				const char last_char = token.value.string[token.value.length - 1U];
-				if (last_char == '.') {
-					assert((token.value.string + token.value.length) == simple_token.value.string);
-					token.value.length += simple_token.value.length;
-				} else {
-					add_token = true;
-				}
-			} else {
-				add_token = true;
-			}
-			break;
-		case expression_token_operator_addition:
-		case expression_token_operator_subtraction: // fall through intended
-			if (new_token_type == expression_token_integer) {
-				assert((token.value.string + token.value.length) == simple_token.value.string);
-				token.value.length += simple_token.value.length;
-				token.type = expression_token_integer;
-			} else if (new_token_type == expression_token_operator_dot) {
-				if ((index + 1U) < input_token_count) {
-					const simple_tokenizer_token_type next_input_token = p_input_tokens[index + 1];
-					const expression_token_type_enum next_token_type = simple_tokenizer_token_type_to_expression_token_type(next_input_token);
-					if (next_token_type == expression_token_integer) {
-						assert((token.value.string + token.value.length) == simple_token.value.string);
-						assert((simple_token.value.string + simple_token.value.length) == next_input_token.value.string);
-						token.value.length += simple_token.value.length;
-						token.value.length += next_input_token.value.length;
-						token.type = expression_token_decimal_number;
-						++index; // intended
-					} else {
-						add_token = true;
-					}
-				}
-			} else {
-				add_token = true;
-			}
-			break;
-		case expression_token_operator_dot:
-			if (new_token_type == expression_token_integer) {
-				assert((token.value.string + token.value.length) == simple_token.value.string);
-				token.value.length += simple_token.value.length;
-				token.type = expression_token_decimal_number;
-			} else {
-				add_token = true;
-			}
-			break;
-		default:
-			add_token = true;
-			break;
+	const char *string = value.string;
+	const char *end = value.string + value.length;
+	while (string < end) {
+		size_t digit_count = 0U;
+		while (string + digit_count < end and string[digit_count] >= '0' and string[digit_count] <= '9') {
+			++digit_count;
+		}
+		if (digit_count > 0U) {
+			const expression_token_type token = {
+				.value = string_to_const_stringref(string, digit_count),
+				.type = expression_token_integer
+			};
+			dynamic_array_append_element(expression_token_type, *p_tokens, token);
+			string += digit_count;
 		}
 
-		if (add_token) {
-			if (token.type != expression_token_can_be_ignored) {
-				dynamic_array_append_element(expression_token_type, tokens, token);
-			}
-			token.type = new_token_type;
-			token.value = simple_token.value;
+		const size_t valid_length = simple_tokenizer_utf8_valid_length(string, (size_t) (end - string));
+		if (valid_length > 0U) {
+			const expression_token_type token = {
+				.value = string_to_const_stringref(string, valid_length),
+				.type = expression_token_identifier
+			};
+			dynamic_array_append_element(expression_token_type, *p_tokens, token);
+			string += valid_length;
+		}
+		if (string < end) {
+			const expression_token_type token = {
+				.value = string_to_const_stringref(string, 1U),
+				.type = expression_token_unsupported
+			};
+			dynamic_array_append_element(expression_token_type, *p_tokens, token);
+			++string;
 		}
 	}
+}
 
-	if (input_token_count > 0U and token.type != expression_token_can_be_ignored) {
-		dynamic_array_append_element(expression_token_type, tokens, token);
+static dynamic_array_type(expression_token_type)
+tokenize_expression(const simple_tokenizer_rules_type *rules, const char *expression, size_t expression_length)
+{
+	dynamic_array_type(expression_token_type) tokens = dynamic_array_create(expression_token_type, 0U);
+	simple_tokenizer_rules_token_array_type rule_tokens;
+	simple_tokenizer_rules_token_array_init(&rule_tokens, scratch_allocator);
+	if (not simple_tokenizer_rules_tokenize_to_array(rules, expression, expression_length, &rule_tokens)) {
+		fprintf(stderr, "Not enough memory for the tokens of the expression.\n");
+		exit(EXIT_FAILURE);
 	}
 
+	for (size_t i = 0U; i < rule_tokens.number_of_tokens; ++i) {
+		const expression_token_type token = {
+			.value = rule_tokens.tokens[i].value,
+			.type = (expression_token_type_enum) rule_tokens.tokens[i].type
+		};
+		if (token.type == expression_token_identifier) {
+			append_identifier_tokens(&tokens, token.value);
+		} else if (token.type != expression_token_can_be_ignored) {
+			dynamic_array_append_element(expression_token_type, tokens, token);
+		}
+	}
+	simple_tokenizer_rules_token_array_deinit(&rule_tokens);
 	return tokens;
 }
 
+/*
+The tokens and the separators are recorded as pieces of a string builder, which reference the expression and the
+separator without copying them. The string is then flattened into an array of the exact size in a single pass.
+*/
 static dynamic_array_type(char)
 generate_expression_string(const expression_token_type *ptokens, size_t token_count, const char *separator, size_t separator_length)
 {
 	assert(ptokens != NULL);
-	dynamic_array_type(char) expression = dynamic_array_create(char, 0U);
-	for (size_t i = 0U; i < token_count; ++i) {
-		const expression_token_type token = ptokens[i];
-		dynamic_array_append_elements(char, expression, token.value.string, token.value.length);
-		if ((i + 1U) < token_count) {
-			if (separator != NULL and separator_length > 0U) {
-				dynamic_array_append_elements(char, expression, separator, separator_length);
-			}
+	const const_stringref_type separator_ref = string_to_const_stringref(separator, separator_length);
+	bool pieces_are_recorded = true;
+	string_builder_type builder;
+	string_builder_init(&builder, scratch_allocator);
+	for (size_t i = 0U; i < token_count and pieces_are_recorded; ++i) {
+		if (i > 0U) {
+			pieces_are_recorded = string_builder_append(&builder, separator_ref);
 		}
+		pieces_are_recorded = pieces_are_recorded and string_builder_append(&builder, ptokens[i].value);
 	}
-	dynamic_array_push_back(char, expression, '\0');
+	if (not pieces_are_recorded) {
+		fprintf(stderr, "Not enough memory for the expression string.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	dynamic_array_type(char) expression = dynamic_array_create(char, string_builder_length(&builder) + 1U);
+	(void) string_builder_flatten_to_buffer(
+		&builder,
+		&dynamic_array_element(char, expression, 0U),
+		dynamic_array_length(expression)
+	);
+	string_builder_deinit(&builder);
 	return expression;
 }
 
@@ -442,7 +432,8 @@ infix_expression_tokens_to_postfix_expression_tokens(const expression_token_type
 {
 	assert(ptokens != NULL);
 	dynamic_array_type(expression_token_type) output_tokens = dynamic_array_create(expression_token_type, 0U);
-	dynamic_array_type(expression_token_type) operator_tokens = dynamic_array_create(expression_token_type, 0U);
+	dynamic_array_type(expression_token_type) operator_tokens =
+		dynamic_array_create_with_allocator(expression_token_type, 0U, scratch_allocator);
 
 	for (size_t i = 0U; i < token_count; ++i) {
 		const expression_token_type token = ptokens[i];
@@ -544,8 +535,8 @@ evaluate_postfix_expression_tokens(const expression_token_type *ptokens, size_t
 		.number = {.value = {.integer = 0}, .type = number_type_integer},
 		.error = evaluation_result_error_none
 	};
-	dynamic_array_type(number_type) numbers = dynamic_array_create(number_type, 0U);
-	dynamic_array_type(char) number_string = dynamic_array_create(char, 0U);
+	dynamic_array_type(number_type) numbers = dynamic_array_create_with_allocator(number_type, 0U, scratch_allocator);
+	dynamic_array_type(char) number_string = dynamic_array_create_with_allocator(char, 0U, scratch_allocator);
 
 	for (size_t i = 0U; i < token_count; ++i) {
 		const expression_token_type token = ptokens[i];
@@ -760,34 +751,19 @@ int main(int argc, char **argv)
 	}
 	dynamic_array_push_back(char, expression, '\0');
 
-	dynamic_array_type(simple_tokenizer_token_type)  simple_tokens =
-		dynamic_array_create(simple_tokenizer_token_type, 0U);
-
-	const size_t number_of_simple_tokens =
-		simple_tokenizer_tokenize(
-			&dynamic_array_element(char, expression, 0U),
-			dynamic_array_length(expression) - 1U,
-			NULL, 0U
-		);
-
-	dynamic_array_resize(
-		simple_tokenizer_token_type,
-		simple_tokens,
-		number_of_simple_tokens
-	);
-
-	(void)
-	simple_tokenizer_tokenize(
-		&dynamic_array_element(char, expression, 0U),
-		dynamic_array_length(expression),
-		&dynamic_array_element(simple_tokenizer_token_type, simple_tokens, 0U),
-		dynamic_array_length(simple_tokens)
-	);
+	const allocator_type heap_allocator = {&malloc, &realloc, &free};
+	simple_tokenizer_rules_type rules;
+	simple_tokenizer_rules_init(&rules, heap_allocator, (int) expression_token_unsupported);
+	if (not add_expression_rules(&rules)) {
+		fprintf(stderr, "Not enough memory for the tokenizer rules.\n");
+		exit(EXIT_FAILURE);
+	}
 
 	dynamic_array_type(expression_token_type)  tokens =
-		simple_tokenizer_tokens_to_expression_tokens(
-			&dynamic_array_element(simple_tokenizer_token_type, simple_tokens, 0U),
-			dynamic_array_length(simple_tokens)
+		tokenize_expression(
+			&rules,
+			&dynamic_array_element(char, expression, 0U),
+			dynamic_array_length(expression) - 1U
 		);
 
 	FILE *fp = stdout;
@@ -868,7 +844,7 @@ int main(int argc, char **argv)
 	dynamic_array_delete(partially_corrected_expression);
 	dynamic_array_delete(new_tokens);
 	dynamic_array_delete(tokens);
-	dynamic_array_delete(simple_tokens);
+	simple_tokenizer_rules_deinit(&rules);
 	dynamic_array_delete(expression);
 	return 0;
 }
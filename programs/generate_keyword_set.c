@@ -0,0 +1,118 @@
+#include "keyword_set.h"
+
+#include <iso646.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+Prints the C code of a keyword set (see string_algorithms/keyword_set.h) for a list of keywords and values.
+The values are copied into the code as they are, so they can be enumerators or other constant expressions.
+
+Usage: generate_keyword_set <name> <keyword> <value> [<keyword> <value> ...]
+*/
+
+static void print_string_literal(FILE *fp, const_stringref_type string)
+{
+	fputc('"', fp);
+	for (size_t i = 0U; i < string.length; ++i) {
+		const unsigned char byte = (unsigned char) string.string[i];
+		if (byte == '"' or byte == '\\') {
+			fprintf(fp, "\\%c", byte);
+		} else if (byte < 0x20U or byte >= 0x7FU or byte == '?') {
+			/* octal escapes always have three digits, so the next character cannot extend them; '?' avoids trigraphs */
+			fprintf(fp, "\\%03o", byte);
+		} else {
+			fputc(byte, fp);
+		}
+	}
+	fputc('"', fp);
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 4 or argc % 2 != 0) {
+		printf("Usage: %s <name> <keyword> <value> [<keyword> <value> ...]\n", argv[0]);
+		return 0;
+	}
+
+	const char *name = argv[1];
+	const size_t number_of_keywords = (size_t) (argc - 2) / 2U;
+	const_stringref_type *keywords = (const_stringref_type*) malloc(number_of_keywords * sizeof(const_stringref_type));
+	const char **values = (const char**) malloc(number_of_keywords * sizeof(const char*));
+	if (keywords == NULL or values == NULL) {
+		fprintf(stderr, "Not enough memory.\n");
+		free(keywords);
+		free(values);
+		return 1;
+	}
+	for (size_t i = 0U; i < number_of_keywords; ++i) {
+		keywords[i] = string_to_const_stringref(argv[2U + 2U * i], strlen(argv[2U + 2U * i]));
+		values[i] = argv[3U + 2U * i];
+		for (size_t j = 0U; j < i; ++j) {
+			if (const_stringref_contents_are_equal(keywords[i], keywords[j])) {
+				fprintf(stderr, "The keyword \"%s\" is given more than once.\n", argv[2U + 2U * i]);
+				free(keywords);
+				free(values);
+				return 1;
+			}
+		}
+	}
+
+	size_t number_of_slots = 1U;
+	while (number_of_slots < number_of_keywords) {
+		number_of_slots *= 2U;
+	}
+	uint32_t seed = 0U;
+	while (not keyword_set_find_seed(keywords, number_of_keywords, number_of_slots, &seed)) {
+		number_of_slots *= 2U;
+	}
+
+	size_t *keyword_index_plus_one = (size_t*) calloc(number_of_slots, sizeof(size_t));
+	if (keyword_index_plus_one == NULL) {
+		fprintf(stderr, "Not enough memory.\n");
+		free(keywords);
+		free(values);
+		return 1;
+	}
+	for (size_t i = 0U; i < number_of_keywords; ++i) {
+		const size_t slot = (size_t) keyword_set_hash(seed, keywords[i].string, keywords[i].length) & (number_of_slots - 1U);
+		keyword_index_plus_one[slot] = i + 1U;
+	}
+
+	FILE *fp = stdout;
+	fprintf(fp, "/* generated by: generate_keyword_set %s", name);
+	for (int i = 2; i < argc; ++i) {
+		fputc(' ', fp);
+		for (const char *p = argv[i]; *p != '\0'; ++p) {
+			fputc(*p, fp);
+			if (p[0] == '*' and p[1] == '/') {
+				/* a space keeps the comment open */
+				fputc(' ', fp);
+			}
+		}
+	}
+	fprintf(fp, " */\n");
+	fprintf(fp, "static const keyword_set_entry_type %s_slots[%lu] = {\n", name, (unsigned long) number_of_slots);
+	for (size_t slot = 0U; slot < number_of_slots; ++slot) {
+		const char *separator = (slot + 1U < number_of_slots) ? "," : "";
+		if (keyword_index_plus_one[slot] > 0U) {
+			const size_t i = keyword_index_plus_one[slot] - 1U;
+			fprintf(fp, "\t{CONST_STRINGREF_LITERAL(");
+			print_string_literal(fp, keywords[i]);
+			fprintf(fp, "), %s}%s\n", values[i], separator);
+		} else {
+			fprintf(fp, "\t{{NULL, 0U}, 0}%s\n", separator);
+		}
+	}
+	fprintf(fp, "};\n");
+	fprintf(fp, "static const keyword_set_type %s = {%s_slots, %luU, 0x%08lXUL};\n",
+		name, name, (unsigned long) number_of_slots, (unsigned long) seed);
+
+	free(keyword_index_plus_one);
+	free(keywords);
+	free(values);
+	return 0;
+}
@@ -1,6 +1,10 @@
 #ifndef SIMPLE_TOKENIZER_H
 #define SIMPLE_TOKENIZER_H
 
+#include "allocator_type.h"
+#include "Boolean_type.h"
+#include "fixed_width_integer_types.h"
+#include "inline_or_static.h"
 #include "string_reference.h"
 
 #ifdef __cplusplus
@@ -51,8 +55,245 @@ const char *simple_tokenizer_token_type_name(simple_tokenizer_token_type_enum to
 
 size_t simple_tokenizer_tokenize(const char *string, size_t string_length, simple_tokenizer_token_type *ptokens, size_t number_of_tokens);
 
+/*
+A growable array of tokens, allocated through an allocator, which simple_tokenizer_tokenize_to_array fills in a
+single pass over the input, instead of counting the tokens with simple_tokenizer_tokenize first.
+*/
+typedef struct simple_tokenizer_token_array_type
+{
+	allocator_type allocator;
+	simple_tokenizer_token_type *tokens;
+	size_t number_of_tokens;
+	size_t capacity;
+} simple_tokenizer_token_array_type;
+
+/* Initializes an empty array. No memory is allocated. */
+void simple_tokenizer_token_array_init(simple_tokenizer_token_array_type *array, allocator_type allocator);
+
+/* Deallocates the tokens of an array, which becomes empty. */
+void simple_tokenizer_token_array_deinit(simple_tokenizer_token_array_type *array);
+
+/* Makes room for at least the number of tokens. Returns Boolean_false if there is not enough memory. */
+Boolean_type simple_tokenizer_token_array_reserve(simple_tokenizer_token_array_type *array, size_t capacity);
+
+/*
+Appends the tokens of a string to an array.
+Room for a number of tokens estimated from the length of the string is reserved first, so the array is usually
+reallocated at most once.
+
+Return value: Boolean_true, or Boolean_false if there is not enough memory, in which case the tokens of the array
+are unchanged.
+*/
+Boolean_type simple_tokenizer_tokenize_to_array(const char *string, size_t string_length,
+	simple_tokenizer_token_array_type *array);
+
+/*
+A compact token takes 8 bytes instead of the 24 bytes of a simple_tokenizer_token_type on 64-bit platforms: the
+offset of the token from the start of the tokenized string, the length in the low 24 bits and the type in the high
+8 bits of a second 32-bit integer. The value of a token is rebuilt from the string with
+simple_tokenizer_compact_token_value.
+
+A string tokenized into compact tokens must not be longer than SIMPLE_TOKENIZER_COMPACT_MAX_STRING_LENGTH bytes,
+otherwise it is rejected without being read; a longer input is tokenized in parts, e.g. at newlines, with an offset
+from the start of each part. A run longer than SIMPLE_TOKENIZER_COMPACT_TOKEN_MAX_LENGTH bytes, which is only
+possible for letters, digits, spaces and zeros, is stored as several consecutive tokens of the same type.
+*/
+typedef struct simple_tokenizer_compact_token_type
+{
+	uint32_t offset;
+	uint32_t length_and_type;
+} simple_tokenizer_compact_token_type;
+
+#define SIMPLE_TOKENIZER_COMPACT_TOKEN_MAX_LENGTH 0xFFFFFFUL
+#define SIMPLE_TOKENIZER_COMPACT_MAX_STRING_LENGTH 0xFFFFFFFFUL
+
+INLINE_OR_STATIC simple_tokenizer_token_type_enum simple_tokenizer_compact_token_type_of(
+	simple_tokenizer_compact_token_type token)
+{
+	return (simple_tokenizer_token_type_enum) (token.length_and_type >> 24U);
+}
+
+INLINE_OR_STATIC size_t simple_tokenizer_compact_token_length(simple_tokenizer_compact_token_type token)
+{
+	return (size_t) (token.length_and_type & SIMPLE_TOKENIZER_COMPACT_TOKEN_MAX_LENGTH);
+}
+
+/* Returns the value of a token of a string, which must be the string which was tokenized. */
+INLINE_OR_STATIC const_stringref_type simple_tokenizer_compact_token_value(const char *string,
+	simple_tokenizer_compact_token_type token)
+{
+	return string_to_const_stringref(string + token.offset, simple_tokenizer_compact_token_length(token));
+}
+
+INLINE_OR_STATIC simple_tokenizer_token_type simple_tokenizer_compact_token_to_token(const char *string,
+	simple_tokenizer_compact_token_type token)
+{
+	simple_tokenizer_token_type full_token;
+	full_token.type = simple_tokenizer_compact_token_type_of(token);
+	full_token.value = simple_tokenizer_compact_token_value(string, token);
+	return full_token;
+}
+
+/*
+As simple_tokenizer_tokenize, but stores compact tokens.
+Return value: the number of tokens, or (size_t) -1 if the string is longer than
+SIMPLE_TOKENIZER_COMPACT_MAX_STRING_LENGTH bytes, in which case no token is stored.
+*/
+size_t simple_tokenizer_tokenize_compact(const char *string, size_t string_length,
+	simple_tokenizer_compact_token_type *tokens, size_t number_of_tokens);
+
+/* A growable array of compact tokens, as simple_tokenizer_token_array_type. */
+typedef struct simple_tokenizer_compact_token_array_type
+{
+	allocator_type allocator;
+	simple_tokenizer_compact_token_type *tokens;
+	size_t number_of_tokens;
+	size_t capacity;
+} simple_tokenizer_compact_token_array_type;
+
+void simple_tokenizer_compact_token_array_init(simple_tokenizer_compact_token_array_type *array,
+	allocator_type allocator);
+
+void simple_tokenizer_compact_token_array_deinit(simple_tokenizer_compact_token_array_type *array);
+
+/*
+As simple_tokenizer_tokenize_to_array, but appends compact tokens. The offsets are from the start of the string,
+so the tokens of different strings should not be mixed in one array.
+Return value: Boolean_false if the string is longer than SIMPLE_TOKENIZER_COMPACT_MAX_STRING_LENGTH bytes or if
+there is not enough memory, in which case the array is left as it was.
+*/
+Boolean_type simple_tokenizer_tokenize_compact_to_array(const char *string, size_t string_length,
+	simple_tokenizer_compact_token_array_type *array);
+
 simple_tokenizer_utf8_char_type  simple_tokenizer_stringref_to_utf8_char(const_stringref_type utf8_char_stringref);
 
+/*
+Returns the length of the longest prefix of a string which is valid UTF-8, i.e. the index of the first byte of the
+first invalid or incomplete character, or the length of the string if it is valid.
+Overlong forms, surrogate halves and code points greater than U+10FFFF are invalid.
+ASCII is skipped a block at a time. With AVX2, the other bytes are validated 32 at a time with the lookup
+algorithm of Keiser and Lemire.
+*/
+size_t simple_tokenizer_utf8_valid_length(const char *string, size_t length);
+
+/*
+The result of a conversion between UTF-8, UTF-16 and UTF-32.
+
+A conversion stops at the first invalid character, or before the first character which does not fit into the
+output. The number of input units is then the index of that character, so a conversion which ran out of room can be
+continued from there. The error tells why a character is invalid:
+
+- simple_tokenizer_utf8_char_error_first_byte_incorrect: a UTF-8 byte which cannot start a character, i.e. a
+  continuation byte, 0xC0, 0xC1 or a byte greater than 0xF4.
+- simple_tokenizer_utf8_char_error_second_byte_incorrect, simple_tokenizer_utf8_char_error_third_byte_incorrect and
+  simple_tokenizer_utf8_char_error_fourth_byte_incorrect: the byte of a UTF-8 character is not a continuation byte,
+  is missing at the end of the input, or makes an overlong form or a code point greater than U+10FFFF.
+- simple_tokenizer_utf8_char_error_unicode_value_is_surrogate_half: a UTF-8 character encodes a surrogate half, or a
+  UTF-16 surrogate half is not part of a pair.
+*/
+typedef struct simple_tokenizer_transcoding_result_type
+{
+	size_t number_of_input_units; /* the number of code units converted */
+	size_t number_of_output_units; /* the number of code units written, or needed if the output is null */
+	simple_tokenizer_utf8_char_error_type error;
+} simple_tokenizer_transcoding_result_type;
+
+/*
+Converts UTF-8 to UTF-32, or UTF-16 with surrogate pairs for the code points greater than U+FFFF.
+Runs of ASCII are widened a block at a time with SSE2. With AVX2, the input is validated a few kilobytes ahead of
+the conversion as by simple_tokenizer_utf8_valid_length, so the characters are decoded without checks; otherwise
+each character is validated as it is decoded.
+
+Parameters:
+string         : The UTF-8 string.
+length         : The number of bytes of the string.
+output         : The buffer for the code units, or null to count the code units which the conversion needs, e.g. to
+                 size a buffer or a dynamic array before converting.
+output_capacity: The number of code units which fit into the output. Ignored if the output is null.
+*/
+simple_tokenizer_transcoding_result_type simple_tokenizer_utf8_to_utf32(const char *string, size_t length,
+	uint32_t *output, size_t output_capacity);
+simple_tokenizer_transcoding_result_type simple_tokenizer_utf8_to_utf16(const char *string, size_t length,
+	uint16_t *output, size_t output_capacity);
+
+/*
+Converts UTF-16 to UTF-8. A surrogate pair becomes one 4-byte character; any other surrogate half is an error.
+Runs of ASCII are narrowed a block at a time with SSE2. The parameters are as for simple_tokenizer_utf8_to_utf32,
+with the length and the capacity swapped between code units of 16 bits and bytes.
+*/
+simple_tokenizer_transcoding_result_type simple_tokenizer_utf16_to_utf8(const uint16_t *string, size_t length,
+	char *output, size_t output_capacity);
+
+/*
+A stream tokenizes its input chunk by chunk, e.g. blocks read from a pipe, and gives the same tokens as
+simple_tokenizer_tokenize for the whole input, including the tokens which cross the boundaries of the chunks.
+
+- The tokens are passed to a callback as soon as they are complete. The value of a token is only valid during
+  the call, since it may refer to a chunk or to the pending bytes of the stream.
+- The bytes of the last token of a chunk which may continue in the next chunk, e.g. a run of letters or the first
+  bytes of a UTF-8 character, are copied to memory allocated through the allocator of the stream. So the memory
+  of a stream is bounded by the length of the longest token, not by the length of the input, or by a maximum
+  token length, see simple_tokenizer_stream_set_maximum_token_length.
+- simple_tokenizer_stream_finish emits the pending tokens at the end of the input.
+- The fields of a stream are private and only changed by the functions below. Callers may read number_of_tokens,
+  which simple_tokenizer_stream_number_of_tokens also returns, but not byte_class_of_pending_run, whose nonzero
+  values are byte classes internal to simple_tokenizer.c.
+
+Example:
+	simple_tokenizer_stream_init(&stream, allocator, &count_words, &number_of_words);
+	while ((length = fread(buffer, 1U, sizeof(buffer), stdin)) > 0U) {
+		if (not simple_tokenizer_stream_feed(&stream, buffer, length)) {
+			break;
+		}
+	}
+	simple_tokenizer_stream_finish(&stream);
+	simple_tokenizer_stream_deinit(&stream);
+*/
+
+typedef void (*simple_tokenizer_token_callback_type)(const simple_tokenizer_token_type *token, void *user_data);
+
+typedef struct simple_tokenizer_stream_type
+{
+	allocator_type allocator;
+	simple_tokenizer_token_callback_type callback;
+	void *user_data;
+	char *pending; /* the bytes after the last emitted token */
+	size_t length_of_pending;
+	size_t capacity_of_pending;
+	int byte_class_of_pending_run; /* the internal byte class of the pending bytes if they are one run, or 0 */
+	size_t maximum_token_length;
+	size_t number_of_tokens;
+} simple_tokenizer_stream_type;
+
+/* Initializes a stream. The callback must not be null. No memory is allocated. */
+void simple_tokenizer_stream_init(simple_tokenizer_stream_type *stream, allocator_type allocator,
+	simple_tokenizer_token_callback_type callback, void *user_data);
+
+/* Deallocates the pending bytes of a stream. Pending tokens are discarded, see simple_tokenizer_stream_finish. */
+void simple_tokenizer_stream_deinit(simple_tokenizer_stream_type *stream);
+
+/*
+Splits the runs longer than a maximum token length, at least 4 bytes, into several tokens of the same type, as
+simple_tokenizer_tokenize_compact does: each piece but the last is as long as the maximum. So the pending bytes never
+take more memory than the maximum, even for an input which is one run of gigabytes. By default, runs are not split.
+*/
+void simple_tokenizer_stream_set_maximum_token_length(simple_tokenizer_stream_type *stream,
+	size_t maximum_token_length);
+
+/*
+Tokenizes the next chunk of the input and emits the tokens which are complete.
+
+Return value: Boolean_true, or Boolean_false if there is not enough memory for the pending bytes, in which case
+the tokens of the rest of the input are lost and the stream should be deinitialized.
+*/
+Boolean_type simple_tokenizer_stream_feed(simple_tokenizer_stream_type *stream, const char *chunk, size_t chunk_length);
+
+/* Emits the pending tokens at the end of the input. The stream can then be fed a new input. */
+void simple_tokenizer_stream_finish(simple_tokenizer_stream_type *stream);
+
+/* Returns the number of tokens emitted so far. */
+size_t simple_tokenizer_stream_number_of_tokens(const simple_tokenizer_stream_type *stream);
+
 #ifdef __cplusplus
 }
 #endif
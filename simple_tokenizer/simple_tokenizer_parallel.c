@@ -0,0 +1,238 @@
+#if defined(__unix__) || defined(__APPLE__)
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L /* for pthread.h */
+#endif
+#define SIMPLE_TOKENIZER_PARALLEL_POSIX 1
+#elif defined(_WIN32)
+#define SIMPLE_TOKENIZER_PARALLEL_WINDOWS 1
+#endif
+
+#include "simple_tokenizer_parallel.h"
+#include <assert.h>
+#include <iso646.h>
+#include <string.h>
+
+#if defined(SIMPLE_TOKENIZER_PARALLEL_POSIX)
+#include <pthread.h>
+#elif defined(SIMPLE_TOKENIZER_PARALLEL_WINDOWS)
+#include <windows.h>
+#endif
+
+/* Notes:
+- The calling thread tokenizes the first chunk directly into the array, so its tokens are not copied. Each other
+  chunk is tokenized into an array of its own, which is appended after all the threads have finished.
+- The tokens refer to the bytes of the string itself, so they need no adjustment when they are appended.
+- The newline is searched within a limited distance of the nominal end of a chunk. Without a newline, the chunk
+  ends after the first run of spaces, which is found with memchr. So a string without newlines, spaces or tabs is
+  still scanned by the calling thread before the worker threads start, but with memchr instead of byte by byte.
+*/
+
+typedef struct simple_tokenizer_parallel_chunk_type
+{
+	const char *string;
+	size_t length;
+	simple_tokenizer_token_array_type tokens;
+	Boolean_type is_tokenized;
+	Boolean_type has_thread;
+#if defined(SIMPLE_TOKENIZER_PARALLEL_POSIX)
+	pthread_t thread;
+#elif defined(SIMPLE_TOKENIZER_PARALLEL_WINDOWS)
+	HANDLE thread;
+#endif
+} simple_tokenizer_parallel_chunk_type;
+
+static void tokenize_chunk(simple_tokenizer_parallel_chunk_type *chunk)
+{
+	chunk->is_tokenized = simple_tokenizer_tokenize_to_array(chunk->string, chunk->length, &chunk->tokens);
+}
+
+#if defined(SIMPLE_TOKENIZER_PARALLEL_POSIX)
+
+static void *posix_thread_main(void *argument)
+{
+	tokenize_chunk((simple_tokenizer_parallel_chunk_type*) argument);
+	return NULL;
+}
+
+static Boolean_type start_thread(simple_tokenizer_parallel_chunk_type *chunk)
+{
+	return (Boolean_type) (pthread_create(&chunk->thread, NULL, &posix_thread_main, chunk) == 0);
+}
+
+static void join_thread(simple_tokenizer_parallel_chunk_type *chunk)
+{
+	(void) pthread_join(chunk->thread, NULL);
+}
+
+#elif defined(SIMPLE_TOKENIZER_PARALLEL_WINDOWS)
+
+static DWORD WINAPI windows_thread_main(LPVOID argument)
+{
+	tokenize_chunk((simple_tokenizer_parallel_chunk_type*) argument);
+	return 0;
+}
+
+static Boolean_type start_thread(simple_tokenizer_parallel_chunk_type *chunk)
+{
+	chunk->thread = CreateThread(NULL, 0, &windows_thread_main, chunk, 0, NULL);
+	return (Boolean_type) (chunk->thread != NULL);
+}
+
+static void join_thread(simple_tokenizer_parallel_chunk_type *chunk)
+{
+	(void) WaitForSingleObject(chunk->thread, INFINITE);
+	(void) CloseHandle(chunk->thread);
+}
+
+#else
+
+static Boolean_type start_thread(simple_tokenizer_parallel_chunk_type *chunk)
+{
+	(void) chunk;
+	return Boolean_false;
+}
+
+static void join_thread(simple_tokenizer_parallel_chunk_type *chunk)
+{
+	(void) chunk;
+}
+
+#endif
+
+static Boolean_type is_space(char byte)
+{
+	return (Boolean_type) (byte == ' ' or byte == '\t');
+}
+
+/* Returns the position of the first space or tab from a position up to a limit, or the limit if there is none. */
+static size_t find_space(const char *string, size_t position, size_t limit)
+{
+	const char *space = (const char*) memchr(string + position, ' ', limit - position);
+	const size_t space_limit = (space != NULL) ? (size_t) (space - string) : limit;
+	const char *tab = (const char*) memchr(string + position, '\t', space_limit - position);
+	return (tab != NULL) ? (size_t) (tab - string) : space_limit;
+}
+
+/*
+Returns the first position from a position up to a limit at which a chunk may end: after the first newline within
+a limited distance, or else at the end of the first run of spaces. Returns the limit if there is no such position.
+*/
+static size_t find_chunk_end(const char *string, size_t position, size_t limit)
+{
+	static const char spaces[8] = {' ', ' ', ' ', ' ', ' ', ' ', ' ', ' '};
+	const size_t max_newline_distance = 4096U;
+	const size_t newline_limit = (limit - position < max_newline_distance) ? limit : position + max_newline_distance;
+	const char *newline = (const char*) memchr(string + position, '\n', newline_limit - position);
+
+	if (newline != NULL) {
+		return (size_t) (newline - string) + 1U;
+	}
+	/* the run of spaces may start just before the position */
+	position = find_space(string, position - 1U, limit);
+	while (limit - position >= sizeof(spaces) and memcmp(string + position, spaces, sizeof(spaces)) == 0) {
+		position += sizeof(spaces);
+	}
+	while (position < limit and is_space(string[position])) {
+		++position;
+	}
+	return position;
+}
+
+/*
+Splits a string into chunks of at least the nominal length, except for the last one. Returns the number of chunks,
+which is at most the maximum number of chunks if the nominal length is at least the length divided by it.
+*/
+static size_t split_into_chunks(const char *string, size_t string_length, size_t nominal_length,
+	simple_tokenizer_parallel_chunk_type *chunks)
+{
+	size_t number_of_chunks = 0U;
+	size_t start = 0U;
+
+	while (start < string_length) {
+		size_t end = string_length;
+		size_t candidate = start + nominal_length;
+
+		while (candidate < string_length) {
+			const size_t limit = (string_length - candidate > nominal_length) ? candidate + nominal_length : string_length;
+			end = find_chunk_end(string, candidate, limit);
+			if (end < limit) {
+				break;
+			}
+			end = string_length;
+			candidate = limit;
+		}
+		chunks[number_of_chunks].string = string + start;
+		chunks[number_of_chunks].length = end - start;
+		++number_of_chunks;
+		start = end;
+	}
+	return number_of_chunks;
+}
+
+Boolean_type simple_tokenizer_parallel_tokenize_to_array(const char *string, size_t string_length,
+	simple_tokenizer_token_array_type *array, size_t number_of_threads)
+{
+	const size_t old_number_of_tokens = array->number_of_tokens;
+	size_t max_number_of_chunks = string_length / SIMPLE_TOKENIZER_PARALLEL_MIN_CHUNK_LENGTH;
+	size_t nominal_length = 0U;
+	size_t number_of_chunks = 0U;
+	size_t number_of_tokens = 0U;
+	simple_tokenizer_parallel_chunk_type *chunks = NULL;
+	Boolean_type is_tokenized = Boolean_true;
+	size_t i = 0U;
+
+	assert(string != NULL or string_length == 0U);
+	assert(array != NULL);
+	assert(number_of_threads >= 1U);
+
+	if (max_number_of_chunks > number_of_threads) {
+		max_number_of_chunks = number_of_threads;
+	}
+	if (max_number_of_chunks <= 1U) {
+		return simple_tokenizer_tokenize_to_array(string, string_length, array);
+	}
+	chunks = (simple_tokenizer_parallel_chunk_type*) array->allocator.allocate(
+		max_number_of_chunks * sizeof(simple_tokenizer_parallel_chunk_type));
+	if (chunks == NULL) {
+		return Boolean_false;
+	}
+	nominal_length = string_length / max_number_of_chunks + ((string_length % max_number_of_chunks != 0U) ? 1U : 0U);
+	number_of_chunks = split_into_chunks(string, string_length, nominal_length, chunks);
+	assert(number_of_chunks <= max_number_of_chunks);
+
+	for (i = 1U; i < number_of_chunks; ++i) {
+		simple_tokenizer_token_array_init(&chunks[i].tokens, array->allocator);
+		chunks[i].is_tokenized = Boolean_false;
+		chunks[i].has_thread = start_thread(&chunks[i]);
+	}
+	is_tokenized = simple_tokenizer_tokenize_to_array(chunks[0].string, chunks[0].length, array);
+	for (i = 1U; i < number_of_chunks; ++i) {
+		if (chunks[i].has_thread) {
+			join_thread(&chunks[i]);
+		} else if (is_tokenized) {
+			tokenize_chunk(&chunks[i]);
+		}
+		is_tokenized = (Boolean_type) (is_tokenized and chunks[i].is_tokenized);
+		number_of_tokens += chunks[i].tokens.number_of_tokens;
+	}
+
+	if (is_tokenized and number_of_tokens > ((size_t) -1) - array->number_of_tokens) {
+		is_tokenized = Boolean_false;
+	}
+	if (is_tokenized) {
+		is_tokenized = simple_tokenizer_token_array_reserve(array, array->number_of_tokens + number_of_tokens);
+	}
+	for (i = 1U; i < number_of_chunks; ++i) {
+		if (is_tokenized and chunks[i].tokens.number_of_tokens > 0U) {
+			memcpy(array->tokens + array->number_of_tokens, chunks[i].tokens.tokens,
+				chunks[i].tokens.number_of_tokens * sizeof(simple_tokenizer_token_type));
+			array->number_of_tokens += chunks[i].tokens.number_of_tokens;
+		}
+		simple_tokenizer_token_array_deinit(&chunks[i].tokens);
+	}
+	allocator_deallocate(array->allocator, chunks);
+	if (not is_tokenized) {
+		array->number_of_tokens = old_number_of_tokens;
+	}
+	return is_tokenized;
+}
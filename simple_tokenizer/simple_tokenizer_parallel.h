@@ -0,0 +1,47 @@
+/* Minimum C Standard: C89 */
+
+#ifndef SIMPLE_TOKENIZER_PARALLEL_H
+#define SIMPLE_TOKENIZER_PARALLEL_H
+
+#include "Boolean_type.h"
+#include "simple_tokenizer.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+Tokenizes a large string on several threads and gives the same tokens as simple_tokenizer_tokenize_to_array.
+
+The string is split into about one chunk per thread. A chunk ends after a newline, or else at the end of a run of
+spaces, near its nominal end, since a token never continues past these positions: a run of spaces ends at the first
+byte which is not a space, and a newline byte is never a part of a UTF-8 character. A chunk without such a position
+is merged with the next one, so a string without any whitespace is tokenized by one thread.
+
+The chunks are tokenized by simple_tokenizer_tokenize_to_array on worker threads, with POSIX threads or Windows
+threads, into arrays of their own, and the tokens are then appended to the array in order. On other platforms, or
+if a thread cannot be started, the chunks are tokenized by the calling thread. Chunks smaller than
+SIMPLE_TOKENIZER_PARALLEL_MIN_CHUNK_LENGTH bytes are not worth a thread, so short strings use fewer threads.
+
+The allocator of the array is called by several threads at once, so it must be thread-safe, e.g. malloc and free.
+
+Parameters:
+string           : The string.
+string_length    : The number of bytes of the string.
+array            : The array to which the tokens are appended.
+number_of_threads: The maximum number of threads, including the calling thread. Must be at least 1.
+
+Return value: Boolean_true, or Boolean_false if there is not enough memory, in which case the tokens of the array
+are unchanged.
+*/
+Boolean_type simple_tokenizer_parallel_tokenize_to_array(const char *string, size_t string_length,
+	simple_tokenizer_token_array_type *array, size_t number_of_threads);
+
+#define SIMPLE_TOKENIZER_PARALLEL_MIN_CHUNK_LENGTH 65536U
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,191 @@
+#include "simple_tokenizer_parallel.h"
+#include "sizeof_array.h"
+#include "unit_testing.h"
+#include "unit_testing_allocator.h"
+#include <iso646.h>
+#include <stdlib.h>
+#include <string.h>
+
+static char s_text[1000000];
+
+/* The worker threads allocate at once, so only the test without memory uses the counting test allocator. */
+static const allocator_type s_allocator = {&malloc, &realloc, &free};
+
+/* Fills the text with words, numbers, operators, UTF-8 characters and invalid bytes, with spaces and newlines. */
+static void fill_text(size_t length, unsigned int newline_percent, unsigned int space_percent)
+{
+	static const char *const pieces[] = {
+		"index", "42", "+", "==", "\xC3\xA9t\xC3\xA9", "\xE6\x97\xA5\xE6\x9C\xAC", "\xF0\x9F\x98\x80", "\x80\xFF",
+		"\xE2\x82", "\0\0", "\r", "(", "x1", "\t"
+	};
+	unsigned long state = 12345UL;
+	size_t position = 0U;
+
+	while (position < length) {
+		unsigned int kind = 0U;
+		const char *piece = NULL;
+		size_t piece_length = 0U;
+
+		state = (state * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+		kind = (unsigned int) ((state >> 8U) % 100U);
+		if (kind < newline_percent) {
+			piece = ((state >> 20U) % 2U == 0U) ? "\n" : "\r\n";
+		} else if (kind < newline_percent + space_percent) {
+			piece = ((state >> 20U) % 2U == 0U) ? " " : "  \t";
+		} else {
+			piece = pieces[(state >> 16U) % sizeof_array(pieces)];
+		}
+		piece_length = (piece[0] == '\0') ? 2U : strlen(piece);
+		if (piece_length > length - position) {
+			piece_length = length - position;
+		}
+		memcpy(s_text + position, piece, piece_length);
+		position += piece_length;
+	}
+}
+
+/* Returns Boolean_true if the tokens of the array are the tokens of the sequential tokenizer. */
+static Boolean_type has_sequential_tokens(const simple_tokenizer_token_array_type *array, size_t length)
+{
+	simple_tokenizer_token_array_type expected;
+	Boolean_type is_equal = Boolean_false;
+
+	simple_tokenizer_token_array_init(&expected, s_allocator);
+	if (simple_tokenizer_tokenize_to_array(s_text, length, &expected) and
+		expected.number_of_tokens == array->number_of_tokens) {
+		size_t i = 0U;
+		is_equal = Boolean_true;
+		for (i = 0U; i < expected.number_of_tokens; ++i) {
+			if (expected.tokens[i].type != array->tokens[i].type or
+				expected.tokens[i].value.string != array->tokens[i].value.string or
+				expected.tokens[i].value.length != array->tokens[i].value.length) {
+				is_equal = Boolean_false;
+				break;
+			}
+		}
+	}
+	simple_tokenizer_token_array_deinit(&expected);
+	return is_equal;
+}
+
+TEST(test_with_small_inputs, "Inputs smaller than two chunks => the tokens of one thread")
+{
+	simple_tokenizer_token_array_type array;
+
+	simple_tokenizer_token_array_init(&array, s_allocator);
+	ASSERT(simple_tokenizer_parallel_tokenize_to_array("", 0U, &array, 4U));
+	ASSERT_EQUAL(array.number_of_tokens, 0U);
+	fill_text(1000U, 5U, 20U);
+	ASSERT(simple_tokenizer_parallel_tokenize_to_array(s_text, 1000U, &array, 4U));
+	ASSERT(has_sequential_tokens(&array, 1000U));
+	simple_tokenizer_token_array_deinit(&array);
+}
+
+TEST(test_with_large_inputs, "Inputs split into chunks on several threads => the tokens of the sequential tokenizer")
+{
+	static const unsigned int percents[][2] = {{5U, 20U}, {0U, 20U}, {0U, 1U}, {0U, 0U}, {30U, 30U}};
+	size_t i = 0U;
+
+	for (i = 0U; i < sizeof_array(percents); ++i) {
+		size_t number_of_threads = 1U;
+		fill_text(sizeof(s_text), percents[i][0], percents[i][1]);
+		for (number_of_threads = 1U; number_of_threads <= 16U; number_of_threads *= 2U) {
+			simple_tokenizer_token_array_type array;
+			simple_tokenizer_token_array_init(&array, s_allocator);
+			ASSERT(simple_tokenizer_parallel_tokenize_to_array(s_text, sizeof(s_text), &array, number_of_threads));
+			ASSERT(has_sequential_tokens(&array, sizeof(s_text)));
+			simple_tokenizer_token_array_deinit(&array);
+		}
+	}
+}
+
+TEST(test_without_whitespace, "An input without spaces and newlines => one chunk, so a run is not split")
+{
+	simple_tokenizer_token_array_type array;
+
+	memset(s_text, 'a', sizeof(s_text));
+	memcpy(s_text + sizeof(s_text) / 2U, "\xC3\xA9", 2U);
+	simple_tokenizer_token_array_init(&array, s_allocator);
+	ASSERT(simple_tokenizer_parallel_tokenize_to_array(s_text, sizeof(s_text), &array, 4U));
+	ASSERT_EQUAL(array.number_of_tokens, 3U);
+	ASSERT(has_sequential_tokens(&array, sizeof(s_text)));
+	simple_tokenizer_token_array_deinit(&array);
+}
+
+TEST(test_with_long_runs_of_spaces, "Long runs of spaces and tabs without newlines => a run is not split")
+{
+	static const char run[] = "  \t \t\t        \t  ";
+	size_t position = 0U;
+	size_t run_length = 1U;
+	size_t number_of_threads = 1U;
+
+	while (position < sizeof(s_text)) {
+		size_t i = 0U;
+		s_text[position++] = 'x';
+		for (i = 0U; i < run_length and position < sizeof(s_text); ++i) {
+			s_text[position++] = run[i % (sizeof(run) - 1U)];
+		}
+		run_length = run_length * 3U % 20011U;
+	}
+	for (number_of_threads = 2U; number_of_threads <= 16U; number_of_threads *= 2U) {
+		simple_tokenizer_token_array_type array;
+		simple_tokenizer_token_array_init(&array, s_allocator);
+		ASSERT(simple_tokenizer_parallel_tokenize_to_array(s_text, sizeof(s_text), &array, number_of_threads));
+		ASSERT(has_sequential_tokens(&array, sizeof(s_text)));
+		simple_tokenizer_token_array_deinit(&array);
+	}
+}
+
+TEST(test_with_existing_tokens, "The tokens are appended after the tokens of the array")
+{
+	simple_tokenizer_token_array_type array;
+	const size_t length = 300000U;
+	size_t number_of_first_tokens = 0U;
+
+	fill_text(length, 5U, 20U);
+	simple_tokenizer_token_array_init(&array, s_allocator);
+	ASSERT(simple_tokenizer_tokenize_to_array(s_text, length / 2U, &array));
+	number_of_first_tokens = array.number_of_tokens;
+	ASSERT(simple_tokenizer_parallel_tokenize_to_array(s_text + length / 2U, length - length / 2U, &array, 3U));
+	ASSERT(array.tokens[number_of_first_tokens].value.string == s_text + length / 2U);
+	simple_tokenizer_token_array_deinit(&array);
+}
+
+TEST(test_without_memory, "Not enough memory => Boolean_false and the tokens of the array are unchanged")
+{
+	simple_tokenizer_token_array_type array;
+	size_t number_of_allocations = 0U;
+
+	fill_text(sizeof(s_text), 5U, 20U);
+	simple_tokenizer_token_array_init(&array, unit_testing_make_allocator());
+	ASSERT(simple_tokenizer_tokenize_to_array("abc def", 7U, &array));
+	/*
+	Only the array of chunks, which the calling thread allocates before the worker threads start, may be allocated,
+	so every allocation of a worker thread fails and the unsynchronized counters are only read by the threads.
+	*/
+	for (number_of_allocations = 0U; number_of_allocations < 2U; ++number_of_allocations) {
+		unit_testing_allocations_until_failure = number_of_allocations;
+		ASSERT(not simple_tokenizer_parallel_tokenize_to_array(s_text, sizeof(s_text), &array, 4U));
+		ASSERT_EQUAL(array.number_of_tokens, 3U);
+		ASSERT(array.tokens[2].value.string[0] == 'd');
+	}
+	simple_tokenizer_token_array_deinit(&array);
+}
+
+int main(void)
+{
+	DEFINE_LIST_OF_TESTS(tests) {
+		test_with_small_inputs,
+		test_with_large_inputs,
+		test_without_whitespace,
+		test_with_long_runs_of_spaces,
+		test_with_existing_tokens,
+		test_without_memory
+	};
+
+	SET_OUTPUT_FILE(stdout);
+	PRINT_FILE_NAME();
+	RUN_TESTS(tests);
+	PRINT_TEST_STATISTICS(tests);
+	return 0;
+}
@@ -0,0 +1,863 @@
+#include "simple_tokenizer_rules.h"
+
+#include <assert.h>
+#include <iso646.h>
+#include <string.h>
+
+/* Notes:
+- A pattern is parsed into a sequence of elements, each a set of 256 bits and a repetition. X+ is stored as X X*.
+- The positions of a pattern are the numbers of its elements which have been matched, from 0 to the number of
+  elements, where the pattern matches. The states of the automaton are sets of positions of all the patterns,
+  built by the subset construction. The sets of the states are bit sets, which are compared with memcmp.
+- State 0 has the empty set. It stops the automaton, so every byte class of state 0 leads to state 0 again.
+- All the bytes of a byte class belong to the same element sets, so one byte of each class is enough to compute
+  the transitions.
+- A set of positions of a state can be completed by some bytes, so stopping at the states which reach no accepting
+  state would only stop at state 0. Maximal munch is made linear instead by remembering the pairs of a state and a
+  position of the string from which no accepting state was reached, as in "Maximal-Munch" Tokenization in Linear
+  Time (Reps, 1998).
+*/
+
+typedef enum rule_repetition_type_enum {
+	rule_repetition_once = 0,
+	rule_repetition_optional,
+	rule_repetition_any
+} rule_repetition_type_enum;
+
+typedef struct rule_element_type
+{
+	unsigned char bytes[32];
+	rule_repetition_type_enum repetition;
+} rule_element_type;
+
+struct simple_tokenizer_rule_type
+{
+	int token_type;
+	rule_element_type *elements;
+	size_t number_of_elements;
+};
+
+static Boolean_type element_has_byte(const rule_element_type *element, unsigned int byte)
+{
+	return (Boolean_type) ((element->bytes[byte >> 3U] & (1U << (byte & 7U))) != 0U);
+}
+
+static void add_byte_range(rule_element_type *element, unsigned int first_byte, unsigned int last_byte)
+{
+	unsigned int byte = 0U;
+
+	for (byte = first_byte; byte <= last_byte; ++byte) {
+		element->bytes[byte >> 3U] = (unsigned char) (element->bytes[byte >> 3U] | (1U << (byte & 7U)));
+	}
+}
+
+static int hexadecimal_digit_value(char digit)
+{
+	if (digit >= '0' and digit <= '9') {
+		return digit - '0';
+	}
+	if (digit >= 'a' and digit <= 'f') {
+		return digit - 'a' + 10;
+	}
+	if (digit >= 'A' and digit <= 'F') {
+		return digit - 'A' + 10;
+	}
+	return -1;
+}
+
+/* Parses a byte or an escape sequence. Returns the position after it, or NULL if it is incorrect. */
+static const char *parse_byte(const char *pattern, unsigned int *byte)
+{
+	if (pattern[0] == '\0') {
+		return NULL;
+	}
+	if (pattern[0] != '\\') {
+		*byte = (unsigned char) pattern[0];
+		return pattern + 1;
+	}
+	switch (pattern[1]) {
+	case '\0':
+		return NULL;
+	case 'x':
+		{
+			const int high_digit = hexadecimal_digit_value(pattern[2]);
+			const int low_digit = (high_digit < 0) ? -1 : hexadecimal_digit_value(pattern[3]);
+			if (low_digit < 0) {
+				return NULL;
+			}
+			*byte = (unsigned int) (high_digit * 16 + low_digit);
+		}
+		return pattern + 4;
+	case 'n':
+		*byte = '\n';
+		break;
+	case 'r':
+		*byte = '\r';
+		break;
+	case 't':
+		*byte = '\t';
+		break;
+	default:
+		*byte = (unsigned char) pattern[1];
+		break;
+	}
+	return pattern + 2;
+}
+
+/* Parses a set of bytes after its [. Returns the position after its ], or NULL if it is incorrect. */
+static const char *parse_byte_set(const char *pattern, rule_element_type *element)
+{
+	Boolean_type is_negated = Boolean_false;
+	Boolean_type is_empty = Boolean_true;
+	size_t i = 0U;
+
+	if (pattern[0] == '^') {
+		is_negated = Boolean_true;
+		++pattern;
+	}
+	while (pattern[0] != ']') {
+		unsigned int first_byte = 0U;
+		unsigned int last_byte = 0U;
+
+		pattern = parse_byte(pattern, &first_byte);
+		if (pattern == NULL) {
+			return NULL;
+		}
+		last_byte = first_byte;
+		if (pattern[0] == '-' and pattern[1] != ']') {
+			pattern = parse_byte(pattern + 1, &last_byte);
+			if (pattern == NULL or last_byte < first_byte) {
+				return NULL;
+			}
+		}
+		add_byte_range(element, first_byte, last_byte);
+		is_empty = Boolean_false;
+	}
+	if (is_empty) {
+		return NULL;
+	}
+	if (is_negated) {
+		for (i = 0U; i < sizeof(element->bytes); ++i) {
+			element->bytes[i] = (unsigned char) ~element->bytes[i];
+		}
+	}
+	return pattern + 1;
+}
+
+/*
+Parses a pattern into elements, of which there are at most as many as the bytes of the pattern.
+Returns the number of elements, or 0 if the pattern is empty or incorrect.
+*/
+static size_t parse_pattern(const char *pattern, rule_element_type *elements)
+{
+	size_t number_of_elements = 0U;
+
+	while (pattern[0] != '\0') {
+		rule_element_type *element = &elements[number_of_elements];
+
+		memset(element, 0, sizeof(rule_element_type));
+		element->repetition = rule_repetition_once;
+		switch (pattern[0]) {
+		case '[':
+			pattern = parse_byte_set(pattern + 1, element);
+			break;
+		case '.':
+			add_byte_range(element, 0U, 255U);
+			++pattern;
+			break;
+		case ']':
+		case '?':
+		case '*':
+		case '+':
+			return 0U;
+		default:
+			{
+				unsigned int byte = 0U;
+				pattern = parse_byte(pattern, &byte);
+				add_byte_range(element, byte, byte);
+			}
+			break;
+		}
+		if (pattern == NULL) {
+			return 0U;
+		}
+		++number_of_elements;
+
+		if (pattern[0] == '?') {
+			element->repetition = rule_repetition_optional;
+			++pattern;
+		} else if (pattern[0] == '*') {
+			element->repetition = rule_repetition_any;
+			++pattern;
+		} else if (pattern[0] == '+') {
+			elements[number_of_elements] = *element;
+			elements[number_of_elements].repetition = rule_repetition_any;
+			++number_of_elements;
+			++pattern;
+		}
+	}
+	return number_of_elements;
+}
+
+static void deinit_automaton(simple_tokenizer_rules_type *rules)
+{
+	allocator_deallocate(rules->allocator, rules->transitions);
+	allocator_deallocate(rules->allocator, rules->accepted_rules);
+	rules->transitions = NULL;
+	rules->accepted_rules = NULL;
+	rules->number_of_classes = 0U;
+	rules->number_of_states = 0U;
+	memset(rules->byte_classes, 0, sizeof(rules->byte_classes));
+}
+
+void simple_tokenizer_rules_init(simple_tokenizer_rules_type *rules, allocator_type allocator,
+	int unmatched_token_type)
+{
+	assert(rules != NULL);
+	assert(allocator.allocate != NULL);
+	assert(allocator.deallocate != NULL);
+	rules->allocator = allocator;
+	rules->unmatched_token_type = unmatched_token_type;
+	rules->rules = NULL;
+	rules->number_of_rules = 0U;
+	rules->capacity = 0U;
+	rules->transitions = NULL;
+	rules->accepted_rules = NULL;
+	deinit_automaton(rules);
+}
+
+void simple_tokenizer_rules_deinit(simple_tokenizer_rules_type *rules)
+{
+	size_t i = 0U;
+
+	assert(rules != NULL);
+	for (i = 0U; i < rules->number_of_rules; ++i) {
+		allocator_deallocate(rules->allocator, rules->rules[i].elements);
+	}
+	allocator_deallocate(rules->allocator, rules->rules);
+	rules->rules = NULL;
+	rules->number_of_rules = 0U;
+	rules->capacity = 0U;
+	deinit_automaton(rules);
+}
+
+/* Appends a rule which takes ownership of its elements. Returns Boolean_false if there is not enough memory. */
+static Boolean_type append_rule(simple_tokenizer_rules_type *rules, rule_element_type *elements,
+	size_t number_of_elements, int token_type)
+{
+	simple_tokenizer_rule_type *rule = NULL;
+
+	if (rules->number_of_rules == rules->capacity) {
+		const size_t new_capacity = (rules->capacity == 0U) ? 8U : 2U * rules->capacity;
+		simple_tokenizer_rule_type *new_rules = (simple_tokenizer_rule_type*) allocator_reallocate(rules->allocator,
+			rules->rules, rules->capacity * sizeof(simple_tokenizer_rule_type),
+			new_capacity * sizeof(simple_tokenizer_rule_type));
+		if (new_rules == NULL) {
+			allocator_deallocate(rules->allocator, elements);
+			return Boolean_false;
+		}
+		rules->rules = new_rules;
+		rules->capacity = new_capacity;
+	}
+	rule = &rules->rules[rules->number_of_rules];
+	rule->token_type = token_type;
+	rule->elements = elements;
+	rule->number_of_elements = number_of_elements;
+	++rules->number_of_rules;
+	return Boolean_true;
+}
+
+Boolean_type simple_tokenizer_rules_add_pattern(simple_tokenizer_rules_type *rules, const char *pattern,
+	int token_type)
+{
+	const size_t pattern_length = strlen(pattern);
+	rule_element_type *elements = NULL;
+	size_t number_of_elements = 0U;
+
+	assert(rules != NULL);
+	assert(pattern != NULL);
+	if (pattern_length == 0U or pattern_length > ((size_t) -1) / sizeof(rule_element_type)) {
+		return Boolean_false;
+	}
+	elements = (rule_element_type*) allocator_allocate(rules->allocator, pattern_length * sizeof(rule_element_type));
+	if (elements == NULL) {
+		return Boolean_false;
+	}
+	number_of_elements = parse_pattern(pattern, elements);
+	if (number_of_elements == 0U) {
+		allocator_deallocate(rules->allocator, elements);
+		return Boolean_false;
+	}
+	return append_rule(rules, elements, number_of_elements, token_type);
+}
+
+Boolean_type simple_tokenizer_rules_add_literal(simple_tokenizer_rules_type *rules, const_stringref_type literal,
+	int token_type)
+{
+	rule_element_type *elements = NULL;
+	size_t i = 0U;
+
+	assert(rules != NULL);
+	assert(literal.string != NULL or literal.length == 0U);
+	if (literal.length == 0U or literal.length > ((size_t) -1) / sizeof(rule_element_type)) {
+		return Boolean_false;
+	}
+	elements = (rule_element_type*) allocator_allocate(rules->allocator, literal.length * sizeof(rule_element_type));
+	if (elements == NULL) {
+		return Boolean_false;
+	}
+	for (i = 0U; i < literal.length; ++i) {
+		const unsigned int byte = (unsigned char) literal.string[i];
+		elements[i].repetition = rule_repetition_once;
+		add_byte_range(&elements[i], byte, byte);
+	}
+	return append_rule(rules, elements, literal.length, token_type);
+}
+
+/*
+Splits the bytes into classes, so that two bytes are in the same class if every element of every rule has both
+or neither of them. Each element splits each class into the bytes it has and the bytes it does not have.
+*/
+static void compute_byte_classes(simple_tokenizer_rules_type *rules)
+{
+	unsigned short new_classes[512];
+	size_t i = 0U;
+	size_t j = 0U;
+	unsigned int byte = 0U;
+
+	memset(rules->byte_classes, 0, sizeof(rules->byte_classes));
+	rules->number_of_classes = 1U;
+	for (i = 0U; i < rules->number_of_rules; ++i) {
+		for (j = 0U; j < rules->rules[i].number_of_elements; ++j) {
+			const rule_element_type *element = &rules->rules[i].elements[j];
+			size_t number_of_classes = 0U;
+
+			memset(new_classes, 0xFF, sizeof(new_classes));
+			for (byte = 0U; byte < 256U; ++byte) {
+				const size_t key = 2U * rules->byte_classes[byte] + (element_has_byte(element, byte) ? 1U : 0U);
+				if (new_classes[key] == 0xFFFFU) {
+					new_classes[key] = (unsigned short) number_of_classes++;
+				}
+				rules->byte_classes[byte] = (unsigned char) new_classes[key];
+			}
+			rules->number_of_classes = number_of_classes;
+		}
+	}
+}
+
+/*
+The sets of positions of the states under construction. The position of element e of rule r is the bit
+first_positions[r] + e, and the bit first_positions[r] + number_of_elements is set where rule r matches.
+The states are found by their sets in a hash table with open addressing, whose slots hold a state plus 1, or 0.
+*/
+typedef struct position_sets_type
+{
+	size_t *first_positions;
+	size_t set_size;
+	unsigned char *sets;
+	size_t capacity;
+	size_t *slots;
+	size_t number_of_slots;
+} position_sets_type;
+
+/* Adds a position to a set, and the positions after the elements which may be skipped. */
+static void add_position(unsigned char *set, const simple_tokenizer_rule_type *rule, size_t first_position,
+	size_t element_index)
+{
+	for (;;) {
+		const size_t position = first_position + element_index;
+		set[position >> 3U] = (unsigned char) (set[position >> 3U] | (1U << (position & 7U)));
+		if (element_index == rule->number_of_elements or
+			rule->elements[element_index].repetition == rule_repetition_once) {
+			break;
+		}
+		++element_index;
+	}
+}
+
+static Boolean_type set_has_position(const unsigned char *set, size_t position)
+{
+	return (Boolean_type) ((set[position >> 3U] & (1U << (position & 7U))) != 0U);
+}
+
+/* Returns the FNV-1a hash of a set. */
+static size_t hash_set(const unsigned char *set, size_t set_size)
+{
+	unsigned long hash = 2166136261UL;
+	size_t i = 0U;
+
+	for (i = 0U; i < set_size; ++i) {
+		hash = ((hash ^ set[i]) * 16777619UL) & 0xFFFFFFFFUL;
+	}
+	return (size_t) hash;
+}
+
+/*
+Returns the slot of a set in the hash table: the slot of the first state with the set, or else the empty slot where
+it would be added.
+*/
+static size_t find_slot(const position_sets_type *position_sets, const unsigned char *set)
+{
+	const size_t set_size = position_sets->set_size;
+	size_t slot = hash_set(set, set_size) & (position_sets->number_of_slots - 1U);
+
+	while (position_sets->slots[slot] != 0U and
+		memcmp(position_sets->sets + (position_sets->slots[slot] - 1U) * set_size, set, set_size) != 0) {
+		slot = (slot + 1U) & (position_sets->number_of_slots - 1U);
+	}
+	return slot;
+}
+
+/*
+Makes room for the sets, transitions and accepted rules of a number of states, and rebuilds the hash table with
+at least twice as many slots as states.
+*/
+static Boolean_type reserve_states(simple_tokenizer_rules_type *rules, position_sets_type *position_sets,
+	size_t number_of_states)
+{
+	const size_t capacity = position_sets->capacity;
+	size_t new_capacity = 0U;
+	size_t number_of_slots = 0U;
+	size_t state = 0U;
+	void *new_block = NULL;
+
+	if (number_of_states <= capacity) {
+		return Boolean_true;
+	}
+	new_capacity = (2U * capacity < SIMPLE_TOKENIZER_RULES_MAX_STATES + 1U) ?
+		2U * capacity : SIMPLE_TOKENIZER_RULES_MAX_STATES + 1U;
+	if (new_capacity < number_of_states) {
+		new_capacity = number_of_states;
+	}
+	new_block = allocator_reallocate(rules->allocator, position_sets->sets, capacity * position_sets->set_size,
+		new_capacity * position_sets->set_size);
+	if (new_block == NULL) {
+		return Boolean_false;
+	}
+	position_sets->sets = (unsigned char*) new_block;
+	new_block = allocator_reallocate(rules->allocator, rules->transitions,
+		capacity * rules->number_of_classes * sizeof(unsigned short),
+		new_capacity * rules->number_of_classes * sizeof(unsigned short));
+	if (new_block == NULL) {
+		return Boolean_false;
+	}
+	rules->transitions = (unsigned short*) new_block;
+	new_block = allocator_reallocate(rules->allocator, rules->accepted_rules, capacity * sizeof(unsigned short),
+		new_capacity * sizeof(unsigned short));
+	if (new_block == NULL) {
+		return Boolean_false;
+	}
+	rules->accepted_rules = (unsigned short*) new_block;
+	position_sets->capacity = new_capacity;
+
+	for (number_of_slots = 16U; number_of_slots < 2U * new_capacity; number_of_slots *= 2U) {
+	}
+	new_block = allocator_allocate(rules->allocator, number_of_slots * sizeof(size_t));
+	if (new_block == NULL) {
+		return Boolean_false;
+	}
+	allocator_deallocate(rules->allocator, position_sets->slots);
+	position_sets->slots = (size_t*) new_block;
+	position_sets->number_of_slots = number_of_slots;
+	for (state = 0U; state < rules->number_of_states; ++state) {
+		position_sets->slots[find_slot(position_sets, position_sets->sets + state * position_sets->set_size)] =
+			state + 1U;
+	}
+	return Boolean_true;
+}
+
+/*
+Appends the set after the last state as a new state, for which there is always room.
+Returns Boolean_false if there is not enough memory or if there would be too many states.
+*/
+static Boolean_type add_state(simple_tokenizer_rules_type *rules, position_sets_type *position_sets)
+{
+	const size_t state = rules->number_of_states;
+	const unsigned char *set = NULL;
+	size_t slot = 0U;
+	size_t i = 0U;
+
+	if (state == SIMPLE_TOKENIZER_RULES_MAX_STATES or not reserve_states(rules, position_sets, state + 2U)) {
+		return Boolean_false;
+	}
+	set = position_sets->sets + state * position_sets->set_size;
+	rules->accepted_rules[state] = 0U;
+	for (i = 0U; i < rules->number_of_rules; ++i) {
+		if (set_has_position(set, position_sets->first_positions[i] + rules->rules[i].number_of_elements)) {
+			rules->accepted_rules[state] = (unsigned short) (i + 1U);
+			break;
+		}
+	}
+	slot = find_slot(position_sets, set);
+	if (position_sets->slots[slot] == 0U) {
+		position_sets->slots[slot] = state + 1U;
+	}
+	++rules->number_of_states;
+	return Boolean_true;
+}
+
+/*
+Finds the state of the set after the last state, which is appended as a new state if there is none yet.
+Returns Boolean_false if there is not enough memory or if there would be too many states.
+*/
+static Boolean_type find_or_add_state(simple_tokenizer_rules_type *rules, position_sets_type *position_sets,
+	size_t *state)
+{
+	const size_t slot = find_slot(position_sets, position_sets->sets + rules->number_of_states * position_sets->set_size);
+
+	if (position_sets->slots[slot] != 0U) {
+		*state = position_sets->slots[slot] - 1U;
+		return Boolean_true;
+	}
+	*state = rules->number_of_states;
+	return add_state(rules, position_sets);
+}
+
+/* Computes the set of positions after a byte from a state, as the set after the last state. */
+static void compute_next_set(const simple_tokenizer_rules_type *rules, position_sets_type *position_sets,
+	size_t state, unsigned int byte)
+{
+	const size_t set_size = position_sets->set_size;
+	const unsigned char *set = position_sets->sets + state * set_size;
+	unsigned char *next_set = position_sets->sets + rules->number_of_states * set_size;
+	size_t i = 0U;
+	size_t j = 0U;
+
+	memset(next_set, 0, set_size);
+	for (i = 0U; i < rules->number_of_rules; ++i) {
+		const simple_tokenizer_rule_type *rule = &rules->rules[i];
+		const size_t first_position = position_sets->first_positions[i];
+		for (j = 0U; j < rule->number_of_elements; ++j) {
+			if (set_has_position(set, first_position + j) and element_has_byte(&rule->elements[j], byte)) {
+				add_position(next_set, rule, first_position,
+					(rule->elements[j].repetition == rule_repetition_any) ? j : j + 1U);
+			}
+		}
+	}
+}
+
+Boolean_type simple_tokenizer_rules_compile(simple_tokenizer_rules_type *rules)
+{
+	position_sets_type position_sets;
+	unsigned char class_bytes[256];
+	size_t number_of_positions = 0U;
+	size_t state = 0U;
+	size_t i = 0U;
+	Boolean_type is_compiled = Boolean_true;
+
+	assert(rules != NULL);
+	deinit_automaton(rules);
+	if (rules->number_of_rules > SIMPLE_TOKENIZER_RULES_MAX_STATES) {
+		return Boolean_false;
+	}
+	compute_byte_classes(rules);
+	for (i = 256U; i > 0U; --i) {
+		class_bytes[rules->byte_classes[i - 1U]] = (unsigned char) (i - 1U);
+	}
+
+	position_sets.first_positions = (size_t*) allocator_allocate(rules->allocator,
+		(rules->number_of_rules + 1U) * sizeof(size_t));
+	if (position_sets.first_positions == NULL) {
+		deinit_automaton(rules);
+		return Boolean_false;
+	}
+	for (i = 0U; i < rules->number_of_rules; ++i) {
+		position_sets.first_positions[i] = number_of_positions;
+		number_of_positions += rules->rules[i].number_of_elements + 1U;
+	}
+	position_sets.set_size = number_of_positions / 8U + 1U;
+	position_sets.sets = NULL;
+	position_sets.capacity = 0U;
+	position_sets.slots = NULL;
+	position_sets.number_of_slots = 0U;
+
+	/* state 0, with the empty set, and the start state, with the first position of every rule */
+	is_compiled = reserve_states(rules, &position_sets, 3U);
+	if (is_compiled) {
+		memset(position_sets.sets, 0, position_sets.set_size);
+		is_compiled = add_state(rules, &position_sets);
+	}
+	if (is_compiled) {
+		unsigned char *start_set = position_sets.sets + position_sets.set_size;
+		memset(start_set, 0, position_sets.set_size);
+		for (i = 0U; i < rules->number_of_rules; ++i) {
+			add_position(start_set, &rules->rules[i], position_sets.first_positions[i], 0U);
+		}
+		is_compiled = add_state(rules, &position_sets);
+	}
+
+	for (state = 0U; is_compiled and state < rules->number_of_states; ++state) {
+		size_t byte_class = 0U;
+		for (byte_class = 0U; byte_class < rules->number_of_classes; ++byte_class) {
+			size_t next_state = 0U;
+			if (state != 0U) {
+				compute_next_set(rules, &position_sets, state, class_bytes[byte_class]);
+				is_compiled = find_or_add_state(rules, &position_sets, &next_state);
+				if (not is_compiled) {
+					break;
+				}
+			}
+			rules->transitions[state * rules->number_of_classes + byte_class] = (unsigned short) next_state;
+		}
+	}
+
+	allocator_deallocate(rules->allocator, position_sets.slots);
+	allocator_deallocate(rules->allocator, position_sets.sets);
+	allocator_deallocate(rules->allocator, position_sets.first_positions);
+	if (not is_compiled) {
+		deinit_automaton(rules);
+	}
+	return is_compiled;
+}
+
+/*
+The pairs of a state and a position of the string from which the automaton reaches no accepting state, in a hash
+table with open addressing. A scan which reaches such a pair stops there, so a part of the string past the end of a
+token is scanned again only from other states, which makes maximal munch linear in the length of the string.
+*/
+typedef struct failed_pair_type
+{
+	size_t position; /* 0 for an empty slot, as no pair is at position 0 */
+	size_t state;
+} failed_pair_type;
+
+typedef struct failed_pairs_type
+{
+	allocator_type allocator;
+	failed_pair_type *slots;
+	size_t number_of_slots;
+	size_t number_of_pairs;
+	size_t last_position; /* the greatest position of a pair */
+	Boolean_type is_full; /* there was not enough memory, so no more pairs are added */
+} failed_pairs_type;
+
+static size_t hash_failed_pair(size_t position, size_t state)
+{
+	return (size_t) (((unsigned long) position * 2654435761UL) ^ ((unsigned long) state * 40503UL));
+}
+
+static size_t find_failed_pair_slot(const failed_pairs_type *failed_pairs, size_t position, size_t state)
+{
+	const size_t mask = failed_pairs->number_of_slots - 1U;
+	size_t slot = hash_failed_pair(position, state) & mask;
+
+	while (failed_pairs->slots[slot].position != 0U and
+		(failed_pairs->slots[slot].position != position or failed_pairs->slots[slot].state != state)) {
+		slot = (slot + 1U) & mask;
+	}
+	return slot;
+}
+
+static Boolean_type has_failed_pair(const failed_pairs_type *failed_pairs, size_t position, size_t state)
+{
+	return (Boolean_type) (failed_pairs->number_of_pairs != 0U and
+		failed_pairs->slots[find_failed_pair_slot(failed_pairs, position, state)].position != 0U);
+}
+
+/* Adds a pair, unless there is not enough memory, in which case the pair is simply not remembered. */
+static void add_failed_pair(failed_pairs_type *failed_pairs, size_t position, size_t state)
+{
+	size_t slot = 0U;
+
+	if (failed_pairs->is_full) {
+		return;
+	}
+	if (2U * (failed_pairs->number_of_pairs + 1U) > failed_pairs->number_of_slots) {
+		failed_pair_type *old_slots = failed_pairs->slots;
+		const size_t old_number_of_slots = failed_pairs->number_of_slots;
+		const size_t number_of_slots = (old_number_of_slots != 0U) ? 2U * old_number_of_slots : 64U;
+		size_t i = 0U;
+
+		failed_pairs->slots = (number_of_slots <= ((size_t) -1) / sizeof(failed_pair_type)) ? (failed_pair_type*)
+			allocator_allocate(failed_pairs->allocator, number_of_slots * sizeof(failed_pair_type)) : NULL;
+		if (failed_pairs->slots == NULL) {
+			failed_pairs->slots = old_slots;
+			failed_pairs->is_full = Boolean_true;
+			return;
+		}
+		failed_pairs->number_of_slots = number_of_slots;
+		for (i = 0U; i < old_number_of_slots; ++i) {
+			if (old_slots[i].position != 0U) {
+				failed_pairs->slots[find_failed_pair_slot(failed_pairs, old_slots[i].position, old_slots[i].state)] =
+					old_slots[i];
+			}
+		}
+		allocator_deallocate(failed_pairs->allocator, old_slots);
+	}
+	slot = find_failed_pair_slot(failed_pairs, position, state);
+	if (failed_pairs->slots[slot].position == 0U) {
+		failed_pairs->slots[slot].position = position;
+		failed_pairs->slots[slot].state = state;
+		++failed_pairs->number_of_pairs;
+		if (position > failed_pairs->last_position) {
+			failed_pairs->last_position = position;
+		}
+	}
+}
+
+/* Forgets the pairs once no scan can reach them any more. */
+static void forget_failed_pairs_before(failed_pairs_type *failed_pairs, size_t position)
+{
+	if (failed_pairs->number_of_pairs != 0U and position > failed_pairs->last_position) {
+		memset(failed_pairs->slots, 0, failed_pairs->number_of_slots * sizeof(failed_pair_type));
+		failed_pairs->number_of_pairs = 0U;
+		failed_pairs->last_position = 0U;
+	}
+}
+
+/*
+Returns the end of the longest match at an index of a string, and its token type.
+The automaton runs until it stops or reaches a failed pair. Then the pairs it went through after the end of the
+longest match are failed pairs, as it reached no accepting state from them.
+*/
+static size_t match_token(const simple_tokenizer_rules_type *rules, const unsigned char *bytes, size_t string_length,
+	size_t index, failed_pairs_type *failed_pairs, int *token_type)
+{
+	const unsigned short *transitions = rules->transitions;
+	const size_t number_of_classes = rules->number_of_classes;
+	size_t state = 1U;
+	size_t position = index;
+	size_t accepted_rule = 0U;
+	size_t token_end = index + 1U;
+	size_t token_end_state = 0U;
+
+	while (position < string_length) {
+		state = transitions[state * number_of_classes + rules->byte_classes[bytes[position]]];
+		if (state == 0U) {
+			break;
+		}
+		++position;
+		if (position == token_end) {
+			token_end_state = state;
+		}
+		if (has_failed_pair(failed_pairs, position, state)) {
+			break;
+		}
+		if (rules->accepted_rules[state] != 0U) {
+			accepted_rule = rules->accepted_rules[state];
+			token_end = position;
+			token_end_state = state;
+		}
+	}
+
+	/* position is now the last position which the automaton reached in a state other than 0 */
+	state = token_end_state;
+	for (index = token_end; index < position; ++index) {
+		state = transitions[state * number_of_classes + rules->byte_classes[bytes[index]]];
+		add_failed_pair(failed_pairs, index + 1U, state);
+	}
+
+	*token_type = (accepted_rule != 0U) ? rules->rules[accepted_rule - 1U].token_type : rules->unmatched_token_type;
+	return token_end;
+}
+
+size_t simple_tokenizer_rules_tokenize(const simple_tokenizer_rules_type *rules, const char *string,
+	size_t string_length, simple_tokenizer_rules_token_type *tokens, size_t number_of_tokens)
+{
+	failed_pairs_type failed_pairs;
+	size_t index = 0U;
+	size_t total_number_of_tokens = 0U;
+
+	assert(rules != NULL);
+	assert(rules->transitions != NULL);
+	assert(string != NULL or string_length == 0U);
+
+	memset(&failed_pairs, 0, sizeof(failed_pairs));
+	failed_pairs.allocator = rules->allocator;
+	while (index < string_length) {
+		int token_type = 0;
+		const size_t token_end = match_token(rules, (const unsigned char*) string, string_length, index,
+			&failed_pairs, &token_type);
+
+		if (tokens != NULL and total_number_of_tokens < number_of_tokens) {
+			tokens[total_number_of_tokens].type = token_type;
+			tokens[total_number_of_tokens].value = string_to_const_stringref(string + index, token_end - index);
+		}
+		++total_number_of_tokens;
+		index = token_end;
+		forget_failed_pairs_before(&failed_pairs, index);
+	}
+	allocator_deallocate(failed_pairs.allocator, failed_pairs.slots);
+	return total_number_of_tokens;
+}
+
+void simple_tokenizer_rules_token_array_init(simple_tokenizer_rules_token_array_type *array,
+	allocator_type allocator)
+{
+	assert(array != NULL);
+	assert(allocator.allocate != NULL);
+	assert(allocator.deallocate != NULL);
+	array->allocator = allocator;
+	array->tokens = NULL;
+	array->number_of_tokens = 0U;
+	array->capacity = 0U;
+}
+
+void simple_tokenizer_rules_token_array_deinit(simple_tokenizer_rules_token_array_type *array)
+{
+	assert(array != NULL);
+	allocator_deallocate(array->allocator, array->tokens);
+	array->tokens = NULL;
+	array->number_of_tokens = 0U;
+	array->capacity = 0U;
+}
+
+/* Makes room for at least a number of tokens, and at least twice as many as before. */
+static Boolean_type reserve_tokens(simple_tokenizer_rules_token_array_type *array, size_t capacity)
+{
+	const size_t max_capacity = ((size_t) -1) / sizeof(simple_tokenizer_rules_token_type);
+	void *new_tokens = NULL;
+
+	if (capacity > max_capacity) {
+		return Boolean_false;
+	}
+	if (capacity < 2U * array->capacity) {
+		capacity = (array->capacity <= max_capacity / 2U) ? 2U * array->capacity : max_capacity;
+	}
+	new_tokens = allocator_reallocate(array->allocator, array->tokens,
+		array->capacity * sizeof(simple_tokenizer_rules_token_type), capacity * sizeof(simple_tokenizer_rules_token_type));
+	if (new_tokens == NULL) {
+		return Boolean_false;
+	}
+	array->tokens = (simple_tokenizer_rules_token_type*) new_tokens;
+	array->capacity = capacity;
+	return Boolean_true;
+}
+
+/* Reserves room for a quarter of the remaining length when the array is full, as simple_tokenizer_tokenize_to_array. */
+Boolean_type simple_tokenizer_rules_tokenize_to_array(const simple_tokenizer_rules_type *rules, const char *string,
+	size_t string_length, simple_tokenizer_rules_token_array_type *array)
+{
+	const size_t old_number_of_tokens = array->number_of_tokens;
+	failed_pairs_type failed_pairs;
+	size_t index = 0U;
+	Boolean_type is_tokenized = Boolean_true;
+
+	assert(rules != NULL);
+	assert(rules->transitions != NULL);
+	assert(string != NULL or string_length == 0U);
+	assert(array != NULL);
+
+	memset(&failed_pairs, 0, sizeof(failed_pairs));
+	failed_pairs.allocator = rules->allocator;
+	while (index < string_length) {
+		int token_type = 0;
+		size_t token_end = 0U;
+
+		if (array->number_of_tokens == array->capacity and
+			not reserve_tokens(array, array->number_of_tokens + (string_length - index) / 4U + 16U)) {
+			array->number_of_tokens = old_number_of_tokens;
+			is_tokenized = Boolean_false;
+			break;
+		}
+		token_end = match_token(rules, (const unsigned char*) string, string_length, index, &failed_pairs,
+			&token_type);
+		array->tokens[array->number_of_tokens].type = token_type;
+		array->tokens[array->number_of_tokens].value = string_to_const_stringref(string + index, token_end - index);
+		++array->number_of_tokens;
+		index = token_end;
+		forget_failed_pairs_before(&failed_pairs, index);
+	}
+	allocator_deallocate(failed_pairs.allocator, failed_pairs.slots);
+	return is_tokenized;
+}
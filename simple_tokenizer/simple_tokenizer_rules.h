@@ -0,0 +1,145 @@
+/* Minimum C Standard: C89 */
+
+#ifndef SIMPLE_TOKENIZER_RULES_H
+#define SIMPLE_TOKENIZER_RULES_H
+
+#include "allocator_type.h"
+#include "Boolean_type.h"
+#include "string_reference.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+A set of tokenizer rules with user-defined token types, e.g. identifiers with underscores, hexadecimal literals and
+operators such as <=, which the fixed byte classes of simple_tokenizer_tokenize split into several tokens.
+
+Each rule is a pattern and a token type. A pattern is a sequence of elements, each of which matches one byte:
+
+- A byte matches itself, except for the special bytes \ [ ] . ? * and +.
+- [...] matches a byte of a set of bytes and ranges of bytes, e.g. [A-Za-z_]. [^...] matches the other bytes.
+- . matches any byte.
+- \xHH is the byte with the hexadecimal value HH, \n, \r and \t are a newline, a carriage return and a tab, and \
+  followed by any other byte is that byte, e.g. \. or \]. Escapes can be used in sets.
+
+An element may be followed by ? (optional), * (zero or more times) or + (one or more times). There is no
+alternation or grouping: several rules with the same token type make an alternation, e.g. [0-9]+ and
+0[xX][0-9A-Fa-f]+ for decimal and hexadecimal integers.
+
+simple_tokenizer_rules_compile turns the rules into a deterministic finite automaton. The bytes which no pattern
+tells apart are merged into one byte class, so the transition table has a row per state and a column per class.
+simple_tokenizer_rules_tokenize then runs the automaton directly on the string, in time linear in its length.
+*/
+typedef struct simple_tokenizer_rule_type simple_tokenizer_rule_type;
+
+typedef struct simple_tokenizer_rules_type
+{
+	allocator_type allocator;
+	int unmatched_token_type;
+	simple_tokenizer_rule_type *rules;
+	size_t number_of_rules;
+	size_t capacity;
+	/* The automaton built by simple_tokenizer_rules_compile. State 0 stops the automaton and state 1 is the start. */
+	unsigned char byte_classes[256];
+	size_t number_of_classes;
+	size_t number_of_states;
+	unsigned short *transitions; /* the next state of each state and byte class */
+	unsigned short *accepted_rules; /* the index plus 1 of the rule matched in each state, or 0 */
+} simple_tokenizer_rules_type;
+
+typedef struct simple_tokenizer_rules_token_type
+{
+	int type;
+	const_stringref_type value;
+} simple_tokenizer_rules_token_type;
+
+/* The maximum number of states of an automaton, and of rules, so a state or a rule fits into an unsigned short. */
+#define SIMPLE_TOKENIZER_RULES_MAX_STATES 65535U
+
+/*
+Initializes an empty rule set. No memory is allocated.
+A byte at which no rule matches is a token of its own, of the unmatched token type.
+*/
+void simple_tokenizer_rules_init(simple_tokenizer_rules_type *rules, allocator_type allocator,
+	int unmatched_token_type);
+
+/* Deallocates the rules and the automaton. */
+void simple_tokenizer_rules_deinit(simple_tokenizer_rules_type *rules);
+
+/*
+Adds a rule with a null-terminated pattern.
+Return value: Boolean_true, or Boolean_false if the pattern is empty or incorrect, or if there is not enough memory.
+*/
+Boolean_type simple_tokenizer_rules_add_pattern(simple_tokenizer_rules_type *rules, const char *pattern,
+	int token_type);
+
+/*
+Adds a rule which matches a literal string, e.g. an operator, without special bytes.
+Return value: Boolean_true, or Boolean_false if the literal is empty or if there is not enough memory.
+*/
+Boolean_type simple_tokenizer_rules_add_literal(simple_tokenizer_rules_type *rules, const_stringref_type literal,
+	int token_type);
+
+/*
+Builds the automaton of the rules added so far, replacing the previous one. The automaton has a state for each set
+of rule positions which some input can reach, usually a few per element, but up to 2^n for a pattern such as
+[ab]*a followed by n elements. Keywords are better matched as identifiers and looked up in a keyword_set than
+given a rule each.
+
+Return value: Boolean_true, or Boolean_false if there is not enough memory or if there are more than
+SIMPLE_TOKENIZER_RULES_MAX_STATES rules or states, in which case there is no automaton.
+*/
+Boolean_type simple_tokenizer_rules_compile(simple_tokenizer_rules_type *rules);
+
+/*
+Tokenizes a string with the compiled automaton of a rule set.
+
+Each token is the longest match of any rule at its position (maximal munch), so <= is one token if there is a rule
+for it, even if there is also a rule for <. If several rules match the longest token, the rule added first gives its
+type. A match must not be empty.
+The automaton may run past the end of the longest match, e.g. for the rule 0x[0-9]+ on the string 0xy. The pairs of
+a state and a position from which it then reaches no accepting state are remembered, so no such pair is scanned
+twice and the time is linear in the length of the string, even for rules such as a and a*b on a string of a's.
+The pairs are kept in a table allocated with the allocator of the rules. If there is not enough memory for it, the
+tokens are the same, but a part of the string may be scanned again for each token.
+
+As simple_tokenizer_tokenize, at most number_of_tokens tokens are stored, and the return value is the number of
+tokens of the string, so a call with a null pointer counts them. A string of n bytes has at most n tokens.
+*/
+size_t simple_tokenizer_rules_tokenize(const simple_tokenizer_rules_type *rules, const char *string,
+	size_t string_length, simple_tokenizer_rules_token_type *tokens, size_t number_of_tokens);
+
+/* A growable array of tokens, as simple_tokenizer_token_array_type. */
+typedef struct simple_tokenizer_rules_token_array_type
+{
+	allocator_type allocator;
+	simple_tokenizer_rules_token_type *tokens;
+	size_t number_of_tokens;
+	size_t capacity;
+} simple_tokenizer_rules_token_array_type;
+
+/* Initializes an empty array. No memory is allocated. */
+void simple_tokenizer_rules_token_array_init(simple_tokenizer_rules_token_array_type *array,
+	allocator_type allocator);
+
+/* Deallocates the tokens of an array, which becomes empty. */
+void simple_tokenizer_rules_token_array_deinit(simple_tokenizer_rules_token_array_type *array);
+
+/*
+As simple_tokenizer_rules_tokenize, but appends the tokens to an array in a single pass, as
+simple_tokenizer_tokenize_to_array does, instead of counting them first or storing them in a buffer for the worst
+case of one token per byte.
+
+Return value: Boolean_true, or Boolean_false if there is not enough memory, in which case the tokens of the array
+are unchanged.
+*/
+Boolean_type simple_tokenizer_rules_tokenize_to_array(const simple_tokenizer_rules_type *rules, const char *string,
+	size_t string_length, simple_tokenizer_rules_token_array_type *array);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,385 @@
+#include "simple_tokenizer_rules.h"
+#include "sizeof_array.h"
+#include "unit_testing.h"
+#include "unit_testing_allocator.h"
+#include <iso646.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+	token_unmatched = -1,
+	token_identifier = 1,
+	token_integer,
+	token_hexadecimal_integer,
+	token_decimal_number,
+	token_less,
+	token_less_or_equal,
+	token_assignment,
+	token_equal,
+	token_whitespace,
+	token_keyword_if
+};
+
+static Boolean_type add_language_rules(simple_tokenizer_rules_type *rules)
+{
+	return (Boolean_type) (
+		simple_tokenizer_rules_add_pattern(rules, "if", token_keyword_if) and
+		simple_tokenizer_rules_add_pattern(rules, "[A-Za-z_][A-Za-z0-9_]*", token_identifier) and
+		simple_tokenizer_rules_add_pattern(rules, "[0-9]+", token_integer) and
+		simple_tokenizer_rules_add_pattern(rules, "0[xX][0-9A-Fa-f]+", token_hexadecimal_integer) and
+		simple_tokenizer_rules_add_pattern(rules, "[0-9]+\\.[0-9]*", token_decimal_number) and
+		simple_tokenizer_rules_add_literal(rules, string_to_const_stringref("<", 1U), token_less) and
+		simple_tokenizer_rules_add_literal(rules, string_to_const_stringref("<=", 2U), token_less_or_equal) and
+		simple_tokenizer_rules_add_literal(rules, string_to_const_stringref("=", 1U), token_assignment) and
+		simple_tokenizer_rules_add_literal(rules, string_to_const_stringref("==", 2U), token_equal) and
+		simple_tokenizer_rules_add_pattern(rules, "[ \\t\\r\\n]+", token_whitespace));
+}
+
+static Boolean_type has_token(const simple_tokenizer_rules_token_type *token, int type, const char *value)
+{
+	return (Boolean_type) (token->type == type and token->value.length == strlen(value) and
+		memcmp(token->value.string, value, token->value.length) == 0);
+}
+
+TEST(test_with_language_rules, "Identifiers, numbers and operators => the longest matches")
+{
+	static const char string[] = "if iff x_1<=0x1F==y\n\t<3.5 $=07.";
+	simple_tokenizer_rules_type rules;
+	simple_tokenizer_rules_token_type tokens[32];
+	size_t number_of_tokens = 0U;
+
+	simple_tokenizer_rules_init(&rules, unit_testing_make_allocator(), token_unmatched);
+	ASSERT(add_language_rules(&rules));
+	ASSERT(simple_tokenizer_rules_compile(&rules));
+	number_of_tokens = simple_tokenizer_rules_tokenize(&rules, string, sizeof(string) - 1U, NULL, 0U);
+	ASSERT_UINT_EQUAL(number_of_tokens, 16U);
+	number_of_tokens = simple_tokenizer_rules_tokenize(&rules, string, sizeof(string) - 1U, tokens,
+		sizeof_array(tokens));
+	ASSERT_UINT_EQUAL(number_of_tokens, 16U);
+	ASSERT(has_token(&tokens[0], token_keyword_if, "if"));
+	ASSERT(has_token(&tokens[1], token_whitespace, " "));
+	ASSERT(has_token(&tokens[2], token_identifier, "iff"));
+	ASSERT(has_token(&tokens[3], token_whitespace, " "));
+	ASSERT(has_token(&tokens[4], token_identifier, "x_1"));
+	ASSERT(has_token(&tokens[5], token_less_or_equal, "<="));
+	ASSERT(has_token(&tokens[6], token_hexadecimal_integer, "0x1F"));
+	ASSERT(has_token(&tokens[7], token_equal, "=="));
+	ASSERT(has_token(&tokens[8], token_identifier, "y"));
+	ASSERT(has_token(&tokens[9], token_whitespace, "\n\t"));
+	ASSERT(has_token(&tokens[10], token_less, "<"));
+	ASSERT(has_token(&tokens[11], token_decimal_number, "3.5"));
+	ASSERT(has_token(&tokens[12], token_whitespace, " "));
+	ASSERT(has_token(&tokens[13], token_unmatched, "$"));
+	ASSERT(has_token(&tokens[14], token_assignment, "="));
+	ASSERT(has_token(&tokens[15], token_decimal_number, "07."));
+
+	number_of_tokens = simple_tokenizer_rules_tokenize(&rules, "0x", 2U, tokens, sizeof_array(tokens));
+	ASSERT_UINT_EQUAL(number_of_tokens, 2U);
+	ASSERT(has_token(&tokens[0], token_integer, "0"));
+	ASSERT(has_token(&tokens[1], token_identifier, "x"));
+	ASSERT_UINT_EQUAL(simple_tokenizer_rules_tokenize(&rules, "", 0U, tokens, sizeof_array(tokens)), 0U);
+	simple_tokenizer_rules_deinit(&rules);
+}
+
+TEST(test_with_sets_and_escapes, "Negated sets, ranges, escapes and any byte => the bytes they stand for")
+{
+	static const char string[] = "A.\xC3\xA9\x80 a]-b\"q\"\"\"\"";
+	simple_tokenizer_rules_type rules;
+	simple_tokenizer_rules_token_type tokens[16];
+	size_t number_of_tokens = 0U;
+
+	simple_tokenizer_rules_init(&rules, unit_testing_make_allocator(), token_unmatched);
+	ASSERT(simple_tokenizer_rules_add_pattern(&rules, "\\x41\\.", 1));
+	ASSERT(simple_tokenizer_rules_add_pattern(&rules, "[\\xC2-\\xF4][\\x80-\\xBF]+", 2));
+	ASSERT(simple_tokenizer_rules_add_pattern(&rules, "a[\\]-]+b", 3));
+	ASSERT(simple_tokenizer_rules_add_pattern(&rules, "\"[^\"]*\"", 4));
+	ASSERT(simple_tokenizer_rules_add_pattern(&rules, "\"..", 5));
+	ASSERT(simple_tokenizer_rules_compile(&rules));
+	number_of_tokens = simple_tokenizer_rules_tokenize(&rules, string, sizeof(string) - 1U, tokens,
+		sizeof_array(tokens));
+	ASSERT_UINT_EQUAL(number_of_tokens, 6U);
+	ASSERT(has_token(&tokens[0], 1, "A."));
+	ASSERT(has_token(&tokens[1], 2, "\xC3\xA9\x80"));
+	ASSERT(has_token(&tokens[2], token_unmatched, " "));
+	ASSERT(has_token(&tokens[3], 3, "a]-b"));
+	ASSERT(has_token(&tokens[4], 4, "\"q\""));
+	ASSERT(has_token(&tokens[5], 5, "\"\"\""));
+	simple_tokenizer_rules_deinit(&rules);
+}
+
+TEST(test_with_incorrect_patterns, "Empty or incorrect patterns => Boolean_false and no rule")
+{
+	static const char *const patterns[] = {
+		"", "[", "[]", "[^]", "[a", "[z-a]", "\\", "a\\", "\\x", "\\xG0", "\\x0", "]", "?", "*a", "+", "a**", "a+?"
+	};
+	simple_tokenizer_rules_type rules;
+	size_t i = 0U;
+
+	simple_tokenizer_rules_init(&rules, unit_testing_make_allocator(), token_unmatched);
+	for (i = 0U; i < sizeof_array(patterns); ++i) {
+		ASSERT(not simple_tokenizer_rules_add_pattern(&rules, patterns[i], 1));
+	}
+	ASSERT(not simple_tokenizer_rules_add_literal(&rules, string_to_const_stringref("", 0U), 1));
+	ASSERT_UINT_EQUAL(rules.number_of_rules, 0U);
+	ASSERT(simple_tokenizer_rules_compile(&rules));
+	ASSERT_UINT_EQUAL(simple_tokenizer_rules_tokenize(&rules, "ab", 2U, NULL, 0U), 2U);
+	simple_tokenizer_rules_deinit(&rules);
+}
+
+/* Returns Boolean_true if an element of a pattern, a byte, . or a set without escapes, matches a byte. */
+static Boolean_type reference_element_matches(const char *element, char byte)
+{
+	Boolean_type is_negated = Boolean_false;
+	Boolean_type matches = Boolean_false;
+
+	if (element[0] == '.') {
+		return Boolean_true;
+	}
+	if (element[0] != '[') {
+		return (Boolean_type) (element[0] == byte);
+	}
+	++element;
+	if (element[0] == '^') {
+		is_negated = Boolean_true;
+		++element;
+	}
+	for (; element[0] != ']'; ++element) {
+		if (element[1] == '-' and element[2] != ']') {
+			matches = (Boolean_type) (matches or (byte >= element[0] and byte <= element[2]));
+			element += 2;
+		} else {
+			matches = (Boolean_type) (matches or byte == element[0]);
+		}
+	}
+	return (Boolean_type) (matches != is_negated);
+}
+
+/* Returns the length of the longest prefix of a string which a pattern without escapes matches, or -1, by search. */
+static long reference_longest_match(const char *pattern, const char *string, size_t length)
+{
+	const char *element_end = NULL;
+	const char *rest = NULL;
+	size_t min_count = 1U;
+	size_t max_count = 1U;
+	size_t count = 0U;
+	long longest_match = -1;
+
+	if (pattern[0] == '\0') {
+		return 0;
+	}
+	element_end = (pattern[0] == '[') ? strchr(pattern, ']') + 1 : pattern + 1;
+	rest = element_end;
+	if (element_end[0] == '?' or element_end[0] == '*' or element_end[0] == '+') {
+		min_count = (element_end[0] == '+') ? 1U : 0U;
+		max_count = (element_end[0] == '?') ? 1U : length;
+		++rest;
+	}
+	for (count = 0U; count <= max_count and count <= length; ++count) {
+		if (count > 0U and not reference_element_matches(pattern, string[count - 1U])) {
+			break;
+		}
+		if (count >= min_count) {
+			const long match = reference_longest_match(rest, string + count, length - count);
+			if (match >= 0 and (long) count + match > longest_match) {
+				longest_match = (long) count + match;
+			}
+		}
+	}
+	return longest_match;
+}
+
+TEST(test_with_random_strings, "Random strings => the longest matches found by search, with the first rule on ties")
+{
+	static const char *const patterns[] = {
+		"[a-z_][a-z0-9_]*", "0x[0-9a-f]+", "[0-9]+", "[0-9]+[.][0-9]*", "<", "<=", "=", "==", "[ \n]+", "a?b*a",
+		"x.x", "[^a-z0-9]+b", "b+0?b"
+	};
+	static const char alphabet[] = "ab01x_ <=.\n";
+	simple_tokenizer_rules_type rules;
+	simple_tokenizer_rules_token_type tokens[16];
+	char string[16];
+	unsigned long state = 2024UL;
+	size_t i = 0U;
+	int iteration = 0;
+
+	simple_tokenizer_rules_init(&rules, unit_testing_make_allocator(), token_unmatched);
+	for (i = 0U; i < sizeof_array(patterns); ++i) {
+		ASSERT(simple_tokenizer_rules_add_pattern(&rules, patterns[i], (int) i));
+	}
+	ASSERT(simple_tokenizer_rules_compile(&rules));
+
+	for (iteration = 0; iteration < 20000; ++iteration) {
+		size_t number_of_tokens = 0U;
+		size_t length = 0U;
+		size_t index = 0U;
+		size_t token_index = 0U;
+
+		state = (state * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+		length = (state >> 16U) % sizeof_array(string);
+		for (i = 0U; i < length; ++i) {
+			state = (state * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+			string[i] = alphabet[(state >> 16U) % (sizeof(alphabet) - 1U)];
+		}
+		number_of_tokens = simple_tokenizer_rules_tokenize(&rules, string, length, tokens, sizeof_array(tokens));
+		for (index = 0U; index < length; ++token_index) {
+			long longest_match = 0;
+			int type = token_unmatched;
+			for (i = 0U; i < sizeof_array(patterns); ++i) {
+				const long match = reference_longest_match(patterns[i], string + index, length - index);
+				if (match > longest_match) {
+					longest_match = match;
+					type = (int) i;
+				}
+			}
+			if (longest_match == 0) {
+				longest_match = 1;
+			}
+			if (token_index >= number_of_tokens or tokens[token_index].type != type or
+				tokens[token_index].value.string != string + index or
+				tokens[token_index].value.length != (size_t) longest_match) {
+				ASSERT(Boolean_false);
+				break;
+			}
+			index += (size_t) longest_match;
+		}
+		ASSERT_UINT_EQUAL(number_of_tokens, token_index);
+	}
+	simple_tokenizer_rules_deinit(&rules);
+}
+
+TEST(test_with_many_states, "Rules with more states than the maximum => Boolean_false and no automaton")
+{
+	simple_tokenizer_rules_type rules;
+
+	simple_tokenizer_rules_init(&rules, unit_testing_make_allocator(), token_unmatched);
+	/* the automaton has to remember which of the last 17 bytes were a, which takes 2^17 states */
+	ASSERT(simple_tokenizer_rules_add_pattern(&rules, "[ab]*a[ab][ab][ab][ab][ab][ab][ab][ab][ab][ab][ab][ab][ab][ab][ab][ab]", 1));
+	ASSERT(not simple_tokenizer_rules_compile(&rules));
+	ASSERT(rules.transitions == NULL);
+	simple_tokenizer_rules_deinit(&rules);
+}
+
+TEST(test_without_memory, "Not enough memory => Boolean_false, and the rule set can still be used")
+{
+	simple_tokenizer_rules_type rules;
+	simple_tokenizer_rules_token_type tokens[4];
+	size_t number_of_allocations = 0U;
+	Boolean_type is_compiled = Boolean_false;
+
+	for (number_of_allocations = 0U; not is_compiled; ++number_of_allocations) {
+		simple_tokenizer_rules_init(&rules, unit_testing_make_allocator(), token_unmatched);
+		unit_testing_allocations_until_failure = number_of_allocations;
+		is_compiled = (Boolean_type) (add_language_rules(&rules) and simple_tokenizer_rules_compile(&rules));
+		if (not is_compiled) {
+			ASSERT(rules.transitions == NULL);
+		}
+		simple_tokenizer_rules_deinit(&rules);
+	}
+	ASSERT_UINT_GREATER(number_of_allocations, 10U);
+
+	simple_tokenizer_rules_init(&rules, unit_testing_make_allocator(), token_unmatched);
+	ASSERT(add_language_rules(&rules));
+	unit_testing_allocations_until_failure = 0U;
+	ASSERT(not simple_tokenizer_rules_compile(&rules));
+	unit_testing_allocations_until_failure = (size_t) -1;
+	ASSERT(simple_tokenizer_rules_compile(&rules));
+	ASSERT_UINT_EQUAL(simple_tokenizer_rules_tokenize(&rules, "a<=1", 4U, tokens, sizeof_array(tokens)), 3U);
+	ASSERT(has_token(&tokens[1], token_less_or_equal, "<="));
+	simple_tokenizer_rules_deinit(&rules);
+}
+
+TEST(test_to_array, "Tokens appended to an array => the same tokens, and only the old ones on failure")
+{
+	static const char string[] = "if iff x_1<=0x1F==y\n\t<3.5 $=07.";
+	simple_tokenizer_rules_type rules;
+	simple_tokenizer_rules_token_type tokens[32];
+	simple_tokenizer_rules_token_array_type array;
+	size_t number_of_tokens = 0U;
+	size_t number_of_allocations = 0U;
+	size_t i = 0U;
+
+	simple_tokenizer_rules_init(&rules, unit_testing_make_allocator(), token_unmatched);
+	ASSERT(add_language_rules(&rules));
+	ASSERT(simple_tokenizer_rules_compile(&rules));
+	number_of_tokens = simple_tokenizer_rules_tokenize(&rules, string, sizeof(string) - 1U, tokens,
+		sizeof_array(tokens));
+
+	simple_tokenizer_rules_token_array_init(&array, unit_testing_make_allocator());
+	ASSERT(simple_tokenizer_rules_tokenize_to_array(&rules, string, 0U, &array));
+	ASSERT_UINT_EQUAL(array.number_of_tokens, 0U);
+	ASSERT(simple_tokenizer_rules_tokenize_to_array(&rules, string, sizeof(string) - 1U, &array));
+	ASSERT(simple_tokenizer_rules_tokenize_to_array(&rules, string, sizeof(string) - 1U, &array));
+	ASSERT_UINT_EQUAL(array.number_of_tokens, 2U * number_of_tokens);
+	for (i = 0U; i < array.number_of_tokens; ++i) {
+		ASSERT_EQUAL(array.tokens[i].type, tokens[i % number_of_tokens].type);
+		ASSERT(array.tokens[i].value.string == tokens[i % number_of_tokens].value.string);
+		ASSERT_UINT_EQUAL(array.tokens[i].value.length, tokens[i % number_of_tokens].value.length);
+	}
+	simple_tokenizer_rules_token_array_deinit(&array);
+
+	/* a failed tokenization keeps the tokens which were in the array */
+	for (number_of_allocations = 0U; number_of_allocations < 4U; ++number_of_allocations) {
+		simple_tokenizer_rules_token_array_init(&array, unit_testing_make_allocator());
+		ASSERT(simple_tokenizer_rules_tokenize_to_array(&rules, string, 3U, &array));
+		ASSERT_UINT_EQUAL(array.number_of_tokens, 2U);
+		unit_testing_allocations_until_failure = number_of_allocations;
+		if (not simple_tokenizer_rules_tokenize_to_array(&rules, string, sizeof(string) - 1U, &array)) {
+			ASSERT_UINT_EQUAL(array.number_of_tokens, 2U);
+		}
+		unit_testing_allocations_until_failure = (size_t) -1;
+		ASSERT(has_token(&array.tokens[1], token_whitespace, " "));
+		simple_tokenizer_rules_token_array_deinit(&array);
+	}
+	simple_tokenizer_rules_deinit(&rules);
+}
+
+TEST(test_with_long_failed_matches, "Rules which run to the end of the string without a match => linear time")
+{
+	static char string[100000];
+	simple_tokenizer_rules_type rules;
+	simple_tokenizer_rules_token_type tokens[4];
+
+	/* at each a, the automaton runs to the end of the string for a*b before it takes a as the longest match */
+	simple_tokenizer_rules_init(&rules, unit_testing_make_allocator(), token_unmatched);
+	ASSERT(simple_tokenizer_rules_add_pattern(&rules, "a", token_identifier));
+	ASSERT(simple_tokenizer_rules_add_pattern(&rules, "a*b", token_keyword_if));
+	ASSERT(simple_tokenizer_rules_compile(&rules));
+
+	memset(string, 'a', sizeof(string));
+	ASSERT_UINT_EQUAL(simple_tokenizer_rules_tokenize(&rules, string, sizeof(string), NULL, 0U), sizeof(string));
+	ASSERT_UINT_EQUAL(simple_tokenizer_rules_tokenize(&rules, string + sizeof(string) - 4U, 4U, tokens,
+		sizeof_array(tokens)), 4U);
+	ASSERT(has_token(&tokens[3], token_identifier, "a"));
+	string[sizeof(string) - 1U] = 'b';
+	ASSERT_UINT_EQUAL(simple_tokenizer_rules_tokenize(&rules, string, sizeof(string), tokens, sizeof_array(tokens)), 1U);
+	ASSERT_EQUAL(tokens[0].type, token_keyword_if);
+	ASSERT_UINT_EQUAL(tokens[0].value.length, sizeof(string));
+
+	/* without memory for the failed states and positions, the tokens are the same */
+	string[sizeof(string) - 1U] = 'a';
+	unit_testing_allocations_until_failure = 0U;
+	ASSERT_UINT_EQUAL(simple_tokenizer_rules_tokenize(&rules, string, 2000U, NULL, 0U), 2000U);
+	unit_testing_allocations_until_failure = (size_t) -1;
+	simple_tokenizer_rules_deinit(&rules);
+	ASSERT_UINT_EQUAL(unit_testing_number_of_allocations, unit_testing_number_of_deallocations);
+}
+
+int main(void)
+{
+	DEFINE_LIST_OF_TESTS(tests) {
+		test_with_language_rules,
+		test_with_sets_and_escapes,
+		test_with_incorrect_patterns,
+		test_with_random_strings,
+		test_with_many_states,
+		test_without_memory,
+		test_to_array,
+		test_with_long_failed_matches
+	};
+
+	SET_OUTPUT_FILE(stdout);
+	PRINT_FILE_NAME();
+	RUN_TESTS(tests);
+	PRINT_TEST_STATISTICS(tests);
+	return 0;
+}
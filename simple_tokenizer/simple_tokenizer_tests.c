@@ -1,6 +1,10 @@
 #include "simple_tokenizer.h"
 #include "sizeof_array.h"
 #include "unit_testing.h"
+#include "unit_testing_allocator.h"
+#include <ctype.h>
+#include <iso646.h>
+#include <stdlib.h>
 #include <string.h>
 
 TEST(test_with_empty_string, "Empty string => no token")
@@ -963,6 +967,624 @@ TEST(test_with_four_byte_utf8_characters, "Four-byte UTF-8 characters => 1 token
 	}
 }
 
+TEST(test_with_every_single_byte, "Every single byte => 1 token of the class of the byte")
+{
+	unsigned int byte = 0U;
+
+	for (byte = 0U; byte < 256U; ++byte) {
+		char string[1];
+		simple_tokenizer_token_type token = {simple_tokenizer_token_unknown, {NULL, 0U}};
+		simple_tokenizer_token_type_enum expected_type = simple_tokenizer_token_unknown;
+		size_t number_of_tokens = 0U;
+
+		string[0] = (char) byte;
+		/* the tests run in the "C" locale, so ctype.h gives the classes of ASCII characters */
+		if (byte >= 128U) {
+			expected_type = simple_tokenizer_token_extended_ascii_character;
+		} else if (isalpha((int) byte)) {
+			expected_type = simple_tokenizer_token_letters;
+		} else if (isdigit((int) byte)) {
+			expected_type = simple_tokenizer_token_digits;
+		} else if (byte == ' ' or byte == '\t') {
+			expected_type = simple_tokenizer_token_spaces;
+		} else if (byte == '\r' or byte == '\n') {
+			expected_type = simple_tokenizer_token_newline;
+		} else if (byte == 0U) {
+			expected_type = simple_tokenizer_token_zeros;
+		} else if (ispunct((int) byte)) {
+			expected_type = simple_tokenizer_token_punctuation;
+		} else {
+			expected_type = simple_tokenizer_token_control_character;
+		}
+		number_of_tokens = simple_tokenizer_tokenize(string, 1U, &token, 1U);
+		ASSERT_UINT_EQUAL(number_of_tokens, 1U);
+		ASSERT_EQUAL(token.type, expected_type);
+		ASSERT_UINT_EQUAL(token.value.length, 1U);
+	}
+}
+
+TEST(test_with_long_runs, "Long runs of letters, digits, spaces and zeros => 1 token for each run")
+{
+	static const char run_bytes[] = {'x', 'Q', '7', ' ', '\t', '\0'};
+	static const char end_bytes[] = {'@', '[', '`', '{', '/', ':', '!', '\n', '\x80', '\x01'};
+	char string[80];
+	size_t i = 0U;
+	size_t run_length = 0U;
+
+	for (i = 0U; i < sizeof_array(run_bytes); ++i) {
+		for (run_length = 1U; run_length < sizeof_array(string); ++run_length) {
+			simple_tokenizer_token_type tokens[2] = {
+				{simple_tokenizer_token_unknown, {NULL, 0U}}
+			};
+			const size_t end_index = run_length % sizeof_array(end_bytes);
+			size_t number_of_tokens = 0U;
+
+			memset(string, run_bytes[i], run_length);
+			/* a letter of the other case, or a space of the other kind, continues the run */
+			string[run_length / 2U] = (run_bytes[i] == 'x') ? 'X' : (run_bytes[i] == ' ') ? '\t' : run_bytes[i];
+			string[run_length] = end_bytes[end_index];
+			number_of_tokens = simple_tokenizer_tokenize(string, run_length + 1U, tokens, sizeof_array(tokens));
+			ASSERT_UINT_EQUAL(number_of_tokens, 2U);
+			ASSERT_UINT_EQUAL(tokens[0].value.length, run_length);
+			ASSERT_UINT_EQUAL(tokens[1].value.length, 1U);
+
+			number_of_tokens = simple_tokenizer_tokenize(string, run_length, tokens, sizeof_array(tokens));
+			ASSERT_UINT_EQUAL(number_of_tokens, 1U);
+			ASSERT_UINT_EQUAL(tokens[0].value.length, run_length);
+		}
+	}
+}
+
+typedef struct collected_tokens_type
+{
+	simple_tokenizer_token_type tokens[64];
+	char bytes[256];
+	size_t number_of_tokens;
+	size_t number_of_bytes;
+} collected_tokens_type;
+
+/* Copies the tokens of a stream, since their values are only valid during the callback. */
+static void collect_token(const simple_tokenizer_token_type *token, void *user_data)
+{
+	collected_tokens_type *collected = (collected_tokens_type*) user_data;
+	if (collected->number_of_tokens < sizeof_array(collected->tokens) and
+		token->value.length <= sizeof(collected->bytes) - collected->number_of_bytes) {
+		memcpy(collected->bytes + collected->number_of_bytes, token->value.string, token->value.length);
+		collected->tokens[collected->number_of_tokens].type = token->type;
+		collected->tokens[collected->number_of_tokens].value =
+			string_to_const_stringref(collected->bytes + collected->number_of_bytes, token->value.length);
+		collected->number_of_bytes += token->value.length;
+	}
+	++collected->number_of_tokens;
+}
+
+TEST(test_with_stream, "Chunks of any size => the same tokens as the whole input")
+{
+	static const char input[] =
+		"abc  \t12\r\n\r\rx\n\xC3\xA9\xE4\xBD\xA0\xF0\x9F\x98\x80\xE4\xBDZ\xE4" "A\xC3"
+		"==0\0\0\x01\x80words and  spaces\xE4\xBD";
+	const size_t input_length = sizeof(input) - 1U;
+	simple_tokenizer_token_type expected_tokens[64];
+	size_t number_of_expected_tokens = 0U;
+	size_t chunk_length = 0U;
+	const allocator_type allocator = {&malloc, &realloc, &free};
+
+	number_of_expected_tokens = simple_tokenizer_tokenize(input, input_length, expected_tokens, sizeof_array(expected_tokens));
+	for (chunk_length = 1U; chunk_length <= input_length; ++chunk_length) {
+		simple_tokenizer_stream_type stream;
+		collected_tokens_type collected;
+		size_t offset = 0U;
+		size_t i = 0U;
+
+		collected.number_of_tokens = 0U;
+		collected.number_of_bytes = 0U;
+		simple_tokenizer_stream_init(&stream, allocator, &collect_token, &collected);
+		for (offset = 0U; offset < input_length; offset += chunk_length) {
+			const size_t length = (input_length - offset < chunk_length) ? input_length - offset : chunk_length;
+			ASSERT(simple_tokenizer_stream_feed(&stream, input + offset, length));
+		}
+		ASSERT(simple_tokenizer_stream_feed(&stream, NULL, 0U));
+		simple_tokenizer_stream_finish(&stream);
+		ASSERT_UINT_EQUAL(simple_tokenizer_stream_number_of_tokens(&stream), number_of_expected_tokens);
+		ASSERT_UINT_EQUAL(collected.number_of_tokens, number_of_expected_tokens);
+		for (i = 0U; i < number_of_expected_tokens and i < collected.number_of_tokens; ++i) {
+			ASSERT_EQUAL(collected.tokens[i].type, expected_tokens[i].type);
+			ASSERT_UINT_EQUAL(collected.tokens[i].value.length, expected_tokens[i].value.length);
+			ASSERT(memcmp(collected.tokens[i].value.string, expected_tokens[i].value.string,
+				expected_tokens[i].value.length) == 0);
+		}
+		simple_tokenizer_stream_deinit(&stream);
+	}
+}
+
+TEST(test_with_stream_maximum_token_length, "A maximum token length => longer runs in pieces, for chunks of any size")
+{
+	static const char input[] = "abcdefghij  \t 1234567890123\xC3\xA9xyzw\r\n\0\0\0\0\0!";
+	const size_t input_length = sizeof(input) - 1U;
+	const size_t maximum_token_length = 4U;
+	simple_tokenizer_token_type whole_tokens[32];
+	simple_tokenizer_token_type expected_tokens[64];
+	size_t number_of_whole_tokens = 0U;
+	size_t number_of_expected_tokens = 0U;
+	size_t chunk_length = 0U;
+	size_t i = 0U;
+
+	number_of_whole_tokens = simple_tokenizer_tokenize(input, input_length, whole_tokens, sizeof_array(whole_tokens));
+	for (i = 0U; i < number_of_whole_tokens; ++i) {
+		size_t offset = 0U;
+		for (offset = 0U; offset < whole_tokens[i].value.length; offset += maximum_token_length) {
+			const size_t rest = whole_tokens[i].value.length - offset;
+			expected_tokens[number_of_expected_tokens].type = whole_tokens[i].type;
+			expected_tokens[number_of_expected_tokens].value = string_to_const_stringref(
+				whole_tokens[i].value.string + offset, (rest < maximum_token_length) ? rest : maximum_token_length);
+			++number_of_expected_tokens;
+		}
+	}
+	for (chunk_length = 1U; chunk_length <= input_length; ++chunk_length) {
+		simple_tokenizer_stream_type stream;
+		collected_tokens_type collected;
+		size_t offset = 0U;
+
+		collected.number_of_tokens = 0U;
+		collected.number_of_bytes = 0U;
+		simple_tokenizer_stream_init(&stream, unit_testing_make_allocator(), &collect_token, &collected);
+		simple_tokenizer_stream_set_maximum_token_length(&stream, maximum_token_length);
+		for (offset = 0U; offset < input_length; offset += chunk_length) {
+			const size_t length = (input_length - offset < chunk_length) ? input_length - offset : chunk_length;
+			ASSERT(simple_tokenizer_stream_feed(&stream, input + offset, length));
+			ASSERT(stream.length_of_pending <= maximum_token_length);
+		}
+		simple_tokenizer_stream_finish(&stream);
+		ASSERT_UINT_EQUAL(collected.number_of_tokens, number_of_expected_tokens);
+		for (i = 0U; i < number_of_expected_tokens and i < collected.number_of_tokens; ++i) {
+			ASSERT_EQUAL(collected.tokens[i].type, expected_tokens[i].type);
+			ASSERT_UINT_EQUAL(collected.tokens[i].value.length, expected_tokens[i].value.length);
+			ASSERT(memcmp(collected.tokens[i].value.string, expected_tokens[i].value.string,
+				expected_tokens[i].value.length) == 0);
+		}
+		simple_tokenizer_stream_deinit(&stream);
+	}
+}
+
+TEST(test_with_stream_long_run, "A long run in small chunks => one token, with each byte scanned once")
+{
+	static char run[1U << 20U];
+	simple_tokenizer_stream_type stream;
+	collected_tokens_type collected;
+	size_t offset = 0U;
+
+	memset(run, 'a', sizeof(run));
+	collected.number_of_tokens = 0U;
+	collected.number_of_bytes = 0U;
+	simple_tokenizer_stream_init(&stream, unit_testing_make_allocator(), &collect_token, &collected);
+	for (offset = 0U; offset < sizeof(run); offset += 7U) {
+		const size_t length = (sizeof(run) - offset < 7U) ? sizeof(run) - offset : 7U;
+		ASSERT(simple_tokenizer_stream_feed(&stream, run + offset, length));
+	}
+	ASSERT_UINT_EQUAL(collected.number_of_tokens, 0U);
+	ASSERT_UINT_EQUAL(stream.length_of_pending, sizeof(run));
+	simple_tokenizer_stream_finish(&stream);
+	ASSERT_UINT_EQUAL(simple_tokenizer_stream_number_of_tokens(&stream), 1U);
+
+	simple_tokenizer_stream_set_maximum_token_length(&stream, 4096U);
+	ASSERT(simple_tokenizer_stream_feed(&stream, run, sizeof(run) - 1U));
+	ASSERT(simple_tokenizer_stream_feed(&stream, run, 1U));
+	simple_tokenizer_stream_finish(&stream);
+	ASSERT_UINT_EQUAL(simple_tokenizer_stream_number_of_tokens(&stream), 1U + sizeof(run) / 4096U);
+	simple_tokenizer_stream_deinit(&stream);
+}
+
+TEST(test_with_stream_without_memory, "No memory for the pending bytes => the stream reports an error")
+{
+	simple_tokenizer_stream_type stream;
+	collected_tokens_type collected;
+	collected.number_of_tokens = 0U;
+	collected.number_of_bytes = 0U;
+	simple_tokenizer_stream_init(&stream, unit_testing_make_allocator(), &collect_token, &collected);
+	unit_testing_allocations_until_failure = 0U;
+	ASSERT(simple_tokenizer_stream_feed(&stream, "+-", 2U));
+	ASSERT_UINT_EQUAL(collected.number_of_tokens, 2U);
+	ASSERT(not simple_tokenizer_stream_feed(&stream, "+abc", 4U));
+	ASSERT_UINT_EQUAL(collected.number_of_tokens, 3U);
+	simple_tokenizer_stream_deinit(&stream);
+}
+
+TEST(test_with_token_array, "Tokenizing into a growable array => the same tokens in one pass")
+{
+	static const char input[] = "x1 = (y2 + 3) * 40\r\n\xC3\xA9!!";
+	const size_t input_length = sizeof(input) - 1U;
+	simple_tokenizer_token_type expected_tokens[32];
+	simple_tokenizer_token_array_type array;
+	char many_tokens[1000];
+	size_t number_of_expected_tokens = 0U;
+	size_t i = 0U;
+
+	number_of_expected_tokens = simple_tokenizer_tokenize(input, input_length, expected_tokens, sizeof_array(expected_tokens));
+	simple_tokenizer_token_array_init(&array, unit_testing_make_allocator());
+	ASSERT(simple_tokenizer_tokenize_to_array("", 0U, &array));
+	ASSERT_UINT_EQUAL(array.number_of_tokens, 0U);
+	ASSERT(simple_tokenizer_tokenize_to_array(input, input_length, &array));
+	ASSERT_UINT_EQUAL(array.number_of_tokens, number_of_expected_tokens);
+	for (i = 0U; i < number_of_expected_tokens and i < array.number_of_tokens; ++i) {
+		ASSERT_EQUAL(array.tokens[i].type, expected_tokens[i].type);
+		ASSERT(array.tokens[i].value.string == expected_tokens[i].value.string);
+		ASSERT_UINT_EQUAL(array.tokens[i].value.length, expected_tokens[i].value.length);
+	}
+
+	/* the tokens are appended; one token per byte needs more room than the estimate */
+	for (i = 0U; i < sizeof(many_tokens); ++i) {
+		many_tokens[i] = (i % 2U == 0U) ? 'a' : '+';
+	}
+	ASSERT(simple_tokenizer_tokenize_to_array(many_tokens, sizeof(many_tokens), &array));
+	ASSERT_UINT_EQUAL(array.number_of_tokens, number_of_expected_tokens + sizeof(many_tokens));
+	ASSERT(array.tokens[number_of_expected_tokens + 999U].value.string == &many_tokens[999]);
+	ASSERT_EQUAL(array.tokens[number_of_expected_tokens + 999U].type, simple_tokenizer_token_punctuation);
+
+	unit_testing_allocations_until_failure = 0U;
+	ASSERT(not simple_tokenizer_tokenize_to_array(many_tokens, sizeof(many_tokens), &array));
+	ASSERT_UINT_EQUAL(array.number_of_tokens, number_of_expected_tokens + sizeof(many_tokens));
+	simple_tokenizer_token_array_deinit(&array);
+	ASSERT_UINT_EQUAL(array.number_of_tokens, 0U);
+}
+
+static unsigned long s_random_state = 1UL;
+
+static unsigned int random_number(unsigned int limit)
+{
+	s_random_state = (s_random_state * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+	return (unsigned int) ((s_random_state >> 8U) % limit);
+}
+
+/* Fills a buffer with ASCII, valid characters and bytes which make invalid or incomplete characters. */
+static void fill_with_random_utf8(unsigned char *buffer, size_t length, unsigned int percent_of_errors)
+{
+	static const unsigned char valid_characters[][4] = {
+		{0xC2U, 0x80U}, {0xDFU, 0xBFU}, {0xE0U, 0xA0U, 0x80U}, {0xEDU, 0x9FU, 0xBFU}, {0xEEU, 0x80U, 0x80U},
+		{0xEFU, 0xBFU, 0xBFU}, {0xF0U, 0x90U, 0x80U, 0x80U}, {0xF4U, 0x8FU, 0xBFU, 0xBFU}, {0xF3U, 0xA0U, 0x81U, 0x92U}
+	};
+	static const unsigned char invalid_bytes[] = {0x80U, 0xBFU, 0xC0U, 0xC1U, 0xE0U, 0xEDU, 0xF0U, 0xF4U, 0xF5U, 0xFFU};
+	size_t index = 0U;
+
+	while (index < length) {
+		const unsigned int kind = random_number(100U);
+		if (kind < percent_of_errors) {
+			buffer[index++] = invalid_bytes[random_number((unsigned int) sizeof(invalid_bytes))];
+		} else if (kind < 60U) {
+			buffer[index++] = (unsigned char) (0x20U + random_number(0x5FU));
+		} else {
+			const unsigned char *character = valid_characters[random_number((unsigned int) sizeof_array(valid_characters))];
+			const size_t number_of_bytes = (character[0] < 0xE0U) ? 2U : (character[0] < 0xF0U) ? 3U : 4U;
+			size_t i = 0U;
+			for (i = 0U; i < number_of_bytes and index < length; ++i) {
+				buffer[index++] = character[i];
+			}
+		}
+	}
+}
+
+/* Decodes the characters one by one and checks the ranges of their code points. */
+static size_t reference_utf8_valid_length(const unsigned char *string, size_t length)
+{
+	size_t index = 0U;
+	while (index < length) {
+		const unsigned int byte = string[index];
+		size_t number_of_bytes = 1U;
+		unsigned long code_point = byte;
+		unsigned long minimum = 0UL;
+		size_t i = 0U;
+
+		if (byte >= 0xF0U and byte < 0xF8U) {
+			number_of_bytes = 4U;
+			code_point = byte & 0x07U;
+			minimum = 0x10000UL;
+		} else if (byte >= 0xE0U and byte < 0xF0U) {
+			number_of_bytes = 3U;
+			code_point = byte & 0x0FU;
+			minimum = 0x800UL;
+		} else if (byte >= 0xC0U and byte < 0xE0U) {
+			number_of_bytes = 2U;
+			code_point = byte & 0x1FU;
+			minimum = 0x80UL;
+		} else if (byte >= 0x80U) {
+			break;
+		}
+		if (length - index < number_of_bytes) {
+			break;
+		}
+		for (i = 1U; i < number_of_bytes; ++i) {
+			if ((string[index + i] & 0xC0U) != 0x80U) {
+				break;
+			}
+			code_point = (code_point << 6U) | (string[index + i] & 0x3FUL);
+		}
+		if (i < number_of_bytes or code_point < minimum or code_point > 0x10FFFFUL or
+			(code_point >= 0xD800UL and code_point <= 0xDFFFUL)) {
+			break;
+		}
+		index += number_of_bytes;
+	}
+	return index;
+}
+
+TEST(test_utf8_valid_length, "The length of the valid UTF-8 prefix is the index of the first invalid character")
+{
+	unsigned char buffer[300];
+	unsigned int round = 0U;
+
+	ASSERT_UINT_EQUAL(simple_tokenizer_utf8_valid_length("", 0U), 0U);
+	ASSERT_UINT_EQUAL(simple_tokenizer_utf8_valid_length("abc\xC3\xA9", 5U), 5U);
+	ASSERT_UINT_EQUAL(simple_tokenizer_utf8_valid_length("abc\xC3\xA9", 4U), 3U);
+	ASSERT_UINT_EQUAL(simple_tokenizer_utf8_valid_length("\xC0\x80", 2U), 0U);
+	ASSERT_UINT_EQUAL(simple_tokenizer_utf8_valid_length("a\xED\xA0\x80", 4U), 1U);
+	ASSERT_UINT_EQUAL(simple_tokenizer_utf8_valid_length("ab\xF4\x90\x80\x80", 6U), 2U);
+	for (round = 0U; round < 3000U; ++round) {
+		const size_t length = random_number((unsigned int) sizeof(buffer) + 1U);
+		size_t expected_length = 0U;
+		fill_with_random_utf8(buffer, length, (round % 3U == 0U) ? 0U : (round % 3U == 1U) ? 1U : 10U);
+		expected_length = reference_utf8_valid_length(buffer, length);
+		ASSERT_UINT_EQUAL(simple_tokenizer_utf8_valid_length((const char*) buffer, length), expected_length);
+	}
+}
+
+TEST(test_with_random_utf8, "Characters which are valid or invalid UTF-8 => the same tokens as a character by character check")
+{
+	unsigned char buffer[300];
+	simple_tokenizer_token_type tokens[300];
+	unsigned int round = 0U;
+
+	/* overlong forms are characters, surrogate halves and their overlong forms are not */
+	ASSERT_UINT_EQUAL(simple_tokenizer_tokenize("\xC0\x80\xE0\x80\x80\xF0\x8D\x9F\xBF", 9U, NULL, 0U), 3U);
+	ASSERT_UINT_EQUAL(simple_tokenizer_tokenize("\xED\xA0\x80\xF0\x8D\xA0\x80", 7U, NULL, 0U), 7U);
+	for (round = 0U; round < 2000U; ++round) {
+		const size_t length = random_number((unsigned int) sizeof(buffer) + 1U);
+		size_t number_of_tokens = 0U;
+		size_t i = 0U;
+		fill_with_random_utf8(buffer, length, (round % 2U == 0U) ? 2U : 20U);
+		if (round >= 1000U) {
+			/* random bytes, with overlong forms and surrogate halves among the invalid characters */
+			for (i = 0U; i < length; ++i) {
+				buffer[i] = (unsigned char) random_number(256U);
+			}
+		}
+		number_of_tokens = simple_tokenizer_tokenize((const char*) buffer, length, tokens, sizeof_array(tokens));
+		for (i = 0U; i < number_of_tokens and i < sizeof_array(tokens); ++i) {
+			const unsigned char byte = (unsigned char) tokens[i].value.string[0];
+			const size_t remaining = length - (size_t) ((const unsigned char*) tokens[i].value.string - buffer);
+			size_t expected_length = 0U;
+
+			if (byte < 0x80U) {
+				continue;
+			}
+			expected_length = ((byte & 0xE0U) == 0xC0U) ? 2U : ((byte & 0xF0U) == 0xE0U) ? 3U :
+				((byte & 0xF8U) == 0xF0U) ? 4U : 1U;
+			if (expected_length > remaining) {
+				expected_length = 1U;
+			} else if (expected_length > 1U and simple_tokenizer_stringref_to_utf8_char(
+				string_to_const_stringref(tokens[i].value.string, expected_length)).error != simple_tokenizer_utf8_char_error_none) {
+				expected_length = 1U;
+			}
+			ASSERT_UINT_EQUAL(tokens[i].value.length, expected_length);
+			ASSERT_EQUAL(tokens[i].type, (expected_length > 1U) ?
+				simple_tokenizer_token_utf8_character : simple_tokenizer_token_extended_ascii_character);
+		}
+	}
+}
+
+static char s_long_utf8_string[9001];
+static uint32_t s_long_utf32_string[4501];
+
+TEST(test_utf8_to_utf32, "UTF-8 => UTF-32 code points, or the position and the error of the first invalid character")
+{
+	uint32_t output[8];
+	simple_tokenizer_transcoding_result_type result;
+	static const struct {
+		const char *string;
+		size_t length;
+		size_t number_of_valid_bytes;
+		simple_tokenizer_utf8_char_error_type error;
+	} invalid_strings[] = {
+		{"ab\x80", 3U, 2U, simple_tokenizer_utf8_char_error_first_byte_incorrect},
+		{"\xC1\xBF", 2U, 0U, simple_tokenizer_utf8_char_error_first_byte_incorrect},
+		{"a\xF5\x80\x80\x80", 5U, 1U, simple_tokenizer_utf8_char_error_first_byte_incorrect},
+		{"\xC3", 1U, 0U, simple_tokenizer_utf8_char_error_second_byte_incorrect},
+		{"\xC3" "a", 2U, 0U, simple_tokenizer_utf8_char_error_second_byte_incorrect},
+		{"\xE0\x9F\xBF", 3U, 0U, simple_tokenizer_utf8_char_error_second_byte_incorrect},
+		{"\xF4\x90\x80\x80", 4U, 0U, simple_tokenizer_utf8_char_error_second_byte_incorrect},
+		{"\xE2\x82", 2U, 0U, simple_tokenizer_utf8_char_error_third_byte_incorrect},
+		{"\xF0\x9F\x98" "a", 4U, 0U, simple_tokenizer_utf8_char_error_fourth_byte_incorrect},
+		{"x\xED\xB0\x80", 4U, 1U, simple_tokenizer_utf8_char_error_unicode_value_is_surrogate_half}
+	};
+	size_t i = 0U;
+
+	result = simple_tokenizer_utf8_to_utf32("A\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80", 10U, output, sizeof_array(output));
+	ASSERT_EQUAL(result.error, simple_tokenizer_utf8_char_error_none);
+	ASSERT_UINT_EQUAL(result.number_of_input_units, 10U);
+	ASSERT_UINT_EQUAL(result.number_of_output_units, 4U);
+	ASSERT_UINT_EQUAL(output[0], 0x41U);
+	ASSERT_UINT_EQUAL(output[1], 0xE9U);
+	ASSERT_UINT_EQUAL(output[2], 0x20ACU);
+	ASSERT_UINT_EQUAL(output[3], 0x1F600U);
+
+	/* the output is full before the last character, which is not an error */
+	result = simple_tokenizer_utf8_to_utf32("A\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80", 10U, output, 3U);
+	ASSERT_EQUAL(result.error, simple_tokenizer_utf8_char_error_none);
+	ASSERT_UINT_EQUAL(result.number_of_input_units, 6U);
+	ASSERT_UINT_EQUAL(result.number_of_output_units, 3U);
+	result = simple_tokenizer_utf8_to_utf32("0123456789", 10U, NULL, 0U);
+	ASSERT_UINT_EQUAL(result.number_of_output_units, 10U);
+
+	for (i = 0U; i < sizeof_array(invalid_strings); ++i) {
+		result = simple_tokenizer_utf8_to_utf32(invalid_strings[i].string, invalid_strings[i].length,
+			output, sizeof_array(output));
+		ASSERT_EQUAL(result.error, invalid_strings[i].error);
+		ASSERT_UINT_EQUAL(result.number_of_input_units, invalid_strings[i].number_of_valid_bytes);
+		ASSERT_UINT_EQUAL(result.number_of_output_units, invalid_strings[i].number_of_valid_bytes);
+	}
+
+	/* the input is validated ahead in parts of a few kilobytes, which may end inside a character */
+	for (i = 0U; i + 6U <= sizeof(s_long_utf8_string) - 1U; i += 6U) {
+		memcpy(s_long_utf8_string + i, "a\xC3\xA9\xE2\x82\xAC", 6U);
+	}
+	s_long_utf8_string[sizeof(s_long_utf8_string) - 1U] = '\x80';
+	result = simple_tokenizer_utf8_to_utf32(s_long_utf8_string, sizeof(s_long_utf8_string), s_long_utf32_string,
+		sizeof_array(s_long_utf32_string));
+	ASSERT_EQUAL(result.error, simple_tokenizer_utf8_char_error_first_byte_incorrect);
+	ASSERT_UINT_EQUAL(result.number_of_input_units, sizeof(s_long_utf8_string) - 1U);
+	ASSERT_UINT_EQUAL(result.number_of_output_units, (sizeof(s_long_utf8_string) - 1U) / 2U);
+	ASSERT_UINT_EQUAL(s_long_utf32_string[4499], 0x20ACU);
+}
+
+TEST(test_utf16_to_utf8, "UTF-16 => UTF-8, and unpaired surrogate halves are errors")
+{
+	static const uint16_t string[] = {0x41U, 0xE9U, 0x20ACU, 0xD83DU, 0xDE00U, 0x7FU};
+	static const uint16_t unpaired_high[] = {0x41U, 0xD83DU, 0x41U};
+	static const uint16_t unpaired_low[] = {0xDE00U};
+	char output[16];
+	simple_tokenizer_transcoding_result_type result;
+
+	result = simple_tokenizer_utf16_to_utf8(string, sizeof_array(string), output, sizeof(output));
+	ASSERT_EQUAL(result.error, simple_tokenizer_utf8_char_error_none);
+	ASSERT_UINT_EQUAL(result.number_of_input_units, 6U);
+	ASSERT_UINT_EQUAL(result.number_of_output_units, 11U);
+	ASSERT(memcmp(output, "A\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80\x7F", 11U) == 0);
+
+	result = simple_tokenizer_utf16_to_utf8(string, sizeof_array(string), output, 9U);
+	ASSERT_EQUAL(result.error, simple_tokenizer_utf8_char_error_none);
+	ASSERT_UINT_EQUAL(result.number_of_input_units, 3U);
+	ASSERT_UINT_EQUAL(result.number_of_output_units, 6U);
+	result = simple_tokenizer_utf16_to_utf8(string, sizeof_array(string), NULL, 0U);
+	ASSERT_UINT_EQUAL(result.number_of_output_units, 11U);
+
+	result = simple_tokenizer_utf16_to_utf8(unpaired_high, sizeof_array(unpaired_high), output, sizeof(output));
+	ASSERT_EQUAL(result.error, simple_tokenizer_utf8_char_error_unicode_value_is_surrogate_half);
+	ASSERT_UINT_EQUAL(result.number_of_input_units, 1U);
+	result = simple_tokenizer_utf16_to_utf8(unpaired_high, 2U, output, sizeof(output));
+	ASSERT_EQUAL(result.error, simple_tokenizer_utf8_char_error_unicode_value_is_surrogate_half);
+	ASSERT_UINT_EQUAL(result.number_of_input_units, 1U);
+	result = simple_tokenizer_utf16_to_utf8(unpaired_low, sizeof_array(unpaired_low), output, sizeof(output));
+	ASSERT_EQUAL(result.error, simple_tokenizer_utf8_char_error_unicode_value_is_surrogate_half);
+	ASSERT_UINT_EQUAL(result.number_of_input_units, 0U);
+}
+
+TEST(test_with_random_transcoding, "Random UTF-8 => UTF-32 and UTF-16 and back, up to the first invalid character")
+{
+	unsigned char buffer[300];
+	uint32_t utf32[300];
+	uint16_t utf16[600];
+	char utf8[1200];
+	unsigned int round = 0U;
+
+	for (round = 0U; round < 1000U; ++round) {
+		const size_t length = random_number((unsigned int) sizeof(buffer) + 1U);
+		size_t valid_length = 0U;
+		simple_tokenizer_transcoding_result_type result;
+		simple_tokenizer_transcoding_result_type utf16_result;
+		size_t index = 0U;
+		size_t i = 0U;
+
+		fill_with_random_utf8(buffer, length, (round % 2U == 0U) ? 0U : 1U);
+		valid_length = reference_utf8_valid_length(buffer, length);
+		result = simple_tokenizer_utf8_to_utf32((const char*) buffer, length, utf32, sizeof_array(utf32));
+		ASSERT_UINT_EQUAL(result.number_of_input_units, valid_length);
+		ASSERT_EQUAL(result.error == simple_tokenizer_utf8_char_error_none, valid_length == length);
+		for (i = 0U; i < result.number_of_output_units; ++i) {
+			simple_tokenizer_utf8_char_type utf8_char;
+			const size_t number_of_bytes = (buffer[index] < 0x80U) ? 1U : (buffer[index] < 0xE0U) ? 2U :
+				(buffer[index] < 0xF0U) ? 3U : 4U;
+			utf8_char = simple_tokenizer_stringref_to_utf8_char(
+				string_to_const_stringref((const char*) buffer + index, number_of_bytes));
+			ASSERT_UINT_EQUAL(utf32[i], utf8_char.unicode_value);
+			index += number_of_bytes;
+		}
+
+		utf16_result = simple_tokenizer_utf8_to_utf16((const char*) buffer, length, utf16, sizeof_array(utf16));
+		ASSERT_UINT_EQUAL(utf16_result.number_of_input_units, valid_length);
+		ASSERT_EQUAL(utf16_result.error, result.error);
+		ASSERT_UINT_EQUAL(simple_tokenizer_utf8_to_utf16((const char*) buffer, length, NULL, 0U).number_of_output_units,
+			utf16_result.number_of_output_units);
+		result = simple_tokenizer_utf16_to_utf8(utf16, utf16_result.number_of_output_units, utf8, sizeof(utf8));
+		ASSERT_EQUAL(result.error, simple_tokenizer_utf8_char_error_none);
+		ASSERT_UINT_EQUAL(result.number_of_output_units, valid_length);
+		ASSERT(memcmp(utf8, buffer, valid_length) == 0);
+	}
+}
+
+TEST(test_with_compact_tokens, "Compact tokens => the same tokens in 8 bytes each")
+{
+	static const char input[] = "x1 = (y2 + 3) * 40\r\n\xC3\xA9\x80!!  \t";
+	const size_t input_length = sizeof(input) - 1U;
+	simple_tokenizer_token_type expected_tokens[32];
+	simple_tokenizer_compact_token_type compact_tokens[32];
+	simple_tokenizer_compact_token_array_type array;
+	size_t number_of_expected_tokens = 0U;
+	size_t i = 0U;
+
+	ASSERT_UINT_EQUAL(sizeof(simple_tokenizer_compact_token_type), 8U);
+	number_of_expected_tokens = simple_tokenizer_tokenize(input, input_length, expected_tokens, sizeof_array(expected_tokens));
+	ASSERT_UINT_EQUAL(simple_tokenizer_tokenize_compact(input, input_length, NULL, 0U), number_of_expected_tokens);
+	ASSERT_UINT_EQUAL(simple_tokenizer_tokenize_compact(input, input_length, compact_tokens, 3U), number_of_expected_tokens);
+	ASSERT_UINT_EQUAL(simple_tokenizer_tokenize_compact(input, input_length, compact_tokens, sizeof_array(compact_tokens)),
+		number_of_expected_tokens);
+	for (i = 0U; i < number_of_expected_tokens; ++i) {
+		const simple_tokenizer_token_type token = simple_tokenizer_compact_token_to_token(input, compact_tokens[i]);
+		ASSERT_EQUAL(token.type, expected_tokens[i].type);
+		ASSERT(token.value.string == expected_tokens[i].value.string);
+		ASSERT_UINT_EQUAL(token.value.length, expected_tokens[i].value.length);
+	}
+
+	simple_tokenizer_compact_token_array_init(&array, unit_testing_make_allocator());
+	ASSERT(simple_tokenizer_tokenize_compact_to_array(input, input_length, &array));
+	ASSERT_UINT_EQUAL(array.number_of_tokens, number_of_expected_tokens);
+	ASSERT(memcmp(array.tokens, compact_tokens, number_of_expected_tokens * sizeof(compact_tokens[0])) == 0);
+	unit_testing_allocations_until_failure = 0U;
+	ASSERT(not simple_tokenizer_tokenize_compact_to_array(input, input_length, &array));
+	ASSERT_UINT_EQUAL(array.number_of_tokens, number_of_expected_tokens);
+	simple_tokenizer_compact_token_array_deinit(&array);
+}
+
+TEST(test_with_long_compact_tokens, "A run longer than a compact token can be => several tokens of the same type")
+{
+	const size_t length = SIMPLE_TOKENIZER_COMPACT_TOKEN_MAX_LENGTH + 10U;
+	char *string = (char*) malloc(length);
+	simple_tokenizer_compact_token_type tokens[4];
+
+	ASSERT(string != NULL);
+	if (string == NULL) {
+		return;
+	}
+	memset(string, ' ', length);
+	string[length - 1U] = 'a';
+	ASSERT_UINT_EQUAL(simple_tokenizer_tokenize_compact(string, length, tokens, sizeof_array(tokens)), 3U);
+	ASSERT_EQUAL(simple_tokenizer_compact_token_type_of(tokens[0]), simple_tokenizer_token_spaces);
+	ASSERT_UINT_EQUAL(simple_tokenizer_compact_token_length(tokens[0]), SIMPLE_TOKENIZER_COMPACT_TOKEN_MAX_LENGTH);
+	ASSERT_EQUAL(simple_tokenizer_compact_token_type_of(tokens[1]), simple_tokenizer_token_spaces);
+	ASSERT_UINT_EQUAL(tokens[1].offset, SIMPLE_TOKENIZER_COMPACT_TOKEN_MAX_LENGTH);
+	ASSERT_UINT_EQUAL(simple_tokenizer_compact_token_length(tokens[1]), 9U);
+	ASSERT_EQUAL(simple_tokenizer_compact_token_type_of(tokens[2]), simple_tokenizer_token_letters);
+	ASSERT(simple_tokenizer_compact_token_value(string, tokens[2]).string == string + length - 1U);
+	free(string);
+}
+
+TEST(test_with_too_long_compact_string, "A string longer than compact offsets can address => an error, nothing read")
+{
+	static const char input[] = "x";
+	simple_tokenizer_compact_token_type tokens[4];
+	simple_tokenizer_compact_token_array_type array;
+
+	/* the string is not read, so its length can exceed its size */
+	if ((size_t) -1 > SIMPLE_TOKENIZER_COMPACT_MAX_STRING_LENGTH) {
+		const size_t length = (size_t) SIMPLE_TOKENIZER_COMPACT_MAX_STRING_LENGTH + 1U;
+		ASSERT_UINT_EQUAL(simple_tokenizer_tokenize_compact(input, length, NULL, 0U), (size_t) -1);
+		ASSERT_UINT_EQUAL(simple_tokenizer_tokenize_compact(input, length, tokens, sizeof_array(tokens)), (size_t) -1);
+
+		simple_tokenizer_compact_token_array_init(&array, unit_testing_make_allocator());
+		ASSERT(simple_tokenizer_tokenize_compact_to_array(input, 1U, &array));
+		ASSERT(not simple_tokenizer_tokenize_compact_to_array(input, length, &array));
+		ASSERT_UINT_EQUAL(array.number_of_tokens, 1U);
+		simple_tokenizer_compact_token_array_deinit(&array);
+	}
+}
+
 int main(void)
 {
 	DEFINE_LIST_OF_TESTS(tests) {
@@ -985,7 +1607,22 @@ int main(void)
 		test_with_multiple_extended_ASCII_characters,
 		test_with_two_byte_utf8_characters,
 		test_with_three_byte_utf8_characters,
-		test_with_four_byte_utf8_characters
+		test_with_four_byte_utf8_characters,
+		test_with_every_single_byte,
+		test_with_long_runs,
+		test_with_stream,
+		test_with_stream_maximum_token_length,
+		test_with_stream_long_run,
+		test_with_stream_without_memory,
+		test_with_token_array,
+		test_utf8_valid_length,
+		test_with_random_utf8,
+		test_utf8_to_utf32,
+		test_utf16_to_utf8,
+		test_with_random_transcoding,
+		test_with_compact_tokens,
+		test_with_long_compact_tokens,
+		test_with_too_long_compact_string
 	};
 
 	SET_OUTPUT_FILE(stdout);
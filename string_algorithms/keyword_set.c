@@ -0,0 +1,62 @@
+#include "keyword_set.h"
+#include <assert.h>
+#include <iso646.h>
+#include <string.h>
+
+enum {
+	keyword_set_seed_limit = 1 << 24
+};
+
+static size_t keyword_set_slot(uint32_t seed, const_stringref_type string, size_t number_of_slots)
+{
+	return (size_t) keyword_set_hash(seed, string.string, string.length) & (number_of_slots - 1U);
+}
+
+const keyword_set_entry_type *keyword_set_find(const keyword_set_type *set, const_stringref_type token)
+{
+	const keyword_set_entry_type *entry = NULL;
+
+	assert(set != NULL);
+	assert(set->number_of_slots > 0U and (set->number_of_slots & (set->number_of_slots - 1U)) == 0U);
+	if (token.string == NULL) {
+		token.length = 0U;
+	}
+	entry = &set->slots[keyword_set_slot(set->seed, token, set->number_of_slots)];
+	if (entry->keyword.string != NULL and entry->keyword.length == token.length and
+		memcmp(entry->keyword.string, token.string, token.length) == 0) {
+		return entry;
+	}
+	return NULL;
+}
+
+/* The slots are compared pairwise, so no memory is needed. Keyword sets are small and this runs before compilation. */
+Boolean_type keyword_set_find_seed(const const_stringref_type *keywords, size_t number_of_keywords,
+	size_t number_of_slots, uint32_t *seed)
+{
+	uint32_t candidate = 0U;
+
+	assert(keywords != NULL or number_of_keywords == 0U);
+	assert(seed != NULL);
+	if (number_of_slots == 0U or (number_of_slots & (number_of_slots - 1U)) != 0U or number_of_slots < number_of_keywords) {
+		return Boolean_false;
+	}
+	for (candidate = 0U; candidate < (uint32_t) keyword_set_seed_limit; ++candidate) {
+		Boolean_type slots_are_distinct = Boolean_true;
+		size_t i = 0U;
+		for (i = 1U; i < number_of_keywords and slots_are_distinct; ++i) {
+			const size_t slot = keyword_set_slot(candidate, keywords[i], number_of_slots);
+			size_t j = 0U;
+			for (j = 0U; j < i; ++j) {
+				if (keyword_set_slot(candidate, keywords[j], number_of_slots) == slot) {
+					slots_are_distinct = Boolean_false;
+					break;
+				}
+			}
+		}
+		if (slots_are_distinct) {
+			*seed = candidate;
+			return Boolean_true;
+		}
+	}
+	return Boolean_false;
+}
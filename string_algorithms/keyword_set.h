@@ -0,0 +1,103 @@
+/* Minimum C Standard: C89 */
+/* Minimum C++ Standard for a constexpr keyword_set_hash: C++14 */
+
+#ifndef KEYWORD_SET_H
+#define KEYWORD_SET_H
+
+#include "Boolean_type.h"
+#include "fixed_width_integer_types.h"
+#include "inline_or_static.h"
+#include "string_reference.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+A keyword set is a constant table of keywords, e.g. the keywords or the operators of a language, with a perfect
+hash function: every keyword has a slot of its own, so a token is classified by hashing it once and comparing it
+with the keyword in a single slot, without any branch over the list of keywords.
+
+The tables are generated before compilation, so they can be static constant data:
+- programs/generate_keyword_set prints the C code of a keyword set for a list of keywords and values.
+- keyword_set_find_seed finds the seed of the hash function at runtime, e.g. to build a table in a test.
+- In C++14 and later, keyword_set_hash is constexpr, so the slots of the keywords can be checked at compile time.
+  KEYWORD_SET_CONSTEXPR_SUPPORTED is 1 then. In C++11, keyword_set_hash is an ordinary function, as its loop is not
+  allowed in a constexpr function, and cannot be used in a static_assert.
+
+The hash function is FNV-1a with the seed mixed into the initial value, followed by a final mix of the bits.
+The slot of a string is the hash modulo the number of slots, which must be a power of two.
+
+Example (generated):
+static const keyword_set_entry_type operator_slots[4] = {
+	{CONST_STRINGREF_LITERAL("-"), token_minus},
+	{CONST_STRINGREF_LITERAL("+"), token_plus},
+	{{NULL, 0U}, 0},
+	{{NULL, 0U}, 0}
+};
+static const keyword_set_type operators = {operator_slots, 4U, 0x00000001UL};
+...
+const keyword_set_entry_type *entry = keyword_set_find(&operators, token);
+type = (entry != NULL) ? entry->value : token_unsupported;
+*/
+
+#if defined(__cplusplus) && (__cplusplus >= 201402L)
+#define KEYWORD_SET_CONSTEXPR constexpr
+#define KEYWORD_SET_CONSTEXPR_SUPPORTED 1
+#else
+#define KEYWORD_SET_CONSTEXPR
+#define KEYWORD_SET_CONSTEXPR_SUPPORTED 0
+#endif
+
+typedef struct keyword_set_entry_type
+{
+	const_stringref_type keyword; /* a null pointer for an empty slot */
+	int value;
+} keyword_set_entry_type;
+
+typedef struct keyword_set_type
+{
+	const keyword_set_entry_type *slots;
+	size_t number_of_slots; /* a power of two */
+	uint32_t seed;
+} keyword_set_type;
+
+INLINE_OR_STATIC KEYWORD_SET_CONSTEXPR
+uint32_t
+keyword_set_hash(uint32_t seed, const char *string, size_t length)
+{
+	uint32_t hash = (uint32_t) (0x811C9DC5UL ^ seed);
+	size_t i = 0U;
+	for (; i < length; ++i) {
+		hash = (uint32_t) ((hash ^ (unsigned char) string[i]) * 0x01000193UL);
+	}
+	hash ^= hash >> 16U;
+	hash = (uint32_t) (hash * 0x7FEB352DUL);
+	hash ^= hash >> 15U;
+	return hash;
+}
+
+/* Returns the entry of the keyword which is equal to the token, or null if the token is not a keyword. */
+const keyword_set_entry_type *keyword_set_find(const keyword_set_type *set, const_stringref_type token);
+
+/*
+Finds a seed for which the keywords have distinct slots.
+
+Parameters:
+keywords          : The keywords, which must be distinct.
+number_of_keywords: The number of keywords.
+number_of_slots   : The number of slots, a power of two not less than the number of keywords.
+seed              : Receives the seed. Must not be null.
+
+Return value: Boolean_true if a seed is found among the first 2^24 seeds, otherwise Boolean_false,
+in which case a larger number of slots should be tried.
+*/
+Boolean_type keyword_set_find_seed(const const_stringref_type *keywords, size_t number_of_keywords,
+	size_t number_of_slots, uint32_t *seed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,61 @@
+/* Minimum C++ Standard: C++14 */
+
+#include "keyword_set.h"
+
+/*
+The tests of this file are static assertions, so the program passes if it compiles.
+keyword_set_hash is only constexpr in C++14 and later, as a constexpr function of C++11 must be a single return
+statement.
+*/
+
+static_assert(KEYWORD_SET_CONSTEXPR_SUPPORTED, "keyword_set_hash must be constexpr in C++14.");
+
+/* The values which the C function returns for the same arguments at runtime. */
+static_assert(keyword_set_hash(0U, "", 0U) == 0xA61DB31CUL, "The hash of an empty string shall not depend on its bytes.");
+static_assert(keyword_set_hash(1U, "if", 2U) == 0x8296B34AUL, "The hash shall be the same at compile time.");
+static_assert(keyword_set_hash(1U, "return", 6U) == 0x0DDFEFEBUL, "The hash shall be the same at compile time.");
+static_assert(keyword_set_hash(0U, "if", 2U) != keyword_set_hash(1U, "if", 2U), "The seed shall change the hash.");
+
+enum token_type {
+	token_if = 1,
+	token_else,
+	token_while,
+	token_for,
+	token_return
+};
+
+/* generated by: generate_keyword_set keywords if token_if else token_else while token_while for token_for return token_return */
+constexpr keyword_set_entry_type keyword_slots[8] = {
+	{CONST_STRINGREF_LITERAL("else"), token_else},
+	{CONST_STRINGREF_LITERAL("for"), token_for},
+	{CONST_STRINGREF_LITERAL("if"), token_if},
+	{CONST_STRINGREF_LITERAL("return"), token_return},
+	{{nullptr, 0U}, 0},
+	{CONST_STRINGREF_LITERAL("while"), token_while},
+	{{nullptr, 0U}, 0},
+	{{nullptr, 0U}, 0}
+};
+constexpr uint32_t keyword_seed = 0x00000001UL;
+
+/* Returns true if every keyword of a table is in the slot of its hash, as keyword_set_find looks it up. */
+template <size_t number_of_slots>
+constexpr bool has_keywords_in_their_slots(const keyword_set_entry_type (&slots)[number_of_slots], uint32_t seed)
+{
+	size_t i = 0U;
+	for (i = 0U; i < number_of_slots; ++i) {
+		const const_stringref_type keyword = slots[i].keyword;
+		if (keyword.string != nullptr and
+			(keyword_set_hash(seed, keyword.string, keyword.length) & (number_of_slots - 1U)) != i) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static_assert(has_keywords_in_their_slots(keyword_slots, keyword_seed), "Each keyword shall be in the slot of its hash.");
+static_assert(not has_keywords_in_their_slots(keyword_slots, keyword_seed + 1U), "Another seed shall move the keywords.");
+
+int main()
+{
+	return 0;
+}
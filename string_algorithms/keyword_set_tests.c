@@ -0,0 +1,92 @@
+#include "keyword_set.h"
+#include "unit_testing.h"
+
+#include <iso646.h>
+#include <string.h>
+
+static const_stringref_type make_stringref(const char *string)
+{
+	return string_to_const_stringref(string, strlen(string));
+}
+
+/* generated by: generate_keyword_set c_keywords if 1 else 2 for 3 while 4 do 5 return 6 */
+static const keyword_set_entry_type c_keywords_slots[8] = {
+	{CONST_STRINGREF_LITERAL("else"), 2},
+	{CONST_STRINGREF_LITERAL("for"), 3},
+	{CONST_STRINGREF_LITERAL("if"), 1},
+	{CONST_STRINGREF_LITERAL("return"), 6},
+	{CONST_STRINGREF_LITERAL("do"), 5},
+	{CONST_STRINGREF_LITERAL("while"), 4},
+	{{NULL, 0U}, 0},
+	{{NULL, 0U}, 0}
+};
+static const keyword_set_type c_keywords = {c_keywords_slots, 8U, 0x00000001UL};
+
+CONSTEXPR_CONST_STRINGREF(s_return_keyword, "return");
+
+TEST(keyword_set_generated_table, "A generated keyword set finds its keywords and nothing else")
+{
+	static const char *const keywords[] = {"if", "else", "for", "while", "do", "return"};
+	static const char *const other_tokens[] = {"", "i", "iff", "els", "elsewhere", "While", "fo", "x", "returns"};
+	size_t i = 0U;
+
+	for (i = 0U; i < sizeof(keywords) / sizeof(keywords[0]); ++i) {
+		const keyword_set_entry_type *entry = keyword_set_find(&c_keywords, make_stringref(keywords[i]));
+		ASSERT(entry != NULL);
+		if (entry != NULL) {
+			ASSERT_EQUAL(entry->value, (int) i + 1);
+		}
+	}
+	for (i = 0U; i < sizeof(other_tokens) / sizeof(other_tokens[0]); ++i) {
+		ASSERT(keyword_set_find(&c_keywords, make_stringref(other_tokens[i])) == NULL);
+	}
+	ASSERT(keyword_set_find(&c_keywords, string_to_const_stringref(NULL, 3U)) == NULL);
+	ASSERT(keyword_set_find(&c_keywords, s_return_keyword) != NULL);
+	ASSERT_SIZE_EQUAL(s_return_keyword.length, 6U);
+}
+
+TEST(keyword_set_find_seed_test, "keyword_set_find_seed gives distinct slots for every keyword")
+{
+	static const char *const operators[] = {"+", "-", "*", "/", "=", ".", "(", ")", "_", "==", "!=", "<=", ">=", "<", ">", "&&"};
+	const_stringref_type keywords[16];
+	keyword_set_entry_type slots[16];
+	keyword_set_type set;
+	uint32_t seed = 0U;
+	size_t i = 0U;
+
+	for (i = 0U; i < 16U; ++i) {
+		keywords[i] = make_stringref(operators[i]);
+	}
+	ASSERT(keyword_set_find_seed(keywords, 16U, 16U, &seed));
+	memset(slots, 0, sizeof(slots));
+	for (i = 0U; i < 16U; ++i) {
+		const size_t slot = (size_t) keyword_set_hash(seed, keywords[i].string, keywords[i].length) & 15U;
+		ASSERT(slots[slot].keyword.string == NULL);
+		slots[slot].keyword = keywords[i];
+		slots[slot].value = (int) i;
+	}
+	set.slots = slots;
+	set.number_of_slots = 16U;
+	set.seed = seed;
+	for (i = 0U; i < 16U; ++i) {
+		const keyword_set_entry_type *entry = keyword_set_find(&set, keywords[i]);
+		ASSERT(entry != NULL and entry->value == (int) i);
+	}
+	ASSERT(keyword_set_find(&set, make_stringref("+=")) == NULL);
+
+	ASSERT(not keyword_set_find_seed(keywords, 16U, 8U, &seed));
+	ASSERT(not keyword_set_find_seed(keywords, 16U, 24U, &seed));
+}
+
+int main(void)
+{
+	DEFINE_LIST_OF_TESTS(list_of_tests) {
+		keyword_set_generated_table,
+		keyword_set_find_seed_test
+	};
+
+	PRINT_FILE_NAME();
+	RUN_TESTS(list_of_tests);
+	PRINT_TEST_STATISTICS(list_of_tests);
+	return 0;
+}
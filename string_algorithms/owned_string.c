@@ -0,0 +1,186 @@
+#include "owned_string.h"
+#include <assert.h>
+#include <iso646.h>
+#include <string.h>
+
+/* Notes:
+- The string is inline if and only if the capacity is OWNED_STRING_INLINE_CAPACITY. A memory block always has a
+  greater capacity, so the capacity tells where the characters are without a separate flag.
+- A memory block has one more byte than the capacity for the null terminator.
+- Once a string has a memory block, it keeps it until owned_string_deinit, like the capacity of a dynamic array.
+*/
+
+static char *owned_string_characters(const owned_string_type *string)
+{
+	return (string->capacity > OWNED_STRING_INLINE_CAPACITY) ?
+		string->storage.heap_string : (char*) string->storage.inline_string;
+}
+
+/* Returns Boolean_true if the referenced characters are inside the memory of the string. */
+static Boolean_type owned_string_contains(const owned_string_type *string, const char *characters)
+{
+	const char *begin = owned_string_characters(string);
+	return (Boolean_type) (characters >= begin and characters <= begin + string->capacity);
+}
+
+void owned_string_init(owned_string_type *string, allocator_type allocator)
+{
+	assert(string != NULL);
+	assert(allocator.allocate != NULL);
+	assert(allocator.deallocate != NULL);
+	string->storage.inline_string[0] = '\0';
+	string->length = 0U;
+	string->capacity = OWNED_STRING_INLINE_CAPACITY;
+	string->allocator = allocator;
+}
+
+void owned_string_deinit(owned_string_type *string)
+{
+	assert(string != NULL);
+	if (string->capacity > OWNED_STRING_INLINE_CAPACITY) {
+		allocator_deallocate(string->allocator, string->storage.heap_string);
+	}
+	string->storage.inline_string[0] = '\0';
+	string->length = 0U;
+	string->capacity = OWNED_STRING_INLINE_CAPACITY;
+}
+
+void owned_string_clear(owned_string_type *string)
+{
+	assert(string != NULL);
+	string->length = 0U;
+	owned_string_characters(string)[0] = '\0';
+}
+
+Boolean_type owned_string_reserve(owned_string_type *string, size_t capacity)
+{
+	const size_t max_capacity = ((size_t) -1) - 1U;
+	size_t new_capacity = 0U;
+	char *new_string = NULL;
+
+	assert(string != NULL);
+	if (capacity <= string->capacity) {
+		return Boolean_true;
+	}
+	if (capacity > max_capacity) {
+		return Boolean_false;
+	}
+	new_capacity = string->capacity;
+	while (new_capacity < capacity) {
+		new_capacity = (new_capacity <= max_capacity / 2U) ? 2U * new_capacity + 1U : max_capacity;
+	}
+	if (string->capacity > OWNED_STRING_INLINE_CAPACITY) {
+		new_string = (char*) allocator_reallocate(string->allocator, string->storage.heap_string,
+			string->capacity + 1U, new_capacity + 1U);
+		if (new_string == NULL) {
+			return Boolean_false;
+		}
+	} else {
+		/* allocate is called directly, since the characters are copied and the rest need not be zeroed */
+		new_string = (char*) string->allocator.allocate(new_capacity + 1U);
+		if (new_string == NULL) {
+			return Boolean_false;
+		}
+		memcpy(new_string, string->storage.inline_string, string->length + 1U);
+	}
+	string->storage.heap_string = new_string;
+	string->capacity = new_capacity;
+	return Boolean_true;
+}
+
+Boolean_type owned_string_assign(owned_string_type *string, const_stringref_type source)
+{
+	char *characters = NULL;
+
+	assert(string != NULL);
+	if (source.string == NULL) {
+		source.length = 0U;
+	}
+	/* a part of the string itself is never longer than the string, so it needs no reallocation */
+	if (not owned_string_reserve(string, source.length)) {
+		return Boolean_false;
+	}
+	characters = owned_string_characters(string);
+	if (source.length > 0U) {
+		memmove(characters, source.string, source.length);
+	}
+	characters[source.length] = '\0';
+	string->length = source.length;
+	return Boolean_true;
+}
+
+Boolean_type owned_string_append(owned_string_type *string, const_stringref_type source)
+{
+	size_t offset_in_string = 0U;
+	Boolean_type source_is_in_string = Boolean_false;
+	char *characters = NULL;
+
+	assert(string != NULL);
+	if (source.string == NULL or source.length == 0U) {
+		return Boolean_true;
+	}
+	if (source.length > ((size_t) -1) - 1U - string->length) {
+		return Boolean_false;
+	}
+	source_is_in_string = owned_string_contains(string, source.string);
+	if (source_is_in_string) {
+		offset_in_string = (size_t) (source.string - owned_string_characters(string));
+	}
+	if (not owned_string_reserve(string, string->length + source.length)) {
+		return Boolean_false;
+	}
+	characters = owned_string_characters(string);
+	if (source_is_in_string) {
+		/* the characters may have been moved by the reallocation */
+		source.string = characters + offset_in_string;
+	}
+	memmove(characters + string->length, source.string, source.length);
+	string->length += source.length;
+	characters[string->length] = '\0';
+	return Boolean_true;
+}
+
+Boolean_type owned_string_push_back(owned_string_type *string, char character)
+{
+	char *characters = NULL;
+
+	assert(string != NULL);
+	if (string->length == string->capacity and not owned_string_reserve(string, string->length + 1U)) {
+		return Boolean_false;
+	}
+	characters = owned_string_characters(string);
+	characters[string->length] = character;
+	++string->length;
+	characters[string->length] = '\0';
+	return Boolean_true;
+}
+
+size_t owned_string_length(const owned_string_type *string)
+{
+	assert(string != NULL);
+	return string->length;
+}
+
+const char *owned_string_c_string(const owned_string_type *string)
+{
+	assert(string != NULL);
+	return owned_string_characters(string);
+}
+
+char *owned_string_data(owned_string_type *string)
+{
+	assert(string != NULL);
+	return owned_string_characters(string);
+}
+
+const_stringref_type owned_string_to_const_stringref(const owned_string_type *string)
+{
+	assert(string != NULL);
+	return string_to_const_stringref(owned_string_characters(string), string->length);
+}
+
+Boolean_type owned_string_is_inline(const owned_string_type *string)
+{
+	assert(string != NULL);
+	return (Boolean_type) (string->capacity == OWNED_STRING_INLINE_CAPACITY);
+}
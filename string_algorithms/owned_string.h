@@ -0,0 +1,100 @@
+/* Minimum C Standard: C89 */
+
+#ifndef OWNED_STRING_H
+#define OWNED_STRING_H
+
+#include "allocator_type.h"
+#include "Boolean_type.h"
+#include "string_reference.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+An owned string holds a copy of its characters, unlike a string reference.
+
+- Strings of up to OWNED_STRING_INLINE_CAPACITY bytes are stored inside the object, so short strings, e.g. names
+  and words, need no memory allocation.
+- Longer strings are stored in a memory block allocated through the allocator passed to owned_string_init.
+  The capacity grows by doubling, so appending a byte takes amortized O(1) time.
+- The characters are always followed by a null terminator, which is not included in the length, so the string can be
+  passed to functions which expect a C string. The string may contain '\0' as well.
+- owned_string_to_const_stringref returns a reference to the characters without copying them. The reference
+  becomes invalid when the string is modified or deinitialized.
+
+Functions which may allocate memory return Boolean_false if there is not enough memory, in which case the string is
+unchanged.
+
+Example:
+	owned_string_type name;
+	owned_string_init(&name, allocator);
+	if (owned_string_assign(&name, string_to_const_stringref("file", 4U)) and
+		owned_string_append(&name, string_to_const_stringref(".txt", 4U))) {
+		fp = fopen(owned_string_c_string(&name), "rb");
+	}
+	owned_string_deinit(&name);
+*/
+
+#define OWNED_STRING_INLINE_CAPACITY 23U
+
+typedef struct owned_string_type
+{
+	union {
+		char *heap_string; /* used if capacity is greater than OWNED_STRING_INLINE_CAPACITY */
+		char inline_string[OWNED_STRING_INLINE_CAPACITY + 1U];
+	} storage;
+	size_t length;
+	size_t capacity; /* the maximum length without reallocation, excluding the null terminator */
+	allocator_type allocator;
+} owned_string_type;
+
+/*
+Initializes an empty string. No memory is allocated.
+
+Parameters:
+string   : A pointer to an owned string. Must not be null.
+allocator: The allocator used for strings longer than OWNED_STRING_INLINE_CAPACITY bytes.
+           Its 'allocate' and 'deallocate' function pointers must not be null.
+*/
+void owned_string_init(owned_string_type *string, allocator_type allocator);
+
+/* Deallocates the memory of a string, which becomes empty. */
+void owned_string_deinit(owned_string_type *string);
+
+/* Removes all the characters and keeps the capacity. */
+void owned_string_clear(owned_string_type *string);
+
+/* Makes room for at least the number of bytes, excluding the null terminator. */
+Boolean_type owned_string_reserve(owned_string_type *string, size_t capacity);
+
+/* Replaces the characters of a string with a copy of the referenced string, which may be part of the string itself. */
+Boolean_type owned_string_assign(owned_string_type *string, const_stringref_type source);
+
+/* Appends a copy of the referenced string, which may be part of the string itself. */
+Boolean_type owned_string_append(owned_string_type *string, const_stringref_type source);
+
+/* Appends a character. */
+Boolean_type owned_string_push_back(owned_string_type *string, char character);
+
+/* Returns the number of bytes of a string, excluding the null terminator. */
+size_t owned_string_length(const owned_string_type *string);
+
+/* Returns a pointer to the null-terminated characters of a string. */
+const char *owned_string_c_string(const owned_string_type *string);
+
+/* Returns a pointer to the characters of a string, which may be modified up to the length. */
+char *owned_string_data(owned_string_type *string);
+
+/* Returns a reference to the characters of a string, without copying them. */
+const_stringref_type owned_string_to_const_stringref(const owned_string_type *string);
+
+/* Returns Boolean_true if the characters are stored inside the object, i.e. no memory is allocated. */
+Boolean_type owned_string_is_inline(const owned_string_type *string);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,140 @@
+#include "owned_string.h"
+#include "unit_testing.h"
+#include "unit_testing_allocator.h"
+
+#include <iso646.h>
+#include <stdlib.h>
+#include <string.h>
+
+TEST(owned_string_inline_test, "Short strings are stored without memory allocation")
+{
+	owned_string_type string;
+	const_stringref_type reference;
+
+	owned_string_init(&string, unit_testing_make_allocator());
+	unit_testing_allocations_until_failure = 0U;
+	ASSERT(owned_string_is_inline(&string));
+	ASSERT_SIZE_EQUAL(owned_string_length(&string), 0U);
+	ASSERT_EQUAL(strcmp(owned_string_c_string(&string), ""), 0);
+	ASSERT(owned_string_assign(&string, unit_testing_make_stringref("Hello")));
+	ASSERT(owned_string_append(&string, unit_testing_make_stringref(", ")));
+	ASSERT(owned_string_append(&string, string_to_const_stringref(NULL, 3U)));
+	ASSERT(owned_string_push_back(&string, 'w'));
+	ASSERT_EQUAL(strcmp(owned_string_c_string(&string), "Hello, w"), 0);
+	ASSERT(owned_string_append(&string, unit_testing_make_stringref("orld, 0123456")));
+	ASSERT_SIZE_EQUAL(owned_string_length(&string), OWNED_STRING_INLINE_CAPACITY - 2U);
+	ASSERT(owned_string_append(&string, unit_testing_make_stringref("78")));
+	ASSERT_SIZE_EQUAL(owned_string_length(&string), OWNED_STRING_INLINE_CAPACITY);
+	ASSERT(owned_string_is_inline(&string));
+	ASSERT_EQUAL(strcmp(owned_string_c_string(&string), "Hello, world, 012345678"), 0);
+	reference = owned_string_to_const_stringref(&string);
+	ASSERT(reference.string == owned_string_c_string(&string));
+	ASSERT_SIZE_EQUAL(reference.length, OWNED_STRING_INLINE_CAPACITY);
+	/* one more byte needs a memory block, which the allocator refuses */
+	ASSERT(not owned_string_push_back(&string, '9'));
+	ASSERT(owned_string_is_inline(&string));
+	ASSERT_EQUAL(strcmp(owned_string_c_string(&string), "Hello, world, 012345678"), 0);
+	owned_string_deinit(&string);
+}
+
+TEST(owned_string_heap_test, "Long strings are stored in allocated memory")
+{
+	owned_string_type string;
+	size_t i = 0U;
+
+	owned_string_init(&string, unit_testing_make_allocator());
+	for (i = 0U; i < 1000U; ++i) {
+		ASSERT(owned_string_push_back(&string, (char) ('a' + (char) (i % 26U))));
+	}
+	ASSERT(not owned_string_is_inline(&string));
+	ASSERT_SIZE_EQUAL(owned_string_length(&string), 1000U);
+	ASSERT_SIZE_EQUAL(strlen(owned_string_c_string(&string)), 1000U);
+	ASSERT(owned_string_c_string(&string)[999] == 'l');
+	ASSERT(owned_string_c_string(&string)[26] == 'a');
+
+	owned_string_clear(&string);
+	ASSERT_SIZE_EQUAL(owned_string_length(&string), 0U);
+	ASSERT_EQUAL(strcmp(owned_string_c_string(&string), ""), 0);
+	unit_testing_allocations_until_failure = 0U;
+	ASSERT(owned_string_assign(&string, unit_testing_make_stringref("a string which is longer than the inline buffer")));
+	ASSERT_EQUAL(strcmp(owned_string_c_string(&string), "a string which is longer than the inline buffer"), 0);
+	owned_string_deinit(&string);
+	ASSERT(owned_string_is_inline(&string));
+	ASSERT_SIZE_EQUAL(owned_string_length(&string), 0U);
+}
+
+TEST(owned_string_reserve_test, "Reserving and failing allocations")
+{
+	owned_string_type string;
+
+	owned_string_init(&string, unit_testing_make_allocator());
+	ASSERT(owned_string_reserve(&string, 10U));
+	ASSERT(owned_string_is_inline(&string));
+	ASSERT(owned_string_assign(&string, unit_testing_make_stringref("abc")));
+	unit_testing_allocations_until_failure = 0U;
+	ASSERT(not owned_string_reserve(&string, 100U));
+	ASSERT(not owned_string_append(&string, unit_testing_make_stringref("a string which is longer than the inline buffer")));
+	ASSERT(not owned_string_assign(&string, unit_testing_make_stringref("a string which is longer than the inline buffer")));
+	ASSERT(not owned_string_reserve(&string, (size_t) -1));
+	ASSERT_EQUAL(strcmp(owned_string_c_string(&string), "abc"), 0);
+	unit_testing_allocations_until_failure = 1U;
+	ASSERT(owned_string_reserve(&string, 100U));
+	ASSERT(not owned_string_is_inline(&string));
+	ASSERT_EQUAL(strcmp(owned_string_c_string(&string), "abc"), 0);
+	ASSERT(not owned_string_reserve(&string, 1000U));
+	ASSERT_EQUAL(strcmp(owned_string_c_string(&string), "abc"), 0);
+	owned_string_deinit(&string);
+}
+
+TEST(owned_string_self_append_test, "Appending and assigning a part of the string itself")
+{
+	owned_string_type string;
+	char expected[96];
+
+	owned_string_init(&string, unit_testing_make_allocator());
+	ASSERT(owned_string_assign(&string, unit_testing_make_stringref("0123456789")));
+	ASSERT(owned_string_append(&string, owned_string_to_const_stringref(&string)));
+	ASSERT_EQUAL(strcmp(owned_string_c_string(&string), "01234567890123456789"), 0);
+	/* the source moves to a memory block during the append */
+	ASSERT(owned_string_append(&string, owned_string_to_const_stringref(&string)));
+	strcpy(expected, "0123456789012345678901234567890123456789");
+	ASSERT_EQUAL(strcmp(owned_string_c_string(&string), expected), 0);
+	ASSERT(owned_string_append(&string, owned_string_to_const_stringref(&string)));
+	strcat(expected, "0123456789012345678901234567890123456789");
+	ASSERT_EQUAL(strcmp(owned_string_c_string(&string), expected), 0);
+	ASSERT(owned_string_assign(&string, string_to_const_stringref(owned_string_c_string(&string) + 5U, 3U)));
+	ASSERT_EQUAL(strcmp(owned_string_c_string(&string), "567"), 0);
+	owned_string_deinit(&string);
+}
+
+TEST(owned_string_null_characters_test, "Strings may contain null characters")
+{
+	owned_string_type string;
+	const_stringref_type reference;
+
+	owned_string_init(&string, unit_testing_make_allocator());
+	ASSERT(owned_string_assign(&string, string_to_const_stringref("a\0b", 3U)));
+	ASSERT(owned_string_push_back(&string, '\0'));
+	reference = owned_string_to_const_stringref(&string);
+	ASSERT_SIZE_EQUAL(reference.length, 4U);
+	ASSERT(memcmp(reference.string, "a\0b\0", 5U) == 0);
+	owned_string_data(&string)[1] = '-';
+	ASSERT_EQUAL(strcmp(owned_string_c_string(&string), "a-b"), 0);
+	owned_string_deinit(&string);
+}
+
+int main(void)
+{
+	DEFINE_LIST_OF_TESTS(list_of_tests) {
+		owned_string_inline_test,
+		owned_string_heap_test,
+		owned_string_reserve_test,
+		owned_string_self_append_test,
+		owned_string_null_characters_test
+	};
+
+	PRINT_FILE_NAME();
+	RUN_TESTS(list_of_tests);
+	PRINT_TEST_STATISTICS(list_of_tests);
+	return 0;
+}
@@ -0,0 +1,228 @@
+#include "string_builder.h"
+#include <assert.h>
+#include <iso646.h>
+#include <string.h>
+
+/* Notes:
+- Empty pieces are never stored, so every piece has at least one byte and a position inside the string always
+  falls inside exactly one piece.
+- The array of pieces grows by doubling. Room for all the new pieces is reserved before the builder is modified,
+  so a failed allocation leaves the builder unchanged.
+*/
+
+enum {
+	string_builder_initial_capacity_of_pieces = 16
+};
+
+/* Makes room for the number of additional pieces. */
+static Boolean_type string_builder_reserve(string_builder_type *builder, size_t number_of_additional_pieces)
+{
+	const size_t max_number_of_pieces = ((size_t) -1) / sizeof(const_stringref_type);
+	size_t new_capacity = builder->capacity_of_pieces;
+	const_stringref_type *new_pieces = NULL;
+
+	if (number_of_additional_pieces > max_number_of_pieces - builder->number_of_pieces) {
+		return Boolean_false;
+	}
+	if (builder->number_of_pieces + number_of_additional_pieces <= builder->capacity_of_pieces) {
+		return Boolean_true;
+	}
+	if (new_capacity == 0U) {
+		new_capacity = (size_t) string_builder_initial_capacity_of_pieces;
+	}
+	while (new_capacity < builder->number_of_pieces + number_of_additional_pieces) {
+		new_capacity = (new_capacity <= max_number_of_pieces / 2U) ? 2U * new_capacity : max_number_of_pieces;
+	}
+	new_pieces = (const_stringref_type*) allocator_reallocate(builder->allocator, builder->pieces,
+		builder->capacity_of_pieces * sizeof(const_stringref_type), new_capacity * sizeof(const_stringref_type));
+	if (new_pieces == NULL) {
+		return Boolean_false;
+	}
+	builder->pieces = new_pieces;
+	builder->capacity_of_pieces = new_capacity;
+	return Boolean_true;
+}
+
+static void string_builder_write(const string_builder_type *builder, char *buffer)
+{
+	size_t i = 0U;
+
+	for (; i < builder->number_of_pieces; ++i) {
+		memcpy(buffer, builder->pieces[i].string, builder->pieces[i].length);
+		buffer += builder->pieces[i].length;
+	}
+	*buffer = '\0';
+}
+
+void string_builder_init(string_builder_type *builder, allocator_type allocator)
+{
+	assert(builder != NULL);
+	assert(allocator.allocate != NULL);
+	assert(allocator.deallocate != NULL);
+	builder->allocator = allocator;
+	builder->pieces = NULL;
+	builder->number_of_pieces = 0U;
+	builder->capacity_of_pieces = 0U;
+	builder->length = 0U;
+}
+
+void string_builder_deinit(string_builder_type *builder)
+{
+	assert(builder != NULL);
+	allocator_deallocate(builder->allocator, builder->pieces);
+	builder->pieces = NULL;
+	builder->number_of_pieces = 0U;
+	builder->capacity_of_pieces = 0U;
+	builder->length = 0U;
+}
+
+void string_builder_clear(string_builder_type *builder)
+{
+	assert(builder != NULL);
+	builder->number_of_pieces = 0U;
+	builder->length = 0U;
+}
+
+Boolean_type string_builder_append(string_builder_type *builder, const_stringref_type string)
+{
+	const_stringref_type *last_piece = NULL;
+
+	assert(builder != NULL);
+	if (string.string == NULL or string.length == 0U) {
+		return Boolean_true;
+	}
+	if (string.length > ((size_t) -1) - builder->length) {
+		return Boolean_false;
+	}
+	if (builder->number_of_pieces > 0U) {
+		last_piece = &builder->pieces[builder->number_of_pieces - 1U];
+		if (last_piece->string + last_piece->length == string.string) {
+			last_piece->length += string.length;
+			builder->length += string.length;
+			return Boolean_true;
+		}
+	}
+	if (not string_builder_reserve(builder, 1U)) {
+		return Boolean_false;
+	}
+	builder->pieces[builder->number_of_pieces] = string;
+	++builder->number_of_pieces;
+	builder->length += string.length;
+	return Boolean_true;
+}
+
+Boolean_type string_builder_insert(string_builder_type *builder, size_t position, const_stringref_type string)
+{
+	size_t index = 0U;
+	size_t offset = position;
+
+	assert(builder != NULL);
+	if (position > builder->length) {
+		return Boolean_false;
+	}
+	if (position == builder->length) {
+		return string_builder_append(builder, string);
+	}
+	if (string.string == NULL or string.length == 0U) {
+		return Boolean_true;
+	}
+	if (string.length > ((size_t) -1) - builder->length) {
+		return Boolean_false;
+	}
+
+	while (offset >= builder->pieces[index].length) {
+		offset -= builder->pieces[index].length;
+		++index;
+	}
+	if (offset == 0U) {
+		/* insert between two pieces */
+		if (not string_builder_reserve(builder, 1U)) {
+			return Boolean_false;
+		}
+		memmove(&builder->pieces[index + 1U], &builder->pieces[index],
+			(builder->number_of_pieces - index) * sizeof(const_stringref_type));
+		builder->pieces[index] = string;
+		builder->number_of_pieces += 1U;
+	} else {
+		/* split the piece into a left part, the new string and a right part */
+		if (not string_builder_reserve(builder, 2U)) {
+			return Boolean_false;
+		}
+		memmove(&builder->pieces[index + 2U], &builder->pieces[index],
+			(builder->number_of_pieces - index) * sizeof(const_stringref_type));
+		builder->pieces[index].length = offset;
+		builder->pieces[index + 1U] = string;
+		builder->pieces[index + 2U].string += offset;
+		builder->pieces[index + 2U].length -= offset;
+		builder->number_of_pieces += 2U;
+	}
+	builder->length += string.length;
+	return Boolean_true;
+}
+
+Boolean_type string_builder_append_builder(string_builder_type *builder, const string_builder_type *other)
+{
+	size_t number_of_other_pieces = 0U;
+
+	assert(builder != NULL);
+	assert(other != NULL);
+	if (other->length > ((size_t) -1) - builder->length) {
+		return Boolean_false;
+	}
+	/* the number of pieces is read first, so a builder can be appended to itself */
+	number_of_other_pieces = other->number_of_pieces;
+	if (not string_builder_reserve(builder, number_of_other_pieces)) {
+		return Boolean_false;
+	}
+	if (number_of_other_pieces > 0U) {
+		memmove(&builder->pieces[builder->number_of_pieces], other->pieces,
+			number_of_other_pieces * sizeof(const_stringref_type));
+	}
+	builder->number_of_pieces += number_of_other_pieces;
+	builder->length += other->length;
+	return Boolean_true;
+}
+
+size_t string_builder_length(const string_builder_type *builder)
+{
+	assert(builder != NULL);
+	return builder->length;
+}
+
+size_t string_builder_number_of_pieces(const string_builder_type *builder)
+{
+	assert(builder != NULL);
+	return builder->number_of_pieces;
+}
+
+size_t string_builder_flatten_to_buffer(const string_builder_type *builder, char *buffer, size_t buffer_size)
+{
+	assert(builder != NULL);
+	assert(buffer != NULL or buffer_size == 0U);
+	if (buffer == NULL or buffer_size <= builder->length) {
+		return (size_t) -1;
+	}
+	string_builder_write(builder, buffer);
+	return builder->length;
+}
+
+stringref_type string_builder_flatten(const string_builder_type *builder, allocator_type allocator)
+{
+	stringref_type string;
+
+	assert(builder != NULL);
+	assert(allocator.allocate != NULL);
+	assert(allocator.deallocate != NULL);
+	string.string = NULL;
+	string.length = 0U;
+	if (builder->length == (size_t) -1) {
+		return string;
+	}
+	/* not zeroed by allocator_allocate: string_builder_write copies every piece and then the null terminator into it */
+	string.string = (char*) allocator.allocate(builder->length + 1U);
+	if (string.string != NULL) {
+		string_builder_write(builder, string.string);
+		string.length = builder->length;
+	}
+	return string;
+}
@@ -0,0 +1,102 @@
+/* Minimum C Standard: C89 */
+
+#ifndef STRING_BUILDER_H
+#define STRING_BUILDER_H
+
+#include "allocator_type.h"
+#include "Boolean_type.h"
+#include "string_reference.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+A string builder is a piece table: it records the string as a sequence of string references (pieces) to strings
+owned by the caller, and copies the bytes only when the string is flattened.
+
+- Appending a piece takes amortized O(1) time. A piece which continues the last piece in memory extends it.
+- Inserting a piece in the middle splits the piece at the position into two references and moves the references
+  after it, not the bytes. Finding the piece at the position takes O(p) time, where p is the number of pieces.
+- Flattening computes the exact length in advance and copies each byte once.
+
+The builder does not copy the strings, so every string added to a builder must outlive it or the next flatten.
+Empty strings and string references with a null pointer add nothing.
+
+Example:
+	string_builder_type builder;
+	stringref_type result;
+	string_builder_init(&builder, allocator);
+	string_builder_append(&builder, name);
+	string_builder_append(&builder, string_to_const_stringref(" = ", 3U));
+	string_builder_append(&builder, value);
+	string_builder_insert(&builder, 0U, string_to_const_stringref("const ", 6U));
+	result = string_builder_flatten(&builder, allocator);
+	string_builder_deinit(&builder);
+*/
+
+typedef struct string_builder_type
+{
+	allocator_type allocator;
+	const_stringref_type *pieces;
+	size_t number_of_pieces;
+	size_t capacity_of_pieces;
+	size_t length; /* the sum of the lengths of the pieces */
+} string_builder_type;
+
+/*
+Initializes an empty builder. No memory is allocated until the first piece is added.
+
+Parameters:
+builder  : A pointer to a string builder. Must not be null.
+allocator: The allocator used for the array of pieces. Its 'allocate' and 'deallocate' function pointers must not be null.
+*/
+void string_builder_init(string_builder_type *builder, allocator_type allocator);
+
+/* Deallocates the array of pieces. The strings referenced by the pieces are not affected. */
+void string_builder_deinit(string_builder_type *builder);
+
+/* Removes all the pieces and keeps the memory of the array of pieces. */
+void string_builder_clear(string_builder_type *builder);
+
+/* Appends a string. Return value: Boolean_false if there is not enough memory, in which case the builder is unchanged. */
+Boolean_type string_builder_append(string_builder_type *builder, const_stringref_type string);
+
+/*
+Inserts a string before the byte at the position. A position equal to the length appends the string.
+Return value: Boolean_false if the position is greater than the length or if there is not enough memory,
+in which case the builder is unchanged.
+*/
+Boolean_type string_builder_insert(string_builder_type *builder, size_t position, const_stringref_type string);
+
+/*
+Appends the pieces of another builder, which is not modified. The bytes are not copied.
+Return value: Boolean_false if there is not enough memory, in which case the builder is unchanged.
+*/
+Boolean_type string_builder_append_builder(string_builder_type *builder, const string_builder_type *other);
+
+/* Returns the length of the string of a builder. */
+size_t string_builder_length(const string_builder_type *builder);
+
+/* Returns the number of pieces of a builder. */
+size_t string_builder_number_of_pieces(const string_builder_type *builder);
+
+/*
+Copies the string of a builder into a buffer, followed by a null terminator. If the buffer is too small, nothing is written.
+Return value: The length of the string, or (size_t) -1 if buffer_size is not greater than the length.
+*/
+size_t string_builder_flatten_to_buffer(const string_builder_type *builder, char *buffer, size_t buffer_size);
+
+/*
+Copies the string of a builder into a new memory block of the exact size, followed by a null terminator.
+The memory block is allocated by the allocator and must be deallocated by its 'deallocate' function.
+Return value: The string, or a string reference with a null pointer if there is not enough memory.
+*/
+stringref_type string_builder_flatten(const string_builder_type *builder, allocator_type allocator);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,177 @@
+#include "string_builder.h"
+#include "unit_testing.h"
+#include "unit_testing_allocator.h"
+
+#include <iso646.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Flattens the builder into a static buffer. */
+static const char *flatten(const string_builder_type *builder)
+{
+	static char buffer[256];
+	if (string_builder_flatten_to_buffer(builder, buffer, sizeof(buffer)) == (size_t) -1) {
+		return "(too long)";
+	}
+	return buffer;
+}
+
+TEST(string_builder_append_test, "Appending strings")
+{
+	string_builder_type builder;
+
+	string_builder_init(&builder, unit_testing_make_allocator());
+	ASSERT_EQUAL(strcmp(flatten(&builder), ""), 0);
+	ASSERT(string_builder_append(&builder, unit_testing_make_stringref("Hello")));
+	ASSERT(string_builder_append(&builder, unit_testing_make_stringref("")));
+	ASSERT(string_builder_append(&builder, string_to_const_stringref(NULL, 3U)));
+	ASSERT(string_builder_append(&builder, unit_testing_make_stringref(", ")));
+	ASSERT(string_builder_append(&builder, unit_testing_make_stringref("world")));
+	ASSERT_SIZE_EQUAL(string_builder_length(&builder), 12U);
+	ASSERT_SIZE_EQUAL(string_builder_number_of_pieces(&builder), 3U);
+	ASSERT_EQUAL(strcmp(flatten(&builder), "Hello, world"), 0);
+	string_builder_clear(&builder);
+	ASSERT_SIZE_EQUAL(string_builder_length(&builder), 0U);
+	ASSERT_EQUAL(strcmp(flatten(&builder), ""), 0);
+	string_builder_deinit(&builder);
+}
+
+TEST(string_builder_contiguous_pieces, "Appending a string which continues the last piece extends the piece")
+{
+	const char *text = "one two three";
+	string_builder_type builder;
+
+	string_builder_init(&builder, unit_testing_make_allocator());
+	ASSERT(string_builder_append(&builder, string_to_const_stringref(text, 3U)));
+	ASSERT(string_builder_append(&builder, string_to_const_stringref(text + 3, 4U)));
+	ASSERT(string_builder_append(&builder, string_to_const_stringref(text + 7, 6U)));
+	ASSERT_SIZE_EQUAL(string_builder_number_of_pieces(&builder), 1U);
+	ASSERT_EQUAL(strcmp(flatten(&builder), text), 0);
+	string_builder_deinit(&builder);
+}
+
+TEST(string_builder_insert_test, "Inserting strings at the start, in the middle and at the end")
+{
+	string_builder_type builder;
+
+	string_builder_init(&builder, unit_testing_make_allocator());
+	ASSERT(string_builder_insert(&builder, 0U, unit_testing_make_stringref("ace")));
+	ASSERT(string_builder_insert(&builder, 1U, unit_testing_make_stringref("b")));
+	ASSERT_EQUAL(strcmp(flatten(&builder), "abce"), 0);
+	ASSERT_SIZE_EQUAL(string_builder_number_of_pieces(&builder), 3U);
+	ASSERT(string_builder_insert(&builder, 3U, unit_testing_make_stringref("d")));
+	ASSERT(string_builder_insert(&builder, 5U, unit_testing_make_stringref("f")));
+	ASSERT(string_builder_insert(&builder, 0U, unit_testing_make_stringref(">")));
+	ASSERT(string_builder_insert(&builder, 2U, unit_testing_make_stringref("")));
+	ASSERT_EQUAL(strcmp(flatten(&builder), ">abcdef"), 0);
+	ASSERT_SIZE_EQUAL(string_builder_length(&builder), 7U);
+	ASSERT(not string_builder_insert(&builder, 8U, unit_testing_make_stringref("x")));
+	ASSERT_EQUAL(strcmp(flatten(&builder), ">abcdef"), 0);
+	string_builder_deinit(&builder);
+}
+
+TEST(string_builder_many_insertions, "Many insertions give the same string as inserting into an array")
+{
+	static const char letters[] = "abcdefghijklmnopqrstuvwxyz";
+	char expected[256];
+	size_t expected_length = 0U;
+	string_builder_type builder;
+	size_t i = 0U;
+
+	string_builder_init(&builder, unit_testing_make_allocator());
+	for (i = 0U; i < 200U; ++i) {
+		const size_t position = (i * 7919U) % (expected_length + 1U);
+		const size_t length = i % 3U + 1U;
+		memmove(expected + position + length, expected + position, expected_length - position);
+		memcpy(expected + position, letters + i % 20U, length);
+		expected_length += length;
+		ASSERT(string_builder_insert(&builder, position, string_to_const_stringref(letters + i % 20U, length)));
+		if (expected_length > 200U) {
+			break;
+		}
+	}
+	expected[expected_length] = '\0';
+	ASSERT_SIZE_EQUAL(string_builder_length(&builder), expected_length);
+	ASSERT_EQUAL(strcmp(flatten(&builder), expected), 0);
+	string_builder_deinit(&builder);
+}
+
+TEST(string_builder_concatenation, "Appending a builder to another builder or to itself")
+{
+	string_builder_type first;
+	string_builder_type second;
+
+	string_builder_init(&first, unit_testing_make_allocator());
+	string_builder_init(&second, unit_testing_make_allocator());
+	ASSERT(string_builder_append(&first, unit_testing_make_stringref("ab")));
+	ASSERT(string_builder_append(&second, unit_testing_make_stringref("cd")));
+	ASSERT(string_builder_append(&second, unit_testing_make_stringref("ef")));
+	ASSERT(string_builder_append_builder(&first, &second));
+	ASSERT_EQUAL(strcmp(flatten(&first), "abcdef"), 0);
+	ASSERT_EQUAL(strcmp(flatten(&second), "cdef"), 0);
+	ASSERT(string_builder_append_builder(&first, &first));
+	ASSERT_EQUAL(strcmp(flatten(&first), "abcdefabcdef"), 0);
+	ASSERT_SIZE_EQUAL(string_builder_length(&first), 12U);
+	string_builder_deinit(&second);
+	string_builder_deinit(&first);
+}
+
+TEST(string_builder_flatten_test, "Flattening into a buffer and into a new memory block")
+{
+	string_builder_type builder;
+	stringref_type string;
+	char buffer[6];
+
+	string_builder_init(&builder, unit_testing_make_allocator());
+	ASSERT(string_builder_append(&builder, unit_testing_make_stringref("12345")));
+	strcpy(buffer, "xxxxx");
+	ASSERT_SIZE_EQUAL(string_builder_flatten_to_buffer(&builder, buffer, 5U), (size_t) -1);
+	ASSERT_EQUAL(strcmp(buffer, "xxxxx"), 0);
+	ASSERT_SIZE_EQUAL(string_builder_flatten_to_buffer(&builder, buffer, 6U), 5U);
+	ASSERT_EQUAL(strcmp(buffer, "12345"), 0);
+
+	string = string_builder_flatten(&builder, unit_testing_make_allocator());
+	ASSERT(string.string != NULL);
+	ASSERT_SIZE_EQUAL(string.length, 5U);
+	ASSERT_EQUAL(strcmp(string.string, "12345"), 0);
+	free(string.string);
+	string_builder_deinit(&builder);
+}
+
+TEST(string_builder_allocation_failure, "A failed allocation leaves the builder unchanged")
+{
+	string_builder_type builder;
+	size_t i = 0U;
+
+	string_builder_init(&builder, unit_testing_make_allocator());
+	unit_testing_allocations_until_failure = 0U;
+	ASSERT(not string_builder_append(&builder, unit_testing_make_stringref("a")));
+	ASSERT_SIZE_EQUAL(string_builder_length(&builder), 0U);
+	unit_testing_allocations_until_failure = 1U;
+	for (i = 0U; i < 16U; ++i) {
+		ASSERT(string_builder_append(&builder, unit_testing_make_stringref("a")));
+	}
+	ASSERT(not string_builder_insert(&builder, 1U, unit_testing_make_stringref("b")));
+	ASSERT_SIZE_EQUAL(string_builder_length(&builder), 16U);
+	ASSERT_SIZE_EQUAL(string_builder_number_of_pieces(&builder), 16U);
+	ASSERT_EQUAL(strcmp(flatten(&builder), "aaaaaaaaaaaaaaaa"), 0);
+	string_builder_deinit(&builder);
+}
+
+int main(void)
+{
+	DEFINE_LIST_OF_TESTS(list_of_tests) {
+		string_builder_append_test,
+		string_builder_contiguous_pieces,
+		string_builder_insert_test,
+		string_builder_many_insertions,
+		string_builder_concatenation,
+		string_builder_flatten_test,
+		string_builder_allocation_failure
+	};
+
+	PRINT_FILE_NAME();
+	RUN_TESTS(list_of_tests);
+	PRINT_TEST_STATISTICS(list_of_tests);
+	return 0;
+}
@@ -0,0 +1,235 @@
+#include "string_case.h"
+#include "string_hash.h"
+#include <assert.h>
+#include <iso646.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define STRING_CASE_USE_AVX2 1
+#define STRING_CASE_BLOCK_SIZE 32U
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define STRING_CASE_USE_SSE2 1
+#define STRING_CASE_BLOCK_SIZE 16U
+#else
+#define STRING_CASE_BLOCK_SIZE 8U
+#endif
+
+/* Notes:
+- A block is folded by adding 0x20 to the bytes from 'A' to 'Z'. The SIMD versions compare the bytes as signed
+  8-bit integers, so the bytes from 0x80 to 0xFF are negative and never in the range.
+- The portable version, which also folds the tails of the SIMD versions, works on the 8 bytes of a 64-bit integer at
+  once. Clearing the top bit of each byte makes room for adding a constant to every byte without a carry into the
+  next byte. The top bit of the sum tells whether the byte is at least 'A', and the top bit of a second sum whether
+  it is greater than 'Z'. Each byte is processed separately, so the byte order of the platform does not matter.
+- Comparisons look for the first block with a difference and find the byte within the block one by one.
+- Hashing folds the string into a buffer on the stack piece by piece and hashes the pieces with the streaming
+  functions of string_hash, which give the same result as hashing the whole folded string.
+*/
+
+#define STRING_CASE_UINT64(high, low) ((((uint64_t) (high)) << 32U) | (uint64_t) (low))
+
+enum {
+	string_case_hash_buffer_size = 256
+};
+
+static unsigned char string_case_fold_byte(unsigned char byte)
+{
+	return (unsigned char) (((unsigned int) byte - 'A' < 26U) ? byte + ('a' - 'A') : byte);
+}
+
+static const_stringref_type string_case_normalize(const_stringref_type string)
+{
+	if (string.string == NULL) {
+		string.length = 0U;
+	}
+	return string;
+}
+
+static uint64_t string_case_fold_word(uint64_t word)
+{
+	const uint64_t low_bits = STRING_CASE_UINT64(0x7F7F7F7FU, 0x7F7F7F7FU);
+	const uint64_t high_bits = STRING_CASE_UINT64(0x80808080U, 0x80808080U);
+	const uint64_t ones = STRING_CASE_UINT64(0x01010101U, 0x01010101U);
+	const uint64_t low = word & low_bits;
+	const uint64_t is_at_least_a = low + ones * (uint64_t) (0x80U - 'A');
+	const uint64_t is_greater_than_z = low + ones * (uint64_t) (0x80U - 'Z' - 1U);
+	const uint64_t is_upper = is_at_least_a & ~is_greater_than_z & ~word & high_bits;
+	return word | (is_upper >> 2U);
+}
+
+static void string_case_fold_word_block(unsigned char *destination, const unsigned char *source)
+{
+	uint64_t word = 0U;
+	memcpy(&word, source, sizeof(word));
+	word = string_case_fold_word(word);
+	memcpy(destination, &word, sizeof(word));
+}
+
+static Boolean_type string_case_word_blocks_are_equal(const unsigned char *block1, const unsigned char *block2)
+{
+	uint64_t word1 = 0U;
+	uint64_t word2 = 0U;
+	memcpy(&word1, block1, sizeof(word1));
+	memcpy(&word2, block2, sizeof(word2));
+	return (string_case_fold_word(word1) == string_case_fold_word(word2)) ? Boolean_true : Boolean_false;
+}
+
+#if defined(STRING_CASE_USE_AVX2)
+
+static __m256i string_case_fold_vector(__m256i bytes)
+{
+	const __m256i is_at_least_a = _mm256_cmpgt_epi8(bytes, _mm256_set1_epi8('A' - 1));
+	const __m256i is_at_most_z = _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), bytes);
+	const __m256i is_upper = _mm256_and_si256(is_at_least_a, is_at_most_z);
+	return _mm256_add_epi8(bytes, _mm256_and_si256(is_upper, _mm256_set1_epi8('a' - 'A')));
+}
+
+static void string_case_fold_block(unsigned char *destination, const unsigned char *source)
+{
+	const __m256i bytes = _mm256_loadu_si256((const __m256i*) (const void*) source);
+	_mm256_storeu_si256((__m256i*) (void*) destination, string_case_fold_vector(bytes));
+}
+
+static Boolean_type string_case_blocks_are_equal(const unsigned char *block1, const unsigned char *block2)
+{
+	const __m256i bytes1 = string_case_fold_vector(_mm256_loadu_si256((const __m256i*) (const void*) block1));
+	const __m256i bytes2 = string_case_fold_vector(_mm256_loadu_si256((const __m256i*) (const void*) block2));
+	return (_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes1, bytes2)) == -1) ? Boolean_true : Boolean_false;
+}
+
+#elif defined(STRING_CASE_USE_SSE2)
+
+static __m128i string_case_fold_vector(__m128i bytes)
+{
+	const __m128i is_at_least_a = _mm_cmpgt_epi8(bytes, _mm_set1_epi8('A' - 1));
+	const __m128i is_at_most_z = _mm_cmplt_epi8(bytes, _mm_set1_epi8('Z' + 1));
+	const __m128i is_upper = _mm_and_si128(is_at_least_a, is_at_most_z);
+	return _mm_add_epi8(bytes, _mm_and_si128(is_upper, _mm_set1_epi8('a' - 'A')));
+}
+
+static void string_case_fold_block(unsigned char *destination, const unsigned char *source)
+{
+	const __m128i bytes = _mm_loadu_si128((const __m128i*) (const void*) source);
+	_mm_storeu_si128((__m128i*) (void*) destination, string_case_fold_vector(bytes));
+}
+
+static Boolean_type string_case_blocks_are_equal(const unsigned char *block1, const unsigned char *block2)
+{
+	const __m128i bytes1 = string_case_fold_vector(_mm_loadu_si128((const __m128i*) (const void*) block1));
+	const __m128i bytes2 = string_case_fold_vector(_mm_loadu_si128((const __m128i*) (const void*) block2));
+	return (_mm_movemask_epi8(_mm_cmpeq_epi8(bytes1, bytes2)) == 0xFFFF) ? Boolean_true : Boolean_false;
+}
+
+#else
+
+#define string_case_fold_block string_case_fold_word_block
+#define string_case_blocks_are_equal string_case_word_blocks_are_equal
+
+#endif
+
+/* Returns the index of the first byte which differs after folding, or the length if there is none. */
+static size_t string_case_find_mismatch(const unsigned char *string1, const unsigned char *string2, size_t length)
+{
+	size_t index = 0U;
+
+	while (length - index >= STRING_CASE_BLOCK_SIZE and
+		string_case_blocks_are_equal(string1 + index, string2 + index)) {
+		index += STRING_CASE_BLOCK_SIZE;
+	}
+	while (length - index >= 8U and string_case_word_blocks_are_equal(string1 + index, string2 + index)) {
+		index += 8U;
+	}
+	for (; index < length; ++index) {
+		if (string_case_fold_byte(string1[index]) != string_case_fold_byte(string2[index])) {
+			break;
+		}
+	}
+	return index;
+}
+
+/* Folds a string of any length from source to destination. The pointers may be equal. */
+static void string_case_fold_bytes(unsigned char *destination, const unsigned char *source, size_t length)
+{
+	size_t index = 0U;
+
+	for (; length - index >= STRING_CASE_BLOCK_SIZE; index += STRING_CASE_BLOCK_SIZE) {
+		string_case_fold_block(destination + index, source + index);
+	}
+	for (; length - index >= 8U; index += 8U) {
+		string_case_fold_word_block(destination + index, source + index);
+	}
+	for (; index < length; ++index) {
+		destination[index] = string_case_fold_byte(source[index]);
+	}
+}
+
+void string_case_fold_ascii(stringref_type string)
+{
+	if (string.string != NULL) {
+		string_case_fold_bytes((unsigned char*) string.string, (const unsigned char*) string.string, string.length);
+	}
+}
+
+Boolean_type string_case_equal_ascii(const_stringref_type string1, const_stringref_type string2)
+{
+	string1 = string_case_normalize(string1);
+	string2 = string_case_normalize(string2);
+	if (string1.length != string2.length) {
+		return Boolean_false;
+	}
+	if (string1.string == string2.string or string1.length == 0U) {
+		return Boolean_true;
+	}
+	return (string_case_find_mismatch((const unsigned char*) string1.string, (const unsigned char*) string2.string,
+		string1.length) == string1.length) ? Boolean_true : Boolean_false;
+}
+
+int string_case_compare_ascii(const_stringref_type string1, const_stringref_type string2)
+{
+	size_t length = 0U;
+	size_t index = 0U;
+
+	string1 = string_case_normalize(string1);
+	string2 = string_case_normalize(string2);
+	length = (string1.length < string2.length) ? string1.length : string2.length;
+	if (length > 0U) {
+		index = string_case_find_mismatch((const unsigned char*) string1.string, (const unsigned char*) string2.string, length);
+		if (index < length) {
+			return (int) string_case_fold_byte((unsigned char) string1.string[index]) -
+				(int) string_case_fold_byte((unsigned char) string2.string[index]);
+		}
+	}
+	if (string1.length == string2.length) {
+		return 0;
+	}
+	return (string1.length < string2.length) ? -1 : 1;
+}
+
+uint64_t string_case_hash_ascii(const_stringref_type string, uint64_t seed)
+{
+	unsigned char buffer[string_case_hash_buffer_size];
+	const unsigned char *p = (const unsigned char*) string.string;
+	size_t length = 0U;
+	string_hash_state_type state;
+
+	string = string_case_normalize(string);
+	length = string.length;
+	if (length <= sizeof(buffer)) {
+		if (length > 0U) {
+			string_case_fold_bytes(buffer, p, length);
+		}
+		return string_hash_bytes(buffer, length, seed);
+	}
+
+	string_hash_init(&state, seed);
+	while (length > 0U) {
+		const size_t number_of_bytes = (length < sizeof(buffer)) ? length : sizeof(buffer);
+		string_case_fold_bytes(buffer, p, number_of_bytes);
+		string_hash_update(&state, buffer, number_of_bytes);
+		p += number_of_bytes;
+		length -= number_of_bytes;
+	}
+	return string_hash_final(&state);
+}
@@ -0,0 +1,52 @@
+/* Minimum C Standard: C89 (requires a 64-bit unsigned integer type) */
+
+#ifndef STRING_CASE_H
+#define STRING_CASE_H
+
+#include "Boolean_type.h"
+#include "fixed_width_integer_types.h"
+#include "string_reference.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ASCII case-insensitive operations for string references.
+
+Only the letters 'A' to 'Z' and 'a' to 'z' are affected. All other bytes, including bytes from 0x80 to 0xFF,
+are compared as they are, so the results do not depend on the locale, unlike tolower and toupper of ctype.h.
+The functions process 32 bytes at a time with AVX2, 16 bytes at a time with SSE2 if the compiler targets them,
+and 8 bytes at a time with 64-bit integer operations otherwise.
+
+The contents of the string references are used, i.e. all the bytes up to the length of each reference,
+including any '\0'. A string reference with a null pointer is treated as an empty string.
+*/
+
+/* Converts the letters 'A' to 'Z' of a string to lowercase in place. */
+void string_case_fold_ascii(stringref_type string);
+
+/* Returns Boolean_true if two strings are equal when their letters are converted to lowercase. */
+Boolean_type string_case_equal_ascii(const_stringref_type string1, const_stringref_type string2);
+
+/*
+Compares two strings as if their letters were converted to lowercase. A string which is a prefix of another string
+is ordered first. The bytes are compared as unsigned char.
+
+Return value: A negative value if string1 is ordered first, zero if the strings are equal, or a positive value
+if string2 is ordered first.
+*/
+int string_case_compare_ascii(const_stringref_type string1, const_stringref_type string2);
+
+/*
+Returns the hash of a string with its letters converted to lowercase, i.e. the same value as string_hash
+of the folded string. Strings which are equal according to string_case_equal_ascii have the same hash.
+*/
+uint64_t string_case_hash_ascii(const_stringref_type string, uint64_t seed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,138 @@
+#include "string_case.h"
+#include "string_hash.h"
+#include "unit_testing.h"
+
+#include <ctype.h>
+#include <iso646.h>
+#include <string.h>
+
+static const_stringref_type make_stringref(const char *string)
+{
+	return string_to_const_stringref(string, strlen(string));
+}
+
+static int sign(int value)
+{
+	return (value > 0) - (value < 0);
+}
+
+/* Reference implementation which folds one byte at a time. */
+static int reference_compare(const char *string1, size_t length1, const char *string2, size_t length2)
+{
+	size_t i = 0U;
+	for (; i < length1 and i < length2; ++i) {
+		const unsigned char byte1 = (unsigned char) string1[i];
+		const unsigned char byte2 = (unsigned char) string2[i];
+		const int folded1 = (byte1 >= 'A' and byte1 <= 'Z') ? byte1 + 32 : byte1;
+		const int folded2 = (byte2 >= 'A' and byte2 <= 'Z') ? byte2 + 32 : byte2;
+		if (folded1 != folded2) {
+			return sign(folded1 - folded2);
+		}
+	}
+	return (length1 == length2) ? 0 : ((length1 < length2) ? -1 : 1);
+}
+
+TEST(string_case_fold_all_bytes, "string_case_fold_ascii only changes the letters A to Z")
+{
+	char bytes[256 + 37];
+	size_t i = 0U;
+
+	for (i = 0U; i < sizeof(bytes); ++i) {
+		bytes[i] = (char) (unsigned char) (i & 0xFFU);
+	}
+	string_case_fold_ascii(string_to_stringref(bytes, sizeof(bytes)));
+	for (i = 0U; i < sizeof(bytes); ++i) {
+		const unsigned char original = (unsigned char) (i & 0xFFU);
+		const unsigned char expected = (original >= 'A' and original <= 'Z') ? (unsigned char) (original + 32U) : original;
+		ASSERT_EQUAL((unsigned char) bytes[i], expected);
+	}
+	string_case_fold_ascii(string_to_stringref(NULL, 10U));
+}
+
+TEST(string_case_equal_test, "string_case_equal_ascii ignores the case of letters only")
+{
+	ASSERT(string_case_equal_ascii(make_stringref("Identifier"), make_stringref("iDENTIFIER")));
+	ASSERT(string_case_equal_ascii(make_stringref("A long identifier with MANY letters and 0123456789"),
+		make_stringref("a LONG IDENTIFIER WITH many LETTERS AND 0123456789")));
+	ASSERT(not string_case_equal_ascii(make_stringref("A long identifier with MANY letters and 0123456789"),
+		make_stringref("a LONG IDENTIFIER WITH many LETTERS AND 0123456788")));
+	ASSERT(not string_case_equal_ascii(make_stringref("abc"), make_stringref("abcd")));
+	ASSERT(not string_case_equal_ascii(make_stringref("@"), make_stringref("`")));
+	ASSERT(not string_case_equal_ascii(make_stringref("["), make_stringref("{")));
+	ASSERT(not string_case_equal_ascii(make_stringref("\xC4"), make_stringref("\xE4")));
+	ASSERT(string_case_equal_ascii(make_stringref(""), string_to_const_stringref(NULL, 5U)));
+}
+
+TEST(string_case_compare_test, "string_case_compare_ascii orders like comparing folded bytes")
+{
+	static const char *const strings[] = {
+		"", "a", "A", "b", "Z", "[", "_", "abc", "ABD", "abcdefghijklmnopqrstuvwxyz0123456789",
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789", "ABCDEFGHIJKLMNOPQRSTUVWXYZ012345678", "\xFF", "\x80" "abc"
+	};
+	const size_t number_of_strings = sizeof(strings) / sizeof(strings[0]);
+	size_t i = 0U;
+	size_t j = 0U;
+
+	for (i = 0U; i < number_of_strings; ++i) {
+		for (j = 0U; j < number_of_strings; ++j) {
+			const size_t length1 = strlen(strings[i]);
+			const size_t length2 = strlen(strings[j]);
+			ASSERT_EQUAL(sign(string_case_compare_ascii(make_stringref(strings[i]), make_stringref(strings[j]))),
+				reference_compare(strings[i], length1, strings[j], length2));
+		}
+	}
+}
+
+TEST(string_case_compare_long_strings, "Differences at every position of long strings are found")
+{
+	char string1[100];
+	char string2[100];
+	size_t length = 0U;
+	size_t position = 0U;
+
+	for (length = 1U; length <= sizeof(string1); ++length) {
+		for (position = 0U; position < length; ++position) {
+			memset(string1, 'q', length);
+			memset(string2, 'Q', length);
+			string2[position] = 'R';
+			ASSERT(string_case_compare_ascii(string_to_const_stringref(string1, length), string_to_const_stringref(string2, length)) < 0);
+			ASSERT(not string_case_equal_ascii(string_to_const_stringref(string1, length), string_to_const_stringref(string2, length)));
+			string2[position] = 'q';
+			ASSERT_EQUAL(string_case_compare_ascii(string_to_const_stringref(string1, length), string_to_const_stringref(string2, length)), 0);
+		}
+	}
+}
+
+TEST(string_case_hash_test, "string_case_hash_ascii is the hash of the folded string")
+{
+	char upper[1000];
+	char lower[1000];
+	size_t length = 0U;
+
+	for (length = 0U; length < sizeof(upper); ++length) {
+		upper[length] = (char) ('A' + length % 26U);
+		lower[length] = (char) tolower(upper[length]);
+	}
+	for (length = 0U; length <= sizeof(upper); length += (length < 300U) ? 1U : 49U) {
+		const uint64_t hash = string_case_hash_ascii(string_to_const_stringref(upper, length), 7U);
+		ASSERT(hash == string_hash(string_to_const_stringref(lower, length), 7U));
+		ASSERT(hash == string_case_hash_ascii(string_to_const_stringref(lower, length), 7U));
+	}
+	ASSERT(string_case_hash_ascii(make_stringref("Hash"), 0U) != string_case_hash_ascii(make_stringref("Hash!"), 0U));
+}
+
+int main(void)
+{
+	DEFINE_LIST_OF_TESTS(list_of_tests) {
+		string_case_fold_all_bytes,
+		string_case_equal_test,
+		string_case_compare_test,
+		string_case_compare_long_strings,
+		string_case_hash_test
+	};
+
+	PRINT_FILE_NAME();
+	RUN_TESTS(list_of_tests);
+	PRINT_TEST_STATISTICS(list_of_tests);
+	return 0;
+}
@@ -0,0 +1,360 @@
+#include "string_hash.h"
+#include <assert.h>
+#include <iso646.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define STRING_HASH_USE_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define STRING_HASH_USE_SSE2 1
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__SIZEOF_INT128__)
+#include <intrin.h>
+#endif
+
+/* Notes:
+- The short input path follows wyhash (final version 4) by Wang Yi, with its default secret.
+- The long input path follows the accumulation of XXH3 by Yann Collet, with a different secret and merge step.
+- Bytes are read in little-endian order on every platform. Compilers turn the byte loads into a single load.
+- A long input is split into stripes of 64 bytes and a tail of 1 to 64 bytes. Every stripe before the tail is
+  accumulated with the key words starting at its index within the block. The last 64 bytes of the input,
+  which may overlap the last stripe, are accumulated with other key words before the merge step.
+- The streaming state buffers up to two stripes. A stripe is only accumulated once a byte after it has been
+  appended, and the stripe before the buffered bytes is kept, so the last 64 bytes are always available.
+*/
+
+#define STRING_HASH_UINT64(high, low) ((((uint64_t) (high)) << 32U) | (uint64_t) (low))
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 string_hash_uint128_type;
+#endif
+
+enum {
+	string_hash_stripes_per_block = 16,
+	string_hash_number_of_secret_words = 24,
+	string_hash_scramble_secret_offset = 16,
+	string_hash_last_stripe_secret_offset = 9,
+	string_hash_merge_secret_offset = 7
+};
+
+static const uint64_t string_hash_wyhash_secret[4] = {
+	STRING_HASH_UINT64(0x2D358DCCU, 0xAA6C78A5U), STRING_HASH_UINT64(0x8BB84B93U, 0x962EACC9U),
+	STRING_HASH_UINT64(0x4B33A62EU, 0xD433D4A3U), STRING_HASH_UINT64(0x4D5A2D26U, 0xC5C5F5B2U)
+};
+
+/* the first 24 outputs of splitmix64 with the state 0 */
+static const uint64_t string_hash_default_secret[string_hash_number_of_secret_words] = {
+	STRING_HASH_UINT64(0xE220A839U, 0x7B1DCDAFU), STRING_HASH_UINT64(0x6E789E6AU, 0xA1B965F4U),
+	STRING_HASH_UINT64(0x06C45D18U, 0x8009454FU), STRING_HASH_UINT64(0xF88BB8A8U, 0x724C81ECU),
+	STRING_HASH_UINT64(0x1B39896AU, 0x51A8749BU), STRING_HASH_UINT64(0x53CB9F0CU, 0x747EA2EAU),
+	STRING_HASH_UINT64(0x2C829ABEU, 0x1F4532E1U), STRING_HASH_UINT64(0xC584133AU, 0xC916AB3CU),
+	STRING_HASH_UINT64(0x3EE57890U, 0x41C98AC3U), STRING_HASH_UINT64(0xF3B8488CU, 0x368CB0A6U),
+	STRING_HASH_UINT64(0x657EECDDU, 0x3CB13D09U), STRING_HASH_UINT64(0xC2D326E0U, 0x055BDEF6U),
+	STRING_HASH_UINT64(0x8621A03FU, 0xE0BBDB7BU), STRING_HASH_UINT64(0x8E1F7555U, 0x983AA92FU),
+	STRING_HASH_UINT64(0xB54E0F16U, 0x00CC4D19U), STRING_HASH_UINT64(0x84BB3F97U, 0x971D80ABU),
+	STRING_HASH_UINT64(0x7D29825CU, 0x75521255U), STRING_HASH_UINT64(0xC3CF1710U, 0x2B7F7F86U),
+	STRING_HASH_UINT64(0x3466E9A0U, 0x83914F64U), STRING_HASH_UINT64(0xD81A8D2BU, 0x5A4485ACU),
+	STRING_HASH_UINT64(0xDB01602BU, 0x100B9ED7U), STRING_HASH_UINT64(0xA9038A92U, 0x1825F10DU),
+	STRING_HASH_UINT64(0xEDF5F1D9U, 0x0DCA2F6AU), STRING_HASH_UINT64(0x54496AD6U, 0x7BD2634CU)
+};
+
+/* the initial values of the accumulators of XXH3 */
+static const uint64_t string_hash_initial_accumulators[8] = {
+	STRING_HASH_UINT64(0x00000000U, 0xC2B2AE3DU), STRING_HASH_UINT64(0x9E3779B1U, 0x85EBCA87U),
+	STRING_HASH_UINT64(0xC2B2AE3DU, 0x27D4EB4FU), STRING_HASH_UINT64(0x165667B1U, 0x9E3779F9U),
+	STRING_HASH_UINT64(0x85EBCA77U, 0xC2B2AE63U), STRING_HASH_UINT64(0x00000000U, 0x85EBCA77U),
+	STRING_HASH_UINT64(0x27D4EB2FU, 0x165667C5U), STRING_HASH_UINT64(0x00000000U, 0x9E3779B1U)
+};
+
+static uint64_t string_hash_read64(const unsigned char *p)
+{
+	return (uint64_t) p[0] | ((uint64_t) p[1] << 8U) | ((uint64_t) p[2] << 16U) | ((uint64_t) p[3] << 24U) |
+		((uint64_t) p[4] << 32U) | ((uint64_t) p[5] << 40U) | ((uint64_t) p[6] << 48U) | ((uint64_t) p[7] << 56U);
+}
+
+static uint64_t string_hash_read32(const unsigned char *p)
+{
+	return (uint64_t) p[0] | ((uint64_t) p[1] << 8U) | ((uint64_t) p[2] << 16U) | ((uint64_t) p[3] << 24U);
+}
+
+/* Computes the 128-bit product of a and b, and returns the lower half in a and the upper half in b. */
+static void string_hash_multiply(uint64_t *a, uint64_t *b)
+{
+#if defined(__SIZEOF_INT128__)
+	const string_hash_uint128_type product = (string_hash_uint128_type) *a * *b;
+	*a = (uint64_t) product;
+	*b = (uint64_t) (product >> 64U);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	*a = _umul128(*a, *b, b);
+#else
+	const uint64_t low_mask = STRING_HASH_UINT64(0U, 0xFFFFFFFFU);
+	const uint64_t a_high = *a >> 32U;
+	const uint64_t a_low = *a & low_mask;
+	const uint64_t b_high = *b >> 32U;
+	const uint64_t b_low = *b & low_mask;
+	const uint64_t high_high = a_high * b_high;
+	const uint64_t high_low = a_high * b_low;
+	const uint64_t low_high = a_low * b_high;
+	const uint64_t low_low = a_low * b_low;
+	const uint64_t middle = (low_low >> 32U) + (high_low & low_mask) + low_high;
+	*a = (middle << 32U) | (low_low & low_mask);
+	*b = high_high + (high_low >> 32U) + (middle >> 32U);
+#endif
+}
+
+static uint64_t string_hash_mix(uint64_t a, uint64_t b)
+{
+	string_hash_multiply(&a, &b);
+	return a ^ b;
+}
+
+static uint64_t string_hash_short(const unsigned char *p, size_t number_of_bytes, uint64_t seed)
+{
+	const uint64_t *secret = string_hash_wyhash_secret;
+	uint64_t a = 0U;
+	uint64_t b = 0U;
+	size_t i = number_of_bytes;
+
+	seed ^= string_hash_mix(seed ^ secret[0], secret[1]);
+	if (number_of_bytes <= 16U) {
+		if (number_of_bytes >= 4U) {
+			const size_t offset = (number_of_bytes >> 3U) << 2U;
+			a = (string_hash_read32(p) << 32U) | string_hash_read32(p + offset);
+			b = (string_hash_read32(p + number_of_bytes - 4U) << 32U) | string_hash_read32(p + number_of_bytes - 4U - offset);
+		} else if (number_of_bytes > 0U) {
+			a = ((uint64_t) p[0] << 16U) | ((uint64_t) p[number_of_bytes >> 1U] << 8U) | (uint64_t) p[number_of_bytes - 1U];
+		}
+	} else {
+		if (i > 48U) {
+			uint64_t seed1 = seed;
+			uint64_t seed2 = seed;
+			do {
+				seed = string_hash_mix(string_hash_read64(p) ^ secret[1], string_hash_read64(p + 8U) ^ seed);
+				seed1 = string_hash_mix(string_hash_read64(p + 16U) ^ secret[2], string_hash_read64(p + 24U) ^ seed1);
+				seed2 = string_hash_mix(string_hash_read64(p + 32U) ^ secret[3], string_hash_read64(p + 40U) ^ seed2);
+				p += 48U;
+				i -= 48U;
+			} while (i > 48U);
+			seed ^= seed1 ^ seed2;
+		}
+		while (i > 16U) {
+			seed = string_hash_mix(string_hash_read64(p) ^ secret[1], string_hash_read64(p + 8U) ^ seed);
+			p += 16U;
+			i -= 16U;
+		}
+		a = string_hash_read64(p + i - 16U);
+		b = string_hash_read64(p + i - 8U);
+	}
+
+	a ^= secret[1];
+	b ^= seed;
+	string_hash_multiply(&a, &b);
+	return string_hash_mix(a ^ secret[0] ^ (uint64_t) number_of_bytes, b ^ secret[1]);
+}
+
+static void string_hash_make_secret(uint64_t *secret, uint64_t seed)
+{
+	size_t i = 0U;
+	for (; i < (size_t) string_hash_number_of_secret_words; i += 2U) {
+		secret[i] = string_hash_default_secret[i] + seed;
+		secret[i + 1U] = string_hash_default_secret[i + 1U] - seed;
+	}
+}
+
+static void string_hash_accumulate_stripe(uint64_t *accumulators, const unsigned char *stripe, const uint64_t *secret)
+{
+#if defined(STRING_HASH_USE_AVX2)
+	size_t i = 0U;
+	for (; i < 2U; ++i) {
+		const __m256i data = _mm256_loadu_si256((const __m256i*) (const void*) (stripe + 32U * i));
+		const __m256i key = _mm256_loadu_si256((const __m256i*) (const void*) (secret + 4U * i));
+		const __m256i data_key = _mm256_xor_si256(data, key);
+		const __m256i product = _mm256_mul_epu32(data_key, _mm256_srli_epi64(data_key, 32));
+		const __m256i data_swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+		__m256i accumulator = _mm256_loadu_si256((const __m256i*) (const void*) (accumulators + 4U * i));
+		accumulator = _mm256_add_epi64(accumulator, _mm256_add_epi64(product, data_swapped));
+		_mm256_storeu_si256((__m256i*) (void*) (accumulators + 4U * i), accumulator);
+	}
+#elif defined(STRING_HASH_USE_SSE2)
+	size_t i = 0U;
+	for (; i < 4U; ++i) {
+		const __m128i data = _mm_loadu_si128((const __m128i*) (const void*) (stripe + 16U * i));
+		const __m128i key = _mm_loadu_si128((const __m128i*) (const void*) (secret + 2U * i));
+		const __m128i data_key = _mm_xor_si128(data, key);
+		const __m128i product = _mm_mul_epu32(data_key, _mm_srli_epi64(data_key, 32));
+		const __m128i data_swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+		__m128i accumulator = _mm_loadu_si128((const __m128i*) (const void*) (accumulators + 2U * i));
+		accumulator = _mm_add_epi64(accumulator, _mm_add_epi64(product, data_swapped));
+		_mm_storeu_si128((__m128i*) (void*) (accumulators + 2U * i), accumulator);
+	}
+#else
+	const uint64_t low_mask = STRING_HASH_UINT64(0U, 0xFFFFFFFFU);
+	size_t i = 0U;
+	for (; i < 8U; ++i) {
+		const uint64_t data = string_hash_read64(stripe + 8U * i);
+		const uint64_t data_key = data ^ secret[i];
+		accumulators[i ^ 1U] += data;
+		accumulators[i] += (data_key & low_mask) * (data_key >> 32U);
+	}
+#endif
+}
+
+static void string_hash_scramble(uint64_t *accumulators, const uint64_t *secret)
+{
+	size_t i = 0U;
+	for (; i < 8U; ++i) {
+		uint64_t accumulator = accumulators[i];
+		accumulator ^= accumulator >> 47U;
+		accumulator ^= secret[string_hash_scramble_secret_offset + i];
+		accumulators[i] = accumulator * STRING_HASH_UINT64(0U, 0x9E3779B1U);
+	}
+}
+
+static void string_hash_accumulate_stripes(uint64_t *accumulators, size_t *number_of_stripes_in_block,
+	const unsigned char *p, size_t number_of_stripes, const uint64_t *secret)
+{
+	size_t i = 0U;
+	for (; i < number_of_stripes; ++i) {
+		string_hash_accumulate_stripe(accumulators, p + i * STRING_HASH_STRIPE_LENGTH, secret + *number_of_stripes_in_block);
+		++*number_of_stripes_in_block;
+		if (*number_of_stripes_in_block == (size_t) string_hash_stripes_per_block) {
+			string_hash_scramble(accumulators, secret);
+			*number_of_stripes_in_block = 0U;
+		}
+	}
+}
+
+/* Accumulates the last 64 bytes of the input and merges the accumulators. */
+static uint64_t string_hash_merge(uint64_t *accumulators, const unsigned char *last_stripe, size_t total_length, const uint64_t *secret)
+{
+	uint64_t result = (uint64_t) total_length * STRING_HASH_UINT64(0x9E3779B1U, 0x85EBCA87U);
+	size_t i = 0U;
+
+	string_hash_accumulate_stripe(accumulators, last_stripe, secret + string_hash_last_stripe_secret_offset);
+	for (; i < 4U; ++i) {
+		result += string_hash_mix(accumulators[2U * i] ^ secret[string_hash_merge_secret_offset + 2U * i],
+			accumulators[2U * i + 1U] ^ secret[string_hash_merge_secret_offset + 2U * i + 1U]);
+	}
+
+	/* avalanche step of XXH3 */
+	result ^= result >> 37U;
+	result *= STRING_HASH_UINT64(0x16566791U, 0x9E3779F9U);
+	result ^= result >> 32U;
+	return result;
+}
+
+static uint64_t string_hash_long(const unsigned char *p, size_t number_of_bytes, uint64_t seed)
+{
+	uint64_t accumulators[8];
+	uint64_t seeded_secret[string_hash_number_of_secret_words];
+	const uint64_t *secret = string_hash_default_secret;
+	size_t number_of_stripes_in_block = 0U;
+
+	if (seed != 0U) {
+		string_hash_make_secret(seeded_secret, seed);
+		secret = seeded_secret;
+	}
+	memcpy(accumulators, string_hash_initial_accumulators, sizeof(accumulators));
+	string_hash_accumulate_stripes(accumulators, &number_of_stripes_in_block, p,
+		(number_of_bytes - 1U) / STRING_HASH_STRIPE_LENGTH, secret);
+	return string_hash_merge(accumulators, p + number_of_bytes - STRING_HASH_STRIPE_LENGTH, number_of_bytes, secret);
+}
+
+uint64_t string_hash_bytes(const void *data, size_t number_of_bytes, uint64_t seed)
+{
+	assert(data != NULL or number_of_bytes == 0U);
+	if (number_of_bytes <= STRING_HASH_SHORT_INPUT_LENGTH) {
+		return string_hash_short((const unsigned char*) data, number_of_bytes, seed);
+	}
+	return string_hash_long((const unsigned char*) data, number_of_bytes, seed);
+}
+
+uint64_t string_hash(const_stringref_type string, uint64_t seed)
+{
+	return (string.string != NULL) ? string_hash_bytes(string.string, string.length, seed) : string_hash_bytes(NULL, 0U, seed);
+}
+
+void string_hash_init(string_hash_state_type *state, uint64_t seed)
+{
+	assert(state != NULL);
+	memcpy(state->accumulators, string_hash_initial_accumulators, sizeof(state->accumulators));
+	string_hash_make_secret(state->secret, seed);
+	state->seed = seed;
+	state->total_length = 0U;
+	state->number_of_stripes_in_block = 0U;
+	state->number_of_buffered_bytes = 0U;
+	state->number_of_accumulated_bytes_in_buffer = 0U;
+}
+
+void string_hash_update(string_hash_state_type *state, const void *data, size_t number_of_bytes)
+{
+	const size_t buffer_size = sizeof(state->buffer);
+	const unsigned char *p = (const unsigned char*) data;
+
+	assert(state != NULL);
+	assert(data != NULL or number_of_bytes == 0U);
+	state->total_length += number_of_bytes;
+	while (number_of_bytes > 0U) {
+		size_t number_of_bytes_to_copy = 0U;
+
+		if (state->number_of_buffered_bytes == buffer_size) {
+			/* more bytes follow, so the stripes of the full buffer can be accumulated */
+			string_hash_accumulate_stripes(state->accumulators, &state->number_of_stripes_in_block,
+				state->buffer + state->number_of_accumulated_bytes_in_buffer,
+				(buffer_size - state->number_of_accumulated_bytes_in_buffer) / STRING_HASH_STRIPE_LENGTH, state->secret);
+			memcpy(state->buffer, state->buffer + STRING_HASH_STRIPE_LENGTH, STRING_HASH_STRIPE_LENGTH);
+			state->number_of_buffered_bytes = STRING_HASH_STRIPE_LENGTH;
+			state->number_of_accumulated_bytes_in_buffer = STRING_HASH_STRIPE_LENGTH;
+		}
+
+		if ((state->number_of_buffered_bytes == 0U and number_of_bytes > buffer_size) or
+			(state->number_of_buffered_bytes == STRING_HASH_STRIPE_LENGTH and
+			state->number_of_accumulated_bytes_in_buffer == STRING_HASH_STRIPE_LENGTH and number_of_bytes > STRING_HASH_STRIPE_LENGTH)) {
+			/* the input is a long input, so its stripes are accumulated without copying them to the buffer */
+			const size_t number_of_stripes = (number_of_bytes - 1U) / STRING_HASH_STRIPE_LENGTH;
+			string_hash_accumulate_stripes(state->accumulators, &state->number_of_stripes_in_block, p, number_of_stripes, state->secret);
+			p += number_of_stripes * STRING_HASH_STRIPE_LENGTH;
+			number_of_bytes -= number_of_stripes * STRING_HASH_STRIPE_LENGTH;
+			memcpy(state->buffer, p - STRING_HASH_STRIPE_LENGTH, STRING_HASH_STRIPE_LENGTH);
+			memcpy(state->buffer + STRING_HASH_STRIPE_LENGTH, p, number_of_bytes);
+			state->number_of_buffered_bytes = STRING_HASH_STRIPE_LENGTH + number_of_bytes;
+			state->number_of_accumulated_bytes_in_buffer = STRING_HASH_STRIPE_LENGTH;
+			break;
+		}
+
+		number_of_bytes_to_copy = buffer_size - state->number_of_buffered_bytes;
+		if (number_of_bytes_to_copy > number_of_bytes) {
+			number_of_bytes_to_copy = number_of_bytes;
+		}
+		memcpy(state->buffer + state->number_of_buffered_bytes, p, number_of_bytes_to_copy);
+		state->number_of_buffered_bytes += number_of_bytes_to_copy;
+		p += number_of_bytes_to_copy;
+		number_of_bytes -= number_of_bytes_to_copy;
+	}
+}
+
+uint64_t string_hash_final(const string_hash_state_type *state)
+{
+	uint64_t accumulators[8];
+	size_t number_of_stripes_in_block = 0U;
+	size_t offset = 0U;
+
+	assert(state != NULL);
+	if (state->total_length <= STRING_HASH_SHORT_INPUT_LENGTH) {
+		return string_hash_short(state->buffer, state->total_length, state->seed);
+	}
+
+	/* the buffer holds the last bytes of the input, starting at a stripe boundary */
+	memcpy(accumulators, state->accumulators, sizeof(accumulators));
+	number_of_stripes_in_block = state->number_of_stripes_in_block;
+	offset = state->number_of_accumulated_bytes_in_buffer;
+	while (offset + STRING_HASH_STRIPE_LENGTH < state->number_of_buffered_bytes) {
+		string_hash_accumulate_stripes(accumulators, &number_of_stripes_in_block, state->buffer + offset, 1U, state->secret);
+		offset += STRING_HASH_STRIPE_LENGTH;
+	}
+	return string_hash_merge(accumulators, state->buffer + state->number_of_buffered_bytes - STRING_HASH_STRIPE_LENGTH,
+		state->total_length, state->secret);
+}
@@ -0,0 +1,65 @@
+/* Minimum C Standard: C89 (requires a 64-bit unsigned integer type) */
+
+#ifndef STRING_HASH_H
+#define STRING_HASH_H
+
+#include "fixed_width_integer_types.h"
+#include "string_reference.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+A fast, seedable 64-bit hash function for string references and byte sequences.
+It is not a cryptographic hash function.
+
+- Inputs of up to STRING_HASH_SHORT_INPUT_LENGTH bytes are hashed like wyhash: 16 bytes at a time are mixed by a
+  64 x 64 -> 128-bit multiplication whose halves are combined with an exclusive or.
+- Longer inputs are hashed like XXH3: eight 64-bit accumulators take 64-byte stripes of the input, and the
+  accumulators are scrambled after every 16 stripes. The accumulation uses SSE2 or AVX2 if the compiler targets
+  them, otherwise portable C.
+- The streaming functions produce the same hash as the one-shot functions, however the input is split.
+- The hash only depends on the bytes, the length and the seed, not on the byte order or the word size of the
+  platform, so hashes can be stored or sent to another machine.
+
+The hash of a string reference is the hash of its contents, i.e. all the bytes up to its length.
+A string reference with a null pointer has the same hash as an empty string.
+*/
+
+#define STRING_HASH_SHORT_INPUT_LENGTH 128U
+#define STRING_HASH_STRIPE_LENGTH 64U
+
+typedef struct string_hash_state_type
+{
+	uint64_t accumulators[8];
+	uint64_t secret[24]; /* keys derived from the seed */
+	uint64_t seed;
+	size_t total_length;
+	size_t number_of_stripes_in_block;
+	size_t number_of_buffered_bytes;
+	size_t number_of_accumulated_bytes_in_buffer; /* 0 or one stripe */
+	unsigned char buffer[STRING_HASH_SHORT_INPUT_LENGTH];
+} string_hash_state_type;
+
+/* Returns the hash of a byte sequence. data may be null if number_of_bytes is zero. */
+uint64_t string_hash_bytes(const void *data, size_t number_of_bytes, uint64_t seed);
+
+/* Returns the hash of the contents of a string reference. */
+uint64_t string_hash(const_stringref_type string, uint64_t seed);
+
+/* Initializes a state for hashing an input which is given in pieces. */
+void string_hash_init(string_hash_state_type *state, uint64_t seed);
+
+/* Appends bytes to the input of a state. data may be null if number_of_bytes is zero. */
+void string_hash_update(string_hash_state_type *state, const void *data, size_t number_of_bytes);
+
+/* Returns the hash of all the bytes appended so far. The state is not modified, so more bytes can be appended. */
+uint64_t string_hash_final(const string_hash_state_type *state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
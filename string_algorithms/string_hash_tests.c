@@ -0,0 +1,143 @@
+#include "string_hash.h"
+#include "unit_testing.h"
+
+#include <iso646.h>
+#include <stdlib.h>
+#include <string.h>
+
+static unsigned char s_data[3000];
+
+static void fill_data(void)
+{
+	size_t i = 0U;
+	for (; i < sizeof(s_data); ++i) {
+		s_data[i] = (unsigned char) ((i * 131U + 7U) & 0xFFU);
+	}
+}
+
+static int compare_hashes(const void *left, const void *right)
+{
+	const uint64_t a = *(const uint64_t*) left;
+	const uint64_t b = *(const uint64_t*) right;
+	return (a < b) ? -1 : ((a > b) ? 1 : 0);
+}
+
+TEST(string_hash_known_values, "string_hash returns the same values on every platform")
+{
+	fill_data();
+	ASSERT(string_hash_bytes(NULL, 0U, 0U) == string_hash_bytes(s_data, 0U, 0U));
+	ASSERT(string_hash_bytes(s_data, 3U, 0U) == ((((uint64_t) 0x2CB96FB6U) << 32U) | 0x80F039D3U));
+	ASSERT(string_hash_bytes(s_data, 16U, 0U) == ((((uint64_t) 0x8B286F37U) << 32U) | 0xC7E28104U));
+	ASSERT(string_hash_bytes(s_data, 100U, 0U) == ((((uint64_t) 0x7F9A0903U) << 32U) | 0x2A9CC398U));
+	ASSERT(string_hash_bytes(s_data, 1000U, 42U) == ((((uint64_t) 0xDDB24FA5U) << 32U) | 0x821F7ABEU));
+}
+
+TEST(string_hash_string_reference, "string_hash hashes the contents of a string reference")
+{
+	const char string[] = "identifier\0suffix";
+
+	ASSERT(string_hash(string_to_const_stringref(string, 10U), 0U) == string_hash_bytes("identifier", 10U, 0U));
+	ASSERT(string_hash(string_to_const_stringref(string, 17U), 0U) != string_hash(string_to_const_stringref(string, 10U), 0U));
+	ASSERT(string_hash(string_to_const_stringref(NULL, 5U), 7U) == string_hash_bytes(NULL, 0U, 7U));
+}
+
+TEST(string_hash_seed, "Different seeds give different hashes")
+{
+	size_t length = 0U;
+
+	fill_data();
+	for (length = 0U; length < sizeof(s_data); length += 61U) {
+		ASSERT(string_hash_bytes(s_data, length, 0U) != string_hash_bytes(s_data, length, 1U));
+		ASSERT(string_hash_bytes(s_data, length, 1U) != string_hash_bytes(s_data, length, 2U));
+		ASSERT(string_hash_bytes(s_data, length, 12345U) == string_hash_bytes(s_data, length, 12345U));
+	}
+}
+
+TEST(string_hash_every_byte_matters, "Changing any byte or the length changes the hash")
+{
+	const size_t lengths[] = {1U, 3U, 4U, 8U, 16U, 17U, 48U, 49U, 128U, 129U, 192U, 1024U, 1025U, 2000U};
+	size_t i = 0U;
+
+	fill_data();
+	for (i = 0U; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+		const size_t length = lengths[i];
+		const uint64_t hash = string_hash_bytes(s_data, length, 0U);
+		size_t position = 0U;
+		ASSERT(hash != string_hash_bytes(s_data, length - 1U, 0U));
+		for (position = 0U; position < length; ++position) {
+			s_data[position] ^= 0x01U;
+			ASSERT(hash != string_hash_bytes(s_data, length, 0U));
+			s_data[position] ^= 0x01U;
+		}
+	}
+}
+
+TEST(string_hash_streaming, "The streaming functions give the same hash as string_hash_bytes")
+{
+	size_t length = 0U;
+
+	fill_data();
+	for (length = 0U; length < sizeof(s_data); length += (length < 300U) ? 1U : 37U) {
+		const uint64_t seed = (length % 3U == 0U) ? 12345U : 0U;
+		string_hash_state_type state;
+		size_t offset = 0U;
+		size_t piece_length = 1U;
+
+		string_hash_init(&state, seed);
+		while (offset < length) {
+			const size_t number_of_bytes = (piece_length < length - offset) ? piece_length : length - offset;
+			string_hash_update(&state, s_data + offset, number_of_bytes);
+			offset += number_of_bytes;
+			piece_length = piece_length * 3U % 97U + 1U;
+			ASSERT(string_hash_final(&state) == string_hash_bytes(s_data, offset, seed));
+		}
+		ASSERT(string_hash_final(&state) == string_hash_bytes(s_data, length, seed));
+	}
+}
+
+TEST(string_hash_no_collisions, "Similar short strings have distinct hashes")
+{
+	enum { number_of_strings = 100000 };
+	uint64_t *hashes = (uint64_t*) malloc(number_of_strings * sizeof(uint64_t));
+	size_t number_of_collisions = 0U;
+	size_t i = 0U;
+
+	ASSERT(hashes != NULL);
+	if (hashes == NULL) {
+		return;
+	}
+	for (i = 0U; i < (size_t) number_of_strings; ++i) {
+		unsigned char key[8];
+		size_t length = 0U;
+		size_t value = i;
+		do {
+			key[length] = (unsigned char) ('0' + value % 10U);
+			value /= 10U;
+			++length;
+		} while (value > 0U);
+		hashes[i] = string_hash_bytes(key, length, 0U);
+	}
+	qsort(hashes, number_of_strings, sizeof(uint64_t), &compare_hashes);
+	for (i = 1U; i < (size_t) number_of_strings; ++i) {
+		number_of_collisions += (hashes[i] == hashes[i - 1U]);
+	}
+	ASSERT_SIZE_EQUAL(number_of_collisions, 0U);
+	free(hashes);
+}
+
+int main(void)
+{
+	DEFINE_LIST_OF_TESTS(list_of_tests) {
+		string_hash_known_values,
+		string_hash_string_reference,
+		string_hash_seed,
+		string_hash_every_byte_matters,
+		string_hash_streaming,
+		string_hash_no_collisions
+	};
+
+	PRINT_FILE_NAME();
+	RUN_TESTS(list_of_tests);
+	PRINT_TEST_STATISTICS(list_of_tests);
+	return 0;
+}
@@ -0,0 +1,249 @@
+#include "string_intern.h"
+#include "string_hash.h"
+#include <assert.h>
+#include <iso646.h>
+#include <string.h>
+
+/* Notes:
+- The arena is a singly linked list of blocks. New strings are appended to the most recent block, and a new block is
+  allocated when the string does not fit. A string longer than the default block size gets a block of its own.
+- Slots store ID + 1, so that a zero-initialized slot array is an empty hash table.
+*/
+
+enum {
+	string_intern_initial_number_of_slots = 64,
+	string_intern_initial_capacity_of_strings = 32,
+	string_intern_arena_block_size = 4096
+};
+
+struct string_intern_arena_block_type
+{
+	string_intern_arena_block_type *previous;
+	size_t capacity; /* number of bytes for strings after the header */
+	size_t number_of_bytes_used;
+};
+
+static size_t string_intern_hash(const char *string, size_t length)
+{
+	return (size_t) string_hash_bytes(string, length, 0U);
+}
+
+static char *string_intern_arena_bytes(string_intern_arena_block_type *block)
+{
+	return (char*) (block + 1);
+}
+
+/* Returns the slot of the string, or the empty slot where it would be inserted. The hash table must not be full. */
+static size_t string_intern_find_slot(const string_intern_table_type *table, const char *string, size_t length, size_t hash)
+{
+	const size_t mask = table->number_of_slots - 1U;
+	size_t index = hash & mask;
+
+	for (;;) {
+		const string_intern_slot_type *slot = &table->slots[index];
+		if (slot->id_plus_one == 0U) {
+			break;
+		}
+		if (slot->hash == hash) {
+			const const_stringref_type *interned_string = &table->strings[slot->id_plus_one - 1U];
+			if (interned_string->length == length and memcmp(interned_string->string, string, length) == 0) {
+				break;
+			}
+		}
+		index = (index + 1U) & mask;
+	}
+	return index;
+}
+
+static Boolean_type string_intern_grow_slots(string_intern_table_type *table)
+{
+	const size_t new_number_of_slots = (table->number_of_slots > 0U) ?
+		2U * table->number_of_slots : (size_t) string_intern_initial_number_of_slots;
+	string_intern_slot_type *new_slots = NULL;
+	size_t i = 0U;
+
+	if (new_number_of_slots > ((size_t) -1) / sizeof(string_intern_slot_type)) {
+		return Boolean_false;
+	}
+	new_slots = (string_intern_slot_type*) allocator_allocate(table->allocator, new_number_of_slots * sizeof(string_intern_slot_type));
+	if (new_slots == NULL) {
+		return Boolean_false;
+	}
+
+	/* the strings are distinct, so each of them goes to the first empty slot of its probe sequence */
+	for (i = 0U; i < table->number_of_slots; ++i) {
+		const string_intern_slot_type *slot = &table->slots[i];
+		if (slot->id_plus_one != 0U) {
+			size_t index = slot->hash & (new_number_of_slots - 1U);
+			while (new_slots[index].id_plus_one != 0U) {
+				index = (index + 1U) & (new_number_of_slots - 1U);
+			}
+			new_slots[index] = *slot;
+		}
+	}
+
+	allocator_deallocate(table->allocator, table->slots);
+	table->slots = new_slots;
+	table->number_of_slots = new_number_of_slots;
+	return Boolean_true;
+}
+
+static Boolean_type string_intern_grow_strings(string_intern_table_type *table)
+{
+	const size_t old_capacity = table->capacity_of_strings;
+	const size_t new_capacity = (old_capacity > 0U) ? 2U * old_capacity : (size_t) string_intern_initial_capacity_of_strings;
+	const_stringref_type *new_strings = NULL;
+
+	if (new_capacity > ((size_t) -1) / sizeof(const_stringref_type)) {
+		return Boolean_false;
+	}
+	new_strings = (const_stringref_type*) allocator_reallocate(table->allocator, table->strings,
+		old_capacity * sizeof(const_stringref_type), new_capacity * sizeof(const_stringref_type));
+	if (new_strings == NULL) {
+		return Boolean_false;
+	}
+	table->strings = new_strings;
+	table->capacity_of_strings = new_capacity;
+	return Boolean_true;
+}
+
+/* Copies the string with a null terminator into the arena. Returns null if there is not enough memory. */
+static const char *string_intern_copy_to_arena(string_intern_table_type *table, const char *string, size_t length)
+{
+	string_intern_arena_block_type *block = table->arena;
+	char *copy = NULL;
+
+	if (length > ((size_t) -1) - sizeof(string_intern_arena_block_type) - 1U) {
+		return NULL;
+	}
+	if (block == NULL or block->capacity - block->number_of_bytes_used < length + 1U) {
+		const size_t default_capacity = (size_t) string_intern_arena_block_size - sizeof(string_intern_arena_block_type);
+		const size_t capacity = (length + 1U > default_capacity) ? length + 1U : default_capacity;
+		block = (string_intern_arena_block_type*) allocator_allocate(table->allocator, sizeof(string_intern_arena_block_type) + capacity);
+		if (block == NULL) {
+			return NULL;
+		}
+		block->capacity = capacity;
+		block->number_of_bytes_used = 0U;
+		if (table->arena != NULL and capacity > default_capacity) {
+			/* keep appending to the current block, which has more free space than the block of a long string */
+			block->previous = table->arena->previous;
+			table->arena->previous = block;
+		} else {
+			block->previous = table->arena;
+			table->arena = block;
+		}
+		table->number_of_arena_bytes += sizeof(string_intern_arena_block_type) + capacity;
+	}
+
+	copy = string_intern_arena_bytes(block) + block->number_of_bytes_used;
+	if (length > 0U) {
+		memcpy(copy, string, length);
+	}
+	copy[length] = '\0';
+	block->number_of_bytes_used += length + 1U;
+	return copy;
+}
+
+void string_intern_table_init(string_intern_table_type *table, allocator_type allocator)
+{
+	assert(table != NULL);
+	assert(allocator.allocate != NULL);
+	assert(allocator.deallocate != NULL);
+	memset(table, 0, sizeof(*table));
+	table->allocator = allocator;
+}
+
+void string_intern_table_deinit(string_intern_table_type *table)
+{
+	string_intern_arena_block_type *block = NULL;
+
+	assert(table != NULL);
+	block = table->arena;
+	while (block != NULL) {
+		string_intern_arena_block_type *previous = block->previous;
+		allocator_deallocate(table->allocator, block);
+		block = previous;
+	}
+	allocator_deallocate(table->allocator, table->slots);
+	allocator_deallocate(table->allocator, table->strings);
+	table->slots = NULL;
+	table->number_of_slots = 0U;
+	table->strings = NULL;
+	table->number_of_strings = 0U;
+	table->capacity_of_strings = 0U;
+	table->arena = NULL;
+	table->number_of_arena_bytes = 0U;
+}
+
+string_intern_id_type string_intern_table_insert(string_intern_table_type *table, const_stringref_type string)
+{
+	const size_t length = (string.string != NULL) ? string.length : 0U;
+	const char *bytes = (string.string != NULL) ? string.string : "";
+	const size_t hash = string_intern_hash(bytes, length);
+	size_t index = 0U;
+	const char *copy = NULL;
+
+	assert(table != NULL);
+	if (table->number_of_slots > 0U) {
+		index = string_intern_find_slot(table, bytes, length, hash);
+		if (table->slots[index].id_plus_one != 0U) {
+			return table->slots[index].id_plus_one - 1U;
+		}
+	}
+
+	/* a new string: make room first, so that a failure leaves the table unchanged */
+	if ((table->number_of_strings + 1U) * 2U > table->number_of_slots) {
+		if (not string_intern_grow_slots(table)) {
+			return STRING_INTERN_INVALID_ID;
+		}
+		index = string_intern_find_slot(table, bytes, length, hash);
+	}
+	if (table->number_of_strings == table->capacity_of_strings and not string_intern_grow_strings(table)) {
+		return STRING_INTERN_INVALID_ID;
+	}
+	copy = string_intern_copy_to_arena(table, bytes, length);
+	if (copy == NULL) {
+		return STRING_INTERN_INVALID_ID;
+	}
+
+	table->strings[table->number_of_strings] = string_to_const_stringref(copy, length);
+	++table->number_of_strings;
+	table->slots[index].hash = hash;
+	table->slots[index].id_plus_one = table->number_of_strings;
+	return table->number_of_strings - 1U;
+}
+
+string_intern_id_type string_intern_table_find(const string_intern_table_type *table, const_stringref_type string)
+{
+	const size_t length = (string.string != NULL) ? string.length : 0U;
+	const char *bytes = (string.string != NULL) ? string.string : "";
+	size_t index = 0U;
+
+	assert(table != NULL);
+	if (table->number_of_slots == 0U) {
+		return STRING_INTERN_INVALID_ID;
+	}
+	index = string_intern_find_slot(table, bytes, length, string_intern_hash(bytes, length));
+	return (table->slots[index].id_plus_one != 0U) ? table->slots[index].id_plus_one - 1U : STRING_INTERN_INVALID_ID;
+}
+
+const_stringref_type string_intern_table_get_string(const string_intern_table_type *table, string_intern_id_type id)
+{
+	assert(table != NULL);
+	return (id < table->number_of_strings) ? table->strings[id] : string_to_const_stringref(NULL, 0U);
+}
+
+size_t string_intern_table_size(const string_intern_table_type *table)
+{
+	assert(table != NULL);
+	return table->number_of_strings;
+}
+
+size_t string_intern_table_memory_usage(const string_intern_table_type *table)
+{
+	assert(table != NULL);
+	return table->number_of_slots * sizeof(string_intern_slot_type) +
+		table->capacity_of_strings * sizeof(const_stringref_type) +
+		table->number_of_arena_bytes;
+}
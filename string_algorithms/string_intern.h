@@ -0,0 +1,100 @@
+/* Minimum C Standard: C89 */
+
+#ifndef STRING_INTERN_H
+#define STRING_INTERN_H
+
+#include "allocator_type.h"
+#include "Boolean_type.h"
+#include "string_reference.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+A string intern table maps strings to small integer IDs. Interning the same string again returns the same ID,
+so strings which have been interned can be compared by comparing their IDs.
+
+IDs are assigned in insertion order starting from 0, so they can also be used as indices of arrays.
+Each distinct string is copied once into an arena of large blocks and stored with a null terminator.
+The copies are never moved, so the string references returned by string_intern_table_get_string remain valid
+until the table is deinitialized.
+
+The IDs are kept in an open addressing hash table with linear probing, and the strings are hashed by string_hash.
+Each slot caches the hash of its string, so a lookup compares the bytes of a string only if the hashes are equal.
+The load factor is kept at or below 1/2.
+
+Strings are compared by their contents, i.e. all the bytes up to the length of each reference, including any '\0'.
+A string reference with a null pointer is treated as an empty string.
+
+Notes:
+- All memory is allocated through the allocator passed to string_intern_table_init.
+- The table is not thread-safe.
+*/
+
+typedef size_t string_intern_id_type;
+
+#define STRING_INTERN_INVALID_ID ((string_intern_id_type) -1)
+
+typedef struct string_intern_slot_type
+{
+	size_t hash;
+	size_t id_plus_one; /* 0 if the slot is empty */
+} string_intern_slot_type;
+
+typedef struct string_intern_arena_block_type string_intern_arena_block_type;
+
+typedef struct string_intern_table_type
+{
+	allocator_type allocator;
+	string_intern_slot_type *slots; /* hash table, the capacity is always a power of two */
+	size_t number_of_slots;
+	const_stringref_type *strings; /* indexed by ID */
+	size_t number_of_strings;
+	size_t capacity_of_strings;
+	string_intern_arena_block_type *arena; /* the most recently allocated block */
+	size_t number_of_arena_bytes; /* number of bytes allocated for the arena blocks */
+} string_intern_table_type;
+
+/*
+Initializes an empty string intern table. No memory is allocated until the first string is interned.
+
+Parameters:
+table    : A pointer to a string intern table. Must not be null.
+allocator: The allocator used for the hash table, the array of strings and the arena.
+           Its 'allocate' and 'deallocate' function pointers must not be null.
+*/
+void string_intern_table_init(string_intern_table_type *table, allocator_type allocator);
+
+/* Deallocates all the memory of a table. All string references obtained from the table become invalid. */
+void string_intern_table_deinit(string_intern_table_type *table);
+
+/*
+Interns a string. If the string has been interned before, its ID is returned and no memory is allocated.
+Otherwise, the string is copied into the arena and a new ID is assigned.
+
+Return value: The ID of the string, or STRING_INTERN_INVALID_ID if there is not enough memory.
+*/
+string_intern_id_type string_intern_table_insert(string_intern_table_type *table, const_stringref_type string);
+
+/* Returns the ID of a string if it has been interned, otherwise STRING_INTERN_INVALID_ID. */
+string_intern_id_type string_intern_table_find(const string_intern_table_type *table, const_stringref_type string);
+
+/*
+Returns the interned copy of the string with the ID. The copy is followed by a null terminator which is not
+included in the length. Returns a reference with a null pointer if the ID is not valid.
+*/
+const_stringref_type string_intern_table_get_string(const string_intern_table_type *table, string_intern_id_type id);
+
+/* Returns the number of distinct strings in the table. */
+size_t string_intern_table_size(const string_intern_table_type *table);
+
+/* Returns the total number of bytes allocated by the table, including the hash table and the arena. */
+size_t string_intern_table_memory_usage(const string_intern_table_type *table);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,164 @@
+#include "string_intern.h"
+#include "sizeof_array.h"
+#include "unit_testing.h"
+#include "unit_testing_allocator.h"
+
+#include <iso646.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+TEST(string_intern_same_string_same_id, "Interning the same string returns the same ID")
+{
+	string_intern_table_type table;
+	char buffer[] = "alpha";
+	string_intern_id_type alpha = 0U;
+	string_intern_id_type beta = 0U;
+
+	string_intern_table_init(&table, unit_testing_make_allocator());
+	alpha = string_intern_table_insert(&table, unit_testing_make_stringref("alpha"));
+	beta = string_intern_table_insert(&table, unit_testing_make_stringref("beta"));
+	ASSERT_SIZE_EQUAL(alpha, 0U);
+	ASSERT_SIZE_EQUAL(beta, 1U);
+	ASSERT_SIZE_EQUAL(string_intern_table_insert(&table, unit_testing_make_stringref(buffer)), alpha);
+	ASSERT_SIZE_EQUAL(string_intern_table_insert(&table, unit_testing_make_stringref("beta")), beta);
+	ASSERT_SIZE_EQUAL(string_intern_table_insert(&table, string_to_const_stringref("alphabet", 5U)), alpha);
+	ASSERT_SIZE_EQUAL(string_intern_table_insert(&table, string_to_const_stringref("alphabet", 4U)), 2U);
+	ASSERT_SIZE_EQUAL(string_intern_table_size(&table), 3U);
+	string_intern_table_deinit(&table);
+	ASSERT_SIZE_EQUAL(unit_testing_number_of_allocations, unit_testing_number_of_deallocations);
+}
+
+TEST(string_intern_find_and_get_string, "string_intern_table_find and string_intern_table_get_string")
+{
+	string_intern_table_type table;
+	const_stringref_type string;
+	string_intern_id_type id = 0U;
+
+	string_intern_table_init(&table, unit_testing_make_allocator());
+	ASSERT_SIZE_EQUAL(string_intern_table_find(&table, unit_testing_make_stringref("x")), STRING_INTERN_INVALID_ID);
+	id = string_intern_table_insert(&table, unit_testing_make_stringref("identifier"));
+	ASSERT_SIZE_EQUAL(string_intern_table_find(&table, unit_testing_make_stringref("identifier")), id);
+	ASSERT_SIZE_EQUAL(string_intern_table_find(&table, unit_testing_make_stringref("identifiers")), STRING_INTERN_INVALID_ID);
+
+	string = string_intern_table_get_string(&table, id);
+	ASSERT_SIZE_EQUAL(string.length, 10U);
+	ASSERT_EQUAL(strcmp(string.string, "identifier"), 0);
+	string = string_intern_table_get_string(&table, id + 1U);
+	ASSERT(string.string == NULL);
+	ASSERT_SIZE_EQUAL(string.length, 0U);
+	string_intern_table_deinit(&table);
+}
+
+TEST(string_intern_empty_and_null_bytes, "Empty strings and strings with null bytes")
+{
+	string_intern_table_type table;
+	const char with_null_bytes[] = "a\0b";
+	string_intern_id_type empty = 0U;
+	string_intern_id_type id = 0U;
+
+	string_intern_table_init(&table, unit_testing_make_allocator());
+	empty = string_intern_table_insert(&table, unit_testing_make_stringref(""));
+	ASSERT_SIZE_EQUAL(string_intern_table_insert(&table, string_to_const_stringref(NULL, 4U)), empty);
+	ASSERT_SIZE_EQUAL(string_intern_table_get_string(&table, empty).length, 0U);
+	ASSERT_EQUAL(string_intern_table_get_string(&table, empty).string[0], '\0');
+
+	id = string_intern_table_insert(&table, string_to_const_stringref(with_null_bytes, sizeof_array(with_null_bytes) - 1U));
+	ASSERT(id != string_intern_table_insert(&table, unit_testing_make_stringref("a")));
+	ASSERT_SIZE_EQUAL(string_intern_table_get_string(&table, id).length, 3U);
+	ASSERT_EQUAL(memcmp(string_intern_table_get_string(&table, id).string, with_null_bytes, 4U), 0);
+	string_intern_table_deinit(&table);
+}
+
+TEST(string_intern_many_strings, "Many strings keep their IDs and their interned copies")
+{
+	string_intern_table_type table;
+	const char *first_copy = NULL;
+	char buffer[32];
+	size_t i = 0U;
+	size_t memory_usage = 0U;
+
+	string_intern_table_init(&table, unit_testing_make_allocator());
+	for (i = 0U; i < 10000U; ++i) {
+		sprintf(buffer, "name_%lu", (unsigned long) i);
+		ASSERT_SIZE_EQUAL(string_intern_table_insert(&table, unit_testing_make_stringref(buffer)), i);
+		if (i == 0U) {
+			first_copy = string_intern_table_get_string(&table, 0U).string;
+		}
+	}
+	ASSERT_SIZE_EQUAL(string_intern_table_size(&table), 10000U);
+	ASSERT(string_intern_table_get_string(&table, 0U).string == first_copy);
+
+	/* interning the strings again takes no extra memory */
+	memory_usage = string_intern_table_memory_usage(&table);
+	for (i = 0U; i < 10000U; ++i) {
+		sprintf(buffer, "name_%lu", (unsigned long) i);
+		ASSERT_SIZE_EQUAL(string_intern_table_insert(&table, unit_testing_make_stringref(buffer)), i);
+	}
+	ASSERT_SIZE_EQUAL(string_intern_table_memory_usage(&table), memory_usage);
+
+	for (i = 0U; i < 10000U; i += 97U) {
+		sprintf(buffer, "name_%lu", (unsigned long) i);
+		ASSERT_EQUAL(strcmp(string_intern_table_get_string(&table, i).string, buffer), 0);
+	}
+	string_intern_table_deinit(&table);
+	ASSERT_SIZE_EQUAL(unit_testing_number_of_allocations, unit_testing_number_of_deallocations);
+}
+
+TEST(string_intern_long_strings, "Strings longer than an arena block")
+{
+	string_intern_table_type table;
+	static char long_string[10000];
+	string_intern_id_type long_id = 0U;
+	string_intern_id_type short_id = 0U;
+
+	memset(long_string, 'x', sizeof(long_string));
+	string_intern_table_init(&table, unit_testing_make_allocator());
+	short_id = string_intern_table_insert(&table, unit_testing_make_stringref("short"));
+	long_id = string_intern_table_insert(&table, string_to_const_stringref(long_string, sizeof(long_string)));
+	ASSERT(long_id != STRING_INTERN_INVALID_ID);
+	ASSERT_SIZE_EQUAL(string_intern_table_insert(&table, unit_testing_make_stringref("short too")), 2U);
+	ASSERT_SIZE_EQUAL(string_intern_table_get_string(&table, long_id).length, sizeof(long_string));
+	ASSERT_EQUAL(memcmp(string_intern_table_get_string(&table, long_id).string, long_string, sizeof(long_string)), 0);
+	ASSERT_EQUAL(strcmp(string_intern_table_get_string(&table, short_id).string, "short"), 0);
+	ASSERT_EQUAL(strcmp(string_intern_table_get_string(&table, 2U).string, "short too"), 0);
+	string_intern_table_deinit(&table);
+	ASSERT_SIZE_EQUAL(unit_testing_number_of_allocations, unit_testing_number_of_deallocations);
+}
+
+TEST(string_intern_allocation_failure, "A failed allocation leaves the table unchanged")
+{
+	string_intern_table_type table;
+	size_t i = 0U;
+
+	string_intern_table_init(&table, unit_testing_make_allocator());
+	/* the hash table, the array of strings and the arena block fail in turn, the successful allocations are kept */
+	for (i = 0U; i < 3U; ++i) {
+		unit_testing_allocations_until_failure = (i > 0U) ? 1U : 0U;
+		ASSERT_SIZE_EQUAL(string_intern_table_insert(&table, unit_testing_make_stringref("first")), STRING_INTERN_INVALID_ID);
+		ASSERT_SIZE_EQUAL(string_intern_table_size(&table), 0U);
+		ASSERT_SIZE_EQUAL(string_intern_table_find(&table, unit_testing_make_stringref("first")), STRING_INTERN_INVALID_ID);
+	}
+	unit_testing_allocations_until_failure = (size_t) -1;
+	ASSERT_SIZE_EQUAL(string_intern_table_insert(&table, unit_testing_make_stringref("first")), 0U);
+	ASSERT_SIZE_EQUAL(string_intern_table_size(&table), 1U);
+	string_intern_table_deinit(&table);
+	ASSERT_SIZE_EQUAL(unit_testing_number_of_allocations, unit_testing_number_of_deallocations);
+}
+
+int main(void)
+{
+	DEFINE_LIST_OF_TESTS(list_of_tests) {
+		string_intern_same_string_same_id,
+		string_intern_find_and_get_string,
+		string_intern_empty_and_null_bytes,
+		string_intern_many_strings,
+		string_intern_long_strings,
+		string_intern_allocation_failure
+	};
+
+	PRINT_FILE_NAME();
+	RUN_TESTS(list_of_tests);
+	PRINT_TEST_STATISTICS(list_of_tests);
+	return 0;
+}
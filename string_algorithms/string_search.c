@@ -0,0 +1,395 @@
+#include "string_search.h"
+#include "sizeof_array.h"
+#include <assert.h>
+#include <iso646.h>
+#include <string.h>
+
+/* Notes:
+- The Two-Way algorithm splits the needle at a critical position into a left half and a right half.
+  At each position of the haystack, the right half is compared from left to right, then the left half from right
+  to left. After a mismatch in the right half, the needle is shifted by the number of matched bytes plus one.
+  After a mismatch in the left half or a match, the needle is shifted by its period.
+  For a periodic needle, the bytes which are known to match after a shift by the period are remembered (memory),
+  so that no byte of the haystack is compared more than twice.
+- The implementation follows the description in "Two-way string-matching" by Crochemore and Perrin (1991).
+- The haystack and the needle can be read backwards (reverse), so that rfind finds the last occurrence first.
+- The table of shifts of a searcher lets the search skip positions where the byte aligned with the end of the needle
+  does not occur at the end of the needle, like the Boyer-Moore-Horspool algorithm.
+*/
+
+#define STRING_SEARCH_BYTE(string, length, index, reverse) \
+	((unsigned char) ((reverse) ? (string)[(length) - 1U - (index)] : (string)[(index)]))
+
+enum {
+	/* number of needle lengths which can be verified in addition to the bytes skipped by memchr */
+	memchr_verification_allowance = 16
+};
+
+typedef struct string_search_factorization_type
+{
+	size_t critical_position;
+	size_t period;
+	Boolean_type is_periodic;
+} string_search_factorization_type;
+
+typedef struct string_search_byte_set_type
+{
+	unsigned char bits[32];
+} string_search_byte_set_type;
+
+static size_t string_search_length(const_stringref_type stringref)
+{
+	return (stringref.string != NULL) ? stringref.length : 0U;
+}
+
+/* Returns the position before the maximal suffix of the needle for the byte order or the inverted byte order. */
+static size_t string_search_maximal_suffix(const char *needle, size_t needle_length, Boolean_type reverse,
+	Boolean_type inverted_order, size_t *period)
+{
+	size_t maximal_suffix = (size_t) -1;
+	size_t j = 0U;
+	size_t k = 1U;
+	size_t p = 1U;
+
+	while (j + k < needle_length) {
+		const unsigned char a = STRING_SEARCH_BYTE(needle, needle_length, j + k, reverse);
+		const unsigned char b = STRING_SEARCH_BYTE(needle, needle_length, maximal_suffix + k, reverse);
+		if (inverted_order ? (b < a) : (a < b)) {
+			/* the suffix is smaller, so the period is the whole prefix so far */
+			j += k;
+			k = 1U;
+			p = j - maximal_suffix;
+		} else if (a == b) {
+			/* advance through a repetition of the current period */
+			if (k != p) {
+				++k;
+			} else {
+				j += p;
+				k = 1U;
+			}
+		} else {
+			/* the suffix is larger, so start over from the current position */
+			maximal_suffix = j;
+			++j;
+			k = 1U;
+			p = 1U;
+		}
+	}
+
+	*period = p;
+	return maximal_suffix;
+}
+
+static string_search_factorization_type string_search_factorize(const char *needle, size_t needle_length, Boolean_type reverse)
+{
+	string_search_factorization_type factorization;
+	size_t period = 0U;
+	size_t inverted_period = 0U;
+	const size_t maximal_suffix = string_search_maximal_suffix(needle, needle_length, reverse, Boolean_false, &period);
+	const size_t inverted_maximal_suffix = string_search_maximal_suffix(needle, needle_length, reverse, Boolean_true, &inverted_period);
+	size_t i = 0U;
+
+	/* the longer of the two maximal suffixes gives a critical factorization */
+	if (inverted_maximal_suffix + 1U < maximal_suffix + 1U) {
+		factorization.critical_position = maximal_suffix + 1U;
+		factorization.period = period;
+	} else {
+		factorization.critical_position = inverted_maximal_suffix + 1U;
+		factorization.period = inverted_period;
+	}
+
+	/* the needle is periodic if the left half is repeated after the period */
+	for (i = 0U; i < factorization.critical_position; ++i) {
+		if (STRING_SEARCH_BYTE(needle, needle_length, i, reverse) !=
+			STRING_SEARCH_BYTE(needle, needle_length, i + factorization.period, reverse)) {
+			break;
+		}
+	}
+	factorization.is_periodic = (i == factorization.critical_position);
+	if (not factorization.is_periodic) {
+		const size_t right_length = needle_length - factorization.critical_position;
+		factorization.period = ((factorization.critical_position > right_length) ? factorization.critical_position : right_length) + 1U;
+	}
+	return factorization;
+}
+
+/*
+Returns the first position of the needle in the haystack, counted from the end if reverse is true.
+The needle must not be empty or longer than the haystack. shift_table may only be used if reverse is false.
+*/
+static size_t string_search_two_way(const char *haystack, size_t haystack_length, const char *needle, size_t needle_length,
+	const string_search_factorization_type *factorization, const size_t *shift_table, Boolean_type reverse)
+{
+	const size_t critical_position = factorization->critical_position;
+	const size_t period = factorization->period;
+	size_t memory = 0U; /* number of bytes at the start of the needle which are known to match */
+	size_t j = 0U;
+
+	assert(needle_length > 0U and needle_length <= haystack_length);
+	assert(shift_table == NULL or not reverse);
+	while (j <= haystack_length - needle_length) {
+		size_t i = 0U;
+		if (shift_table != NULL) {
+			size_t shift = shift_table[(unsigned char) haystack[j + needle_length - 1U]];
+			/* a shift of one byte is left to Two-Way, whose shift does not depend on a table lookup */
+			if (shift > 1U) {
+				if (memory > 0U and shift < period) {
+					/* the needle is periodic, but the last period has a byte out of place */
+					shift = needle_length - period;
+				}
+				memory = 0U;
+				j += shift;
+				continue;
+			}
+		}
+
+		i = (critical_position > memory) ? critical_position : memory;
+		while (i < needle_length and STRING_SEARCH_BYTE(needle, needle_length, i, reverse) ==
+			STRING_SEARCH_BYTE(haystack, haystack_length, i + j, reverse)) {
+			++i;
+		}
+
+		if (i < needle_length) {
+			j += i - critical_position + 1U;
+			memory = 0U;
+		} else {
+			i = critical_position;
+			while (i > memory and STRING_SEARCH_BYTE(needle, needle_length, i - 1U, reverse) ==
+				STRING_SEARCH_BYTE(haystack, haystack_length, i - 1U + j, reverse)) {
+				--i;
+			}
+			if (i <= memory) {
+				return j;
+			}
+			j += period;
+			memory = factorization->is_periodic ? needle_length - period : 0U;
+		}
+	}
+
+	return STRING_SEARCH_NOT_FOUND;
+}
+
+static void string_search_make_byte_set(string_search_byte_set_type *byte_set, const_stringref_type characters)
+{
+	size_t i = 0U;
+	memset(byte_set, 0, sizeof(*byte_set));
+	for (; i < characters.length; ++i) {
+		const unsigned char byte = (unsigned char) characters.string[i];
+		byte_set->bits[byte / 8U] = (unsigned char) (byte_set->bits[byte / 8U] | (1U << (byte % 8U)));
+	}
+}
+
+static Boolean_type string_search_byte_set_contains(const string_search_byte_set_type *byte_set, char character)
+{
+	const unsigned char byte = (unsigned char) character;
+	return (byte_set->bits[byte / 8U] & (1U << (byte % 8U))) != 0U;
+}
+
+/*
+Returns the first position of the needle in the haystack. The needle must be at least two bytes long.
+Candidates are found with memchr on the first byte of the needle and verified with memcmp. If too many candidates are
+false positives, e.g. in a repetitive text, the rest of the haystack is searched with Two-Way to keep O(n + m).
+factorization and shift_table may be null, e.g. for a one-off search.
+*/
+static size_t string_search_find_with_prefilter(const char *haystack, size_t haystack_length, const char *needle, size_t needle_length,
+	const string_search_factorization_type *factorization, const size_t *shift_table)
+{
+	size_t position = 0U;
+	size_t number_of_verified_bytes = 0U;
+
+	assert(needle_length > 1U);
+	while (position + needle_length <= haystack_length) {
+		const char *candidate = (const char*) memchr(haystack + position, needle[0], haystack_length - needle_length - position + 1U);
+		if (candidate == NULL) {
+			return STRING_SEARCH_NOT_FOUND;
+		}
+
+		position = (size_t) (candidate - haystack);
+		if (memcmp(candidate + 1, needle + 1, needle_length - 1U) == 0) {
+			return position;
+		}
+		++position;
+
+		number_of_verified_bytes += needle_length;
+		if (number_of_verified_bytes > position + memchr_verification_allowance * needle_length and
+			position + needle_length <= haystack_length) {
+			string_search_factorization_type computed_factorization;
+			size_t offset = 0U;
+			if (factorization == NULL) {
+				computed_factorization = string_search_factorize(needle, needle_length, Boolean_false);
+				factorization = &computed_factorization;
+			}
+			offset = string_search_two_way(haystack + position, haystack_length - position, needle, needle_length,
+				factorization, shift_table, Boolean_false);
+			return (offset != STRING_SEARCH_NOT_FOUND) ? position + offset : STRING_SEARCH_NOT_FOUND;
+		}
+	}
+
+	return STRING_SEARCH_NOT_FOUND;
+}
+
+size_t string_search_find(const_stringref_type haystack, const_stringref_type needle)
+{
+	const size_t haystack_length = string_search_length(haystack);
+	const size_t needle_length = string_search_length(needle);
+
+	if (needle_length == 0U) {
+		return 0U;
+	}
+	if (needle_length > haystack_length) {
+		return STRING_SEARCH_NOT_FOUND;
+	}
+	if (needle_length == 1U) {
+		return string_search_find_char(haystack, needle.string[0]);
+	}
+	return string_search_find_with_prefilter(haystack.string, haystack_length, needle.string, needle_length, NULL, NULL);
+}
+
+size_t string_search_rfind(const_stringref_type haystack, const_stringref_type needle)
+{
+	const size_t haystack_length = string_search_length(haystack);
+	const size_t needle_length = string_search_length(needle);
+	string_search_factorization_type factorization;
+	size_t offset = 0U;
+
+	if (needle_length == 0U) {
+		return haystack_length;
+	}
+	if (needle_length > haystack_length) {
+		return STRING_SEARCH_NOT_FOUND;
+	}
+	if (needle_length == 1U) {
+		return string_search_rfind_char(haystack, needle.string[0]);
+	}
+
+	factorization = string_search_factorize(needle.string, needle_length, Boolean_true);
+	offset = string_search_two_way(haystack.string, haystack_length, needle.string, needle_length, &factorization, NULL, Boolean_true);
+	return (offset != STRING_SEARCH_NOT_FOUND) ? haystack_length - needle_length - offset : STRING_SEARCH_NOT_FOUND;
+}
+
+size_t string_search_find_char(const_stringref_type haystack, char character)
+{
+	const size_t haystack_length = string_search_length(haystack);
+	const char *found = (haystack_length > 0U) ? (const char*) memchr(haystack.string, character, haystack_length) : NULL;
+	return (found != NULL) ? (size_t) (found - haystack.string) : STRING_SEARCH_NOT_FOUND;
+}
+
+size_t string_search_rfind_char(const_stringref_type haystack, char character)
+{
+	size_t index = string_search_length(haystack);
+	while (index > 0U) {
+		--index;
+		if (haystack.string[index] == character) {
+			return index;
+		}
+	}
+	return STRING_SEARCH_NOT_FOUND;
+}
+
+size_t string_search_find_any_of(const_stringref_type haystack, const_stringref_type characters)
+{
+	const size_t haystack_length = string_search_length(haystack);
+	const size_t number_of_characters = string_search_length(characters);
+	string_search_byte_set_type byte_set;
+	size_t index = 0U;
+
+	if (number_of_characters == 1U) {
+		return string_search_find_char(haystack, characters.string[0]);
+	}
+	if (number_of_characters == 0U) {
+		return STRING_SEARCH_NOT_FOUND;
+	}
+
+	string_search_make_byte_set(&byte_set, characters);
+	for (; index < haystack_length; ++index) {
+		if (string_search_byte_set_contains(&byte_set, haystack.string[index])) {
+			return index;
+		}
+	}
+	return STRING_SEARCH_NOT_FOUND;
+}
+
+size_t string_search_rfind_any_of(const_stringref_type haystack, const_stringref_type characters)
+{
+	const size_t number_of_characters = string_search_length(characters);
+	string_search_byte_set_type byte_set;
+	size_t index = string_search_length(haystack);
+
+	if (number_of_characters == 0U) {
+		return STRING_SEARCH_NOT_FOUND;
+	}
+
+	string_search_make_byte_set(&byte_set, characters);
+	while (index > 0U) {
+		--index;
+		if (string_search_byte_set_contains(&byte_set, haystack.string[index])) {
+			return index;
+		}
+	}
+	return STRING_SEARCH_NOT_FOUND;
+}
+
+size_t string_search_find_none_of(const_stringref_type haystack, const_stringref_type characters)
+{
+	const size_t haystack_length = string_search_length(haystack);
+	string_search_byte_set_type byte_set;
+	size_t index = 0U;
+
+	string_search_make_byte_set(&byte_set, string_to_const_stringref(characters.string, string_search_length(characters)));
+	for (; index < haystack_length; ++index) {
+		if (not string_search_byte_set_contains(&byte_set, haystack.string[index])) {
+			return index;
+		}
+	}
+	return STRING_SEARCH_NOT_FOUND;
+}
+
+void string_searcher_init(string_searcher_type *searcher, const_stringref_type needle)
+{
+	size_t needle_length = 0U;
+	size_t i = 0U;
+
+	assert(searcher != NULL);
+	needle_length = string_search_length(needle);
+	searcher->needle = string_to_const_stringref(needle.string, needle_length);
+	searcher->critical_position = 0U;
+	searcher->period = 1U;
+	searcher->is_periodic = Boolean_true;
+	if (needle_length > 0U) {
+		const string_search_factorization_type factorization = string_search_factorize(needle.string, needle_length, Boolean_false);
+		searcher->critical_position = factorization.critical_position;
+		searcher->period = factorization.period;
+		searcher->is_periodic = factorization.is_periodic;
+	}
+
+	for (i = 0U; i < sizeof_array(searcher->shift_table); ++i) {
+		searcher->shift_table[i] = needle_length;
+	}
+	for (i = 0U; i < needle_length; ++i) {
+		searcher->shift_table[(unsigned char) needle.string[i]] = needle_length - i - 1U;
+	}
+}
+
+size_t string_searcher_find(const string_searcher_type *searcher, const_stringref_type haystack)
+{
+	const size_t haystack_length = string_search_length(haystack);
+	const size_t needle_length = searcher->needle.length;
+	string_search_factorization_type factorization;
+
+	assert(searcher != NULL);
+	if (needle_length == 0U) {
+		return 0U;
+	}
+	if (needle_length > haystack_length) {
+		return STRING_SEARCH_NOT_FOUND;
+	}
+	if (needle_length == 1U) {
+		return string_search_find_char(haystack, searcher->needle.string[0]);
+	}
+
+	factorization.critical_position = searcher->critical_position;
+	factorization.period = searcher->period;
+	factorization.is_periodic = searcher->is_periodic;
+	return string_search_find_with_prefilter(haystack.string, haystack_length, searcher->needle.string, needle_length,
+		&factorization, searcher->shift_table);
+}
@@ -0,0 +1,77 @@
+/* Minimum C Standard: C89 */
+
+#ifndef STRING_SEARCH_H
+#define STRING_SEARCH_H
+
+#include "Boolean_type.h"
+#include "string_reference.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+Search functions for string references.
+
+The functions search the contents of the string references, i.e. all the bytes up to the length of each reference,
+including any '\0'. A string reference with a null pointer is treated as an empty string.
+The results are byte offsets from the start of the haystack, or STRING_SEARCH_NOT_FOUND.
+
+Substring search takes O(n + m) time in the worst case, where n is the length of the haystack and m is the length
+of the needle, and uses O(1) extra memory:
+- A needle of one byte is found with memchr.
+- Longer needles are found with memchr on their first byte, and each candidate position is verified with memcmp.
+  If the candidates turn out to be too frequent, the search switches to the Two-Way algorithm of Crochemore and Perrin.
+- The same needle can be searched for repeatedly with a string_searcher_type, which precomputes the critical
+  factorization of the needle and a table of shifts for the Two-Way algorithm.
+*/
+
+#define STRING_SEARCH_NOT_FOUND ((size_t) -1)
+
+/* Returns the offset of the first occurrence of the needle in the haystack. An empty needle is found at offset 0. */
+size_t string_search_find(const_stringref_type haystack, const_stringref_type needle);
+
+/* Returns the offset of the last occurrence of the needle in the haystack. An empty needle is found at the end. */
+size_t string_search_rfind(const_stringref_type haystack, const_stringref_type needle);
+
+/* Returns the offset of the first occurrence of the character in the haystack. */
+size_t string_search_find_char(const_stringref_type haystack, char character);
+
+/* Returns the offset of the last occurrence of the character in the haystack. */
+size_t string_search_rfind_char(const_stringref_type haystack, char character);
+
+/* Returns the offset of the first byte of the haystack which is one of the characters. */
+size_t string_search_find_any_of(const_stringref_type haystack, const_stringref_type characters);
+
+/* Returns the offset of the last byte of the haystack which is one of the characters. */
+size_t string_search_rfind_any_of(const_stringref_type haystack, const_stringref_type characters);
+
+/* Returns the offset of the first byte of the haystack which is none of the characters. */
+size_t string_search_find_none_of(const_stringref_type haystack, const_stringref_type characters);
+
+/*
+A searcher holds the precomputed data for searching a needle in many haystacks.
+The needle is referenced, not copied, so it must outlive the searcher.
+The searcher is about 2 KiB large because of the table of shifts, so it is not meant for one-off searches.
+*/
+typedef struct string_searcher_type
+{
+	const_stringref_type needle;
+	size_t critical_position; /* start of the right half of the critical factorization */
+	size_t period; /* period of the needle if is_periodic is true, otherwise a safe shift */
+	Boolean_type is_periodic;
+	size_t shift_table[256]; /* distance from the last occurrence of each byte to the end of the needle */
+} string_searcher_type;
+
+/* Initializes a searcher for the needle in O(m) time. */
+void string_searcher_init(string_searcher_type *searcher, const_stringref_type needle);
+
+/* Returns the offset of the first occurrence of the needle of the searcher in the haystack. */
+size_t string_searcher_find(const string_searcher_type *searcher, const_stringref_type haystack);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,206 @@
+#include "string_search.h"
+#include "sizeof_array.h"
+#include "unit_testing.h"
+
+#include <iso646.h>
+#include <string.h>
+
+static const_stringref_type make_stringref(const char *string)
+{
+	return string_to_const_stringref(string, strlen(string));
+}
+
+static size_t naive_find(const char *haystack, size_t haystack_length, const char *needle, size_t needle_length)
+{
+	size_t position = 0U;
+	for (; position + needle_length <= haystack_length; ++position) {
+		if (memcmp(haystack + position, needle, needle_length) == 0) {
+			return position;
+		}
+	}
+	return STRING_SEARCH_NOT_FOUND;
+}
+
+static size_t naive_rfind(const char *haystack, size_t haystack_length, const char *needle, size_t needle_length)
+{
+	size_t position = haystack_length - needle_length + 1U;
+	if (needle_length > haystack_length) {
+		return STRING_SEARCH_NOT_FOUND;
+	}
+	while (position > 0U) {
+		--position;
+		if (memcmp(haystack + position, needle, needle_length) == 0) {
+			return position;
+		}
+	}
+	return STRING_SEARCH_NOT_FOUND;
+}
+
+static unsigned long next_random_number(unsigned long *state)
+{
+	*state = (*state * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+	return *state >> 16U;
+}
+
+TEST(string_search_find_basic, "string_search_find finds the first occurrence")
+{
+	const_stringref_type haystack = make_stringref("the cat sat on the mat");
+
+	ASSERT_SIZE_EQUAL(string_search_find(haystack, make_stringref("the")), 0U);
+	ASSERT_SIZE_EQUAL(string_search_find(haystack, make_stringref("at")), 5U);
+	ASSERT_SIZE_EQUAL(string_search_find(haystack, make_stringref("mat")), 19U);
+	ASSERT_SIZE_EQUAL(string_search_find(haystack, make_stringref("t")), 0U);
+	ASSERT_SIZE_EQUAL(string_search_find(haystack, make_stringref("dog")), STRING_SEARCH_NOT_FOUND);
+	ASSERT_SIZE_EQUAL(string_search_find(haystack, make_stringref("the cat sat on the mat!")), STRING_SEARCH_NOT_FOUND);
+}
+
+TEST(string_search_find_empty_and_null, "string_search_find with empty strings and null pointers")
+{
+	const_stringref_type haystack = make_stringref("abc");
+	const_stringref_type null_ref = string_to_const_stringref(NULL, 3U);
+
+	ASSERT_SIZE_EQUAL(string_search_find(haystack, make_stringref("")), 0U);
+	ASSERT_SIZE_EQUAL(string_search_rfind(haystack, make_stringref("")), 3U);
+	ASSERT_SIZE_EQUAL(string_search_find(make_stringref(""), make_stringref("")), 0U);
+	ASSERT_SIZE_EQUAL(string_search_find(null_ref, make_stringref("a")), STRING_SEARCH_NOT_FOUND);
+	ASSERT_SIZE_EQUAL(string_search_find(haystack, null_ref), 0U);
+	ASSERT_SIZE_EQUAL(string_search_rfind(null_ref, make_stringref("a")), STRING_SEARCH_NOT_FOUND);
+	ASSERT_SIZE_EQUAL(string_search_find_char(null_ref, 'a'), STRING_SEARCH_NOT_FOUND);
+	ASSERT_SIZE_EQUAL(string_search_rfind_char(null_ref, 'a'), STRING_SEARCH_NOT_FOUND);
+}
+
+TEST(string_search_find_null_bytes, "string_search_find searches the contents including null bytes")
+{
+	const char haystack_string[] = "ab\0cd\0cd";
+	const char needle_string[] = "\0cd";
+	const_stringref_type haystack = string_to_const_stringref(haystack_string, sizeof_array(haystack_string) - 1U);
+	const_stringref_type needle = string_to_const_stringref(needle_string, sizeof_array(needle_string) - 1U);
+
+	ASSERT_SIZE_EQUAL(string_search_find(haystack, needle), 2U);
+	ASSERT_SIZE_EQUAL(string_search_rfind(haystack, needle), 5U);
+	ASSERT_SIZE_EQUAL(string_search_find_char(haystack, '\0'), 2U);
+	ASSERT_SIZE_EQUAL(string_search_rfind_char(haystack, '\0'), 5U);
+}
+
+TEST(string_search_rfind_basic, "string_search_rfind finds the last occurrence")
+{
+	const_stringref_type haystack = make_stringref("the cat sat on the mat");
+
+	ASSERT_SIZE_EQUAL(string_search_rfind(haystack, make_stringref("the")), 15U);
+	ASSERT_SIZE_EQUAL(string_search_rfind(haystack, make_stringref("at")), 20U);
+	ASSERT_SIZE_EQUAL(string_search_rfind(haystack, make_stringref("the cat")), 0U);
+	ASSERT_SIZE_EQUAL(string_search_rfind(haystack, make_stringref("t")), 21U);
+	ASSERT_SIZE_EQUAL(string_search_rfind(haystack, make_stringref("dog")), STRING_SEARCH_NOT_FOUND);
+}
+
+TEST(string_search_find_periodic_needles, "string_search_find with periodic needles in repetitive text")
+{
+	char haystack_string[2000];
+	const_stringref_type haystack = string_to_const_stringref(haystack_string, sizeof(haystack_string));
+	string_searcher_type searcher;
+
+	memset(haystack_string, 'a', sizeof(haystack_string));
+	haystack_string[sizeof(haystack_string) - 1U] = 'b';
+	ASSERT_SIZE_EQUAL(string_search_find(haystack, make_stringref("aaaaaaaaab")), sizeof(haystack_string) - 10U);
+	ASSERT_SIZE_EQUAL(string_search_find(haystack, make_stringref("aaaaaaaaac")), STRING_SEARCH_NOT_FOUND);
+	ASSERT_SIZE_EQUAL(string_search_rfind(haystack, make_stringref("baaaaa")), STRING_SEARCH_NOT_FOUND);
+	ASSERT_SIZE_EQUAL(string_search_rfind(haystack, make_stringref("aaaaab")), sizeof(haystack_string) - 6U);
+	ASSERT_SIZE_EQUAL(string_search_rfind(haystack, make_stringref("aaaaa")), sizeof(haystack_string) - 6U);
+
+	string_searcher_init(&searcher, make_stringref("aaaaaaaaab"));
+	ASSERT_SIZE_EQUAL(string_searcher_find(&searcher, haystack), sizeof(haystack_string) - 10U);
+	string_searcher_init(&searcher, make_stringref("abaaaaaaaa"));
+	ASSERT_SIZE_EQUAL(string_searcher_find(&searcher, haystack), STRING_SEARCH_NOT_FOUND);
+}
+
+TEST(string_search_find_random_strings, "string_search_find, string_search_rfind and string_searcher_find agree with naive search")
+{
+	char haystack_string[128];
+	char needle_string[12];
+	unsigned long state = 12345UL;
+	int iteration = 0;
+
+	for (iteration = 0; iteration < 20000; ++iteration) {
+		/* small alphabets produce many partial matches and periodic needles */
+		const unsigned long alphabet_size = 2UL + next_random_number(&state) % 3UL;
+		const size_t haystack_length = (size_t) (next_random_number(&state) % sizeof(haystack_string));
+		const size_t needle_length = 1U + (size_t) (next_random_number(&state) % sizeof(needle_string));
+		const_stringref_type haystack = string_to_const_stringref(haystack_string, haystack_length);
+		const_stringref_type needle = string_to_const_stringref(needle_string, needle_length);
+		string_searcher_type searcher;
+		size_t i = 0U;
+
+		for (i = 0U; i < haystack_length; ++i) {
+			haystack_string[i] = (char) ('a' + next_random_number(&state) % alphabet_size);
+		}
+		for (i = 0U; i < needle_length; ++i) {
+			needle_string[i] = (char) ('a' + next_random_number(&state) % alphabet_size);
+		}
+
+		string_searcher_init(&searcher, needle);
+		ASSERT_SIZE_EQUAL(string_search_find(haystack, needle), naive_find(haystack_string, haystack_length, needle_string, needle_length));
+		ASSERT_SIZE_EQUAL(string_search_rfind(haystack, needle), naive_rfind(haystack_string, haystack_length, needle_string, needle_length));
+		ASSERT_SIZE_EQUAL(string_searcher_find(&searcher, haystack), naive_find(haystack_string, haystack_length, needle_string, needle_length));
+	}
+}
+
+TEST(string_searcher_find_repeated, "string_searcher_find with the same needle in different haystacks")
+{
+	string_searcher_type searcher;
+	string_searcher_init(&searcher, make_stringref("needle"));
+
+	ASSERT_SIZE_EQUAL(string_searcher_find(&searcher, make_stringref("a needle in a haystack")), 2U);
+	ASSERT_SIZE_EQUAL(string_searcher_find(&searcher, make_stringref("needles")), 0U);
+	ASSERT_SIZE_EQUAL(string_searcher_find(&searcher, make_stringref("noodle")), STRING_SEARCH_NOT_FOUND);
+	ASSERT_SIZE_EQUAL(string_searcher_find(&searcher, make_stringref("needl")), STRING_SEARCH_NOT_FOUND);
+	ASSERT_SIZE_EQUAL(string_searcher_find(&searcher, make_stringref("the last one is a needle")), 18U);
+
+	string_searcher_init(&searcher, make_stringref(""));
+	ASSERT_SIZE_EQUAL(string_searcher_find(&searcher, make_stringref("abc")), 0U);
+	string_searcher_init(&searcher, make_stringref("c"));
+	ASSERT_SIZE_EQUAL(string_searcher_find(&searcher, make_stringref("abc")), 2U);
+}
+
+TEST(string_search_find_any_of_test, "string_search_find_any_of and string_search_rfind_any_of")
+{
+	const_stringref_type haystack = make_stringref("key = value; other = 42");
+
+	ASSERT_SIZE_EQUAL(string_search_find_any_of(haystack, make_stringref("=;")), 4U);
+	ASSERT_SIZE_EQUAL(string_search_rfind_any_of(haystack, make_stringref("=;")), 19U);
+	ASSERT_SIZE_EQUAL(string_search_find_any_of(haystack, make_stringref(";")), 11U);
+	ASSERT_SIZE_EQUAL(string_search_find_any_of(haystack, make_stringref("0123456789")), 21U);
+	ASSERT_SIZE_EQUAL(string_search_rfind_any_of(haystack, make_stringref("0123456789")), 22U);
+	ASSERT_SIZE_EQUAL(string_search_find_any_of(haystack, make_stringref("#!")), STRING_SEARCH_NOT_FOUND);
+	ASSERT_SIZE_EQUAL(string_search_find_any_of(haystack, make_stringref("")), STRING_SEARCH_NOT_FOUND);
+	ASSERT_SIZE_EQUAL(string_search_rfind_any_of(haystack, make_stringref("")), STRING_SEARCH_NOT_FOUND);
+	ASSERT_SIZE_EQUAL(string_search_find_any_of(make_stringref("\xC3\xA9t\xC3\xA9"), make_stringref("\xA9")), 1U);
+}
+
+TEST(string_search_find_none_of_test, "string_search_find_none_of skips the characters")
+{
+	ASSERT_SIZE_EQUAL(string_search_find_none_of(make_stringref("   \tvalue"), make_stringref(" \t")), 4U);
+	ASSERT_SIZE_EQUAL(string_search_find_none_of(make_stringref("value"), make_stringref(" \t")), 0U);
+	ASSERT_SIZE_EQUAL(string_search_find_none_of(make_stringref("  \t "), make_stringref(" \t")), STRING_SEARCH_NOT_FOUND);
+	ASSERT_SIZE_EQUAL(string_search_find_none_of(make_stringref("value"), make_stringref("")), 0U);
+	ASSERT_SIZE_EQUAL(string_search_find_none_of(make_stringref(""), make_stringref("")), STRING_SEARCH_NOT_FOUND);
+}
+
+int main(void)
+{
+	DEFINE_LIST_OF_TESTS(list_of_tests) {
+		string_search_find_basic,
+		string_search_find_empty_and_null,
+		string_search_find_null_bytes,
+		string_search_rfind_basic,
+		string_search_find_periodic_needles,
+		string_search_find_random_strings,
+		string_searcher_find_repeated,
+		string_search_find_any_of_test,
+		string_search_find_none_of_test
+	};
+
+	PRINT_FILE_NAME();
+	RUN_TESTS(list_of_tests);
+	PRINT_TEST_STATISTICS(list_of_tests);
+	return 0;
+}
@@ -0,0 +1,208 @@
+#include "string_split.h"
+#include "string_search.h"
+#include <assert.h>
+#include <iso646.h>
+#include <string.h>
+
+/* Notes:
+- The iterator keeps the rest of the string after the last delimiter found. Each call of string_split_next searches
+  the rest once, so iterating over all the pieces takes the time of one search through the string.
+- A set of one character is split like a single character, because memchr is faster than the table of bits.
+- The join functions compute the exact length first, so the output is written once without any reallocation.
+*/
+
+static const char string_split_empty_string[] = "";
+
+static const_stringref_type string_split_normalize(const_stringref_type string)
+{
+	if (string.string == NULL) {
+		string.string = string_split_empty_string;
+		string.length = 0U;
+	}
+	return string;
+}
+
+static void string_split_init(string_split_iterator_type *iterator, const_stringref_type string,
+	string_split_delimiter_kind_type delimiter_kind)
+{
+	assert(iterator != NULL);
+	memset(iterator, 0, sizeof(*iterator));
+	iterator->remaining = string_split_normalize(string);
+	iterator->delimiter_kind = delimiter_kind;
+	iterator->is_finished = Boolean_false;
+}
+
+void string_split_by_char_init(string_split_iterator_type *iterator, const_stringref_type string, char delimiter)
+{
+	string_split_init(iterator, string, string_split_delimiter_character);
+	iterator->character = delimiter;
+}
+
+void string_split_by_any_of_init(string_split_iterator_type *iterator, const_stringref_type string, const_stringref_type characters)
+{
+	size_t i = 0U;
+
+	characters = string_split_normalize(characters);
+	if (characters.length == 1U) {
+		string_split_by_char_init(iterator, string, characters.string[0]);
+		return;
+	}
+	string_split_init(iterator, string, string_split_delimiter_any_of);
+	for (; i < characters.length; ++i) {
+		const unsigned char byte = (unsigned char) characters.string[i];
+		iterator->byte_set[byte >> 3U] |= (unsigned char) (1U << (byte & 7U));
+	}
+}
+
+void string_split_by_substring_init(string_split_iterator_type *iterator, const_stringref_type string, const_stringref_type delimiter)
+{
+	string_split_init(iterator, string, string_split_delimiter_substring);
+	iterator->delimiter = string_split_normalize(delimiter);
+}
+
+/* Returns the offset of the next delimiter in the rest of the string and its length. */
+static size_t string_split_find_delimiter(const string_split_iterator_type *iterator, size_t *delimiter_length)
+{
+	const_stringref_type remaining = iterator->remaining;
+	size_t index = 0U;
+
+	*delimiter_length = 1U;
+	switch (iterator->delimiter_kind) {
+	case string_split_delimiter_character:
+		return string_search_find_char(remaining, iterator->character);
+	case string_split_delimiter_any_of:
+		for (; index < remaining.length; ++index) {
+			const unsigned char byte = (unsigned char) remaining.string[index];
+			if ((iterator->byte_set[byte >> 3U] >> (byte & 7U)) & 1U) {
+				return index;
+			}
+		}
+		return STRING_SEARCH_NOT_FOUND;
+	case string_split_delimiter_substring:
+		*delimiter_length = iterator->delimiter.length;
+		if (iterator->delimiter.length == 0U) {
+			return STRING_SEARCH_NOT_FOUND;
+		}
+		return string_search_find(remaining, iterator->delimiter);
+	default:
+		assert(0);
+		return STRING_SEARCH_NOT_FOUND;
+	}
+}
+
+Boolean_type string_split_next(string_split_iterator_type *iterator, const_stringref_type *piece)
+{
+	size_t delimiter_length = 0U;
+	size_t offset = 0U;
+
+	assert(iterator != NULL);
+	assert(piece != NULL);
+	if (iterator->is_finished) {
+		return Boolean_false;
+	}
+
+	offset = string_split_find_delimiter(iterator, &delimiter_length);
+	if (offset == STRING_SEARCH_NOT_FOUND) {
+		*piece = iterator->remaining;
+		iterator->remaining.string += iterator->remaining.length;
+		iterator->remaining.length = 0U;
+		iterator->is_finished = Boolean_true;
+	} else {
+		piece->string = iterator->remaining.string;
+		piece->length = offset;
+		iterator->remaining.string += offset + delimiter_length;
+		iterator->remaining.length -= offset + delimiter_length;
+	}
+	return Boolean_true;
+}
+
+size_t string_split_count(const string_split_iterator_type *iterator)
+{
+	string_split_iterator_type copy;
+	const_stringref_type piece;
+	size_t number_of_pieces = 0U;
+
+	assert(iterator != NULL);
+	copy = *iterator;
+	while (string_split_next(&copy, &piece)) {
+		++number_of_pieces;
+	}
+	return number_of_pieces;
+}
+
+size_t string_join_length(const const_stringref_type *pieces, size_t number_of_pieces, const_stringref_type separator)
+{
+	const size_t max_length = (size_t) -1;
+	const size_t separator_length = (separator.string != NULL) ? separator.length : 0U;
+	size_t length = 0U;
+	size_t i = 0U;
+
+	assert(pieces != NULL or number_of_pieces == 0U);
+	for (; i < number_of_pieces; ++i) {
+		const size_t piece_length = (pieces[i].string != NULL) ? pieces[i].length : 0U;
+		if (i > 0U) {
+			if (separator_length >= max_length - length) {
+				return max_length;
+			}
+			length += separator_length;
+		}
+		if (piece_length >= max_length - length) {
+			return max_length;
+		}
+		length += piece_length;
+	}
+	return length;
+}
+
+static void string_join_write(const const_stringref_type *pieces, size_t number_of_pieces, const_stringref_type separator,
+	char *buffer)
+{
+	size_t i = 0U;
+
+	for (; i < number_of_pieces; ++i) {
+		if (i > 0U and separator.string != NULL and separator.length > 0U) {
+			memcpy(buffer, separator.string, separator.length);
+			buffer += separator.length;
+		}
+		if (pieces[i].string != NULL and pieces[i].length > 0U) {
+			memcpy(buffer, pieces[i].string, pieces[i].length);
+			buffer += pieces[i].length;
+		}
+	}
+	*buffer = '\0';
+}
+
+size_t string_join_to_buffer(const const_stringref_type *pieces, size_t number_of_pieces, const_stringref_type separator,
+	char *buffer, size_t buffer_size)
+{
+	const size_t length = string_join_length(pieces, number_of_pieces, separator);
+
+	assert(buffer != NULL or buffer_size == 0U);
+	if (length == (size_t) -1 or buffer == NULL or buffer_size <= length) {
+		return (size_t) -1;
+	}
+	string_join_write(pieces, number_of_pieces, separator, buffer);
+	return length;
+}
+
+stringref_type string_join(const const_stringref_type *pieces, size_t number_of_pieces, const_stringref_type separator,
+	allocator_type allocator)
+{
+	const size_t length = string_join_length(pieces, number_of_pieces, separator);
+	stringref_type joined_string;
+
+	assert(allocator.allocate != NULL);
+	assert(allocator.deallocate != NULL);
+	joined_string.string = NULL;
+	joined_string.length = 0U;
+	if (length == (size_t) -1) {
+		return joined_string;
+	}
+	/* not zeroed, as the length counts exactly the pieces and separators which string_join_write copies */
+	joined_string.string = (char*) allocator.allocate(length + 1U);
+	if (joined_string.string != NULL) {
+		string_join_write(pieces, number_of_pieces, separator, joined_string.string);
+		joined_string.length = length;
+	}
+	return joined_string;
+}
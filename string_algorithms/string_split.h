@@ -0,0 +1,116 @@
+/* Minimum C Standard: C89 */
+
+#ifndef STRING_SPLIT_H
+#define STRING_SPLIT_H
+
+#include "allocator_type.h"
+#include "Boolean_type.h"
+#include "string_reference.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+Split iterators and join functions for string references.
+
+A split iterator yields the pieces of a string between delimiters as string references into the original string.
+Nothing is copied and no memory is allocated, so the string must outlive the pieces.
+The delimiter is a character, any character of a set, or a substring.
+
+The pieces follow the same rules for every kind of delimiter:
+- A string with n delimiters has n + 1 pieces. Adjacent delimiters give an empty piece between them,
+  and a delimiter at the start or the end gives an empty piece at the start or the end.
+- An empty string has one empty piece.
+- An empty substring or an empty set of characters never matches, so the whole string is one piece.
+
+The contents of the string references are used, i.e. all the bytes up to the length of each reference,
+including any '\0'. A string reference with a null pointer is treated as an empty string.
+
+Example:
+	string_split_iterator_type iterator;
+	const_stringref_type piece;
+	string_split_by_char_init(&iterator, line, ',');
+	while (string_split_next(&iterator, &piece)) {
+		process_field(piece);
+	}
+*/
+
+typedef enum string_split_delimiter_kind_type
+{
+	string_split_delimiter_character,
+	string_split_delimiter_any_of,
+	string_split_delimiter_substring
+} string_split_delimiter_kind_type;
+
+typedef struct string_split_iterator_type
+{
+	const_stringref_type remaining; /* the bytes after the last delimiter found */
+	const_stringref_type delimiter; /* the substring delimiter; unused for a character or a set of characters */
+	unsigned char byte_set[32]; /* bit i is set if the byte i is in the set of characters */
+	char character;
+	string_split_delimiter_kind_type delimiter_kind;
+	Boolean_type is_finished;
+} string_split_iterator_type;
+
+/* Initializes an iterator over the pieces of a string separated by a character. */
+void string_split_by_char_init(string_split_iterator_type *iterator, const_stringref_type string, char delimiter);
+
+/*
+Initializes an iterator over the pieces of a string separated by any of the characters. Each character found is a
+delimiter of its own, e.g. splitting "a, b" by ", " gives "a", "" and "b". The characters are copied into the iterator.
+*/
+void string_split_by_any_of_init(string_split_iterator_type *iterator, const_stringref_type string, const_stringref_type characters);
+
+/*
+Initializes an iterator over the pieces of a string separated by a substring. The substring is referenced, not copied,
+so it must outlive the iterator. Occurrences of the substring do not overlap, they are found from left to right.
+*/
+void string_split_by_substring_init(string_split_iterator_type *iterator, const_stringref_type string, const_stringref_type delimiter);
+
+/*
+Finds the next piece.
+
+Parameters:
+iterator: An initialized iterator. Must not be null.
+piece   : Receives the next piece. Must not be null.
+
+Return value: Boolean_true if a piece is found, Boolean_false if all the pieces have been returned.
+*/
+Boolean_type string_split_next(string_split_iterator_type *iterator, const_stringref_type *piece);
+
+/* Returns the number of pieces which string_split_next has not returned yet. The iterator is not modified. */
+size_t string_split_count(const string_split_iterator_type *iterator);
+
+/*
+Returns the length of the strings joined with the separator between each two of them, excluding the null terminator.
+Returns (size_t) -1 if the length is not representable by size_t.
+The pieces may be null if number_of_pieces is zero.
+*/
+size_t string_join_length(const const_stringref_type *pieces, size_t number_of_pieces, const_stringref_type separator);
+
+/*
+Joins the strings with the separator between each two of them into a buffer, followed by a null terminator.
+Each byte is written once. If the buffer is too small, nothing is written.
+
+Return value: The length of the joined string, or (size_t) -1 if buffer_size is not greater than the length.
+*/
+size_t string_join_to_buffer(const const_stringref_type *pieces, size_t number_of_pieces, const_stringref_type separator,
+	char *buffer, size_t buffer_size);
+
+/*
+Joins the strings with the separator between each two of them into a new memory block of the exact size,
+followed by a null terminator. The memory block is allocated by the allocator and must be deallocated by its
+'deallocate' function.
+
+Return value: The joined string, or a string reference with a null pointer if there is not enough memory.
+*/
+stringref_type string_join(const const_stringref_type *pieces, size_t number_of_pieces, const_stringref_type separator,
+	allocator_type allocator);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
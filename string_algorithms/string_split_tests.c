@@ -0,0 +1,180 @@
+#include "string_split.h"
+#include "sizeof_array.h"
+#include "unit_testing.h"
+
+#include <iso646.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const_stringref_type make_stringref(const char *string)
+{
+	return string_to_const_stringref(string, strlen(string));
+}
+
+/* Checks that the iterator yields the expected pieces, which are given as a string separated by '|'. */
+static Boolean_type pieces_are(string_split_iterator_type *iterator, const char *expected_pieces)
+{
+	const_stringref_type piece;
+	const char *expected = expected_pieces;
+	Boolean_type is_last = Boolean_false;
+
+	while (not is_last) {
+		const char *end = strchr(expected, '|');
+		size_t expected_length = 0U;
+		if (end == NULL) {
+			end = expected + strlen(expected);
+			is_last = Boolean_true;
+		}
+		expected_length = (size_t) (end - expected);
+		if (not string_split_next(iterator, &piece) or piece.length != expected_length or
+			memcmp(piece.string, expected, expected_length) != 0) {
+			return Boolean_false;
+		}
+		expected = end + 1;
+	}
+	return string_split_next(iterator, &piece) ? Boolean_false : Boolean_true;
+}
+
+TEST(string_split_by_char_test, "Splitting by a character")
+{
+	string_split_iterator_type iterator;
+
+	string_split_by_char_init(&iterator, make_stringref("a,b,c"), ',');
+	ASSERT_SIZE_EQUAL(string_split_count(&iterator), 3U);
+	ASSERT(pieces_are(&iterator, "a|b|c"));
+	string_split_by_char_init(&iterator, make_stringref(",a,,b,"), ',');
+	ASSERT(pieces_are(&iterator, "|a||b|"));
+	string_split_by_char_init(&iterator, make_stringref("abc"), ',');
+	ASSERT(pieces_are(&iterator, "abc"));
+	string_split_by_char_init(&iterator, make_stringref(""), ',');
+	ASSERT_SIZE_EQUAL(string_split_count(&iterator), 1U);
+	ASSERT(pieces_are(&iterator, ""));
+	string_split_by_char_init(&iterator, string_to_const_stringref(NULL, 3U), ',');
+	ASSERT(pieces_are(&iterator, ""));
+	string_split_by_char_init(&iterator, string_to_const_stringref("a\0b", 3U), '\0');
+	ASSERT(pieces_are(&iterator, "a|b"));
+}
+
+TEST(string_split_pieces_reference_the_string, "The pieces point into the original string")
+{
+	const char string[] = "key=value";
+	string_split_iterator_type iterator;
+	const_stringref_type piece;
+
+	string_split_by_char_init(&iterator, make_stringref(string), '=');
+	ASSERT(string_split_next(&iterator, &piece));
+	ASSERT(piece.string == string);
+	ASSERT(string_split_next(&iterator, &piece));
+	ASSERT(piece.string == string + 4);
+	ASSERT_SIZE_EQUAL(piece.length, 5U);
+	ASSERT(not string_split_next(&iterator, &piece));
+	ASSERT(not string_split_next(&iterator, &piece));
+}
+
+TEST(string_split_by_any_of_test, "Splitting by any of a set of characters")
+{
+	string_split_iterator_type iterator;
+
+	string_split_by_any_of_init(&iterator, make_stringref("a b\tc\nd"), make_stringref(" \t\n"));
+	ASSERT_SIZE_EQUAL(string_split_count(&iterator), 4U);
+	ASSERT(pieces_are(&iterator, "a|b|c|d"));
+	string_split_by_any_of_init(&iterator, make_stringref("a, b"), make_stringref(", "));
+	ASSERT(pieces_are(&iterator, "a||b"));
+	string_split_by_any_of_init(&iterator, make_stringref("a;b"), make_stringref(";"));
+	ASSERT(pieces_are(&iterator, "a|b"));
+	string_split_by_any_of_init(&iterator, make_stringref("a b"), make_stringref(""));
+	ASSERT(pieces_are(&iterator, "a b"));
+	string_split_by_any_of_init(&iterator, make_stringref("\xFF" "a" "\x80"), make_stringref("\x80\xFF"));
+	ASSERT(pieces_are(&iterator, "|a|"));
+}
+
+TEST(string_split_by_substring_test, "Splitting by a substring")
+{
+	string_split_iterator_type iterator;
+
+	string_split_by_substring_init(&iterator, make_stringref("one\r\ntwo\r\n\r\nthree"), make_stringref("\r\n"));
+	ASSERT_SIZE_EQUAL(string_split_count(&iterator), 4U);
+	ASSERT(pieces_are(&iterator, "one|two||three"));
+	string_split_by_substring_init(&iterator, make_stringref("aaaaa"), make_stringref("aa"));
+	ASSERT(pieces_are(&iterator, "||a"));
+	string_split_by_substring_init(&iterator, make_stringref("abc"), make_stringref(""));
+	ASSERT(pieces_are(&iterator, "abc"));
+	string_split_by_substring_init(&iterator, make_stringref("abc"), make_stringref("abcd"));
+	ASSERT(pieces_are(&iterator, "abc"));
+	string_split_by_substring_init(&iterator, make_stringref("--"), make_stringref("--"));
+	ASSERT(pieces_are(&iterator, "|"));
+}
+
+TEST(string_join_to_buffer_test, "Joining into a buffer")
+{
+	const_stringref_type pieces[3];
+	char buffer[16];
+
+	pieces[0] = make_stringref("a");
+	pieces[1] = make_stringref("");
+	pieces[2] = make_stringref("bc");
+	ASSERT_SIZE_EQUAL(string_join_length(pieces, 3U, make_stringref(", ")), 7U);
+	ASSERT_SIZE_EQUAL(string_join_to_buffer(pieces, 3U, make_stringref(", "), buffer, sizeof(buffer)), 7U);
+	ASSERT_EQUAL(strcmp(buffer, "a, , bc"), 0);
+	ASSERT_SIZE_EQUAL(string_join_to_buffer(pieces, 3U, string_to_const_stringref(NULL, 0U), buffer, sizeof(buffer)), 3U);
+	ASSERT_EQUAL(strcmp(buffer, "abc"), 0);
+	ASSERT_SIZE_EQUAL(string_join_to_buffer(pieces, 1U, make_stringref(", "), buffer, sizeof(buffer)), 1U);
+	ASSERT_EQUAL(strcmp(buffer, "a"), 0);
+	ASSERT_SIZE_EQUAL(string_join_to_buffer(NULL, 0U, make_stringref(", "), buffer, sizeof(buffer)), 0U);
+	ASSERT_EQUAL(strcmp(buffer, ""), 0);
+
+	/* the buffer must have room for the null terminator, otherwise nothing is written */
+	strcpy(buffer, "unchanged");
+	ASSERT_SIZE_EQUAL(string_join_to_buffer(pieces, 3U, make_stringref(", "), buffer, 7U), (size_t) -1);
+	ASSERT_EQUAL(strcmp(buffer, "unchanged"), 0);
+	ASSERT_SIZE_EQUAL(string_join_to_buffer(pieces, 3U, make_stringref(", "), buffer, 8U), 7U);
+}
+
+TEST(string_join_length_overflow, "string_join_length detects an overflow")
+{
+	const_stringref_type pieces[2];
+
+	pieces[0] = string_to_const_stringref("x", (size_t) -1 / 2U);
+	pieces[1] = string_to_const_stringref("x", (size_t) -1 / 2U);
+	ASSERT_SIZE_EQUAL(string_join_length(pieces, 2U, make_stringref("")), (size_t) -1 - 1U);
+	ASSERT_SIZE_EQUAL(string_join_length(pieces, 2U, make_stringref("--")), (size_t) -1);
+}
+
+TEST(string_join_allocates_exact_size, "string_join allocates the exact size and round trips with split")
+{
+	allocator_type allocator = {&malloc, &realloc, &free};
+	const char *csv = "alpha,beta,,gamma";
+	const_stringref_type pieces[8];
+	size_t number_of_pieces = 0U;
+	string_split_iterator_type iterator;
+	stringref_type joined;
+
+	string_split_by_char_init(&iterator, make_stringref(csv), ',');
+	while (number_of_pieces < sizeof_array(pieces) and string_split_next(&iterator, &pieces[number_of_pieces])) {
+		++number_of_pieces;
+	}
+	ASSERT_SIZE_EQUAL(number_of_pieces, 4U);
+	joined = string_join(pieces, number_of_pieces, make_stringref(","), allocator);
+	ASSERT(joined.string != NULL);
+	ASSERT_SIZE_EQUAL(joined.length, strlen(csv));
+	ASSERT_EQUAL(strcmp(joined.string, csv), 0);
+	free(joined.string);
+}
+
+int main(void)
+{
+	DEFINE_LIST_OF_TESTS(list_of_tests) {
+		string_split_by_char_test,
+		string_split_pieces_reference_the_string,
+		string_split_by_any_of_test,
+		string_split_by_substring_test,
+		string_join_to_buffer_test,
+		string_join_length_overflow,
+		string_join_allocates_exact_size
+	};
+
+	PRINT_FILE_NAME();
+	RUN_TESTS(list_of_tests);
+	PRINT_TEST_STATISTICS(list_of_tests);
+	return 0;
+}
@@ -0,0 +1,242 @@
+#include "string_transform.h"
+#include "fixed_width_integer_types.h"
+#include <assert.h>
+#include <iso646.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define STRING_TRANSFORM_USE_AVX2 1
+#define STRING_TRANSFORM_BLOCK_SIZE 32U
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define STRING_TRANSFORM_USE_SSE2 1
+#define STRING_TRANSFORM_BLOCK_SIZE 16U
+#endif
+
+/* Notes:
+- A string is reversed by loading a block from each end, reversing the bytes of both blocks and storing each block
+  at the other end. The blocks move towards the middle. The part in the middle which is shorter than two blocks is
+  reversed with 64-bit words, then byte by byte.
+- The bytes of a 64-bit word are reversed by swapping adjacent bytes, then adjacent pairs of bytes, then the halves.
+  Reversing all the bytes of a word has the same effect on its bytes in memory on every byte order, and so has
+  swapping the bytes within its 2-byte and 4-byte parts, so the words are loaded with memcpy in the native order.
+- SSE2 has no byte shuffle, so bytes are swapped within 16-bit lanes with shifts, and 16-bit lanes with shuffles.
+  AVX2 shuffles bytes within each 128-bit lane with _mm256_shuffle_epi8.
+*/
+
+#define STRING_TRANSFORM_UINT64(high, low) ((((uint64_t) (high)) << 32U) | (uint64_t) (low))
+
+static uint64_t string_transform_swap_bytes_of_words(uint64_t word, size_t word_size)
+{
+	const uint64_t byte_mask = STRING_TRANSFORM_UINT64(0x00FF00FFU, 0x00FF00FFU);
+	const uint64_t pair_mask = STRING_TRANSFORM_UINT64(0x0000FFFFU, 0x0000FFFFU);
+
+	word = ((word & byte_mask) << 8U) | ((word >> 8U) & byte_mask);
+	if (word_size >= 4U) {
+		word = ((word & pair_mask) << 16U) | ((word >> 16U) & pair_mask);
+	}
+	if (word_size >= 8U) {
+		word = (word << 32U) | (word >> 32U);
+	}
+	return word;
+}
+
+static uint64_t string_transform_load64(const char *p)
+{
+	uint64_t word = 0U;
+	memcpy(&word, p, sizeof(word));
+	return word;
+}
+
+static void string_transform_store64(char *p, uint64_t word)
+{
+	memcpy(p, &word, sizeof(word));
+}
+
+#if defined(STRING_TRANSFORM_USE_AVX2)
+
+typedef __m256i string_transform_vector_type;
+
+static string_transform_vector_type string_transform_load(const char *p)
+{
+	return _mm256_loadu_si256((const __m256i*) (const void*) p);
+}
+
+static void string_transform_store(char *p, string_transform_vector_type vector)
+{
+	_mm256_storeu_si256((__m256i*) (void*) p, vector);
+}
+
+static string_transform_vector_type string_transform_reverse_vector(string_transform_vector_type vector)
+{
+	const __m256i reverse_within_lanes = _mm256_setr_epi8(
+		15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+		15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	vector = _mm256_shuffle_epi8(vector, reverse_within_lanes);
+	return _mm256_permute4x64_epi64(vector, _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+static void string_transform_swap_byte_order_of_blocks(char *p, size_t number_of_blocks, size_t word_size)
+{
+	unsigned char shuffle_bytes[32];
+	__m256i shuffle;
+	size_t i = 0U;
+
+	for (i = 0U; i < sizeof(shuffle_bytes); ++i) {
+		const size_t index_in_lane = i % 16U;
+		shuffle_bytes[i] = (unsigned char) (index_in_lane / word_size * word_size + (word_size - 1U - index_in_lane % word_size));
+	}
+	shuffle = _mm256_loadu_si256((const __m256i*) (const void*) shuffle_bytes);
+	for (i = 0U; i < number_of_blocks; ++i) {
+		char *block = p + i * STRING_TRANSFORM_BLOCK_SIZE;
+		string_transform_store(block, _mm256_shuffle_epi8(string_transform_load(block), shuffle));
+	}
+}
+
+#elif defined(STRING_TRANSFORM_USE_SSE2)
+
+typedef __m128i string_transform_vector_type;
+
+static string_transform_vector_type string_transform_load(const char *p)
+{
+	return _mm_loadu_si128((const __m128i*) (const void*) p);
+}
+
+static void string_transform_store(char *p, string_transform_vector_type vector)
+{
+	_mm_storeu_si128((__m128i*) (void*) p, vector);
+}
+
+static __m128i string_transform_swap_adjacent_bytes(__m128i vector)
+{
+	return _mm_or_si128(_mm_slli_epi16(vector, 8), _mm_srli_epi16(vector, 8));
+}
+
+static string_transform_vector_type string_transform_reverse_vector(string_transform_vector_type vector)
+{
+	vector = string_transform_swap_adjacent_bytes(vector);
+	vector = _mm_shufflelo_epi16(vector, _MM_SHUFFLE(0, 1, 2, 3));
+	vector = _mm_shufflehi_epi16(vector, _MM_SHUFFLE(0, 1, 2, 3));
+	return _mm_shuffle_epi32(vector, _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+static void string_transform_swap_byte_order_of_blocks(char *p, size_t number_of_blocks, size_t word_size)
+{
+	size_t i = 0U;
+
+	for (; i < number_of_blocks; ++i) {
+		char *block = p + i * STRING_TRANSFORM_BLOCK_SIZE;
+		__m128i vector = string_transform_swap_adjacent_bytes(string_transform_load(block));
+		if (word_size == 4U) {
+			vector = _mm_shufflelo_epi16(vector, _MM_SHUFFLE(2, 3, 0, 1));
+			vector = _mm_shufflehi_epi16(vector, _MM_SHUFFLE(2, 3, 0, 1));
+		} else if (word_size == 8U) {
+			vector = _mm_shufflelo_epi16(vector, _MM_SHUFFLE(0, 1, 2, 3));
+			vector = _mm_shufflehi_epi16(vector, _MM_SHUFFLE(0, 1, 2, 3));
+		}
+		string_transform_store(block, vector);
+	}
+}
+
+#endif
+
+void string_transform_reverse(stringref_type string)
+{
+	char *p = string.string;
+	size_t front = 0U;
+	size_t back = string.length;
+
+	if (p == NULL) {
+		return;
+	}
+#if defined(STRING_TRANSFORM_BLOCK_SIZE)
+	while (back - front >= 2U * STRING_TRANSFORM_BLOCK_SIZE) {
+		const string_transform_vector_type front_block = string_transform_load(p + front);
+		const string_transform_vector_type back_block = string_transform_load(p + back - STRING_TRANSFORM_BLOCK_SIZE);
+		string_transform_store(p + front, string_transform_reverse_vector(back_block));
+		string_transform_store(p + back - STRING_TRANSFORM_BLOCK_SIZE, string_transform_reverse_vector(front_block));
+		front += STRING_TRANSFORM_BLOCK_SIZE;
+		back -= STRING_TRANSFORM_BLOCK_SIZE;
+	}
+#endif
+	while (back - front >= 16U) {
+		const uint64_t front_word = string_transform_load64(p + front);
+		const uint64_t back_word = string_transform_load64(p + back - 8U);
+		string_transform_store64(p + front, string_transform_swap_bytes_of_words(back_word, 8U));
+		string_transform_store64(p + back - 8U, string_transform_swap_bytes_of_words(front_word, 8U));
+		front += 8U;
+		back -= 8U;
+	}
+	while (back - front >= 2U) {
+		const char byte = p[front];
+		--back;
+		p[front] = p[back];
+		p[back] = byte;
+		++front;
+	}
+}
+
+void string_transform_swap_byte_order(stringref_type string, size_t word_size)
+{
+	size_t length = 0U;
+	size_t index = 0U;
+
+	if (string.string == NULL or (word_size != 2U and word_size != 4U and word_size != 8U)) {
+		return;
+	}
+	length = string.length / word_size * word_size;
+#if defined(STRING_TRANSFORM_BLOCK_SIZE)
+	index = length / STRING_TRANSFORM_BLOCK_SIZE * STRING_TRANSFORM_BLOCK_SIZE;
+	string_transform_swap_byte_order_of_blocks(string.string, length / STRING_TRANSFORM_BLOCK_SIZE, word_size);
+#endif
+	for (; length - index >= 8U; index += 8U) {
+		string_transform_store64(string.string + index,
+			string_transform_swap_bytes_of_words(string_transform_load64(string.string + index), word_size));
+	}
+	for (; index < length; index += word_size) {
+		char *word = string.string + index;
+		size_t left = 0U;
+		size_t right = word_size - 1U;
+		for (; left < right; ++left, --right) {
+			const char byte = word[left];
+			word[left] = word[right];
+			word[right] = byte;
+		}
+	}
+}
+
+void string_transform_translate(stringref_type string, const unsigned char *table)
+{
+	unsigned char *p = (unsigned char*) string.string;
+	size_t index = 0U;
+
+	assert(table != NULL);
+	if (p == NULL or table == NULL) {
+		return;
+	}
+	/* four independent lookups per iteration */
+	for (; string.length - index >= 4U; index += 4U) {
+		const unsigned char byte0 = table[p[index]];
+		const unsigned char byte1 = table[p[index + 1U]];
+		const unsigned char byte2 = table[p[index + 2U]];
+		const unsigned char byte3 = table[p[index + 3U]];
+		p[index] = byte0;
+		p[index + 1U] = byte1;
+		p[index + 2U] = byte2;
+		p[index + 3U] = byte3;
+	}
+	for (; index < string.length; ++index) {
+		p[index] = table[p[index]];
+	}
+}
+
+void string_transform_make_identity_table(unsigned char *table)
+{
+	size_t i = 0U;
+
+	assert(table != NULL);
+	for (; i < 256U; ++i) {
+		table[i] = (unsigned char) i;
+	}
+}
@@ -0,0 +1,50 @@
+/* Minimum C Standard: C89 */
+
+#ifndef STRING_TRANSFORM_H
+#define STRING_TRANSFORM_H
+
+#include "string_reference.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+In-place byte transforms for string references.
+
+The functions transform all the bytes up to the length of a string reference, including any '\0'.
+Nothing is done for a string reference with a null pointer.
+
+Reversing and swapping the byte order process 32 bytes at a time with AVX2, 16 bytes at a time with SSE2 if the
+compiler targets them, and 8 bytes at a time with 64-bit integer operations otherwise.
+Translation uses a table lookup per byte, which is faster than any SIMD emulation of a 256-entry table without
+AVX-512 instructions.
+*/
+
+/* Reverses the order of the bytes of a string. The result is the same as of stringref_reverse_string. */
+void string_transform_reverse(stringref_type string);
+
+/*
+Reverses the order of the bytes within each word of a string, e.g. converts an array of big-endian integers
+into little-endian integers.
+
+Parameters:
+string   : The string.
+word_size: The number of bytes of each word, 2, 4 or 8. Other sizes leave the string unchanged.
+
+Bytes after the last complete word are left unchanged.
+*/
+void string_transform_swap_byte_order(stringref_type string, size_t word_size);
+
+/* Replaces each byte b of a string with table[b]. The table must have 256 entries. */
+void string_transform_translate(stringref_type string, const unsigned char *table);
+
+/* Fills a table for string_transform_translate which maps each byte to itself. */
+void string_transform_make_identity_table(unsigned char *table);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
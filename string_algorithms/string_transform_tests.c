@@ -0,0 +1,123 @@
+#include "string_transform.h"
+#include "unit_testing.h"
+
+#include <iso646.h>
+#include <string.h>
+
+static char s_buffer[300];
+static char s_expected[300];
+
+static void fill_buffer(size_t length)
+{
+	size_t i = 0U;
+	for (; i < length; ++i) {
+		s_buffer[i] = (char) (unsigned char) ((i * 37U + 11U) & 0xFFU);
+	}
+}
+
+TEST(string_transform_reverse_all_lengths, "string_transform_reverse reverses strings of every length")
+{
+	size_t length = 0U;
+	size_t i = 0U;
+
+	for (length = 0U; length <= sizeof(s_buffer); ++length) {
+		fill_buffer(length);
+		for (i = 0U; i < length; ++i) {
+			s_expected[i] = s_buffer[length - 1U - i];
+		}
+		string_transform_reverse(string_to_stringref(s_buffer, length));
+		ASSERT_EQUAL(memcmp(s_buffer, s_expected, length), 0);
+	}
+}
+
+TEST(string_transform_reverse_matches_stringref_reverse_string, "string_transform_reverse gives the same result as stringref_reverse_string")
+{
+	char string1[] = "Hello, world! This string is longer than two blocks of thirty-two bytes.";
+	char string2[] = "Hello, world! This string is longer than two blocks of thirty-two bytes.";
+
+	string_transform_reverse(string_to_stringref(string1, strlen(string1)));
+	stringref_reverse_string(string_to_stringref(string2, strlen(string2)));
+	ASSERT_EQUAL(strcmp(string1, string2), 0);
+	string_transform_reverse(string_to_stringref(NULL, 5U));
+}
+
+TEST(string_transform_swap_byte_order_test, "string_transform_swap_byte_order reverses the bytes of each word")
+{
+	const size_t word_sizes[] = {2U, 4U, 8U};
+	size_t w = 0U;
+	size_t length = 0U;
+	size_t i = 0U;
+
+	for (w = 0U; w < sizeof(word_sizes) / sizeof(word_sizes[0]); ++w) {
+		const size_t word_size = word_sizes[w];
+		for (length = 0U; length <= sizeof(s_buffer); ++length) {
+			const size_t swapped_length = length / word_size * word_size;
+			fill_buffer(length);
+			for (i = 0U; i < length; ++i) {
+				s_expected[i] = (i < swapped_length) ? s_buffer[i / word_size * word_size + (word_size - 1U - i % word_size)] : s_buffer[i];
+			}
+			string_transform_swap_byte_order(string_to_stringref(s_buffer, length), word_size);
+			ASSERT_EQUAL(memcmp(s_buffer, s_expected, length), 0);
+		}
+	}
+}
+
+TEST(string_transform_swap_byte_order_values, "Swapping the byte order of integers")
+{
+	unsigned char bytes[8] = {0x01U, 0x02U, 0x03U, 0x04U, 0x05U, 0x06U, 0x07U, 0x08U};
+	const unsigned char expected4[8] = {0x04U, 0x03U, 0x02U, 0x01U, 0x08U, 0x07U, 0x06U, 0x05U};
+	const unsigned char expected8[8] = {0x05U, 0x06U, 0x07U, 0x08U, 0x01U, 0x02U, 0x03U, 0x04U};
+
+	string_transform_swap_byte_order(string_to_stringref((char*) bytes, sizeof(bytes)), 4U);
+	ASSERT_EQUAL(memcmp(bytes, expected4, sizeof(bytes)), 0);
+	string_transform_swap_byte_order(string_to_stringref((char*) bytes, sizeof(bytes)), 8U);
+	ASSERT_EQUAL(memcmp(bytes, expected8, sizeof(bytes)), 0);
+	string_transform_swap_byte_order(string_to_stringref((char*) bytes, sizeof(bytes)), 3U);
+	ASSERT_EQUAL(memcmp(bytes, expected8, sizeof(bytes)), 0);
+	string_transform_swap_byte_order(string_to_stringref((char*) bytes, sizeof(bytes)), 0U);
+	ASSERT_EQUAL(memcmp(bytes, expected8, sizeof(bytes)), 0);
+}
+
+TEST(string_transform_translate_test, "string_transform_translate replaces each byte using the table")
+{
+	unsigned char table[256];
+	char string[] = "hex: 0123456789abcdef";
+	size_t i = 0U;
+
+	string_transform_make_identity_table(table);
+	for (i = 0U; i < 256U; ++i) {
+		ASSERT_EQUAL(table[i], (unsigned char) i);
+	}
+	for (i = 'a'; i <= 'f'; ++i) {
+		table[i] = (unsigned char) (i - 'a' + 'A');
+	}
+	table[' '] = '_';
+	string_transform_translate(string_to_stringref(string, strlen(string)), table);
+	ASSERT_EQUAL(strcmp(string, "hEx:_0123456789ABCDEF"), 0);
+
+	for (i = 0U; i < 256U; ++i) {
+		table[i] = (unsigned char) (255U - i);
+	}
+	fill_buffer(sizeof(s_buffer));
+	for (i = 0U; i < sizeof(s_buffer); ++i) {
+		s_expected[i] = (char) (unsigned char) (255U - (unsigned char) s_buffer[i]);
+	}
+	string_transform_translate(string_to_stringref(s_buffer, sizeof(s_buffer)), table);
+	ASSERT_EQUAL(memcmp(s_buffer, s_expected, sizeof(s_buffer)), 0);
+}
+
+int main(void)
+{
+	DEFINE_LIST_OF_TESTS(list_of_tests) {
+		string_transform_reverse_all_lengths,
+		string_transform_reverse_matches_stringref_reverse_string,
+		string_transform_swap_byte_order_test,
+		string_transform_swap_byte_order_values,
+		string_transform_translate_test
+	};
+
+	PRINT_FILE_NAME();
+	RUN_TESTS(list_of_tests);
+	PRINT_TEST_STATISTICS(list_of_tests);
+	return 0;
+}
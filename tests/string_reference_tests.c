@@ -263,6 +263,51 @@ TEST(const_stringref_string_length_null_pointer, "const_stringref_string_length
 	ASSERT_SIZE_EQUAL(length, 0U);
 }
 
+TEST(const_stringref_string_length_long_strings, "const_stringref_string_length finds the null terminator at every position")
+{
+	char buffer[300];
+	size_t position = 0U;
+
+	memset(buffer, 'a', sizeof(buffer));
+	for (position = 0U; position < sizeof(buffer); ++position) {
+		size_t offset = 0U;
+		buffer[position] = '\0';
+		for (offset = 0U; offset < 4U && offset <= position; ++offset) {
+			const_stringref_type ref = string_to_const_stringref(buffer + offset, sizeof(buffer) - offset);
+			const_stringref_type short_ref = string_to_const_stringref(buffer + offset, position - offset);
+			ASSERT_SIZE_EQUAL(const_stringref_string_length(ref), position - offset);
+			ASSERT_SIZE_EQUAL(const_stringref_string_length(short_ref), position - offset);
+		}
+		buffer[position] = 'a';
+	}
+}
+
+TEST(const_stringref_truncate_at_null_terminator_test, "const_stringref_truncate_at_null_terminator keeps the string length")
+{
+	const char str[] = "Hello\0World";
+	const_stringref_type ref = string_to_const_stringref(str, sizeof_array(str) - 1U);
+	const_stringref_type truncated_ref = const_stringref_truncate_at_null_terminator(ref);
+	const_stringref_type null_ref = const_stringref_truncate_at_null_terminator(string_to_const_stringref(NULL, 5U));
+
+	ASSERT(truncated_ref.string == str);
+	ASSERT_SIZE_EQUAL(truncated_ref.length, 5U);
+	ASSERT(null_ref.string == NULL);
+	ASSERT_SIZE_EQUAL(null_ref.length, 0U);
+}
+
+CONSTEXPR_CONST_STRINGREF(s_keyword_while, "while");
+
+TEST(const_stringref_literal_test, "CONST_STRINGREF_LITERAL initializes references at compile time")
+{
+	static const const_stringref_type keywords[] = {CONST_STRINGREF_LITERAL("if"), CONST_STRINGREF_LITERAL("a\0b")};
+
+	ASSERT_SIZE_EQUAL(keywords[0].length, 2U);
+	ASSERT_EQUAL(strcmp(keywords[0].string, "if"), 0);
+	ASSERT_SIZE_EQUAL(keywords[1].length, 3U);
+	ASSERT_SIZE_EQUAL(s_keyword_while.length, 5U);
+	ASSERT_EQUAL(memcmp(s_keyword_while.string, "while", 5U), 0);
+}
+
 /* TEST: stringref_string_length */
 
 TEST(stringref_string_length_basic, "stringref_string_length calculates correct length")
@@ -500,6 +545,48 @@ TEST(const_stringref_strings_are_equal_special, "const_stringref_strings_are_equ
 	ASSERT(const_stringref_strings_are_equal(ref1, ref2));
 }
 
+TEST(const_stringref_strings_are_equal_second_null_terminated, "const_stringref_strings_are_equal with a null terminator in the second string")
+{
+	const char str1[] = "Hello";
+	const char str2[] = "Hello\0World";
+	const char str3[] = "HelloWorld";
+	const_stringref_type ref1 = string_to_const_stringref(str1, strlen(str1));
+	const_stringref_type ref2 = string_to_const_stringref(str2, sizeof_array(str2) - 1U);
+	const_stringref_type ref3 = string_to_const_stringref(str3, strlen(str3));
+	const_stringref_type ref4 = string_to_const_stringref(str3, 4U);
+
+	ASSERT(const_stringref_strings_are_equal(ref1, ref2));
+	ASSERT(const_stringref_strings_are_equal(ref2, ref1));
+	ASSERT(not const_stringref_strings_are_equal(ref1, ref3));
+	ASSERT(not const_stringref_strings_are_equal(ref3, ref1));
+	ASSERT(not const_stringref_strings_are_equal(ref1, ref4));
+	ASSERT(not const_stringref_strings_are_equal(ref4, ref1));
+}
+
+TEST(const_stringref_strings_are_equal_long_strings, "const_stringref_strings_are_equal with long strings")
+{
+	char buffer1[200];
+	char buffer2[200];
+	size_t position = 0U;
+
+	memset(buffer1, 'x', sizeof(buffer1));
+	memset(buffer2, 'x', sizeof(buffer2));
+	for (position = 0U; position < sizeof(buffer1); ++position) {
+		const_stringref_type ref1 = string_to_const_stringref(buffer1, sizeof(buffer1));
+		const_stringref_type ref2 = string_to_const_stringref(buffer2, sizeof(buffer2));
+		ASSERT(const_stringref_strings_are_equal(ref1, ref2));
+		buffer2[position] = 'y';
+		ASSERT(not const_stringref_strings_are_equal(ref1, ref2));
+		buffer1[position] = '\0';
+		ASSERT(const_stringref_strings_are_equal(ref1, string_to_const_stringref(buffer2, position)));
+		ASSERT(not const_stringref_strings_are_equal(ref1, ref2));
+		buffer2[position] = '\0';
+		ASSERT(const_stringref_strings_are_equal(ref1, ref2));
+		buffer1[position] = 'x';
+		buffer2[position] = 'x';
+	}
+}
+
 /* TEST: const_stringref_contents_are_equal */
 
 TEST(const_stringref_contents_are_equal_identical, "const_stringref_contents_are_equal with identical strings")
@@ -690,6 +777,9 @@ int main(void)
 		const_stringref_string_length_with_null_terminator_in_middle,
 		const_stringref_string_length_no_null_terminator,
 		const_stringref_string_length_null_pointer,
+		const_stringref_string_length_long_strings,
+		const_stringref_truncate_at_null_terminator_test,
+		const_stringref_literal_test,
 
 		/* stringref_string_length */
 		stringref_string_length_basic,
@@ -725,6 +815,8 @@ int main(void)
 		const_stringref_strings_are_equal_one_null,
 		const_stringref_strings_are_equal_case_sensitive,
 		const_stringref_strings_are_equal_special,
+		const_stringref_strings_are_equal_second_null_terminated,
+		const_stringref_strings_are_equal_long_strings,
 
 		/* const_stringref_contents_are_equal */
 		const_stringref_contents_are_equal_identical,
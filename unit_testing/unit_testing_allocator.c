@@ -0,0 +1,51 @@
+#include "unit_testing_allocator.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+size_t unit_testing_allocations_until_failure = (size_t) -1;
+size_t unit_testing_number_of_allocations = 0U;
+size_t unit_testing_number_of_deallocations = 0U;
+
+void *unit_testing_allocate(size_t number_of_bytes)
+{
+	void *memory_block = NULL;
+
+	if (unit_testing_allocations_until_failure == 0U) {
+		return NULL;
+	}
+	memory_block = malloc(number_of_bytes);
+	if (memory_block != NULL) {
+		if (unit_testing_allocations_until_failure != (size_t) -1) {
+			--unit_testing_allocations_until_failure;
+		}
+		++unit_testing_number_of_allocations;
+	}
+	return memory_block;
+}
+
+void unit_testing_deallocate(void *memory_block)
+{
+	if (memory_block != NULL) {
+		++unit_testing_number_of_deallocations;
+	}
+	free(memory_block);
+}
+
+allocator_type unit_testing_make_allocator(void)
+{
+	allocator_type allocator;
+
+	allocator.allocate = &unit_testing_allocate;
+	allocator.reallocate = NULL;
+	allocator.deallocate = &unit_testing_deallocate;
+	unit_testing_allocations_until_failure = (size_t) -1;
+	unit_testing_number_of_allocations = 0U;
+	unit_testing_number_of_deallocations = 0U;
+	return allocator;
+}
+
+const_stringref_type unit_testing_make_stringref(const char *string)
+{
+	return string_to_const_stringref(string, strlen(string));
+}
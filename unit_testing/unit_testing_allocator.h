@@ -0,0 +1,43 @@
+#ifndef UNIT_TESTING_ALLOCATOR_H
+#define UNIT_TESTING_ALLOCATOR_H
+
+#include "allocator_type.h"
+#include "string_reference.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+An allocator for tests of code which allocates memory: it counts the allocations and deallocations, and the next
+allocations can be made to fail, to test the handling of a lack of memory.
+
+unit_testing_allocations_until_failure is the number of allocations which succeed before every further allocation
+fails, or (size_t) -1 if no allocation fails.
+
+The counters are plain global variables without any synchronization. The allocator must not be used where several
+threads can succeed at allocating or can deallocate at the same time: only a failing allocation, which reads the
+countdown and writes nothing, may run in several threads at once. Tests of multithreaded code which allocates
+should use malloc, realloc and free directly, except to test a lack of memory.
+*/
+extern size_t unit_testing_allocations_until_failure;
+extern size_t unit_testing_number_of_allocations;
+extern size_t unit_testing_number_of_deallocations;
+
+void *unit_testing_allocate(size_t number_of_bytes);
+
+void unit_testing_deallocate(void *memory_block);
+
+/* Returns the allocator, after resetting the counters, so no allocation fails. */
+allocator_type unit_testing_make_allocator(void);
+
+/* Returns a reference to a null-terminated string, without the null character. */
+const_stringref_type unit_testing_make_stringref(const char *string);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif